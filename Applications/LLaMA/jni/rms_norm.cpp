@@ -14,12 +14,33 @@
 #include <cmath>
 #include <iostream>
 
+#include <blas_interface.h>
+
 #include "rms_norm.h"
 
 namespace custom {
 
 static constexpr size_t SINGLE_INOUT_IDX = 0;
 
+/**
+ * @brief normalize each row of the width axis with the fused kernel, which
+ * reads a row once for the mean square and once for the output
+ */
+static void rmsNormRows(const nntrainer::Tensor &in, nntrainer::Tensor &out,
+                        const nntrainer::Tensor &gamma, float epsilon) {
+  const unsigned int width = in.width();
+  const unsigned int rows = in.size() / width;
+  const float *in_data = in.getData<float>();
+  float *out_data = out.getData<float>();
+  const float *gamma_data = gamma.getData<float>();
+
+  for (unsigned int r = 0; r < rows; ++r) {
+    const size_t offset = static_cast<size_t>(r) * width;
+    nntrainer::rms_norm(width, in_data + offset, gamma_data, epsilon,
+                        out_data + offset);
+  }
+}
+
 void RMSNormLayer::finalize(nntrainer::InitLayerContext &context) {
   std::vector<nntrainer::TensorDim> dim = context.getInputDimensions();
 
@@ -45,11 +66,7 @@ void RMSNormLayer::forwarding(nntrainer::RunLayerContext &context,
   auto &epsilon = std::get<nntrainer::props::Epsilon>(rms_props).get();
 
   if (in.getDataType() == ml::train::TensorDim::DataType::FP32) {
-    std::function<float(float)> f = [](float x) { return 1 / std::sqrt(x); };
-    auto t = in.multiply(in).average(3).add(epsilon);
-    t.apply_i(f);
-    in.multiply(t, out);
-    out.multiply_i(gamma);
+    rmsNormRows(in, out, gamma, epsilon);
 
   } else if (in.getDataType() == ml::train::TensorDim::DataType::FP16) {
 #ifdef ENABLE_FP16
@@ -102,11 +119,7 @@ void RMSNormLayer::incremental_forwarding(nntrainer::RunLayerContext &context,
   auto &epsilon = std::get<nntrainer::props::Epsilon>(rms_props).get();
 
   if (in_step.getDataType() == ml::train::TensorDim::DataType::FP32) {
-    std::function<float(float)> f = [](float x) { return 1 / std::sqrt(x); };
-    auto t = in_step.multiply(in_step).average(3).add(epsilon);
-    t.apply_i(f);
-    in_step.multiply(t, out_step);
-    out_step.multiply_i(gamma);
+    rmsNormRows(in_step, out_step, gamma, epsilon);
 
   } else if (in_step.getDataType() == ml::train::TensorDim::DataType::FP16) {
 #ifdef ENABLE_FP16
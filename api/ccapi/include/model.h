@@ -47,6 +47,8 @@ struct RunStats {
   int epoch_idx;
   unsigned int
     num_correct_predictions; /** number of right sample on this run */
+  unsigned int num_overflows; /** number of gradient overflows on this run */
+  float loss_scale;           /** loss scale at the end of this run */
 
   /**
    * @brief     Initializer of RunStats
@@ -57,7 +59,9 @@ struct RunStats {
     num_iterations(0),
     max_epoch(0),
     epoch_idx(0),
-    num_correct_predictions(0) {}
+    num_correct_predictions(0),
+    num_overflows(0),
+    loss_scale(1.0f) {}
 };
 
 /**
@@ -91,6 +95,9 @@ for inference and training without any configurations*/
                                            where the binary will be saved */
   MODEL_FORMAT_FLATBUFFER =
     ML_TRAIN_MODEL_FORMAT_FLATBUFFER, /**< flatbuffer file */
+  MODEL_FORMAT_MMAP_BIN =
+    ML_TRAIN_MODEL_FORMAT_MMAP_BIN, /**< bin file with the page aligned weight
+                                       memory, mapped at load */
 };
 
 /**
@@ -413,6 +420,13 @@ createModel(ModelType type = ml::train::ModelType::NEURAL_NET,
  */
 std::unique_ptr<Model> copyConfiguration(Model &from);
 
+/**
+ * @brief creator of an inference session sharing the weights of the given
+ * initialized model. Each session runs inference independently, so sessions
+ * can run in parallel from different threads.
+ */
+std::unique_ptr<Model> createSession(Model &from);
+
 } // namespace train
 } // namespace ml
 
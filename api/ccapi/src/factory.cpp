@@ -90,6 +90,14 @@ std::unique_ptr<Model> copyConfiguration(Model &from) {
   return model;
 }
 
+/**
+ * @brief creator of an inference session sharing the weights of the model
+ */
+std::unique_ptr<Model> createSession(Model &from) {
+  nntrainer::NeuralNetwork &f = dynamic_cast<nntrainer::NeuralNetwork &>(from);
+  return f.createSession();
+}
+
 /**
  * @brief Factory creator with constructor for dataset
  */
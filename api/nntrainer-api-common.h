@@ -262,7 +262,10 @@ typedef enum {
     2, /**< Ini with bin format file saves configurations with parameters
          required for inference and training. */
   ML_TRAIN_MODEL_FORMAT_FLATBUFFER =
-    3 /**< Flatbuffer format file saves model configurations and weights. */
+    3, /**< Flatbuffer format file saves model configurations and weights. */
+  ML_TRAIN_MODEL_FORMAT_MMAP_BIN =
+    4 /**< Bin file saves the weight memory with the page aligned layout, which
+         is mapped at load instead of being read. */
 } ml_train_model_format_e;
 
 /**
@@ -17,6 +17,7 @@
  */
 
 #include <algorithm>
+#include <cstring>
 #include <limits>
 #include <sstream>
 #include <unistd.h>
@@ -84,8 +85,215 @@ static ml::train::TensorDim to_nntr_tensor_dim(const GstTensorInfo *info) {
   return {d[3], d[2], d[1], d[0]};
 }
 
-NNTrainerInference::NNTrainerInference(const std::string &model_config_) :
+/**
+ * @brief microseconds elapsed from @a from to @a to
+ */
+template <typename TimePoint>
+static std::uint64_t elapsed_us(const TimePoint &from, const TimePoint &to) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(to - from)
+    .count();
+}
+
+NNTrainerBatchScheduler::NNTrainerBatchScheduler(
+  const std::string &model_config_, unsigned int max_batch_,
+  std::chrono::microseconds max_delay_) :
+  model_config(model_config_),
+  max_batch(max_batch_),
+  max_delay(max_delay_),
+  queued_samples(0),
+  stop(false),
+  started(Clock::now()) {
+  model = ml::train::createModel(ml::train::ModelType::NEURAL_NET);
+  model->load(model_config, ml::train::ModelFormat::MODEL_FORMAT_INI_WITH_BIN);
+  model->compile();
+  model->initialize();
+
+  input_dims = model->getInputDimension();
+  output_dims = model->getOutputDimension();
+  staging.resize(input_dims.size());
+
+  worker = std::thread(&NNTrainerBatchScheduler::loop, this);
+}
+
+NNTrainerBatchScheduler::~NNTrainerBatchScheduler() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stop = true;
+  }
+  cv.notify_one();
+  worker.join();
+
+  auto seconds = elapsed_us(started, Clock::now()) / 1e6;
+  ml_logi("batching %s: %" G_GUINT64_FORMAT " requests, %" G_GUINT64_FORMAT
+          " samples in %" G_GUINT64_FORMAT " batches, %.1f samples/s",
+          model_config.c_str(), stats.requests, stats.samples, stats.batches,
+          seconds > 0 ? stats.samples / seconds : 0.0);
+}
+
+std::shared_ptr<NNTrainerBatchScheduler>
+NNTrainerBatchScheduler::get(const std::string &model_config,
+                             unsigned int max_batch,
+                             std::chrono::microseconds max_delay) {
+  static std::mutex registry_mutex;
+  static std::map<std::string, std::weak_ptr<NNTrainerBatchScheduler>>
+    registry;
+
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  auto scheduler = registry[model_config].lock();
+  if (scheduler) {
+    if (scheduler->max_batch != max_batch ||
+        scheduler->max_delay != max_delay) {
+      ml_logi("batching %s: options differ from the running scheduler, "
+              "keeping max batch %u",
+              model_config.c_str(), scheduler->max_batch);
+    }
+    return scheduler;
+  }
+
+  scheduler = std::make_shared<NNTrainerBatchScheduler>(model_config,
+                                                        max_batch, max_delay);
+  registry[model_config] = scheduler;
+  return scheduler;
+}
+
+void NNTrainerBatchScheduler::run(unsigned int batch,
+                                  const std::vector<float *> &inputs,
+                                  const std::vector<float *> &outputs) {
+  Request request{batch, inputs, outputs, Clock::now(), {}};
+  auto done = request.done.get_future();
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    queue.push_back(&request);
+    queued_samples += batch;
+  }
+  cv.notify_one();
+
+  done.get();
+}
+
+NNTrainerBatchScheduler::Statistics NNTrainerBatchScheduler::getStatistics() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return stats;
+}
+
+void NNTrainerBatchScheduler::loop() {
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true) {
+    cv.wait(lock, [this] { return stop || !queue.empty(); });
+    if (queue.empty())
+      return;
+
+    /// wait for more requests until the batch is full or the oldest request
+    /// has waited long enough
+    auto deadline = queue.front()->enqueued + max_delay;
+    cv.wait_until(lock, deadline,
+                  [this] { return stop || queued_samples >= max_batch; });
+
+    std::vector<Request *> requests;
+    unsigned int samples = 0;
+    while (!queue.empty() &&
+           (requests.empty() || samples + queue.front()->batch <= max_batch)) {
+      requests.push_back(queue.front());
+      samples += queue.front()->batch;
+      queue.pop_front();
+    }
+    queued_samples -= samples;
+
+    lock.unlock();
+    forward(requests, samples);
+    lock.lock();
+  }
+}
+
+void NNTrainerBatchScheduler::forward(std::vector<Request *> &requests,
+                                      unsigned int samples) {
+  /// round the batch up to a power of two so that only a few batch sizes are
+  /// planned and allocated by the model
+  unsigned int batch = 1;
+  while (batch < samples)
+    batch <<= 1;
+  batch = std::max(samples, std::min(batch, max_batch));
+
+  auto start = Clock::now();
+  std::exception_ptr error;
+  try {
+    std::vector<float *> inputs;
+    if (requests.size() == 1 && batch == samples) {
+      inputs = requests.front()->inputs;
+    } else {
+      /// gather the inputs, the padded samples are left as they are
+      for (size_t idx = 0; idx < input_dims.size(); idx++) {
+        size_t len = input_dims[idx].getFeatureLen();
+        staging[idx].resize(batch * len);
+        float *dst = staging[idx].data();
+        for (auto &request : requests) {
+          std::memcpy(dst, request->inputs[idx],
+                      request->batch * len * sizeof(float));
+          dst += request->batch * len;
+        }
+        inputs.push_back(staging[idx].data());
+      }
+    }
+
+    std::vector<float *> labels;
+    auto outputs = model->inference(batch, inputs, labels);
+
+    /// scatter the outputs back to each request
+    for (size_t idx = 0; idx < output_dims.size(); idx++) {
+      NNTR_THROW_IF(outputs[idx] == nullptr, std::runtime_error)
+        << "output of the batched inference is null";
+      size_t len = output_dims[idx].getFeatureLen();
+      const float *src = outputs[idx];
+      for (auto &request : requests) {
+        std::memcpy(request->outputs[idx], src,
+                    request->batch * len * sizeof(float));
+        src += request->batch * len;
+      }
+    }
+  } catch (...) {
+    error = std::current_exception();
+  }
+  auto end = Clock::now();
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stats.batches++;
+    stats.padded_samples += batch - samples;
+    stats.total_forward_us += elapsed_us(start, end);
+    for (auto &request : requests) {
+      auto queue_us = elapsed_us(request->enqueued, start);
+      auto latency_us = elapsed_us(request->enqueued, end);
+      stats.requests++;
+      stats.samples += request->batch;
+      stats.total_queue_us += queue_us;
+      stats.max_queue_us = std::max(stats.max_queue_us, queue_us);
+      stats.total_latency_us += latency_us;
+      stats.max_latency_us = std::max(stats.max_latency_us, latency_us);
+    }
+  }
+
+  /// the callers may return as soon as they are notified, so requests must
+  /// not be touched after this
+  for (auto &request : requests) {
+    if (error)
+      request->done.set_exception(error);
+    else
+      request->done.set_value();
+  }
+}
+
+NNTrainerInference::NNTrainerInference(const std::string &model_config_,
+                                       unsigned int max_batch,
+                                       std::chrono::microseconds max_delay) :
   batch_size(1), model_config(model_config_) {
+  if (max_batch > 1) {
+    scheduler =
+      NNTrainerBatchScheduler::get(model_config, max_batch, max_delay);
+    outputs.resize(scheduler->getOutputDimension().size());
+    return;
+  }
+
   loadModel();
   model->compile();
   model->initialize();
@@ -123,6 +331,9 @@ int NNTrainerInference::run(const GstTensorMemory *input,
     // do not allocate new, but instead use tensor::Map
     inputs.emplace_back(static_cast<float *>(input[idx].data));
 
+  if (scheduler)
+    return runBatched(inputs, output);
+
   std::vector<float *> outputs;
   std::vector<float *> labels;
 
@@ -151,6 +362,33 @@ int NNTrainerInference::run(const GstTensorMemory *input,
   return 0;
 }
 
+int NNTrainerInference::runBatched(const std::vector<float *> &inputs,
+                                   GstTensorMemory *output) {
+  auto output_dims = getOutputDimension();
+
+  std::vector<float *> dst;
+  dst.reserve(output_dims.size());
+  for (size_t idx = 0; idx < output_dims.size(); idx++) {
+    outputs[idx].resize(batch_size * output_dims[idx].getFeatureLen());
+    dst.push_back(outputs[idx].data());
+  }
+
+  try {
+    scheduler->run(batch_size, inputs, dst);
+  } catch (std::exception &e) {
+    ml_loge("%s %s", typeid(e).name(), e.what());
+    return -2;
+  } catch (...) {
+    ml_loge("unknown error type thrown");
+    return -3;
+  }
+
+  for (size_t idx = 0; idx < output_dims.size(); idx++)
+    output[idx].data = static_cast<void *>(dst[idx]);
+
+  return 0;
+}
+
 static void nntrainer_close(const GstTensorFilterProperties *prop,
                             void **private_data) {
   NNTrainerInference *nntrainer =
@@ -162,6 +400,36 @@ static void nntrainer_close(const GstTensorFilterProperties *prop,
   *private_data = NULL;
 }
 
+/**
+ * @brief parse the custom properties of the filter, given as
+ * "MaxBatch:8,MaxDelay:5" where MaxDelay is in milliseconds
+ */
+static void nntrainer_parseCustom(const GstTensorFilterProperties *prop,
+                                  unsigned int &max_batch,
+                                  std::chrono::microseconds &max_delay) {
+  if (prop->custom_properties == NULL)
+    return;
+
+  gchar **options = g_strsplit(prop->custom_properties, ",", -1);
+  for (guint i = 0; options[i] != NULL; ++i) {
+    gchar **pair = g_strsplit(options[i], ":", 2);
+    if (pair[0] != NULL && pair[1] != NULL) {
+      g_strstrip(pair[0]);
+      g_strstrip(pair[1]);
+      if (g_ascii_strcasecmp(pair[0], "MaxBatch") == 0) {
+        max_batch = g_ascii_strtoull(pair[1], NULL, 10);
+      } else if (g_ascii_strcasecmp(pair[0], "MaxDelay") == 0) {
+        max_delay = std::chrono::milliseconds(
+          g_ascii_strtoull(pair[1], NULL, 10));
+      } else {
+        ml_logi("unknown custom property %s is ignored", pair[0]);
+      }
+    }
+    g_strfreev(pair);
+  }
+  g_strfreev(options);
+}
+
 static int nntrainer_loadModelFile(const GstTensorFilterProperties *prop,
                                    void **private_data) {
   if (prop->num_models != 1)
@@ -177,8 +445,12 @@ static int nntrainer_loadModelFile(const GstTensorFilterProperties *prop,
     nntrainer_close(prop, private_data);
   }
 
+  unsigned int max_batch = 0;
+  std::chrono::microseconds max_delay(0);
+  nntrainer_parseCustom(prop, max_batch, max_delay);
+
   try {
-    nntrainer = new NNTrainerInference(model_file);
+    nntrainer = new NNTrainerInference(model_file, max_batch, max_delay);
   } catch (std::exception &e) {
     ml_loge("%s %s", typeid(e).name(), e.what());
     return -1;
@@ -16,9 +16,15 @@
  * Fill in "GstTensorFilterFramework" for tensor_filter.h/c
  *
  */
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
+#include <deque>
+#include <future>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 #include <nnstreamer_plugin_api.h>
@@ -35,6 +41,144 @@ typedef struct {
   std::vector<std::int64_t> dims;
 } nntrainer_tensor_info_s;
 
+/**
+ * @brief Batching scheduler which coalesces the requests of every filter
+ * instance running the same model into one batched inference
+ * @note  A single worker thread owns the model. Requests are queued until
+ * max_batch samples are gathered or the oldest request has waited max_delay,
+ * and the outputs are copied back to each caller after the forward.
+ */
+class NNTrainerBatchScheduler {
+public:
+  /**
+   * @brief Counters of the scheduler, times are in microseconds
+   */
+  struct Statistics {
+    std::uint64_t requests = 0;         /**< number of requests served */
+    std::uint64_t samples = 0;          /**< number of samples served */
+    std::uint64_t batches = 0;          /**< number of forwards run */
+    std::uint64_t padded_samples = 0;   /**< samples added to round the batch */
+    std::uint64_t total_queue_us = 0;   /**< sum of the queueing delays */
+    std::uint64_t max_queue_us = 0;     /**< largest queueing delay */
+    std::uint64_t total_latency_us = 0; /**< sum of the request latencies */
+    std::uint64_t max_latency_us = 0;   /**< largest request latency */
+    std::uint64_t total_forward_us = 0; /**< time spent in the forwards */
+  };
+
+  /**
+   * @brief Construct a new NNTrainerBatchScheduler object
+   *
+   * @param model_config model config path
+   * @param max_batch maximum number of samples in a batch
+   * @param max_delay maximum time the oldest request waits for others
+   */
+  NNTrainerBatchScheduler(const std::string &model_config,
+                          unsigned int max_batch,
+                          std::chrono::microseconds max_delay);
+
+  /**
+   * @brief Destroy the NNTrainerBatchScheduler object, stops the worker
+   *
+   */
+  ~NNTrainerBatchScheduler();
+
+  /**
+   * @brief Get the scheduler of the model shared by the filter instances,
+   * create one if there is none
+   *
+   * @param model_config model config path
+   * @param max_batch maximum number of samples in a batch
+   * @param max_delay maximum time the oldest request waits for others
+   * @return std::shared_ptr<NNTrainerBatchScheduler> scheduler
+   */
+  static std::shared_ptr<NNTrainerBatchScheduler>
+  get(const std::string &model_config, unsigned int max_batch,
+      std::chrono::microseconds max_delay);
+
+  /**
+   * @brief Run inference of @a batch samples along with the other requests,
+   * blocks until the outputs are written
+   *
+   * @param batch batch size of the request
+   * @param inputs input buffers, one per model input
+   * @param outputs output buffers to fill, one per model output
+   * @throw any exception thrown by the inference of the batch
+   */
+  void run(unsigned int batch, const std::vector<float *> &inputs,
+           const std::vector<float *> &outputs);
+
+  /**
+   * @brief Get the Input Dimension object
+   *
+   * @return const std::vector<ml::train::TensorDim> input dimensions
+   */
+  const std::vector<ml::train::TensorDim> getInputDimension() {
+    return input_dims;
+  }
+
+  /**
+   * @brief Get the Output Dimension object
+   *
+   * @return const std::vector<ml::train::TensorDim> output dimensions
+   */
+  const std::vector<ml::train::TensorDim> getOutputDimension() {
+    return output_dims;
+  }
+
+  /**
+   * @brief Get the counters of the scheduler
+   *
+   * @return Statistics counters so far
+   */
+  Statistics getStatistics();
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  /**
+   * @brief A request waiting in the queue
+   */
+  struct Request {
+    unsigned int batch;
+    const std::vector<float *> &inputs;
+    const std::vector<float *> &outputs;
+    Clock::time_point enqueued;
+    std::promise<void> done;
+  };
+
+  /**
+   * @brief loop of the worker thread
+   */
+  void loop();
+
+  /**
+   * @brief run one batched inference of @a requests and scatter the outputs
+   *
+   * @param requests requests of the batch
+   * @param samples number of samples in @a requests
+   */
+  void forward(std::vector<Request *> &requests, unsigned int samples);
+
+  std::string model_config;
+  unsigned int max_batch;
+  std::chrono::microseconds max_delay;
+
+  std::unique_ptr<ml::train::Model> model; /**< used by the worker only */
+  std::vector<ml::train::TensorDim> input_dims;
+  std::vector<ml::train::TensorDim> output_dims;
+  std::vector<std::vector<float>> staging; /**< gathered inputs */
+
+  std::mutex mutex;           /**< guards the members below */
+  std::condition_variable cv; /**< notified on enqueue and stop */
+  std::deque<Request *> queue;
+  unsigned int queued_samples;
+  bool stop;
+  Statistics stats;
+  Clock::time_point started;
+
+  std::thread worker;
+};
+
 /**
  * @brief NNTrainerInference wrapper for nnstreamer filter subplugin
  *
@@ -45,8 +189,13 @@ public:
    * @brief Construct a new NNTrainerInference object
    *
    * @param model_config_ config address
+   * @param max_batch if larger than 1, requests are batched with the other
+   * instances of the same model up to @a max_batch samples
+   * @param max_delay maximum time a request waits to be batched
    */
-  NNTrainerInference(const std::string &model_config);
+  NNTrainerInference(
+    const std::string &model_config, unsigned int max_batch = 0,
+    std::chrono::microseconds max_delay = std::chrono::microseconds(0));
 
   /**
    * @brief Destroy the NNTrainerInference object
@@ -74,7 +223,8 @@ public:
    * @return const std::vector<nntrainer::TensorDim> input dimensions
    */
   const std::vector<ml::train::TensorDim> getInputDimension() {
-    return model->getInputDimension();
+    return scheduler ? scheduler->getInputDimension()
+                     : model->getInputDimension();
   }
 
   /**
@@ -83,9 +233,17 @@ public:
    * @return const std::vector<nntrainer::TensorDim> output dimensions
    */
   const std::vector<ml::train::TensorDim> getOutputDimension() {
-    return model->getOutputDimension();
+    return scheduler ? scheduler->getOutputDimension()
+                     : model->getOutputDimension();
   }
 
+  /**
+   * @brief Get the batching scheduler
+   *
+   * @return NNTrainerBatchScheduler* scheduler, nullptr if not batching
+   */
+  NNTrainerBatchScheduler *getScheduler() { return scheduler.get(); }
+
   /**
    * @brief run inference, output
    *
@@ -98,8 +256,21 @@ public:
 private:
   void loadModel();
 
+  /**
+   * @brief run inference through the batching scheduler
+   *
+   * @param inputs input buffers
+   * @param output output tensor memory
+   * @return int 0 if success
+   */
+  int runBatched(const std::vector<float *> &inputs, GstTensorMemory *output);
+
   unsigned int batch_size;
 
   std::string model_config;
   std::unique_ptr<ml::train::Model> model;
+
+  std::shared_ptr<NNTrainerBatchScheduler> scheduler;
+  /** outputs of the last run when batching, valid until the next run */
+  std::vector<std::vector<float>> outputs;
 };
@@ -0,0 +1,131 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file   fusion_realizer.cpp
+ * @date   18 October 2026
+ * @brief  NNTrainer graph realizer which fuses batch normalization and
+ * activation layers into the preceding convolution or fully connected layer
+ * for inference
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @bug    No known bugs except for NYI items
+ */
+#include <fusion_realizer.h>
+#include <remap_realizer.h>
+
+#include <activation_layer.h>
+#include <bn_layer.h>
+#include <common_properties.h>
+#include <conv2d_layer.h>
+#include <fc_layer.h>
+#include <layer_node.h>
+#include <node_exporter.h>
+#include <unordered_map>
+
+namespace nntrainer {
+
+/**
+ * @brief check if the activation runs element by element, so that it can be
+ * applied in place on the output of the layer it is fused to
+ *
+ * @param act activation type
+ * @return true if the activation can be fused
+ */
+static bool isFusableActivation(ActivationType act) {
+  switch (act) {
+  case ActivationType::ACT_RELU:
+  case ActivationType::ACT_SIGMOID:
+  case ActivationType::ACT_SWISH:
+  case ActivationType::ACT_GELU:
+    return true;
+  default:
+    return false;
+  }
+}
+
+/**
+ * @brief get the epsilon of the batch normalization layer if it can be fused,
+ * a batch normalization with an explicit axis is not fused
+ *
+ * @param node batch normalization layer node
+ * @return std::string epsilon, empty if it can not be fused
+ */
+static std::string getFusableEpsilon(const LayerNode &node) {
+  Exporter e;
+  node.exportTo(e, ml::train::ExportMethods::METHOD_STRINGVECTOR);
+  auto props = e.getResult<ml::train::ExportMethods::METHOD_STRINGVECTOR>();
+
+  std::string epsilon;
+  for (auto &[key, value] : *props) {
+    if (key == props::Axis::key)
+      return std::string();
+    if (key == props::Epsilon::key)
+      epsilon = value;
+  }
+  return epsilon;
+}
+
+GraphRepresentation
+FusionRealizer::realize(const GraphRepresentation &reference) {
+  std::unordered_map<std::string /**< layer_name */,
+                     std::vector<LayerNode *> /**< consumers */>
+    consumers;
+  for (auto &node : reference) {
+    for (unsigned int i = 0; i < node->getNumInputConnections(); ++i) {
+      consumers[node->getInputConnectionName(i)].push_back(node.get());
+    }
+  }
+
+  auto single_consumer = [&consumers](const LayerNode *node) -> LayerNode * {
+    auto iter = consumers.find(node->getName());
+    if (iter == consumers.end() || iter->second.size() != 1)
+      return nullptr;
+    return iter->second.front();
+  };
+
+  std::unordered_map<std::string /**< fused_layer_name */,
+                     std::string /**< layer_name */>
+    remap_table;
+
+  for (auto &node : reference) {
+    if (node->getType() != Conv2DLayer::type &&
+        node->getType() != FullyConnectedLayer::type)
+      continue;
+
+    LayerNode *next = single_consumer(node.get());
+    if (next && next->getType() == BatchNormalizationLayer::type &&
+        next->getNumInputConnections() == 1) {
+      if (auto epsilon = getFusableEpsilon(*next); !epsilon.empty()) {
+        const auto &bn_scope = next->getSharedFrom().empty()
+                                 ? next->getName()
+                                 : next->getSharedFrom();
+        node->setProperty(
+          {"fused_bn_epsilon=" + epsilon, "fused_bn_name=" + bn_scope});
+        remap_table.insert({next->getName(), node->getName()});
+        next = single_consumer(next);
+      }
+    }
+
+    if (next && next->getType() == ActivationLayer::type &&
+        isFusableActivation(next->getActivationType())) {
+      props::FusedActivation act_prop;
+      act_prop.set(next->getActivationType());
+      node->setProperty({"fused_activation=" + to_string(act_prop)});
+      remap_table.insert({next->getName(), node->getName()});
+    }
+  }
+
+  GraphRepresentation processed;
+  processed.reserve(reference.size() - remap_table.size());
+  for (auto &node : reference) {
+    if (remap_table.find(node->getName()) == remap_table.end())
+      processed.push_back(node);
+  }
+
+  return RemapRealizer([&remap_table](std::string &name, unsigned &idx) {
+           if (auto iter = remap_table.find(name); iter != remap_table.end()) {
+             name = iter->second;
+           }
+         })
+    .realize(processed);
+}
+
+} // namespace nntrainer
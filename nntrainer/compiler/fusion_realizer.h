@@ -0,0 +1,55 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file   fusion_realizer.h
+ * @date   18 October 2026
+ * @brief  NNTrainer graph realizer which fuses batch normalization and
+ * activation layers into the preceding convolution or fully connected layer
+ * for inference
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @bug    No known bugs except for NYI items
+ */
+#ifndef __FUSION_REALIZER_H__
+#define __FUSION_REALIZER_H__
+
+#include <realizer.h>
+
+namespace nntrainer {
+
+/**
+ * @brief Graph realizer class which fuses batch normalization and activation
+ * layers into the conv2d or fully connected layer feeding them
+ * @note A layer is fused only if it is the only consumer of the layer before.
+ * The fused batch normalization keeps its statistics as the weights of the
+ * layer it is fused to, in the same order and under the same names, so the
+ * weight file of the model without fusion is read as is.
+ *
+ */
+class FusionRealizer final : public GraphRealizer {
+public:
+  /**
+   * @brief Construct a new Fusion Realizer object
+   *
+   */
+  FusionRealizer() = default;
+
+  /**
+   * @brief Destroy the Fusion Realizer object
+   *
+   */
+  ~FusionRealizer() = default;
+
+  /**
+   * @brief graph realizer creates a shallow copied graph based on the reference
+   * @note fusion realizer removes the fused layers from GraphRepresentation
+   * and sets fused_bn_epsilon, fused_bn_name and fused_activation on the
+   * layers they are fused to
+   * @param reference GraphRepresentation to be realized
+   * @throw std::invalid_argument if graph is ill formed
+   *
+   */
+  GraphRepresentation realize(const GraphRepresentation &reference) override;
+};
+
+} // namespace nntrainer
+
+#endif // __FUSION_REALIZER_H__
@@ -125,6 +125,16 @@ public:
    * @return bool true if thread safe.
    */
   virtual bool isMultiThreadSafe() const { return false; }
+
+  /**
+   * @brief hint that the sample of @a idx is going to be generated soon, so
+   * that the producer can start loading it in the background
+   * @note called from the fetch workers running the generator of the last
+   * finalize(), concurrently if isMultiThreadSafe() is true
+   *
+   * @param idx index of the sample
+   */
+  virtual void prefetch(unsigned int idx) const {}
 };
 } // namespace nntrainer
 #endif // __DATA_PRODUCER_H__
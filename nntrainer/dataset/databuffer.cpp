@@ -21,6 +21,7 @@
  *
  */
 
+#include <algorithm>
 #include <base_properties.h>
 #include <cassert>
 #include <climits>
@@ -30,6 +31,7 @@
 #include <functional>
 #include <iomanip>
 #include <iostream>
+#include <mutex>
 #include <nntrainer_error.h>
 #include <nntrainer_log.h>
 #include <node_exporter.h>
@@ -50,14 +52,34 @@ class PropsBufferSize : public nntrainer::PositiveIntegerProperty {
 public:
   /**
    * @brief Construct a new props min object with a default value
+   * @note the default value is 2, so that the next batch is staged by the
+   * fetch worker while the current batch is being used
    *
    * @param value default value
    */
-  PropsBufferSize(unsigned int value = 1) { set(value); }
+  PropsBufferSize(unsigned int value = 2) { set(value); }
   static constexpr const char *key = "buffer_size"; /**< unique key to access */
   using prop_tag = uint_prop_tag;                   /**< property type */
 };
 
+/**
+ * @brief Props containing number of fetch workers
+ *
+ */
+class PropsNumWorkers : public nntrainer::PositiveIntegerProperty {
+public:
+  /**
+   * @brief Construct a new props num workers object with a default value
+   * @note more than one worker is used only when the producer is multi thread
+   * safe and the size of the producer is defined
+   *
+   * @param value default value
+   */
+  PropsNumWorkers(unsigned int value = 1) { set(value); }
+  static constexpr const char *key = "num_workers"; /**< unique key to access */
+  using prop_tag = uint_prop_tag;                   /**< property type */
+};
+
 constexpr char USER_DATA[] = "user_data";
 
 DataBuffer::DataBuffer(std::unique_ptr<DataProducer> &&producer_) :
@@ -78,6 +100,7 @@ DataBuffer::startFetchWorker(const std::vector<TensorDim> &input_dims,
     << "There must be at least one input";
 
   auto q_size = std::get<PropsBufferSize>(*db_props);
+  unsigned int num_workers = std::get<PropsNumWorkers>(*db_props);
   auto iq = std::make_shared<IterationQueue>(q_size, input_dims, label_dims);
   auto generator = producer->finalize(input_dims, label_dims);
   auto size = producer->size(input_dims, label_dims);
@@ -98,6 +121,14 @@ DataBuffer::startFetchWorker(const std::vector<TensorDim> &input_dims,
     IterationQueue *iq = iq;
   };
 
+  if (num_workers > 1 && (size == DataProducer::SIZE_UNDEFINED ||
+                          !producer->isMultiThreadSafe())) {
+    ml_logw("[DataBuffer] %s producer is not multi thread safe or its size is "
+            "undefined, using a single fetch worker",
+            producer->getType().c_str());
+    num_workers = 1;
+  }
+
   /// case of generator
   if (size == DataProducer::SIZE_UNDEFINED) {
     return std::async(std::launch::async, [iq, generator] {
@@ -131,22 +162,72 @@ DataBuffer::startFetchWorker(const std::vector<TensorDim> &input_dims,
     std::shuffle(idxes_.begin(), idxes_.end(), rng);
   }
 
+  /// samples which fit in the queue are hinted to the producer ahead
+  const unsigned int window = q_size.get() * input_dims[0].batch();
+
   return std::async(std::launch::async, [iq, generator, size,
-                                         idxes = std::move(idxes_), shuffle] {
+                                         idxes = std::move(idxes_), shuffle,
+                                         num_workers, producer = producer,
+                                         window] {
     auto notifier = NotifyOnDestruct(iq.get());
-    for (unsigned int i = 0; i < size; ++i) {
-      /// below loop can be parallelized
-      auto sample_view = iq->requestEmptySlot();
-      NNTR_THROW_IF(sample_view.isEmpty(), std::runtime_error)
-        << "[Databuffer] Cannot fill empty buffer";
-      auto &sample = sample_view.get();
+    std::mutex slot_mutex;
+    unsigned int next = 0;
+    std::exception_ptr error;
+
+    for (unsigned int i = 0; i < std::min(window, size); ++i) {
+      producer->prefetch(shuffle ? idxes[i] : i);
+    }
+
+    /// the index and the slot are taken together, so the i-th sample is always
+    /// placed at the i-th slot no matter which worker fills it
+    auto fill = [&] {
       try {
-        generator(shuffle ? idxes[i] : i, sample.getInputsRef(),
-                  sample.getLabelsRef());
-      } catch (std::exception &e) {
-        ml_loge("Fetching sample failed, Error: %s", e.what());
-        throw;
+        while (true) {
+          std::unique_lock lg(slot_mutex);
+          if (next >= size) {
+            break;
+          }
+          unsigned int i = next++;
+          auto sample_view = iq->requestEmptySlot();
+          lg.unlock();
+
+          if (i + window < size) {
+            producer->prefetch(shuffle ? idxes[i + window] : i + window);
+          }
+
+          NNTR_THROW_IF(sample_view.isEmpty(), std::runtime_error)
+            << "[Databuffer] Cannot fill empty buffer";
+          auto &sample = sample_view.get();
+          try {
+            generator(shuffle ? idxes[i] : i, sample.getInputsRef(),
+                      sample.getLabelsRef());
+          } catch (std::exception &e) {
+            ml_loge("Fetching sample failed, Error: %s", e.what());
+            throw;
+          }
+        }
+      } catch (...) {
+        /// stop the other workers from taking a new slot
+        std::scoped_lock lg(slot_mutex);
+        next = size;
+        if (!error) {
+          error = std::current_exception();
+        }
       }
+    };
+
+    std::vector<std::future<void>> workers;
+    workers.reserve(num_workers - 1);
+    for (unsigned int w = 1; w < num_workers; ++w) {
+      workers.push_back(std::async(std::launch::async, fill));
+    }
+    fill();
+    for (auto &worker : workers) {
+      worker.get();
+    }
+
+    if (error) {
+      std::rethrow_exception(error);
     }
 
     return iq;
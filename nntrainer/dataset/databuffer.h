@@ -50,6 +50,7 @@ using datagen_cb = ml::train::datagen_cb;
 using TensorDim = ml::train::TensorDim;
 
 class PropsBufferSize;
+class PropsNumWorkers;
 
 /**
  * @class   DataBuffer Data Buffers
@@ -157,7 +158,7 @@ public:
 protected:
   std::shared_ptr<DataProducer> producer;
   std::weak_ptr<IterationQueue> iq_view;
-  using Props = std::tuple<PropsBufferSize>;
+  using Props = std::tuple<PropsBufferSize, PropsNumWorkers>;
   std::unique_ptr<Props> db_props;
   std::mt19937 rng;
 
@@ -86,8 +86,8 @@ const std::string DirDataProducer::getType() const {
 }
 
 bool DirDataProducer::isMultiThreadSafe() const {
-  /// @todo make this true, it is needed to test multiple worker scenario
-  return false;
+  /// the generator only reads data_list and opens a file for each sample
+  return true;
 }
 
 void DirDataProducer::setProperty(const std::vector<std::string> &properties) {
@@ -10,6 +10,7 @@
  * @bug    No known bugs except for NYI items
  *
  */
+#include <algorithm>
 #include <chrono>
 #include <iteration_queue.h>
 
@@ -52,7 +53,8 @@ IterationQueue::~IterationQueue() {
 }
 
 ScopedView<Sample> IterationQueue::requestEmptySlot() {
-  std::scoped_lock lg(empty_mutex);
+  std::scoped_lock request_lock(request_mutex);
+  std::unique_lock lg(empty_mutex);
   auto current_flow_state = flow_state.load();
   NNTR_THROW_IF(current_flow_state != FlowState::FLOW_STATE_OPEN,
                 std::invalid_argument)
@@ -68,9 +70,15 @@ ScopedView<Sample> IterationQueue::requestEmptySlot() {
 
   if (being_filled == nullptr ||
       current_iterator + 1 == being_filled->get().end()) {
-    being_filled = empty_q.waitAndPop();
+    /// empty_mutex is released while waiting, so that the samples being
+    /// filled by the other workers can be marked filled
+    lg.unlock();
+    auto iteration = empty_q.waitAndPop();
+    lg.lock();
+    being_filled = iteration;
     being_filled->reset();
     num_being_filled++;
+    filling.emplace_back(being_filled, false);
     current_iterator = being_filled->get().begin();
   } else {
     current_iterator++;
@@ -83,8 +91,16 @@ ScopedView<Sample> IterationQueue::requestEmptySlot() {
     },
     [this, current_being_filled = this->being_filled] {
       std::unique_lock lg(empty_mutex);
-      this->markEmpty(current_being_filled);
-      num_being_filled--;
+      auto iter = std::find_if(filling.begin(), filling.end(),
+                               [current_being_filled](auto &f) {
+                                 return f.first == current_being_filled;
+                               });
+      if (iter != filling.end()) {
+        filling.erase(iter);
+        this->markEmpty(current_being_filled);
+        num_being_filled--;
+      }
+      pushFilled(nullptr);
       notify_emptied_cv.notify_all();
     });
   return view;
@@ -126,6 +142,7 @@ ScopedView<Iteration> IterationQueue::requestFilledSlot() {
 }
 
 void IterationQueue::notifyEndOfRequestEmpty() {
+  std::scoped_lock request_lock(request_mutex);
   std::unique_lock lg(empty_mutex);
   auto open_state = FlowState::FLOW_STATE_OPEN;
 
@@ -154,12 +171,25 @@ void IterationQueue::notifyEndOfRequestEmpty() {
 
 void IterationQueue::markFilled(MarkableIteration *iteration) {
   std::unique_lock lg(empty_mutex);
-  num_being_filled--;
-  filled_q.push(iteration);
+  pushFilled(iteration);
   lg.unlock();
   notify_emptied_cv.notify_all();
 }
 
+void IterationQueue::pushFilled(MarkableIteration *iteration) {
+  for (auto &[it, filled] : filling) {
+    if (it == iteration) {
+      filled = true;
+    }
+  }
+
+  while (!filling.empty() && filling.front().second) {
+    num_being_filled--;
+    filled_q.push(filling.front().first);
+    filling.pop_front();
+  }
+}
+
 void IterationQueue::markEmpty(MarkableIteration *iteration) {
   empty_q.push(iteration);
 }
@@ -222,8 +252,7 @@ void IterationQueue::MarkableIteration::setEndSample(
          "locked.";
 #endif
     /// warning: iq has to be locked with iq->empty_mutex
-    iq->num_being_filled--;
-    iq->filled_q.push(this);
+    iq->pushFilled(this);
     iq->notify_emptied_cv.notify_all();
     num_observed = 0;
   }
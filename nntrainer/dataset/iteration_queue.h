@@ -15,6 +15,7 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <queue>
@@ -354,6 +355,16 @@ private:
    */
   void markFilled(MarkableIteration *iteration) /** noexcept */;
 
+  /**
+   * @brief mark the given iteration filled and move the filled iterations to
+   * filled_q in the order they were started to be filled, so that multiple
+   * workers serve the iterations in order
+   * @note empty_mutex must be locked
+   *
+   * @param iteration iteration to mark it as filled, nullptr to move only
+   */
+  void pushFilled(MarkableIteration *iteration);
+
   /**
    * @brief mark the given iteration empty
    * @todo make this noexcept with the thread safe queue
@@ -366,10 +377,15 @@ private:
   std::vector<Sample>::iterator
     current_iterator; /**< current sample iteration of being_filled */
 
+  mutable std::mutex request_mutex; /**< mutex to serialize the requests of
+                                       empty slots */
   mutable std::mutex empty_mutex; /**< mutex to be used when it is mutually
                                      exclusive to the requesting empty slots */
   unsigned int
     num_being_filled; /**< number of iteration that is in being_filled state */
+  std::deque<std::pair<MarkableIteration *, bool>>
+    filling; /**< iterations in being_filled state in the requested order, and
+                whether each is filled */
   mutable std::mutex
     filled_mutex; /**< mutex to be used when it is mutually exclusive to the
                      requesting filled slots */
@@ -14,28 +14,116 @@
 
 #include <raw_file_data_producer.h>
 
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
 #include <memory>
 #include <numeric>
 #include <random>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include <vector>
 
 #include <common_properties.h>
 #include <nntrainer_error.h>
+#include <nntrainer_log.h>
 #include <node_exporter.h>
 #include <util_func.h>
 
 namespace nntrainer {
 
-RawFileDataProducer::RawFileDataProducer() : raw_file_props(new PropTypes()) {}
+/**
+ * @brief read only mapping of a file, which is unmapped on destruction
+ */
+class RawFileDataProducer::FileMapping {
+public:
+  /**
+   * @brief Map the whole file
+   *
+   * @param path path of the file
+   */
+  FileMapping(const std::string &path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    NNTR_THROW_IF(fd < 0, std::invalid_argument)
+      << "[RawFileDataProducer] Cannot open file: " << path;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+      close(fd);
+      throw std::invalid_argument("[RawFileDataProducer] Cannot stat file: " +
+                                  path);
+    }
+
+    length = static_cast<size_t>(st.st_size);
+    if (length == 0) {
+      close(fd);
+      return;
+    }
+
+    void *ptr = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    /// the mapping holds the file, so the descriptor is not needed anymore
+    close(fd);
+    NNTR_THROW_IF(ptr == MAP_FAILED, std::runtime_error)
+      << "[RawFileDataProducer] Cannot map file: " << path;
+    data = static_cast<const char *>(ptr);
+
+    /// the samples may be accessed in the shuffled order, so the read-ahead
+    /// on fault would only read the pages of the neighbouring samples. The
+    /// upcoming samples are requested by willNeed() instead
+    if (madvise(ptr, length, MADV_RANDOM) != 0)
+      ml_logd("[RawFileDataProducer] madvise(MADV_RANDOM) failed");
+  }
+
+  FileMapping(const FileMapping &) = delete;
+  FileMapping &operator=(const FileMapping &) = delete;
+
+  /**
+   * @brief Unmap the file
+   */
+  ~FileMapping() {
+    if (data != nullptr)
+      munmap(const_cast<char *>(data), length);
+  }
+
+  /**
+   * @brief Start reading the pages of [offset, offset + len) into the page
+   * cache in the background
+   */
+  void willNeed(size_t offset, size_t len) const {
+    if (data == nullptr || offset >= length)
+      return;
+
+    static const size_t page_size = sysconf(_SC_PAGE_SIZE);
+    size_t start = offset / page_size * page_size;
+    size_t end = std::min(offset + len, length);
+    if (madvise(const_cast<char *>(data) + start, end - start,
+                MADV_WILLNEED) != 0)
+      ml_logd("[RawFileDataProducer] madvise(MADV_WILLNEED) failed");
+  }
+
+  const char *data = nullptr; /**< start of the mapping */
+  size_t length = 0;          /**< length of the mapping */
+};
+
+RawFileDataProducer::RawFileDataProducer() :
+  sample_bytes(0), raw_file_props(new PropTypes()) {}
 
 RawFileDataProducer::RawFileDataProducer(const std::string &path) :
-  raw_file_props(new PropTypes(props::FilePath(path))) {}
+  sample_bytes(0), raw_file_props(new PropTypes(props::FilePath(path))) {}
 RawFileDataProducer::~RawFileDataProducer() {}
 
 const std::string RawFileDataProducer::getType() const {
   return RawFileDataProducer::type;
 }
 
+bool RawFileDataProducer::isMultiThreadSafe() const { return true; }
+
+void RawFileDataProducer::prefetch(unsigned int idx) const {
+  if (mapping)
+    mapping->willNeed(static_cast<size_t>(idx) * sample_bytes, sample_bytes);
+}
+
 void RawFileDataProducer::setProperty(
   const std::vector<std::string> &properties) {
   auto left = loadProperties(properties, *raw_file_props);
@@ -59,23 +147,35 @@ RawFileDataProducer::finalize(const std::vector<TensorDim> &input_dims,
   sample_size = std::accumulate(label_dims.begin(), label_dims.end(),
                                 sample_size, size_accumulator);
 
-  /// as we are passing the reference of file, this means created lamabda is
-  /// tightly couple with the file, this is not desirable but working fine for
-  /// now...
-  file = std::ifstream(path_prop.get(), std::ios::binary);
-  return [sample_size, sz, this](unsigned int idx, std::vector<Tensor> &inputs,
-                                 std::vector<Tensor> &labels) {
+  /// the generator owns the mapping and copies the samples straight from it,
+  /// so it can be called from multiple threads at once
+  mapping = std::make_shared<FileMapping>(path_prop.get());
+  sample_bytes =
+    static_cast<size_t>(sample_size) * RawFileDataProducer::pixel_size;
+  return [sample_size, sz, mapping = mapping](unsigned int idx,
+                                    std::vector<Tensor> &inputs,
+                                    std::vector<Tensor> &labels) {
     NNTR_THROW_IF(idx >= sz, std::range_error)
       << "given index is out of bound, index: " << idx << " size: " << sz;
-    std::streamoff offset = static_cast<std::streamoff>(idx) *
-                            static_cast<std::streamoff>(sample_size) *
-                            RawFileDataProducer::pixel_size;
-    file.seekg(offset, std::ios_base::beg);
+    size_t offset = static_cast<size_t>(idx) * sample_size *
+                    RawFileDataProducer::pixel_size;
+
+    auto copy = [&mapping, &offset](Tensor &t) {
+      NNTR_THROW_IF(!t.getContiguous(), std::invalid_argument)
+        << t.getName() << " is not contiguous, cannot read.";
+      size_t len = t.bytes();
+      NNTR_THROW_IF(offset + len > mapping->length, std::runtime_error)
+        << "[RawFileDataProducer] reading out of the file, offset: " << offset
+        << " size: " << len << " file size: " << mapping->length;
+      std::memcpy(t.getData<char>(), mapping->data + offset, len);
+      offset += len;
+    };
+
     for (auto &input : inputs) {
-      input.read(file);
+      copy(input);
     }
     for (auto &label : labels) {
-      label.read(file);
+      copy(label);
     }
 
     return idx == sz - 1;
@@ -17,7 +17,6 @@
 
 #include <dataset.h>
 
-#include <fstream>
 #include <memory>
 #include <string>
 #include <vector>
@@ -64,6 +63,16 @@ public:
    */
   const std::string getType() const override;
 
+  /**
+   * @copydoc DataProducer::isMultiThreadSafe()
+   */
+  bool isMultiThreadSafe() const override;
+
+  /**
+   * @copydoc DataProducer::prefetch(unsigned int idx)
+   */
+  void prefetch(unsigned int idx) const override;
+
   /**
    * @copydoc DataProducer::setProeprty(const std::vector<std::string>
    * &properties)
@@ -93,7 +102,11 @@ public:
                 const ml::train::ExportMethods &method) const override;
 
 private:
-  std::ifstream file;
+  class FileMapping;
+
+  std::shared_ptr<FileMapping> mapping; /**< mapping of the last finalize() */
+  size_t sample_bytes;                  /**< size of a sample in the file */
+
   using PropTypes = std::tuple<props::FilePath>;
   std::unique_ptr<PropTypes> raw_file_props;
 };
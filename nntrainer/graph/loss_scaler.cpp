@@ -0,0 +1,52 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file   loss_scaler.cpp
+ * @date   18 October 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @bug    No known bugs except for NYI items
+ * @brief  Dynamic loss scaler for the mixed precision training
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include <loss_scaler.h>
+#include <nntrainer_log.h>
+
+namespace nntrainer {
+
+DynamicLossScaler::DynamicLossScaler(float scale, unsigned int growth_interval,
+                                     float growth_factor, float backoff_factor,
+                                     bool skip_on_overflow) :
+  scale(scale),
+  growth_interval(growth_interval),
+  growth_factor(growth_factor),
+  backoff_factor(backoff_factor),
+  skip_on_overflow(skip_on_overflow),
+  good_steps(0),
+  num_overflows(0) {}
+
+bool DynamicLossScaler::update(bool overflow) {
+  float prev = scale;
+
+  if (overflow) {
+    num_overflows++;
+    good_steps = 0;
+    scale = std::max(scale * backoff_factor, 1.0f);
+    ml_logd("loss scale is reduced to %f", scale);
+    return scale != prev;
+  }
+
+  if (++good_steps < growth_interval)
+    return false;
+
+  good_steps = 0;
+  float grown = scale * growth_factor;
+  /** keep the scale if it does not fit in float anymore */
+  if (std::isfinite(grown))
+    scale = grown;
+
+  return scale != prev;
+}
+
+} // namespace nntrainer
@@ -0,0 +1,78 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file   loss_scaler.h
+ * @date   18 October 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @bug    No known bugs except for NYI items
+ * @brief  Dynamic loss scaler for the mixed precision training
+ */
+
+#ifndef __LOSS_SCALER_H__
+#define __LOSS_SCALER_H__
+#ifdef __cplusplus
+
+namespace nntrainer {
+
+/**
+ * @class   DynamicLossScaler
+ * @brief   Keeps the loss scale as large as possible without overflowing the
+ * gradients
+ *
+ * @details The scale is multiplied by the backoff factor whenever a step
+ * overflows, and multiplied by the growth factor after growth_interval
+ * consecutive steps without overflow. The scale does not go below 1.
+ */
+class DynamicLossScaler {
+public:
+  /**
+   * @brief Construct a new Dynamic Loss Scaler object
+   *
+   * @param scale initial loss scale
+   * @param growth_interval number of consecutive finite steps to grow the
+   * scale
+   * @param growth_factor factor to grow the scale with
+   * @param backoff_factor factor to shrink the scale with on overflow
+   * @param skip_on_overflow skip the step on overflow instead of recomputing
+   * the step with the shrunk scale
+   */
+  DynamicLossScaler(float scale = 1.0f, unsigned int growth_interval = 2000,
+                    float growth_factor = 2.0f, float backoff_factor = 0.5f,
+                    bool skip_on_overflow = false);
+
+  /**
+   * @brief Update the scale with the result of a step
+   *
+   * @param overflow true if the gradients of the step are not finite
+   * @return bool true if the scale has changed
+   */
+  bool update(bool overflow);
+
+  /**
+   * @brief Get the current loss scale
+   */
+  float getScale() const { return scale; }
+
+  /**
+   * @brief Check if the step is skipped on overflow
+   */
+  bool isSkipOnOverflow() const { return skip_on_overflow; }
+
+  /**
+   * @brief Get the number of overflowed steps so far
+   */
+  unsigned int getNumOverflows() const { return num_overflows; }
+
+private:
+  float scale;                  /**< current loss scale */
+  unsigned int growth_interval; /**< steps without overflow to grow */
+  float growth_factor;          /**< growth factor of the scale */
+  float backoff_factor;         /**< backoff factor of the scale */
+  bool skip_on_overflow;        /**< skip the step on overflow */
+  unsigned int good_steps;      /**< consecutive steps without overflow */
+  unsigned int num_overflows;   /**< number of overflowed steps */
+};
+
+} // namespace nntrainer
+
+#endif /* __cplusplus */
+#endif /* __LOSS_SCALER_H__ */
@@ -277,8 +277,9 @@ void NetworkGraph::setBatchSize(unsigned int batch_size) {
 
   auto allocated = tensor_manager->isAllocated();
 
+  /** the memory is reused if the layout for the new batch fits in it */
   if (allocated)
-    deallocateTensors();
+    deallocateTensors(false, true);
 
   for (auto iter = cbegin(); iter != cend(); iter++) {
     if ((*iter)->isFinalized()) {
@@ -435,18 +436,26 @@ bool NetworkGraph::backwarding(
 
   if (!is_valid) {
     /** if has NaN
-     * 1. reset the loss scale. : @todo Backoff_factor : default --> 0.5
-     * 2. run forwarding from cur_iter to cend() && !stop_cb(userdata);
-     * 3. return false --> run backwarding again;
+     * 1. back off the loss scale.
+     * 2. skip the step, or run forwarding from cur_iter to cend() and return
+     * false to run backwarding again.
      */
-    float scale = (*iter_)->getRunContext().getLossScale();
+    float scale = loss_scaler.getScale();
+    bool skip = loss_scaler.isSkipOnOverflow();
 
-    NNTR_THROW_IF(scale - 1.0f < 10e-6, std::invalid_argument)
+    NNTR_THROW_IF(!skip && scale - 1.0f < 10e-6, std::invalid_argument)
       << "Loss Scale Factor is 1.0f";
 
-    float s = scale > 1.5f ? scale * 0.5f : 1.0f;
+    if (loss_scaler.update(true))
+      resetLossScale(loss_scaler.getScale());
 
-    resetLossScale(s);
+    if (skip) {
+      /// the weights are not updated, so the gradients of this step are
+      /// simply dropped and nothing needs to be recomputed
+      ml_logd("skipping the step of iteration %d on gradient overflow",
+              iteration);
+      return true;
+    }
 
     auto f_iter = cbegin() + graph.getSortedNodeIdx((*iter_)->getName());
 
@@ -466,10 +475,7 @@ bool NetworkGraph::backwarding(
   }
 
   /** perform clipping of the gradients by global norm if any */
-  if (lazy_weights.empty())
-    return true;
-
-  if (is_clip_grad) {
+  if (is_clip_grad && !lazy_weights.empty()) {
     /** calculate the global norm */
     Tensor global_norm_t(
       TensorDim({1u, 1u, 1u, (unsigned int)lazy_weights.size()}));
@@ -479,9 +485,10 @@ bool NetworkGraph::backwarding(
       auto const &w = lazy_weights[idx];
 
       if (isMixedPrecision()) {
+        w->densifyGradient();
         Tensor scaled_grad =
           w->getGradientRef().clone(TensorDim::DataType::FP32);
-        scaled_grad.divide_i(loss_scale);
+        scaled_grad.divide_i(loss_scaler.getScale());
         global_norm_data[idx] = scaled_grad.l2norm();
       } else {
         global_norm_data[idx] = w->getGradientNorm();
@@ -497,16 +504,10 @@ bool NetworkGraph::backwarding(
   for (auto w : lazy_weights) {
     lazy_apply_grad_op(*w, iteration);
   }
-  nan_count++;
-
-  /** @todo : handle as property : growth_interval : default --> 2000 */
-  if (nan_count > 2000) {
-    float scale = (*iter_)->getRunContext().getLossScale();
-    /** @todo growth_factor : default --> 2.0 */
-    float s = scale * 2.0f;
-    resetLossScale(s);
-    nan_count = 0;
-  }
+
+  /** the scale can grow only after the gradients are unscaled and applied */
+  if (isMixedPrecision() && loss_scaler.update(false))
+    resetLossScale(loss_scaler.getScale());
 
   return true;
 }
@@ -657,7 +658,10 @@ NetworkGraph::canExecuteInPlace(const std::shared_ptr<LayerNode> &lnode) {
     return InPlaceType::NONE;
   }
 
-  if (lnode->getType() == MultiOutLayer::type) {
+  /** the outputs of these layers may be a part of the input */
+  if (lnode->getType() == MultiOutLayer::type ||
+      lnode->getType() == ConcatLayer::type ||
+      lnode->getType() == SplitLayer::type) {
     return InPlaceType::RESTRICTING;
   }
 
@@ -721,6 +725,32 @@ setInplaceSharedMemoryConfigByLayer(const std::shared_ptr<LayerNode> &lnode,
    */
 }
 
+/**
+ * @brief Place the inputs or the outputs of a layer inside one another as
+ * requested by the layer, so that the layer does not have to copy them
+ *
+ * @param manager tensor manager
+ * @param context init context of the layer
+ * @param inputs inputs of the layer
+ * @param outputs outputs of the layer
+ */
+static void placeTensors(Manager &manager, const InitLayerContext &context,
+                         const std::vector<Var_Grad *> &inputs,
+                         const std::vector<Var_Grad *> &outputs) {
+  auto place = [&manager](Var_Grad *dest, Var_Grad *host,
+                          unsigned int offset) {
+    manager.placeTensor(dest->getName(), host->getName(), offset);
+    if (dest->hasGradient() && host->hasGradient())
+      manager.placeTensor(dest->getGradientName(), host->getGradientName(),
+                          offset);
+  };
+
+  for (auto const &[idx, offset] : context.getInputPlacements())
+    place(inputs[idx], outputs[0], offset);
+  for (auto const &[idx, offset] : context.getOutputPlacements())
+    place(outputs[idx], inputs[0], offset);
+}
+
 std::vector<Var_Grad *>
 NetworkGraph::finalizeContext(const std::shared_ptr<LayerNode> &lnode,
                               const std::vector<Var_Grad *> &prev_inputs) {
@@ -732,7 +762,8 @@ NetworkGraph::finalizeContext(const std::shared_ptr<LayerNode> &lnode,
                  [](const Var_Grad *vg) { return vg->getDim(); });
 
   /** finalize the layer and get the final context */
-  auto init_context = lnode->finalize(input_dims, getTensorType(), exec_mode);
+  auto init_context = lnode->finalize(input_dims, getTensorType(), exec_mode,
+                                     tensor_manager->getKVCacheManager());
 
   /**
    * Request manager for either a pre-allocated output as input or a newly
@@ -785,6 +816,18 @@ NetworkGraph::finalizeContext(const std::shared_ptr<LayerNode> &lnode,
         }
       }
     }
+
+    /**
+     * the first output of multiout shares the gradient of the input, so that
+     * calcDerivative only accumulates the others to it
+     */
+    if (lnode->getType() == MultiOutLayer::type && !out_specs.empty() &&
+        out_specs[0].gradient_spec && inputs[0]->hasGradient()) {
+      auto &grad_spec = *out_specs[0].gradient_spec;
+      grad_spec.request_type = TensorSpecV2::RequestType::READ_ONLY_VIEW;
+      grad_spec.reference_name = inputs[0]->getGradientName();
+      grad_spec.dim.setFormat(inputs[0]->getDim().getFormat());
+    }
   }
   if (lnode->requireLabel()) {
     NNTR_THROW_IF(out_specs.size() != 1, std::invalid_argument)
@@ -821,6 +864,9 @@ NetworkGraph::finalizeContext(const std::shared_ptr<LayerNode> &lnode,
     out_specs, Manager::TensorGroupType::OUTPUT, lnode->getExecutionOrder(),
     lnode->getName());
 
+  if (lnode->getInPlaceType() != InPlaceType::NONE)
+    placeTensors(*tensor_manager, init_context, inputs, outputs);
+
   /** create shared weight names if requested */
   std::vector<std::string> shared_weight_names;
   std::vector<std::string> shared_tensor_names;
@@ -875,7 +921,7 @@ NetworkGraph::finalizeContext(const std::shared_ptr<LayerNode> &lnode,
     inputs, outputs,
     tensor_manager->requestTensors(gnode, init_context.getTensorsSpec(),
                                    lnode->getTrainable(), shared_tensor_names),
-    init_context.getLossScale());
+    init_context.getLossScale(), tensor_manager->getKVCacheManager());
 
   return outputs;
 }
@@ -891,7 +937,8 @@ NetworkGraph::refinalizeContext(const std::shared_ptr<LayerNode> &lnode,
                  [](const Var_Grad *vg) { return vg->getDim(); });
 
   /** refinalize the layer and get the final context */
-  auto init_context = lnode->refinalize(input_dims);
+  auto init_context =
+    lnode->refinalize(input_dims, tensor_manager->getKVCacheManager());
 
   /**
    * Request manager for either a pre-allocated output as input or a newly
@@ -915,7 +962,7 @@ NetworkGraph::refinalizeContext(const std::shared_ptr<LayerNode> &lnode,
   auto out_specs = init_context.getOutSpecs();
   /// @note try move inplace control to finalize
   bool shared_var = false, shared_grad = false;
-  if (lnode->getInPlaceType() != InPlaceType::NONE) {
+  if (lnode->getInPlaceType() != InPlaceType::NONE && lnode->supportInPlace()) {
     setInplaceSharedMemoryConfigByLayer(lnode, shared_var, shared_grad);
     for (unsigned int i = 0; i < out_specs.size(); ++i) {
       auto &s = out_specs.at(i);
@@ -974,6 +1021,9 @@ NetworkGraph::refinalizeContext(const std::shared_ptr<LayerNode> &lnode,
     out_specs, Manager::TensorGroupType::OUTPUT, lnode->getExecutionOrder(),
     lnode->getName());
 
+  if (lnode->getInPlaceType() != InPlaceType::NONE)
+    placeTensors(*tensor_manager, init_context, inputs, outputs);
+
   /** create shared weight names if requested */
   std::vector<std::string> shared_weight_names;
   std::vector<std::string> shared_tensor_names;
@@ -1025,7 +1075,7 @@ NetworkGraph::refinalizeContext(const std::shared_ptr<LayerNode> &lnode,
     weights, inputs, outputs,
     tensor_manager->requestTensors(gnode, init_context.getTensorsSpec(),
                                    lnode->getTrainable(), shared_tensor_names),
-    init_context.getLossScale());
+    init_context.getLossScale(), tensor_manager->getKVCacheManager());
 
   return outputs;
 }
@@ -1568,7 +1618,6 @@ void NetworkGraph::requestOptimizerVariable(
 }
 
 void NetworkGraph::resetLossScale(float scale) {
-  loss_scale = scale;
   for (auto iter = cbegin(); iter != cend(); iter++) {
     auto &ln = *iter;
     ln->getRunContext().setLossScale(scale);
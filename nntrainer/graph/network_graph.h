@@ -23,6 +23,7 @@
 
 #include <graph_core.h>
 #include <layer_node.h>
+#include <loss_scaler.h>
 #include <manager.h>
 
 namespace nntrainer {
@@ -51,9 +52,7 @@ public:
     optimize_memory(true),
     exec_mode(ExecutionMode::TRAIN),
     tensor_format("NCHW"),
-    tensor_dtype(split("FP32-FP32", getRegex("\\-"))) {
-    nan_count = 0;
-  }
+    tensor_dtype(split("FP32-FP32", getRegex("\\-"))) {}
 
   /**
    * @brief     Constructor of NeuralNetwork Graph Class
@@ -80,9 +79,7 @@ public:
     optimize_memory(true),
     exec_mode(mode),
     tensor_format(tensor_format_),
-    tensor_dtype(split(tensor_dtype_, getRegex("\\-"))) {
-    nan_count = 0;
-  }
+    tensor_dtype(split(tensor_dtype_, getRegex("\\-"))) {}
 
   /**
    * @brief   Destructor of the NeuralNetwork Graph class
@@ -361,9 +358,24 @@ public:
 
   /**
    * @brief Deallocate memory for all the managed tensors
+   *
+   * @param dealloc_weights deallocate the weights as well
+   * @param keep_memory keep the memory of the tensors to be reused by the
+   * next allocation
+   */
+  void deallocateTensors(bool dealloc_weights = false,
+                         bool keep_memory = false) {
+    tensor_manager->deallocateTensors(dealloc_weights, keep_memory);
+  }
+
+  /**
+   * @brief Check if the tensors are allocated for the given execution mode
+   *
+   * @param mode execution mode
+   * @return true if allocated for @a mode, else false
    */
-  void deallocateTensors(bool dealloc_weights = false) {
-    tensor_manager->deallocateTensors(dealloc_weights);
+  bool isAllocated(ExecutionMode mode) const {
+    return exec_mode == mode && tensor_manager->isAllocated();
   }
 
   /**
@@ -379,6 +391,40 @@ public:
    */
   void deallocateWeights() { tensor_manager->deallocateWeights(); }
 
+  /**
+   * @brief Allocate the weights as a private mapping of the given file
+   *
+   * @param path file which holds the image of the weight pool
+   * @param offset offset of the image in the file
+   */
+  void mapWeights(const std::string &path, size_t offset) {
+    tensor_manager->mapWeights(
+      std::get<3>(backward_iter_end->getExecutionOrder()), path, offset);
+  }
+
+  /**
+   * @brief Allocate the weights in the memory of the weights of another graph
+   *
+   * @param from graph of the same configuration whose weights are shared
+   */
+  void shareWeights(NetworkGraph &from) {
+    tensor_manager->shareWeights(
+      std::get<3>(backward_iter_end->getExecutionOrder()),
+      *from.tensor_manager);
+  }
+
+  /**
+   * @brief Get the locations of the weights in the weight pool
+   */
+  std::vector<Manager::WeightLocation> getWeightLocations() {
+    return tensor_manager->getWeightLocations();
+  }
+
+  /**
+   * @brief Get the size of the weight pool in bytes
+   */
+  size_t getWeightPoolSize() { return tensor_manager->getWeightPoolSize(); }
+
   /**
    * @brief     Enable the memory optimizations for the network
    *
@@ -389,6 +435,34 @@ public:
     optimize_memory = val;
   }
 
+  /**
+   * @brief     Set the paged kv cache for the incremental inference
+   *
+   * @param page_size number of tokens in a page
+   * @param num_pages number of pages
+   */
+  void setKVCache(unsigned int page_size, unsigned int num_pages) {
+    tensor_manager->setKVCache(page_size, num_pages);
+  }
+
+  /**
+   * @brief     Get the paged kv cache
+   *
+   * @return KVCacheManager* kv cache, nullptr if it is not set
+   */
+  KVCacheManager *getKVCacheManager() {
+    return tensor_manager->getKVCacheManager();
+  }
+
+  /**
+   * @brief     Set the memory planner for the tensors of the network
+   *
+   * @param planner memory planner, nullptr to use the default planner
+   */
+  void setMemoryPlanner(std::shared_ptr<MemoryPlanner> planner) {
+    tensor_manager->setMemoryPlanner(planner);
+  }
+
   /**
    * @brief     Create optimizer variable for every weights
    *
@@ -459,11 +533,22 @@ public:
 #endif // ENABLE_TEST
 
   /**
-   * @brief     reset the loss scale
+   * @brief     reset the loss scale of the layers
    * @param[in] scale
    */
   void resetLossScale(float scale);
 
+  /**
+   * @brief     set the dynamic loss scaler
+   * @param[in] scaler loss scaler which holds the initial loss scale
+   */
+  void setLossScaler(const DynamicLossScaler &scaler) { loss_scaler = scaler; }
+
+  /**
+   * @brief     get the dynamic loss scaler
+   */
+  const DynamicLossScaler &getLossScaler() const { return loss_scaler; }
+
   /**
    * @brief     check if it is mixed precision training
    */
@@ -508,8 +593,7 @@ private:
     lazy_weights; /**< weights with delayed grad update, e.g., gradient
                      clipping, loss scaling */
   bool is_clip_grad;
-  float loss_scale;
-  unsigned int nan_count;
+  DynamicLossScaler loss_scaler; /**< loss scaler of mixed precision */
 
   /**
    * @brief     topological sort
@@ -57,19 +57,26 @@ public:
 
     switch (acti_type) {
     case ActivationType::ACT_TANH:
-      this->setActivation<T>(tanhFloat<T>, tanhPrime<T>);
+      this->setElementwiseActivation<T>(
+        vectorize<T, ele_tanh>([](T x) { return tanhFloat<T>(x); }),
+        [](T x) { return tanhPrime<T>(x); });
       break;
     case ActivationType::ACT_SIGMOID:
-      this->setActivation<T>(sigmoid<T>, sigmoidPrime<T>);
+      this->setElementwiseActivation<T>(
+        vectorize<T, ele_sigmoid>([](T x) { return sigmoid<T>(x); }),
+        [](T x) { return sigmoidPrime<T>(x); });
       break;
     case ActivationType::ACT_SOFTMAX:
       this->setActivation<Tensor>(softmax<T>, softmaxPrime<T>);
       break;
     case ActivationType::ACT_RELU:
-      this->setActivation<T>(relu<T>, reluPrime<T>);
+      this->setElementwiseActivation<T>([](T x) { return relu<T>(x); },
+                                        [](T x) { return reluPrime<T>(x); });
       break;
     case ActivationType::ACT_LEAKY_RELU:
-      this->setActivation<T>(leakyRelu<T>, leakyReluPrime<T>);
+      this->setElementwiseActivation<T>(
+        [](T x) { return leakyRelu<T>(x); },
+        [](T x) { return leakyReluPrime<T>(x); });
       break;
     case ActivationType::ACT_SWISH:
       is_inplace = false;
@@ -88,19 +95,25 @@ public:
       this->setActivation<Tensor>(sigmoidGelu<T>, sigmoidGeluPrime<T>);
       break;
     case ActivationType::ACT_ELU:
-      this->setActivation<T>(elu<T>, eluPrime<T>);
+      this->setElementwiseActivation<T>([](T x) { return elu<T>(x); },
+                                        [](T x) { return eluPrime<T>(x); });
       break;
     case ActivationType::ACT_SELU:
-      this->setActivation<T>(selu<T>, seluPrime<T>);
+      this->setElementwiseActivation<T>([](T x) { return selu<T>(x); },
+                                        [](T x) { return seluPrime<T>(x); });
       break;
     case ActivationType::ACT_SOFTPLUS:
-      this->setActivation<T>(softplus<T>, softplusPrime<T>);
+      this->setElementwiseActivation<T>(
+        [](T x) { return softplus<T>(x); },
+        [](T x) { return softplusPrime<T>(x); });
       break;
     case ActivationType::ACT_MISH:
-      this->setActivation<T>(mish<T>, mishPrime<T>);
+      this->setElementwiseActivation<T>([](T x) { return mish<T>(x); },
+                                        [](T x) { return mishPrime<T>(x); });
       break;
     case ActivationType::ACT_NONE:
-      this->setActivation<T>(no_op<T>, no_op_prime<T>);
+      this->setElementwiseActivation<T>(
+        [](T x) { return no_op<T>(x); }, [](T x) { return no_op_prime<T>(x); });
       break;
     case ActivationType::ACT_UNKNOWN:
     default:
@@ -179,6 +192,17 @@ public:
 
     T *output_data = output.getData<T>();
 
+    if constexpr (std::is_same_v<T, float>) {
+      // exp(x - max) and its sum in a pass over each row
+      for (unsigned int i = 0; i < bch_size; i++) {
+        float *ptr = output_data + i * width;
+        float max_value = *std::max_element(ptr, ptr + width);
+        sscal(width, 1.0f / exp_sub_sum(width, ptr, max_value), ptr, 1);
+      }
+
+      return output;
+    }
+
     // prevent overflow
     Tensor tmp(width, input.getTensorType());
     for (unsigned int i = 0; i < bch_size; i++) {
@@ -192,7 +216,7 @@ public:
     }
 
     // take exp
-    output.apply<T>(exp_util<T>, output);
+    output.apply_op<T>([](T x) { return exp_util<T>(x); }, output);
 
     // take sum over the last dimension
     Tensor sum = output.sum(3);
@@ -393,10 +417,10 @@ public:
    */
   template <typename T = float>
   static Tensor &swish(Tensor const &t_in, Tensor &t_out) {
-    t_in.apply<T>([&](T x) { return sigmoid<T>(x); }, t_out);
-    t_out.multiply_i(t_in);
-
-    return t_out;
+    return t_in.apply_op<T>(
+      vectorize<T, ele_swish>(
+        [](T x) { return static_cast<T>(x * sigmoid<T>(x)); }),
+      t_out);
   }
 
   /**
@@ -414,8 +438,9 @@ public:
       outgoing_derivative = Tensor(t_out.getDim());
 
     Tensor tmp = Tensor(t_out.getDim());
-    t_in.apply<T>([&](T x) { return sigmoid(x); }, outgoing_derivative);
-    t_out.apply<T>([&](T x) { return 1 - x; }, tmp);
+    t_in.apply_op<T>(vectorize<T, ele_sigmoid>([](T x) { return sigmoid(x); }),
+                     outgoing_derivative);
+    t_out.apply_op<T>([](T x) { return 1 - x; }, tmp);
     outgoing_derivative.multiply_i(tmp);
     outgoing_derivative.add_i(t_out);
 
@@ -431,10 +456,11 @@ public:
    */
   template <typename T = float>
   static Tensor &gelu(Tensor const &t_in, Tensor &t_out) {
-    double tmp = 1.0 / sqrt(2.0);
-    t_in.apply<T>(
-      [&](T x) { return static_cast<T>(0.5 * x * (1 + erf(x * tmp))); }, t_out);
-    return t_out;
+    return t_in.apply_op<T>(vectorize<T, ele_gelu>([](T x) {
+                              return static_cast<T>(
+                                0.5 * x * (1 + erf(x * M_SQRT1_2)));
+                            }),
+                            t_out);
   }
 
   /**
@@ -452,9 +478,9 @@ public:
     if (outgoing_derivative.empty())
       outgoing_derivative = Tensor(t_out.getDim());
 
-    T tmp = static_cast<T>(1 / sqrt(2));
-    t_in.apply<T>(
-      [&](T x) {
+    t_in.apply_op<T>(
+      [](T x) {
+        const T tmp = static_cast<T>(M_SQRT1_2);
         return static_cast<T>(
           0.5 * (1 + erf(x * tmp) +
                  x * ((2 / sqrt(M_PI)) * exp(-pow(x * tmp, 2))) * tmp));
@@ -473,15 +499,14 @@ public:
    */
   template <typename T = float>
   static Tensor &tanhGelu(Tensor const &t_in, Tensor &t_out) {
-    t_in.apply<T>(
-      [&](T x) {
+    return t_in.apply_op<T>(
+      vectorize<T, ele_tanh_gelu>([](T x) {
         return static_cast<T>(
           0.5 * x *
           (1 + tanhFloat<T>(
                  static_cast<T>(sqrt(2 / M_PI) * (x + 0.044715 * pow(x, 3))))));
-      },
+      }),
       t_out);
-    return t_out;
   }
 
   /**
@@ -508,12 +533,11 @@ public:
    */
   template <typename T = float>
   static Tensor &sigmoidGelu(Tensor const &t_in, Tensor &t_out) {
-    t_in.apply<T>(
-      [&](T x) {
-        return static_cast<T>(x * (sigmoid<T>(static_cast<T>(1.702 * x))));
-      },
-      t_out);
-    return t_out;
+    return t_in.apply_op<T>(vectorize<T, ele_sigmoid_gelu>([](T x) {
+                              return static_cast<T>(
+                                x * (sigmoid<T>(static_cast<T>(1.702 * x))));
+                            }),
+                            t_out);
   }
 
   /**
@@ -755,6 +779,45 @@ public:
     std::function<float(float const)> const &activation_fn,
     std::function<float(float const, float const)> const &activation_prime_fn);
 
+  /**
+   * @brief setActivation by elementwise kernels, which are inlined in the
+   * loop of Tensor::apply_op() instead of being called through std::function
+   * for each element
+   * @note  apply derivative as this prime_fn does not utilize derivative
+   * @tparam T type of the element
+   * @param[in] fn activation kernel, T(T) or a span kernel of
+   * Tensor::apply_op()
+   * @param[in] prime_fn derivative kernel computed from the output
+   */
+  template <typename T = float, typename Fn, typename PrimeFn>
+  void setElementwiseActivation(Fn fn, PrimeFn prime_fn) {
+    _act_fn = [fn](Tensor const &x, Tensor &hidden) -> Tensor & {
+      return x.apply_op<T>(fn, hidden);
+    };
+    if (!is_inplace) {
+      _act_prime_fn =
+        [prime_fn](Tensor const &t_in, Tensor &t_out,
+                   Tensor &outgoing_derivative,
+                   Tensor const &incoming_derivative) -> Tensor & {
+        /** @todo update this based on supportInPlace */
+        t_out.apply_op<T>(prime_fn, outgoing_derivative);
+        outgoing_derivative.multiply_i_strided(incoming_derivative);
+
+        return outgoing_derivative;
+      };
+    } else {
+      _act_prime_fn =
+        [prime_fn](Tensor const &t_in, Tensor &t_out,
+                   Tensor &outgoing_derivative,
+                   Tensor const &incoming_derivative) -> Tensor & {
+        t_out.apply_op<T>(prime_fn, t_out);
+        incoming_derivative.multiply_strided(t_out, outgoing_derivative);
+
+        return outgoing_derivative;
+      };
+    }
+  }
+
   /**
    * @brief   Notify that this layer will execute in-place
    *
@@ -769,6 +832,22 @@ public:
   }
 
 private:
+  /**
+   * @brief vectorized kernel of blas for float, or @a fn for the other types
+   * @tparam T type of the element
+   * @tparam vec_fn blas function computing the activation of a float span
+   * @param[in] fn activation of an element
+   */
+  template <typename T,
+            void (*vec_fn)(const unsigned int, const float *, float *),
+            typename Fn>
+  static auto vectorize(Fn fn) {
+    if constexpr (std::is_same_v<T, float>)
+      return [](unsigned int N, const float *X, float *Y) { vec_fn(N, X, Y); };
+    else
+      return fn;
+  }
+
   constexpr static inline float alpha = 1.0f; /**< alpha for elu */
   constexpr static inline float beta = 1.0f;  /**< beta for Softplus */
   constexpr static inline float selu_alpha = 1.67326324f; /**< alpha for selu */
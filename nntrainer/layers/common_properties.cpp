@@ -94,6 +94,8 @@ Epsilon::Epsilon(float value) { set(value); }
 
 bool Epsilon::isValid(const float &value) const { return value > 0.0f; }
 
+bool FusedBNEpsilon::isValid(const float &value) const { return value > 0.0f; }
+
 Momentum::Momentum(float value) { set(value); }
 
 bool Momentum::isValid(const float &value) const {
@@ -1217,6 +1217,74 @@ public:
   static constexpr const char *key = "flip_direction";
 };
 
+/**
+ * @brief     Enumeration of convolution algorithm
+ */
+struct ConvAlgorithmInfo {
+  enum class Enum { auto_select, im2col, gemm_1x1, winograd, direct };
+  static constexpr std::initializer_list<Enum> EnumList = {
+    Enum::auto_select, Enum::im2col, Enum::gemm_1x1, Enum::winograd,
+    Enum::direct};
+
+  static constexpr const char *EnumStr[] = {"auto", "im2col", "gemm_1x1",
+                                            "winograd", "direct"};
+};
+
+/**
+ * @brief ConvAlgorithm property, algorithm used to compute the convolution.
+ * If empty or "auto", it is picked from the shape of the layer
+ *
+ */
+class ConvAlgorithm final : public EnumProperty<ConvAlgorithmInfo> {
+public:
+  using prop_tag = enum_class_prop_tag;
+  static constexpr const char *key = "conv_algorithm";
+};
+
+/**
+ * @brief FusedBNEpsilon property, epsilon of the batch normalization folded
+ * into the layer for inference. The layer does not fold any if empty
+ *
+ */
+class FusedBNEpsilon : public nntrainer::Property<float> {
+public:
+  static constexpr const char *key =
+    "fused_bn_epsilon";            /**< unique key to access */
+  using prop_tag = float_prop_tag; /**< property type */
+
+  /**
+   * @brief FusedBNEpsilon validator
+   *
+   * @param value float to validate
+   * @retval true if it is greater than 0.0
+   * @retval false if it is smaller or equal than 0.0
+   */
+  bool isValid(const float &value) const override;
+};
+
+/**
+ * @brief FusedBNName property, name of the batch normalization folded into
+ * the layer for inference. The statistics are named after it, so the weights
+ * saved without fusion are found by their names
+ *
+ */
+class FusedBNName : public Name {
+public:
+  static constexpr const char *key = "fused_bn_name"; /**< unique key */
+  using prop_tag = str_prop_tag;                      /**< property type */
+};
+
+/**
+ * @brief FusedActivation property, activation applied to the output of the
+ * layer in place for inference
+ *
+ */
+class FusedActivation final : public EnumProperty<ActivationTypeInfo> {
+public:
+  using prop_tag = enum_class_prop_tag;
+  static constexpr const char *key = "fused_activation";
+};
+
 /**
  * @brief timestep property, timestep is used to identify for which timestep
  * should the lstm/gru/rnn layer do the operation for
@@ -1453,6 +1521,18 @@ public:
   using prop_tag = uint_prop_tag;                  /**< property type */
 };
 
+/**
+ * @brief Quantization group size property
+ * @details Number of the input features sharing a scale of the quantized
+ * weight. The scale is per output channel if it is not given.
+ */
+class QuantGroupSize : public PositiveIntegerProperty {
+public:
+  static constexpr const char *key =
+    "quant_group_size";           /**< unique key to access */
+  using prop_tag = uint_prop_tag; /**< property type */
+};
+
 /**
  * @brief properties for getting the clipping value to clip the gradient by norm
  *
@@ -30,6 +30,16 @@ ConcatLayer::ConcatLayer() : Layer(), leading_helper_dim(1) {}
 
 static constexpr size_t SINGLE_INOUT_IDX = 0;
 
+/**
+ * @brief check if @a tensor is at @a offset of a single sample @a target,
+ * which is the case when the tensor manager placed the one in the other
+ */
+static bool isPlacedAt(const Tensor &tensor, const Tensor &target,
+                       unsigned int offset) {
+  return target.batch() == 1 && tensor.getData<char>() != nullptr &&
+         tensor.getData<char>() == target.getData<char>(offset);
+}
+
 void ConcatLayer::finalize(InitLayerContext &context) {
   auto &concat_dimension_prop = std::get<props::ConcatDimension>(concat_props);
   /** for backward compatibility, default concat dimension will be channel */
@@ -124,6 +134,18 @@ void ConcatLayer::finalize(InitLayerContext &context) {
     leading_helper_dim *= output_dim.getTensorDim(idx);
   }
 
+  /**
+   * When a sample of each input is contiguous in the output, the producers
+   * can write the inputs in place, and the copies below are skipped.
+   */
+  if (leading_helper_dim == 1) {
+    unsigned int offset = 0;
+    for (unsigned int idx = 0; idx < input_dims.size(); ++idx) {
+      context.requestInputPlacement(idx, offset);
+      offset += input_reshape_helper[idx].width();
+    }
+  }
+
   setBatch(input_dims[SINGLE_INOUT_IDX].batch());
 }
 
@@ -141,8 +163,8 @@ void ConcatLayer::forwarding(RunLayerContext &context, bool training) {
    * row would be a batch, and the column would be a width. the number of each
    * block in the diagram indicates the order of copy to output.
    *
-   * @todo avoid copy by creating input here as a shared_tensor of the output
-   * here and then this layer can be in_place as well
+   * @note If the tensor manager placed an input in the output, its producer
+   * has written it in place already and the copy is skipped.
    */
   Tensor &output = context.getOutput(SINGLE_INOUT_IDX);
 
@@ -155,6 +177,13 @@ void ConcatLayer::forwarding(RunLayerContext &context, bool training) {
     Tensor &input = context.getInput(idx);
     const TensorDim in_dim = input.getDim();
     auto const &irh = input_reshape_helper[idx];
+
+    /** the producer already wrote the input in place */
+    if (isPlacedAt(input, output, output_width_offset)) {
+      output_width_offset += irh.width();
+      continue;
+    }
+
     input.reshape(irh);
     unsigned int data_copy_size = irh.width();
 
@@ -202,8 +231,7 @@ void ConcatLayer::incremental_forwarding(RunLayerContext &context,
                                          unsigned int from, unsigned int to,
                                          bool training) {
   /**
-   * @todo avoid copy by creating input here as a shared_tensor of the output
-   * here and then this layer can be in_place as well
+   * @note an input placed in the output by the tensor manager is not copied
    */
   Tensor &output = context.getOutput(SINGLE_INOUT_IDX);
 
@@ -216,10 +244,21 @@ void ConcatLayer::incremental_forwarding(RunLayerContext &context,
   // for other axes
   unsigned int batch_channel = out_dim.batch() * out_dim.channel();
 
+  unsigned int output_width_offset = 0;
+
   for (unsigned int idx = 0; idx < context.getNumInputs(); idx++) {
     Tensor &input = context.getInput(idx);
     const TensorDim in_dim = input.getDim();
     auto const &irh = input_reshape_helper[idx];
+
+    /** the producer already wrote the input in place */
+    const bool placed = isPlacedAt(input, output, output_width_offset);
+    output_width_offset += irh.width();
+    if (placed) {
+      output_height_offset += irh.height();
+      continue;
+    }
+
     input.reshape(irh);
 
     /** loop over the dimensions before the concat dimension */
@@ -259,8 +298,8 @@ void ConcatLayer::calcDerivative(RunLayerContext &context) {
    * The number of each block in the diagram indicates the order of copy to
    * inputs.
    *
-   * @todo avoid copy by creating input here as a shared_tensor of the output
-   * here and then this layer can be in_place as well
+   * @note If the tensor manager placed an input in the output, its
+   * derivative is a part of the incoming derivative and the copy is skipped.
    */
   Tensor output = context.getIncomingDerivative(SINGLE_INOUT_IDX);
 
@@ -272,6 +311,13 @@ void ConcatLayer::calcDerivative(RunLayerContext &context) {
     Tensor &input = context.getOutgoingDerivative(idx);
     const TensorDim in_dim = input.getDim();
     auto const &irh = input_reshape_helper[idx];
+
+    /** the derivative is already a part of the incoming derivative */
+    if (isPlacedAt(input, output, output_width_offset)) {
+      output_width_offset += irh.width();
+      continue;
+    }
+
     input.reshape(irh);
     unsigned int data_copy_size = irh.width();
 
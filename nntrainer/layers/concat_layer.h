@@ -87,6 +87,13 @@ public:
    */
   bool supportBackwarding() const override { return true; }
 
+  /**
+   * @brief Initialize the in-place settings of the layer
+   * @details the inputs may be placed in the output by the tensor manager
+   * @return InPlaceType
+   */
+  InPlaceType initializeInPlace() override { return InPlaceType::RESTRICTING; }
+
   /**
    * @copydoc Layer::setProperty(const PropertyType type, const std::string
    * &value)
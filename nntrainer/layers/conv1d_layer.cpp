@@ -31,7 +31,7 @@ static constexpr size_t SINGLE_INOUT_IDX = 0;
 Conv1DLayer::Conv1DLayer() :
   LayerImpl(),
   conv_props(props::FilterSize(), props::KernelSize(), props::Stride(),
-             props::Padding1D(), props::Dilation()) {
+             props::Padding1D(), props::Dilation(), props::ConvAlgorithm()) {
   wt_idx.fill(std::numeric_limits<unsigned>::max());
   conv2d_layer = std::make_unique<Conv2DLayer>();
 }
@@ -71,6 +71,10 @@ void Conv1DLayer::finalize(InitLayerContext &context) {
   setPropertyKV(props::Stride::key, "1," + std::to_string(stride));
   setPropertyKV(props::Padding2D::key, padding_str);
   setPropertyKV(props::Dilation::key, "1," + std::to_string(dilation));
+  if (auto &algorithm = std::get<props::ConvAlgorithm>(conv_props);
+      !algorithm.empty()) {
+    setPropertyKV(props::ConvAlgorithm::key, to_string(algorithm));
+  }
 
   conv2d_layer->finalize(context);
 }
@@ -100,7 +100,7 @@ public:
 
 private:
   std::tuple<props::FilterSize, props::KernelSize, props::Stride,
-             props::Padding1D, props::Dilation>
+             props::Padding1D, props::Dilation, props::ConvAlgorithm>
     conv_props;
 
   std::array<unsigned int, 5> wt_idx; /**< indices of the weights and tensors */
@@ -15,6 +15,7 @@
 #include <cstring>
 #include <limits>
 #include <string>
+#include <vector>
 
 #include <blas_interface.h>
 #include <conv2d_layer.h>
@@ -287,6 +288,410 @@ static void im2col(const Tensor &in, const TensorDim &kdim,
     throw std::runtime_error("Not supported datatype");
   }
 }
+
+/**
+ * @brief largest patch (input channel * kernel height * kernel width) which is
+ * convolved directly, the column matrix does not pay off below this
+ */
+static constexpr unsigned int DIRECT_CONV_MAX_PATCH = 32;
+
+/**
+ * @brief largest output of a sample (out_channel * out_height * out_width)
+ * which is convolved directly. Each kernel element makes a pass over an
+ * output plane, so a larger output, e.g. the stem of an image model at full
+ * resolution, runs faster as a gemm on the column matrix
+ */
+static constexpr unsigned int DIRECT_CONV_MAX_OUTPUT = 4096;
+
+/**
+ * @brief geometry of the convolution of a single sample
+ */
+struct ConvGeometry {
+  unsigned int in_channel, in_height, in_width;
+  unsigned int out_channel, out_height, out_width;
+  unsigned int k_height, k_width;
+  int pad_top, pad_left;
+  unsigned int stride_h, stride_w;
+  unsigned int dilation_h, dilation_w;
+};
+
+/**
+ * @brief     get the range of output positions reading an input position in
+ * [0, in_len) where input = output * stride + offset
+ *
+ * @param[in] offset offset of the kernel element considering padding
+ * @param[in] stride stride
+ * @param[in] in_len input length
+ * @param[in] out_len output length
+ * @param[out] begin first output position
+ * @param[out] end end of the output positions
+ */
+static void valid_range(int offset, unsigned int stride, unsigned int in_len,
+                        unsigned int out_len, unsigned int &begin,
+                        unsigned int &end) {
+  int b = offset >= 0 ? 0 : (-offset + (int)stride - 1) / (int)stride;
+  int last = (int)in_len - 1 - offset;
+  int e = last < 0 ? 0 : std::min((int)out_len, last / (int)stride + 1);
+  begin = b;
+  end = std::max(b, e);
+}
+
+/**
+ * @brief     call @a fn(k, c, i, j, oh_begin, oh_end, ow_begin, ow_end,
+ * in_offset) for each kernel element, where the input of output (oh, ow) is
+ * at in_offset + oh * stride_h * in_width + ow * stride_w of channel c
+ */
+template <typename Fn>
+static void for_each_kernel_element(const ConvGeometry &g, Fn fn) {
+  for (unsigned int k = 0; k < g.out_channel; ++k) {
+    for (unsigned int c = 0; c < g.in_channel; ++c) {
+      for (unsigned int i = 0; i < g.k_height; ++i) {
+        int off_h = (int)(i * g.dilation_h) - g.pad_top;
+        unsigned int hb, he;
+        valid_range(off_h, g.stride_h, g.in_height, g.out_height, hb, he);
+        for (unsigned int j = 0; j < g.k_width; ++j) {
+          int off_w = (int)(j * g.dilation_w) - g.pad_left;
+          unsigned int wb, we;
+          valid_range(off_w, g.stride_w, g.in_width, g.out_width, wb, we);
+          if (hb >= he || wb >= we)
+            continue;
+          fn(k, c, i, j, hb, he, wb, we, off_h * (int)g.in_width + off_w);
+        }
+      }
+    }
+  }
+}
+
+/**
+ * @brief     convolve a sample directly without the column matrix
+ *
+ * @param[in] g geometry
+ * @param[in] in input of (in_channel, in_height, in_width)
+ * @param[in] kernel kernel of (out_channel, in_channel, k_height, k_width)
+ * @param[out] out output of (out_channel, out_height, out_width)
+ */
+static void direct_conv(const ConvGeometry &g, const float *in,
+                        const float *kernel, float *out) {
+  const unsigned int in_plane = g.in_height * g.in_width;
+  const unsigned int out_plane = g.out_height * g.out_width;
+  const unsigned int sw = g.stride_w;
+  std::fill(out, out + g.out_channel * out_plane, 0.0f);
+
+  for_each_kernel_element(g, [&](unsigned int k, unsigned int c,
+                                 unsigned int i, unsigned int j,
+                                 unsigned int hb, unsigned int he,
+                                 unsigned int wb, unsigned int we, int off) {
+    const float w =
+      kernel[((k * g.in_channel + c) * g.k_height + i) * g.k_width + j];
+    for (unsigned int oh = hb; oh < he; ++oh) {
+      const float *in_row =
+        in + c * in_plane + off + (int)(oh * g.stride_h * g.in_width);
+      float *out_row = out + k * out_plane + oh * g.out_width;
+      for (unsigned int ow = wb; ow < we; ++ow)
+        out_row[ow] += w * in_row[ow * sw];
+    }
+  });
+}
+
+/**
+ * @brief     derivative of direct_conv with respect to the input
+ *
+ * @param[in] g geometry
+ * @param[in] deriv incoming derivative of (out_channel, out_height, out_width)
+ * @param[in] kernel kernel of (out_channel, in_channel, k_height, k_width)
+ * @param[out] in_deriv derivative of (in_channel, in_height, in_width)
+ */
+static void direct_conv_derivative(const ConvGeometry &g, const float *deriv,
+                                   const float *kernel, float *in_deriv) {
+  const unsigned int in_plane = g.in_height * g.in_width;
+  const unsigned int out_plane = g.out_height * g.out_width;
+  const unsigned int sw = g.stride_w;
+  std::fill(in_deriv, in_deriv + g.in_channel * in_plane, 0.0f);
+
+  for_each_kernel_element(g, [&](unsigned int k, unsigned int c,
+                                 unsigned int i, unsigned int j,
+                                 unsigned int hb, unsigned int he,
+                                 unsigned int wb, unsigned int we, int off) {
+    const float w =
+      kernel[((k * g.in_channel + c) * g.k_height + i) * g.k_width + j];
+    for (unsigned int oh = hb; oh < he; ++oh) {
+      float *in_row =
+        in_deriv + c * in_plane + off + (int)(oh * g.stride_h * g.in_width);
+      const float *deriv_row = deriv + k * out_plane + oh * g.out_width;
+      for (unsigned int ow = wb; ow < we; ++ow)
+        in_row[ow * sw] += w * deriv_row[ow];
+    }
+  });
+}
+
+/**
+ * @brief     derivative of direct_conv with respect to the kernel, added to
+ * @a kernel_grad
+ *
+ * @param[in] g geometry
+ * @param[in] in input of (in_channel, in_height, in_width)
+ * @param[in] deriv incoming derivative of (out_channel, out_height, out_width)
+ * @param[out] kernel_grad gradient of (out_channel, in_channel, k_height,
+ * k_width)
+ */
+static void direct_conv_gradient(const ConvGeometry &g, const float *in,
+                                 const float *deriv, float *kernel_grad) {
+  const unsigned int in_plane = g.in_height * g.in_width;
+  const unsigned int out_plane = g.out_height * g.out_width;
+  const unsigned int sw = g.stride_w;
+
+  for_each_kernel_element(g, [&](unsigned int k, unsigned int c,
+                                 unsigned int i, unsigned int j,
+                                 unsigned int hb, unsigned int he,
+                                 unsigned int wb, unsigned int we, int off) {
+    float sum = 0.0f;
+    for (unsigned int oh = hb; oh < he; ++oh) {
+      const float *in_row =
+        in + c * in_plane + off + (int)(oh * g.stride_h * g.in_width);
+      const float *deriv_row = deriv + k * out_plane + oh * g.out_width;
+      for (unsigned int ow = wb; ow < we; ++ow)
+        sum += deriv_row[ow] * in_row[ow * sw];
+    }
+    kernel_grad[((k * g.in_channel + c) * g.k_height + i) * g.k_width + j] +=
+      sum;
+  });
+}
+
+/**
+ * @brief     transform 3x3 kernels for winograd F(2x2, 3x3), U = G g G^T
+ *
+ * @param[in] kernel kernel of (filters, channel, 3, 3)
+ * @param[in] filters number of filters
+ * @param[in] channel number of channels
+ * @param[in] transpose if true, kernels are rotated by 180 degree and filters
+ * and channels are swapped to convolve the derivative
+ * @param[out] U transformed kernel of (16, out, in) where (out, in) is
+ * (filters, channel), or (channel, filters) if @a transpose
+ */
+static void winograd_kernel(const float *kernel, unsigned int filters,
+                            unsigned int channel, bool transpose, float *U) {
+  const unsigned int out = transpose ? channel : filters;
+  const unsigned int in = transpose ? filters : channel;
+
+  for (unsigned int k = 0; k < filters; ++k) {
+    for (unsigned int c = 0; c < channel; ++c) {
+      const float *src = kernel + (k * channel + c) * 9;
+      float g[9];
+      for (unsigned int e = 0; e < 9; ++e)
+        g[e] = transpose ? src[8 - e] : src[e];
+
+      /// t = G g
+      float t[12];
+      for (unsigned int j = 0; j < 3; ++j) {
+        t[j] = g[j];
+        t[3 + j] = 0.5f * (g[j] + g[3 + j] + g[6 + j]);
+        t[6 + j] = 0.5f * (g[j] - g[3 + j] + g[6 + j]);
+        t[9 + j] = g[6 + j];
+      }
+
+      /// u = t G^T
+      unsigned int o = transpose ? c : k;
+      unsigned int i = transpose ? k : c;
+      for (unsigned int r = 0; r < 4; ++r) {
+        const float *row = t + r * 3;
+        float u[4] = {row[0], 0.5f * (row[0] + row[1] + row[2]),
+                      0.5f * (row[0] - row[1] + row[2]), row[2]};
+        for (unsigned int s = 0; s < 4; ++s)
+          U[((r * 4 + s) * out + o) * in + i] = u[s];
+      }
+    }
+  }
+}
+
+/**
+ * @brief     convolve a sample with 3x3 kernels of stride 1 by winograd
+ * F(2x2, 3x3). Each 4x4 input tile gives a 2x2 output tile, and the 16
+ * elements of the tiles are multiplied by the transformed kernel with GEMMs.
+ *
+ * @param[in] in input of (in_channel, in_height, in_width)
+ * @param[in] in_channel number of input channels
+ * @param[in] in_height input height
+ * @param[in] in_width input width
+ * @param[in] U kernel transformed by winograd_kernel
+ * @param[in] out_channel number of output channels
+ * @param[in] pad_top top padding, may be negative
+ * @param[in] pad_left left padding, may be negative
+ * @param[out] out output of (out_channel, out_height, out_width)
+ * @param[in] out_height output height
+ * @param[in] out_width output width
+ * @param[in] V buffer of the transformed input tiles
+ * @param[in] M buffer of the transformed output tiles
+ */
+static void winograd_conv(const float *in, unsigned int in_channel,
+                          unsigned int in_height, unsigned int in_width,
+                          const float *U, unsigned int out_channel,
+                          int pad_top, int pad_left, float *out,
+                          unsigned int out_height, unsigned int out_width,
+                          std::vector<float> &V, std::vector<float> &M) {
+  const unsigned int tiles_h = (out_height + 1) / 2;
+  const unsigned int tiles_w = (out_width + 1) / 2;
+  const unsigned int tiles = tiles_h * tiles_w;
+  V.resize(16 * in_channel * tiles);
+  M.resize(16 * out_channel * tiles);
+
+  /// V = B^T d B for every input tile d
+  for (unsigned int c = 0; c < in_channel; ++c) {
+    const float *plane = in + c * in_height * in_width;
+    for (unsigned int th = 0; th < tiles_h; ++th) {
+      for (unsigned int tw = 0; tw < tiles_w; ++tw) {
+        float d[16];
+        for (unsigned int r = 0; r < 4; ++r) {
+          int h = (int)(th * 2 + r) - pad_top;
+          for (unsigned int s = 0; s < 4; ++s) {
+            int w = (int)(tw * 2 + s) - pad_left;
+            d[r * 4 + s] = (h < 0 || (int)in_height <= h || w < 0 ||
+                            (int)in_width <= w)
+                             ? 0.0f
+                             : plane[h * in_width + w];
+          }
+        }
+
+        float t[16];
+        for (unsigned int s = 0; s < 4; ++s) {
+          t[s] = d[s] - d[8 + s];
+          t[4 + s] = d[4 + s] + d[8 + s];
+          t[8 + s] = d[8 + s] - d[4 + s];
+          t[12 + s] = d[4 + s] - d[12 + s];
+        }
+
+        unsigned int tile = th * tiles_w + tw;
+        for (unsigned int r = 0; r < 4; ++r) {
+          const float *row = t + r * 4;
+          float v[4] = {row[0] - row[2], row[1] + row[2], row[2] - row[1],
+                        row[1] - row[3]};
+          for (unsigned int s = 0; s < 4; ++s)
+            V[((r * 4 + s) * in_channel + c) * tiles + tile] = v[s];
+        }
+      }
+    }
+  }
+
+  /// M = U V for each of the 16 elements
+  for (unsigned int e = 0; e < 16; ++e) {
+    sgemm((unsigned int)TStorageOrder::ROW_MAJOR, false, false, out_channel,
+          tiles, in_channel, 1.0f, U + e * out_channel * in_channel,
+          in_channel, V.data() + e * in_channel * tiles, tiles, 0.0f,
+          M.data() + e * out_channel * tiles, tiles);
+  }
+
+  /// Y = A^T m A for every output tile m
+  for (unsigned int k = 0; k < out_channel; ++k) {
+    float *plane = out + k * out_height * out_width;
+    for (unsigned int th = 0; th < tiles_h; ++th) {
+      for (unsigned int tw = 0; tw < tiles_w; ++tw) {
+        unsigned int tile = th * tiles_w + tw;
+        float m[16];
+        for (unsigned int e = 0; e < 16; ++e)
+          m[e] = M[(e * out_channel + k) * tiles + tile];
+
+        float t[8];
+        for (unsigned int s = 0; s < 4; ++s) {
+          t[s] = m[s] + m[4 + s] + m[8 + s];
+          t[4 + s] = m[4 + s] - m[8 + s] - m[12 + s];
+        }
+
+        for (unsigned int r = 0; r < 2; ++r) {
+          unsigned int h = th * 2 + r;
+          if (h >= out_height)
+            continue;
+          const float *row = t + r * 4;
+          float y[2] = {row[0] + row[1] + row[2], row[1] - row[2] - row[3]};
+          for (unsigned int s = 0; s < 2; ++s) {
+            unsigned int w = tw * 2 + s;
+            if (w < out_width)
+              plane[h * out_width + w] = y[s];
+          }
+        }
+      }
+    }
+  }
+}
+
+/**
+ * @brief     select the algorithm of the convolution
+ *
+ * @param[in] requested algorithm requested by the property
+ * @param[in] g geometry
+ * @param[in] padding padding information
+ * @param[in] fp32_nchw true if the input and the kernel are fp32 in nchw
+ * @return algorithm to use
+ */
+static props::ConvAlgorithmInfo::Enum
+select_algorithm(props::ConvAlgorithmInfo::Enum requested,
+                 const ConvGeometry &g,
+                 const std::array<unsigned int, 4> &padding, bool fp32_nchw) {
+  using Algorithm = props::ConvAlgorithmInfo::Enum;
+
+  bool unit_stride = g.stride_h == 1 && g.stride_w == 1;
+  bool no_padding = std::all_of(padding.begin(), padding.end(),
+                                [](unsigned int p) { return p == 0; });
+  bool gemm_1x1 =
+    fp32_nchw && g.k_height == 1 && g.k_width == 1 && unit_stride && no_padding;
+  bool winograd = fp32_nchw && g.k_height == 3 && g.k_width == 3 &&
+                  unit_stride && g.dilation_h == 1 && g.dilation_w == 1;
+  bool direct = fp32_nchw;
+
+  switch (requested) {
+  case Algorithm::im2col:
+    return requested;
+  case Algorithm::gemm_1x1:
+    NNTR_THROW_IF(!gemm_1x1, std::invalid_argument)
+      << "[Conv2D] gemm_1x1 requires an fp32 1x1 kernel of stride 1 and "
+         "no padding";
+    return requested;
+  case Algorithm::winograd:
+    NNTR_THROW_IF(!winograd, std::invalid_argument)
+      << "[Conv2D] winograd requires an fp32 3x3 kernel of stride 1 and "
+         "dilation 1";
+    return requested;
+  case Algorithm::direct:
+    NNTR_THROW_IF(!direct, std::invalid_argument)
+      << "[Conv2D] direct requires fp32 tensors of nchw format";
+    return requested;
+  default:
+    break;
+  }
+
+  if (gemm_1x1)
+    return Algorithm::gemm_1x1;
+  if (direct && g.in_channel * g.k_height * g.k_width <= DIRECT_CONV_MAX_PATCH &&
+      g.out_channel * g.out_height * g.out_width <= DIRECT_CONV_MAX_OUTPUT)
+    return Algorithm::direct;
+  if (winograd)
+    return Algorithm::winograd;
+  return Algorithm::im2col;
+}
+
+/**
+ * @brief     get the geometry of the convolution of a single sample
+ */
+static ConvGeometry
+make_geometry(const TensorDim &in_dim, const TensorDim &out_dim,
+              const TensorDim &kdim, const std::array<unsigned int, 4> &padding,
+              const std::array<props::Stride, CONV2D_DIM> &stride,
+              const std::array<props::Dilation, CONV2D_DIM> &dilation) {
+  ConvGeometry g;
+  g.in_channel = in_dim.channel();
+  g.in_height = in_dim.height();
+  g.in_width = in_dim.width();
+  g.out_channel = out_dim.channel();
+  g.out_height = out_dim.height();
+  g.out_width = out_dim.width();
+  g.k_height = kdim.height();
+  g.k_width = kdim.width();
+  g.pad_top = padding[0];
+  g.pad_left = padding[2];
+  g.stride_h = stride[0];
+  g.stride_w = stride[1];
+  g.dilation_h = dilation[0];
+  g.dilation_w = dilation[1];
+  return g;
+}
 } // namespace
 
 enum ConvParams { weight, bias };
@@ -297,7 +702,10 @@ Conv2DLayer::Conv2DLayer(
   padding(padding_),
   conv_props(props::FilterSize(), std::array<props::KernelSize, CONV2D_DIM>(),
              std::array<props::Stride, CONV2D_DIM>(), props::Padding2D(),
-             std::array<props::Dilation, CONV2D_DIM>()) {
+             std::array<props::Dilation, CONV2D_DIM>(), props::ConvAlgorithm(),
+             props::FusedBNEpsilon(), props::FusedBNName(),
+             props::FusedActivation()),
+  algorithm(props::ConvAlgorithmInfo::Enum::im2col) {
   wt_idx.fill(std::numeric_limits<unsigned>::max());
 }
 
@@ -375,6 +783,23 @@ void Conv2DLayer::finalize(InitLayerContext &context) {
                   eff_in_width - padding[2] - kernel_size[1] > IM,
                 std::invalid_argument)
     << "Failed to initialize: Calculated patch end is over int max";
+
+  bool fp32_nchw = in_dim.getDataType() == TensorDim::DataType::FP32 &&
+                   kernel_dim.getDataType() == TensorDim::DataType::FP32 &&
+                   in_dim.getFormat() == TensorDim::Format::NCHW;
+  auto &requested = std::get<props::ConvAlgorithm>(conv_props);
+  algorithm = select_algorithm(
+    requested.empty() ? props::ConvAlgorithmInfo::Enum::auto_select
+                      : requested.get(),
+    make_geometry(in_dim, out_dim, kernel_dim, padding, stride, dilation),
+    padding, fp32_nchw);
+
+  /** the bias runs along the channels of the output */
+  const bool has_bias = disable_bias.empty() || disable_bias.get() == false;
+  epilogue.finalize(context, out_dim, has_bias ? 1 : 0,
+                    std::get<props::FusedBNEpsilon>(conv_props),
+                    std::get<props::FusedBNName>(conv_props),
+                    std::get<props::FusedActivation>(conv_props));
 }
 
 void Conv2DLayer::forwarding(RunLayerContext &context, bool training) {
@@ -436,22 +861,70 @@ void Conv2DLayer::forwarding(RunLayerContext &context, bool training) {
 
   filter_kernel.reshape(filter_dim_squeezed);
 
+  using Algorithm = props::ConvAlgorithmInfo::Enum;
+  ConvGeometry g =
+    make_geometry(in_dim, out_dim, filter_dim, padding, stride, dilation);
+
+  std::vector<float> U;
+  if (algorithm == Algorithm::winograd) {
+    U.resize(16 * g.out_channel * g.in_channel);
+    winograd_kernel(filter_kernel.getData<float>(), g.out_channel,
+                    g.in_channel, false, U.data());
+  }
+
+  auto &disable_bias = std::get<props::DisableBias>(*layer_impl_props);
+  bool has_bias = disable_bias.empty() || disable_bias.get() == false;
+  if (!epilogue.empty()) {
+    epilogue.prepare(context, has_bias
+                                ? &context.getWeight(wt_idx[ConvParams::bias])
+                                : nullptr);
+  }
+
   /**
    * Below sets the pad area values to zero
    * it is faster to do this way than seting selective area to zero
    */
   auto forwarding_job = [&](unsigned int s, unsigned int e, unsigned int pid,
                             void *user_data) {
-    Tensor result = Tensor(calcCol2ImOutputDim(out_dim, filter_dim));
-    result.setZero();
+    Tensor result;
+    if (algorithm == Algorithm::im2col) {
+      result = Tensor(calcCol2ImOutputDim(out_dim, filter_dim));
+      result.setZero();
+    }
+    std::vector<float> V, M;
     for (unsigned int b = s; b < e; ++b) {
       Tensor out = hidden_.getBatchSlice(b, 1);
       out.reshape({filter_size, out_dim.width() * out_dim.height()});
       Tensor in_sub = input_.getBatchSlice(b, 1);
 
-      im2col(in_sub, filter_dim, padding, stride, dilation, result);
-      // filter kernel is (K, CRS), result is (CRS, OH*OW)
-      filter_kernel.dot(result, out, false, true);
+      switch (algorithm) {
+      case Algorithm::gemm_1x1:
+        // the input is the column matrix already, (C, H*W)
+        in_sub.reshape({g.in_channel, g.in_height * g.in_width});
+        filter_kernel.dot(in_sub, out);
+        break;
+      case Algorithm::winograd:
+        winograd_conv(in_sub.getData<float>(), g.in_channel, g.in_height,
+                      g.in_width, U.data(), g.out_channel, g.pad_top,
+                      g.pad_left, out.getData<float>(), g.out_height,
+                      g.out_width, V, M);
+        break;
+      case Algorithm::direct:
+        direct_conv(g, in_sub.getData<float>(), filter_kernel.getData<float>(),
+                    out.getData<float>());
+        break;
+      default:
+        im2col(in_sub, filter_dim, padding, stride, dilation, result);
+        // filter kernel is (K, CRS), result is (CRS, OH*OW)
+        filter_kernel.dot(result, out, false, true);
+        break;
+      }
+
+      // apply the fused layers while the output of the sample is in cache
+      if (!epilogue.empty()) {
+        Tensor fused = hidden_.getBatchSlice(b, 1);
+        epilogue.run(fused);
+      }
     }
     result.deallocate();
   };
@@ -465,8 +938,7 @@ void Conv2DLayer::forwarding(RunLayerContext &context, bool training) {
   }
 
   filter_kernel.reshape(filter_dim);
-  if (auto &disable_bias = std::get<props::DisableBias>(*layer_impl_props);
-      disable_bias.empty() || disable_bias.get() == false) {
+  if (has_bias && epilogue.empty()) {
     Tensor &bias_kernel = context.getWeight(wt_idx[ConvParams::bias]);
     status = hidden_.add_i(bias_kernel);
     if (status != ML_ERROR_NONE) {
@@ -491,25 +963,62 @@ void Conv2DLayer::calcDerivative(RunLayerContext &context) {
 
   filter_kernel.reshape(filter_dim_squeezed);
 
+  using Algorithm = props::ConvAlgorithmInfo::Enum;
+  ConvGeometry g =
+    make_geometry(input_derivative.getDim(), derivative.getDim(), filter_dim,
+                  padding, stride, dilation);
+
+  /// the derivative of a 3x3 convolution of stride 1 is a 3x3 convolution of
+  /// the incoming derivative with the rotated kernel, padded by 2 - padding
+  std::vector<float> U;
+  if (algorithm == Algorithm::winograd) {
+    U.resize(16 * g.out_channel * g.in_channel);
+    winograd_kernel(filter_kernel.getData<float>(), g.out_channel,
+                    g.in_channel, true, U.data());
+  }
+
   /// for each batch
   /// filter_kernel^T X derivaitive  -> column matrix
   /// col2im(column matrix) to reconstruct the original image
 
   auto compute_derivative = [&](unsigned int s, unsigned int e,
                                 unsigned int pid, void *user_data) {
-    Tensor result =
-      Tensor(calcCol2ImOutputDim(derivative.getDim(), filter_dim));
+    Tensor result;
+    if (algorithm == Algorithm::im2col)
+      result = Tensor(calcCol2ImOutputDim(derivative.getDim(), filter_dim));
+    std::vector<float> V, M;
 
     for (unsigned int b = s; b < e; ++b) {
       Tensor deriv_sub = derivative.getBatchSlice(b, 1);
       Tensor in_deriv_sub = input_derivative.getBatchSlice(b, 1);
       deriv_sub.reshape(
         {filter_size, derivative.width() * derivative.height()});
-      // filter_kernel is (K, CRS), deriv_sub is (K, OH*OW), result is (CRS,
-      // OH*OW)
-      filter_kernel.dot(deriv_sub, result, true, false);
-      col2im(result, filter_dim, padding, stride, dilation, in_deriv_sub);
-      // in_derv_sub is (C,H,W)
+
+      switch (algorithm) {
+      case Algorithm::gemm_1x1:
+        // filter_kernel is (K, C), deriv_sub is (K, H*W)
+        in_deriv_sub.reshape({g.in_channel, g.in_height * g.in_width});
+        filter_kernel.dot(deriv_sub, in_deriv_sub, true, false);
+        break;
+      case Algorithm::winograd:
+        winograd_conv(deriv_sub.getData<float>(), g.out_channel, g.out_height,
+                      g.out_width, U.data(), g.in_channel, 2 - g.pad_top,
+                      2 - g.pad_left, in_deriv_sub.getData<float>(),
+                      g.in_height, g.in_width, V, M);
+        break;
+      case Algorithm::direct:
+        direct_conv_derivative(g, deriv_sub.getData<float>(),
+                               filter_kernel.getData<float>(),
+                               in_deriv_sub.getData<float>());
+        break;
+      default:
+        // filter_kernel is (K, CRS), deriv_sub is (K, OH*OW), result is (CRS,
+        // OH*OW)
+        filter_kernel.dot(deriv_sub, result, true, false);
+        col2im(result, filter_dim, padding, stride, dilation, in_deriv_sub);
+        // in_derv_sub is (C,H,W)
+        break;
+      }
     }
     result.deallocate();
   };
@@ -549,6 +1058,42 @@ void Conv2DLayer::calcGradient(RunLayerContext &context) {
 
   TensorDim out_dim_squeezed{filter_size,
                              derivative.width() * derivative.height()};
+
+  using Algorithm = props::ConvAlgorithmInfo::Enum;
+  ConvGeometry g = make_geometry(input_.getDim(), derivative.getDim(),
+                                 filter_dim, padding, stride, dilation);
+  /// winograd gets the gradient of the kernel through the column matrix
+  bool use_im2col =
+    algorithm == Algorithm::im2col || algorithm == Algorithm::winograd;
+
+  /// deriv_sub is (K, OH*OW), result is the column matrix of (OH*OW, CRS),
+  /// grad is (K, CRS) which is overwritten if beta is 0
+  auto add_gradient = [&](Tensor &deriv_sub, Tensor &in_sub, Tensor &result,
+                          Tensor &grad, float beta) {
+    switch (algorithm) {
+    case Algorithm::gemm_1x1:
+      // the input is the transposed column matrix already, (C, H*W)
+      in_sub.reshape({g.in_channel, g.in_height * g.in_width});
+      deriv_sub.dot(in_sub, grad, false, true, beta);
+      break;
+    case Algorithm::direct:
+      if (beta == 0.0f)
+        grad.setZero();
+      direct_conv_gradient(g, in_sub.getData<float>(),
+                           deriv_sub.getData<float>(), grad.getData<float>());
+      break;
+    default:
+      /**
+       * @todo this result can be cached from the forward iteration at the
+       * expense of memory. In this case, memory of im2col_result must be
+       * saved for the whole batch. try this while benchmarking.
+       */
+      im2col(in_sub, filter_dim, padding, stride, dilation, result);
+      deriv_sub.dot(result, grad, false, false, beta);
+      break;
+    }
+  };
+
   auto workers = ParallelBatch(input_.batch());
   /// input -(im2col)-> column_matrix -> filter x (column_matrix) = output
   /// so delK = dy x column_matrix ^ T;
@@ -562,9 +1107,11 @@ void Conv2DLayer::calcGradient(RunLayerContext &context) {
 
     auto calc_grad_job = [&](unsigned int s, unsigned int e, unsigned int pid,
                              void *user_data) {
-      Tensor result =
-        Tensor(calcCol2ImOutputDim(derivative.getDim(), filter_dim));
-      result.setZero();
+      Tensor result;
+      if (use_im2col) {
+        result = Tensor(calcCol2ImOutputDim(derivative.getDim(), filter_dim));
+        result.setZero();
+      }
       for (unsigned int b = s; b < e; ++b) {
         Tensor deriv_sub = derivative.getBatchSlice(b, 1);
         Tensor delK_sub = delK_par.getBatchSlice(b, 1);
@@ -572,14 +1119,7 @@ void Conv2DLayer::calcGradient(RunLayerContext &context) {
 
         Tensor in_sub = input_.getBatchSlice(b, 1);
 
-        /**
-         * @todo this result can be cached from the forward iteration at the
-         * expense of memory. In this case, memory of im2col_result must be
-         * saved for the whole batch. try this while benchmarking.
-         */
-        // deriv_sub is (K, OH*OW) and result is (CRS, OH*OW)
-        im2col(in_sub, filter_dim, padding, stride, dilation, result);
-        deriv_sub.dot(result, delK_sub, false, false);
+        add_gradient(deriv_sub, in_sub, result, delK_sub, 0.0f);
       }
       result.deallocate();
     };
@@ -594,9 +1134,11 @@ void Conv2DLayer::calcGradient(RunLayerContext &context) {
     }
 
   } else {
-    Tensor result =
-      Tensor(calcCol2ImOutputDim(derivative.getDim(), filter_dim));
-    result.setZero();
+    Tensor result;
+    if (use_im2col) {
+      result = Tensor(calcCol2ImOutputDim(derivative.getDim(), filter_dim));
+      result.setZero();
+    }
 
     for (unsigned int b = 0; b < input_.batch(); ++b) {
       Tensor deriv_sub = derivative.getBatchSlice(b, 1);
@@ -604,13 +1146,7 @@ void Conv2DLayer::calcGradient(RunLayerContext &context) {
 
       Tensor in_sub = input_.getBatchSlice(b, 1);
 
-      /**
-       * @todo this result can be cached from the forward iteration at the
-       * expense of memory. In this case, memory of im2col_result must be saved
-       * for the whole batch. try this while benchmarking.
-       */
-      im2col(in_sub, filter_dim, padding, stride, dilation, result);
-      deriv_sub.dot(result, delK, false, false, b == 0 ? 0 : 1);
+      add_gradient(deriv_sub, in_sub, result, delK, b == 0 ? 0 : 1);
     }
     result.deallocate();
   }
@@ -18,6 +18,7 @@
 #include <memory.h>
 
 #include <common_properties.h>
+#include <fused_epilogue.h>
 #include <layer_impl.h>
 
 namespace nntrainer {
@@ -112,10 +113,16 @@ private:
   std::array<unsigned int, CONV2D_DIM * 2> padding;
   std::tuple<props::FilterSize, std::array<props::KernelSize, CONV2D_DIM>,
              std::array<props::Stride, CONV2D_DIM>, props::Padding2D,
-             std::array<props::Dilation, CONV2D_DIM>>
+             std::array<props::Dilation, CONV2D_DIM>, props::ConvAlgorithm,
+             props::FusedBNEpsilon, props::FusedBNName, props::FusedActivation>
     conv_props;
 
   std::array<unsigned int, 5> wt_idx; /**< indices of the weights and tensors */
+
+  /** algorithm computing the convolution, selected at finalize */
+  props::ConvAlgorithmInfo::Enum algorithm;
+
+  FusedEpilogue epilogue; /**< layers fused into the output for inference */
 };
 
 } // namespace nntrainer
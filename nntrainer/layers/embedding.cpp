@@ -19,6 +19,7 @@
 #include <node_exporter.h>
 #include <util_func.h>
 
+#include <algorithm>
 #include <iostream>
 
 namespace nntrainer {
@@ -161,6 +162,29 @@ void EmbeddingLayer::calcDerivative(RunLayerContext &context) {
     "calcDerivative for Embedding layer is not supported");
 }
 
+/**
+ * @brief add the incoming derivative of each word to the row of the word in
+ * djdw
+ */
+template <typename T>
+static void scatterGradient(Tensor &djdw, const Tensor &derivative,
+                            const Tensor &input, unsigned int out_dim) {
+  for (unsigned int b = 0; b < input.batch(); ++b) {
+    const float *in_data =
+      input.getAddress<float>(b * input.getDim().getFeatureLen());
+
+    for (unsigned int i = 0; i < input.width(); ++i) {
+      uint embed_idx = static_cast<uint>(in_data[i]);
+      T *djdw_data = djdw.getAddress<T>(embed_idx * out_dim);
+      const T *grad_data = derivative.getAddress<T>(
+        b * derivative.getDim().getFeatureLen() + i * out_dim);
+
+      std::transform(djdw_data, djdw_data + out_dim, grad_data, djdw_data,
+                     std::plus<T>());
+    }
+  }
+}
+
 void EmbeddingLayer::calcGradient(RunLayerContext &context) {
   unsigned int out_dim = std::get<props::OutDim>(embedding_props);
 
@@ -168,59 +192,49 @@ void EmbeddingLayer::calcGradient(RunLayerContext &context) {
   const Tensor &derivative_ = context.getIncomingDerivative(SINGLE_INOUT_IDX);
   Tensor &input_ = context.getInput(SINGLE_INOUT_IDX);
 
-  djdw.setZero();
-
-  // TODO:
-  // This is to calculate gradient with current implementation of optimizer.
-  // In order to accelerate, we need to better way like using index to weight.
-
- /// @todo
-  // Current nntrainer gradient Tensor shape is identical to its
-  // weight shape. However, this creates a sparse Tensor since we are only using
-  // certain indices of the Tensor that we are interested in. Since we have such
-  // indices before accessing to the Tensor, we can optimize it by deleting the
-  // sparse-value indices. Also left as an Issue as well.
-
-  for (unsigned int b = 0; b < input_.batch(); ++b) {
-    float *in_data =
-      input_.getAddress<float>(b * input_.getDim().getFeatureLen());
-
-    if (djdw.getDataType() == TensorDim::DataType::FP32) {
-      for (unsigned int i = 0; i < input_.width(); ++i) {
-        uint embed_idx = ((float *)(in_data))[i];
-        // Assume padding is 0 and index always start from 1.
-        // If in_data[i] - 1 < 0, then it skips.
-        // if (embed_idx == 0)
-        //   continue;
-
-        float *djdw_data = djdw.getAddress<float>(embed_idx * out_dim);
-        const float *grad_data = derivative_.getAddress<float>(
-          b * derivative_.getDim().getFeatureLen() + i * out_dim);
+  /**
+   * Only the rows of the words in the batch are written, so the gradient is
+   * kept row-sparse rather than zeroing the whole [in_dim x out_dim] table.
+   * The optimizers which support the row-sparse gradient update those rows
+   * only, and the gradient is made dense for the others.
+   *
+   * The mark is kept by the weight of this layer, which the other layers
+   * sharing the table do not see. So the gradient is kept dense if it is
+   * shared, i.e. this layer is not both the first and the last to write it.
+   */
+  bool row_sparse = context.isGradientFirstAccess(weight_idx) &&
+                    context.isGradientLastAccess(weight_idx);
+  std::vector<unsigned int> rows;
+  if (row_sparse) {
+    rows.reserve(input_.batch() * input_.width());
+    for (unsigned int b = 0; b < input_.batch(); ++b) {
+      const float *in_data =
+        input_.getAddress<float>(b * input_.getDim().getFeatureLen());
+      for (unsigned int i = 0; i < input_.width(); ++i)
+        rows.push_back(static_cast<uint>(in_data[i]));
+    }
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+
+    TensorDim row_dim({1, 1, 1, out_dim}, djdw.getTensorType());
+    for (auto row : rows)
+      djdw.getSharedDataTensor(row_dim, row * out_dim).setZero();
+  } else if (context.isGradientFirstAccess(weight_idx)) {
+    djdw.setZero();
+  }
 
-        std::transform(djdw_data, djdw_data + out_dim, grad_data, djdw_data,
-                       std::plus<float>());
-      }
-    } else if (djdw.getDataType() == TensorDim::DataType::FP16) {
+  if (djdw.getDataType() == TensorDim::DataType::FP32) {
+    scatterGradient<float>(djdw, derivative_, input_, out_dim);
+  } else if (djdw.getDataType() == TensorDim::DataType::FP16) {
 #ifdef ENABLE_FP16
-      for (unsigned int i = 0; i < input_.width(); ++i) {
-        uint embed_idx = ((float *)(in_data))[i];
-        // Assume padding is 0 and index always start from 1.
-        // If in_data[i] - 1 < 0, then it skips.
-        // if (embed_idx == 0)
-        //   continue;
-
-        _FP16 *djdw_data = djdw.getAddress<_FP16>(embed_idx * out_dim);
-        const _FP16 *grad_data = derivative_.getAddress<_FP16>(
-          b * derivative_.getDim().getFeatureLen() + i * out_dim);
-
-        std::transform(djdw_data, djdw_data + out_dim, grad_data, djdw_data,
-                       std::plus<_FP16>());
-      }
+    scatterGradient<_FP16>(djdw, derivative_, input_, out_dim);
 #else
-      throw std::invalid_argument("Error: enable-fp16 is not enabled");
+    throw std::invalid_argument("Error: enable-fp16 is not enabled");
 #endif
-    }
   }
+
+  if (row_sparse)
+    context.setWeightGradientRows(weight_idx, std::move(rows));
 }
 
 void EmbeddingLayer::exportTo(Exporter &exporter,
@@ -21,6 +21,7 @@
  *
  */
 
+#include <blas_interface.h>
 #include <common_properties.h>
 #include <fc_layer.h>
 #include <layer_context.h>
@@ -36,13 +37,16 @@ namespace nntrainer {
 
 static constexpr size_t SINGLE_INOUT_IDX = 0;
 
-enum FCParams { weight, bias };
+enum FCParams { weight, bias, weight_scale };
 enum LORAParams { loraA, loraB, loraTmp, loraOut };
 
 FullyConnectedLayer::FullyConnectedLayer() :
   LayerImpl(),
   lora_scaling(1.0f),
-  fc_props(props::Unit(), props::LoraRank(), props::LoraAlpha()) {
+  fc_props(props::Unit(), props::LoraRank(), props::LoraAlpha(),
+           props::QuantGroupSize(), props::FusedBNEpsilon(),
+           props::FusedBNName(), props::FusedActivation()),
+  weight_type(TensorDim::DataType::FP32) {
   weight_idx.fill(std::numeric_limits<unsigned>::max());
   lora_idx.fill(std::numeric_limits<unsigned>::max());
 }
@@ -88,6 +92,11 @@ void FullyConnectedLayer::finalize(InitLayerContext &context) {
 
   context.setOutputDimensions(output_dims);
 
+  weight_type = context.getWeightDataType();
+  /** weights other than the quantized one are kept in the activation type */
+  const TensorDim::DataType param_type =
+    isQuantized() ? context.getActivationDataType() : weight_type;
+
   /** set weight specifications */
   // @todo : This NCHW format setting is just temporal, it needs to be set by
   // global configuration
@@ -95,19 +104,53 @@ void FullyConnectedLayer::finalize(InitLayerContext &context) {
   /** Bias Dimension : (1, 1, 1, unit) */
   TensorDim bias_dim(
     1, is_nchw ? 1 : unit, 1, is_nchw ? unit : 1,
-    TensorDim::TensorType(context.getFormat(), context.getWeightDataType()),
+    TensorDim::TensorType(context.getFormat(), param_type),
     is_nchw ? 0b0001 : 0b0100);
 
   /** Weight Dimension : (1, 1, in_dim.width(), unit)*/
   TensorDim weight_dim(
     1, is_nchw ? 1 : unit, is_nchw ? in_dim.width() : 1,
     is_nchw ? unit : in_dim.channel(),
-    TensorDim::TensorType(context.getFormat(), context.getWeightDataType()),
+    TensorDim::TensorType(context.getFormat(), param_type),
     is_nchw ? 0b0011 : 0b0101);
 
-  weight_idx[FCParams::weight] = context.requestWeight(
-    weight_dim, weight_initializer, weight_regularizer,
-    weight_regularizer_constant, weight_decay, "weight", true);
+  if (isQuantized()) {
+    NNTR_THROW_IF(!is_nchw, std::invalid_argument)
+      << "quantized fully connected layer supports NCHW only";
+
+    const auto &group_prop = std::get<props::QuantGroupSize>(fc_props);
+    unsigned int group_size =
+      group_prop.empty() ? in_dim.width() : group_prop.get();
+    NNTR_THROW_IF(in_dim.width() % group_size, std::invalid_argument)
+      << "input width: " << in_dim.width()
+      << " is not a multiple of quant_group_size: " << group_size;
+
+    /** int4 weight packs two output channels in a byte */
+    unsigned int packed_unit =
+      weight_type == TensorDim::DataType::QINT4 ? (unit + 1) / 2 : unit;
+    weight_dim = TensorDim(
+      1, 1, in_dim.width(), packed_unit,
+      TensorDim::TensorType(context.getFormat(), TensorDim::DataType::QINT8),
+      0b0011);
+
+    /** Scale Dimension : (1, 1, in_dim.width() / group_size, unit) */
+    TensorDim scale_dim(
+      1, 1, in_dim.width() / group_size, unit,
+      TensorDim::TensorType(context.getFormat(), TensorDim::DataType::FP32),
+      0b0011);
+
+    /** quantized weight is for inference, so it is not trainable */
+    weight_idx[FCParams::weight] = context.requestWeight(
+      weight_dim, Initializer::ZEROS, WeightRegularizer::NONE, 1.0f, 0.0f,
+      "weight", false);
+    weight_idx[FCParams::weight_scale] = context.requestWeight(
+      scale_dim, Initializer::ONES, WeightRegularizer::NONE, 1.0f, 0.0f,
+      "weight_scale", false);
+  } else {
+    weight_idx[FCParams::weight] = context.requestWeight(
+      weight_dim, weight_initializer, weight_regularizer,
+      weight_regularizer_constant, weight_decay, "weight", true);
+  }
 
   if (disable_bias.empty() || disable_bias.get() == false) {
     weight_idx[FCParams::bias] =
@@ -122,28 +165,28 @@ void FullyConnectedLayer::finalize(InitLayerContext &context) {
     TensorDim loraA_dim(
       1, is_nchw ? 1 : lora_rank, is_nchw ? in_dim.width() : 1,
       is_nchw ? lora_rank : in_dim.channel(),
-      TensorDim::TensorType(context.getFormat(), context.getWeightDataType()),
+      TensorDim::TensorType(context.getFormat(), param_type),
       is_nchw ? 0b0011 : 0b0101);
 
     /** loraB Dimension : (1, 1, lora_rank, unit) */
     TensorDim loraB_dim(
       1, is_nchw ? 1 : unit, is_nchw ? lora_rank : 1,
       is_nchw ? unit : lora_rank,
-      TensorDim::TensorType(context.getFormat(), context.getWeightDataType()),
+      TensorDim::TensorType(context.getFormat(), param_type),
       is_nchw ? 0b0011 : 0b0101);
 
     /** loraTmp Dimension : (B, 1, in_dim.height(), lora_rank) */
     TensorDim loraTmp_dim(
       in_dim.batch(), is_nchw ? 1 : lora_rank, is_nchw ? in_dim.height() : 1,
       is_nchw ? lora_rank : in_dim.width(),
-      TensorDim::TensorType(context.getFormat(), context.getWeightDataType()),
+      TensorDim::TensorType(context.getFormat(), param_type),
       is_nchw ? 0b1011 : 0b1101);
 
     /** loraTmp Dimension : (B, 1, in_dim.height(), unit) */
     TensorDim loraOut_dim(
       in_dim.batch(), is_nchw ? 1 : unit, is_nchw ? in_dim.height() : 1,
       is_nchw ? unit : in_dim.width(),
-      TensorDim::TensorType(context.getFormat(), context.getWeightDataType()),
+      TensorDim::TensorType(context.getFormat(), param_type),
       is_nchw ? 0b1011 : 0b1101);
 
     lora_idx[LORAParams::loraA] = context.requestWeight(
@@ -162,6 +205,13 @@ void FullyConnectedLayer::finalize(InitLayerContext &context) {
       context.requestTensor(loraOut_dim, "hidden_lora", Initializer::NONE, true,
                             TensorLifespan::FORWARD_FUNC_LIFESPAN);
   }
+
+  /** the bias runs along the width of the output */
+  const bool has_bias = disable_bias.empty() || disable_bias.get() == false;
+  epilogue.finalize(context, output_dims[0], has_bias ? 3 : 0,
+                    std::get<props::FusedBNEpsilon>(fc_props),
+                    std::get<props::FusedBNName>(fc_props),
+                    std::get<props::FusedActivation>(fc_props));
 }
 
 void FullyConnectedLayer::exportTo(
@@ -184,25 +234,47 @@ void FullyConnectedLayer::setBatch(nntrainer::RunLayerContext &context,
   }
 }
 
+/**
+ * @brief hidden = input * dequantize(weight) with the weight-only quantized
+ * gemm, which does not materialize the full precision weight
+ */
+static void quantizedDot(const Tensor &input, const Tensor &weight,
+                         const Tensor &scale, Tensor &hidden,
+                         TensorDim::DataType weight_type) {
+  if (input.getDataType() != TensorDim::DataType::FP32) {
+    /** activation of the other types is computed in full precision */
+    Tensor input32 = input.clone(TensorDim::DataType::FP32);
+    TensorDim hidden32_dim = hidden.getDim();
+    hidden32_dim.setDataType(TensorDim::DataType::FP32);
+    Tensor hidden32(hidden32_dim, true);
+    quantizedDot(input32, weight, scale, hidden32, weight_type);
+    hidden.copyData(hidden32);
+    return;
+  }
+
+  const unsigned int K = input.width();
+  const unsigned int N = hidden.width();
+  const unsigned int M = input.size() / K;
+  const unsigned int group_size = K / scale.height();
+
+  if (weight_type == TensorDim::DataType::QINT4)
+    qgemm_q4(M, N, K, input.getData<float>(), K, weight.getData<uint8_t>(),
+             weight.width(), scale.getData<float>(), N, group_size,
+             hidden.getData<float>(), N);
+  else
+    qgemm_q8(M, N, K, input.getData<float>(), K, weight.getData<int8_t>(),
+             weight.width(), scale.getData<float>(), N, group_size,
+             hidden.getData<float>(), N);
+}
+
 void FullyConnectedLayer::forwarding(RunLayerContext &context, bool training) {
   Tensor &weight = context.getWeight(weight_idx[FCParams::weight]);
   Tensor &hidden_ = context.getOutput(SINGLE_INOUT_IDX);
   Tensor &input_ = context.getInput(SINGLE_INOUT_IDX);
 
-  if (weight.getDataType() == nntrainer::Tdatatype::QINT4 ||
-      weight.getDataType() == nntrainer::Tdatatype::QINT8) {
-    Tdatatype dtype = input_.getDataType();
-
-    Tensor weight_(
-      {{weight.batch(), weight.channel(), weight.height(), weight.width()},
-       {weight.getFormat(), dtype}},
-      true);
-
-    unsigned int axis =
-      context.getWeightObject(weight_idx[FCParams::weight]).getOutputAxis();
-
-    // weight.dequantize(weight_, axis);
-    input_.dot(weight_, hidden_, false, false);
+  if (isQuantized()) {
+    Tensor &scale = context.getWeight(weight_idx[FCParams::weight_scale]);
+    quantizedDot(input_, weight, scale, hidden_, weight_type);
   } else {
     input_.dot(weight, hidden_, false, false);
   }
@@ -219,8 +291,14 @@ void FullyConnectedLayer::forwarding(RunLayerContext &context, bool training) {
     hidden_.add_i(hidden_out_lora);
   }
 
-  if (auto &disable_bias = std::get<props::DisableBias>(*layer_impl_props);
-      disable_bias.empty() || disable_bias.get() == false) {
+  auto &disable_bias = std::get<props::DisableBias>(*layer_impl_props);
+  bool has_bias = disable_bias.empty() || disable_bias.get() == false;
+  if (!epilogue.empty()) {
+    epilogue.prepare(context, has_bias
+                                ? &context.getWeight(weight_idx[FCParams::bias])
+                                : nullptr);
+    epilogue.run(hidden_);
+  } else if (has_bias) {
     Tensor &bias = context.getWeight(weight_idx[FCParams::bias]);
     hidden_.add_i(bias);
   }
@@ -230,9 +308,7 @@ void FullyConnectedLayer::incremental_forwarding(RunLayerContext &context,
                                                  unsigned int from,
                                                  unsigned int to,
                                                  bool training) {
-  Tensor w;
-  Tensor &weight = w;
-  context.getWeight(weight, weight_idx[FCParams::weight]);
+  Tensor &weight = context.getWeight(weight_idx[FCParams::weight]);
 
   Tensor &input_ = context.getInput(SINGLE_INOUT_IDX);
   Tensor &hidden_ = context.getOutput(SINGLE_INOUT_IDX);
@@ -255,14 +331,27 @@ void FullyConnectedLayer::incremental_forwarding(RunLayerContext &context,
   hidden_step_dim.batch(1);
   hidden_step_dim.height(to - from);
 
+  auto &disable_bias = std::get<props::DisableBias>(*layer_impl_props);
+  bool has_bias = disable_bias.empty() || disable_bias.get() == false;
+  if (!epilogue.empty()) {
+    epilogue.prepare(context, has_bias
+                                ? &context.getWeight(weight_idx[FCParams::bias])
+                                : nullptr);
+  }
+
   // @todo make it parallelized with batch axis
   for (unsigned int b = 0; b < hidden_.batch(); ++b) {
     Tensor input_step = input_.getSharedDataTensor(
-      input_step_dim, b * hidden_dim.getFeatureLen(), true);
+      input_step_dim, b * input_dim.getFeatureLen(), true);
     Tensor hidden_step = hidden_.getSharedDataTensor(
       hidden_step_dim, b * hidden_dim.getFeatureLen(), true);
 
-    input_step.dot(weight, hidden_step, false, false);
+    if (isQuantized())
+      quantizedDot(input_step, weight,
+                   context.getWeight(weight_idx[FCParams::weight_scale]),
+                   hidden_step, weight_type);
+    else
+      input_step.dot(weight, hidden_step, false, false);
 
     if (!std::get<props::LoraRank>(fc_props).empty()) {
       Tensor &loraA = context.getWeight(lora_idx[LORAParams::loraA]);
@@ -278,8 +367,9 @@ void FullyConnectedLayer::incremental_forwarding(RunLayerContext &context,
       hidden_step.add_i(hidden_out_lora);
     }
 
-    if (auto &disable_bias = std::get<props::DisableBias>(*layer_impl_props);
-        disable_bias.empty() || disable_bias.get() == false) {
+    if (!epilogue.empty()) {
+      epilogue.run(hidden_step);
+    } else if (has_bias) {
       Tensor &bias = context.getWeight(weight_idx[FCParams::bias]);
       hidden_step.add_i(bias);
     }
@@ -287,6 +377,9 @@ void FullyConnectedLayer::incremental_forwarding(RunLayerContext &context,
 }
 
 void FullyConnectedLayer::calcDerivative(RunLayerContext &context) {
+  NNTR_THROW_IF(isQuantized(), std::runtime_error)
+    << "quantized fully connected layer does not support backwarding";
+
   Tensor &weight = context.getWeight(weight_idx[FCParams::weight]);
 
   const Tensor &derivative_ = context.getIncomingDerivative(SINGLE_INOUT_IDX);
@@ -303,6 +396,8 @@ void FullyConnectedLayer::calcDerivative(RunLayerContext &context) {
 }
 
 void FullyConnectedLayer::calcGradient(RunLayerContext &context) {
+  NNTR_THROW_IF(isQuantized(), std::runtime_error)
+    << "quantized fully connected layer does not support backwarding";
 
   /** (default) calcGradient - compute gradient of weight and bias */
   if (std::get<props::LoraRank>(fc_props).empty()) {
@@ -16,6 +16,7 @@
 #ifdef __cplusplus
 
 #include <common_properties.h>
+#include <fused_epilogue.h>
 #include <layer_impl.h>
 
 namespace nntrainer {
@@ -112,15 +113,31 @@ public:
   inline static const std::string type = "fully_connected";
 
 private:
+  /**
+   * @brief check if the weight is quantized
+   *
+   * @return true if the weight is QINT8 or QINT4, else false
+   */
+  bool isQuantized() const {
+    return weight_type == TensorDim::DataType::QINT8 ||
+           weight_type == TensorDim::DataType::QINT4;
+  }
+
   float lora_scaling;
-  std::tuple<props::Unit, props::LoraRank, props::LoraAlpha>
+  std::tuple<props::Unit, props::LoraRank, props::LoraAlpha,
+             props::QuantGroupSize, props::FusedBNEpsilon, props::FusedBNName,
+             props::FusedActivation>
     fc_props;                             /**< fc layer properties :
                                                 unit - number of output neurons,
                                                 lora_rank - rank of lora (optional)
                                                 lora_scaling - scaling factor of LoRA apply, i.e.,
-                                             lora_scaling = alpha / lora_rank */
-  std::array<unsigned int, 2> weight_idx; /**< indices of the weights */
+                                             lora_scaling = alpha / lora_rank
+                                                quant_group_size - input features sharing a scale
+                                                fused_bn_epsilon, fused_bn_name, fused_activation - layers fused for inference */
+  TensorDim::DataType weight_type;        /**< data type of the weight */
+  std::array<unsigned int, 3> weight_idx; /**< indices of the weights */
   std::array<unsigned int, 4> lora_idx;   /**< indices of the lora weights */
+  FusedEpilogue epilogue; /**< layers fused into the output for inference */
 };
 } // namespace nntrainer
 
@@ -0,0 +1,242 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file   fused_epilogue.cpp
+ * @date   18 October 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @bug    No known bugs except for NYI items
+ * @brief  Epilogue of the batch normalization and the activation fused into
+ * a convolution or fully connected layer for inference
+ *
+ */
+
+#include <cmath>
+#include <cstring>
+
+#include <acti_func.h>
+#include <fused_epilogue.h>
+#include <layer_context.h>
+#include <nntrainer_error.h>
+
+namespace nntrainer {
+
+enum FusedBNParams { mu, var, gamma, beta };
+
+/**
+ * @brief     out = act(out * scale + shift) for each channel in a single pass
+ *
+ * @param[in,out] out output of (outer, channels, inner)
+ * @param[in] scale scale of each channel, nullptr if 1
+ * @param[in] shift shift of each channel, nullptr if 0
+ * @param[in] outer number of the runs of channels
+ * @param[in] channels number of the channels
+ * @param[in] inner number of the elements of a channel in a run
+ * @param[in] act_fn elementwise activation
+ */
+template <typename T, typename Act>
+static void scale_shift_act(T *out, const T *scale, const T *shift,
+                            size_t outer, size_t channels, size_t inner,
+                            Act act_fn) {
+  for (size_t o = 0; o < outer; ++o) {
+    for (size_t c = 0; c < channels; ++c) {
+      const T s = scale ? scale[c] : static_cast<T>(1);
+      const T t = shift ? shift[c] : static_cast<T>(0);
+      for (size_t i = 0; i < inner; ++i, ++out)
+        *out = act_fn(static_cast<T>(*out * s + t));
+    }
+  }
+}
+
+FusedEpilogue::FusedEpilogue() :
+  has_bn(false),
+  act(ActivationType::ACT_NONE),
+  epsilon(0.0f),
+  axis(3),
+  wt_idx({0}) {}
+
+void FusedEpilogue::finalize(InitLayerContext &context,
+                             const TensorDim &out_dim, unsigned int bias_axis,
+                             const props::FusedBNEpsilon &epsilon_,
+                             const props::FusedBNName &bn_name,
+                             const props::FusedActivation &act_) {
+  has_bn = !epsilon_.empty();
+  act = act_.empty() ? ActivationType::ACT_NONE : act_.get();
+
+  NNTR_THROW_IF(!empty() && context.getExecutionMode() !=
+                              ml::train::ExecutionMode::INFERENCE,
+                std::invalid_argument)
+    << context.getName() << ": fused layers are supported for inference only";
+
+  switch (act) {
+  case ActivationType::ACT_NONE:
+  case ActivationType::ACT_RELU:
+  case ActivationType::ACT_SIGMOID:
+  case ActivationType::ACT_SWISH:
+  case ActivationType::ACT_GELU:
+    break;
+  default:
+    NNTR_THROW_IF(true, std::invalid_argument)
+      << context.getName()
+      << ": only relu, sigmoid, swish and gelu can be fused";
+  }
+
+#ifndef ENABLE_FP16
+  NNTR_THROW_IF(!empty() && context.getActivationDataType() ==
+                              TensorDim::DataType::FP16,
+                std::invalid_argument)
+    << "enable-fp16 is not set!";
+#endif
+
+  /** apply() walks the output as (outer, channels, height * width) */
+  NNTR_THROW_IF(!empty() && context.getFormat() != TensorDim::Format::NCHW,
+                std::invalid_argument)
+    << context.getName() << ": fused layers are supported for NCHW only";
+
+  /// @note same as the batch normalization layer fed by the output, or the
+  /// bias alone without it
+  axis = has_bn ? (out_dim.channel() > 1 ? 1 : 3) : (bias_axis ? bias_axis : 3);
+  sources.clear();
+
+  NNTR_THROW_IF(has_bn && bias_axis != 0 && bias_axis != axis &&
+                  out_dim.getTensorDim(bias_axis) > 1,
+                std::invalid_argument)
+    << context.getName()
+    << ": the bias and the statistics of the fused batch normalization run "
+       "along different axes of the output "
+    << out_dim;
+
+  if (!has_bn)
+    return;
+
+  epsilon = epsilon_.get();
+
+  TensorDim dim(context.getFormat(), context.getWeightDataType());
+  dim.setTensorDim(axis, out_dim.getTensorDim(axis));
+
+  /** named after the batch normalization layer if it is known */
+  auto request = [&context, &dim, &bn_name](Initializer init,
+                                            const std::string &name) {
+    if (bn_name.empty())
+      return context.requestWeight(dim, dim, init, WeightRegularizer::NONE,
+                                   1.0f, 0.0f, name, false);
+
+    return context.requestWeight(WeightSpec(
+      dim, dim, init, WeightRegularizer::NONE, 1.0f, 0.0f, 0.0f, false,
+      bn_name.get() + ":" + name, 3, context.getLossScale(),
+      context.getWeightDataType() != TensorDim::DataType::FP32));
+  };
+
+  wt_idx[FusedBNParams::mu] = request(Initializer::ZEROS, "moving_mean");
+  wt_idx[FusedBNParams::var] = request(Initializer::ONES, "moving_variance");
+  wt_idx[FusedBNParams::gamma] = request(Initializer::ONES, "gamma");
+  wt_idx[FusedBNParams::beta] = request(Initializer::ZEROS, "beta");
+}
+
+void FusedEpilogue::prepare(RunLayerContext &context, const Tensor *bias) {
+  std::vector<const Tensor *> inputs;
+  if (has_bn) {
+    for (auto idx : wt_idx)
+      inputs.push_back(&context.getWeight(idx));
+  }
+  if (bias)
+    inputs.push_back(bias);
+
+  auto is_cached = [this, &inputs]() {
+    if (inputs.size() != sources.size())
+      return false;
+    for (unsigned int i = 0; i < inputs.size(); ++i) {
+      if (inputs[i]->bytes() != sources[i].bytes() ||
+          std::memcmp(inputs[i]->getData<char>(), sources[i].getData<char>(),
+                      sources[i].bytes()) != 0)
+        return false;
+    }
+    return true;
+  };
+  if (is_cached())
+    return;
+
+  sources.clear();
+  for (auto input : inputs)
+    sources.push_back(input->clone());
+
+  if (!has_bn) {
+    scale = Tensor();
+    shift = bias ? bias->clone() : Tensor();
+  } else {
+    Tensor &mu_ = context.getWeight(wt_idx[FusedBNParams::mu]);
+    Tensor &var_ = context.getWeight(wt_idx[FusedBNParams::var]);
+    Tensor &gamma_ = context.getWeight(wt_idx[FusedBNParams::gamma]);
+    Tensor &beta_ = context.getWeight(wt_idx[FusedBNParams::beta]);
+
+    /** scale = gamma / sqrt(var + eps), shift = (bias - mu) * scale + beta */
+    scale = var_.add(epsilon);
+    scale.pow_i(-0.5f);
+    scale.multiply(gamma_, scale);
+
+    shift = mu_.multiply(-1.0f);
+    if (bias)
+      shift.add(*bias, shift);
+    shift.multiply(scale, shift);
+    shift.add(beta_, shift);
+  }
+
+  /** run() reads them in the data type of the output */
+  auto out_type = context.getOutput(0).getDataType();
+  if (!scale.empty() && scale.getDataType() != out_type)
+    scale = scale.clone(out_type);
+  if (!shift.empty() && shift.getDataType() != out_type)
+    shift = shift.clone(out_type);
+}
+
+void FusedEpilogue::run(Tensor &output) const {
+  if (output.getDataType() == TensorDim::DataType::FP32) {
+    apply<float>(output);
+  } else if (output.getDataType() == TensorDim::DataType::FP16) {
+#ifdef ENABLE_FP16
+    apply<_FP16>(output);
+#else
+    throw std::invalid_argument("enable-fp16 is not set!");
+#endif
+  } else {
+    throw std::runtime_error("Not supported datatype");
+  }
+}
+
+template <typename T> void FusedEpilogue::apply(Tensor &output) const {
+  if (scale.empty() && shift.empty() && act == ActivationType::ACT_NONE)
+    return;
+
+  const size_t channels =
+    !scale.empty() ? scale.size() : (!shift.empty() ? shift.size() : 1);
+  const size_t inner = axis == 1 ? output.height() * output.width() : 1;
+  const size_t outer = output.size() / (channels * inner);
+  T *out = output.getData<T>();
+  const T *s = scale.empty() ? nullptr : scale.getData<T>();
+  const T *t = shift.empty() ? nullptr : shift.getData<T>();
+
+  switch (act) {
+  case ActivationType::ACT_RELU:
+    scale_shift_act(out, s, t, outer, channels, inner,
+                    [](T x) { return ActiFunc::relu<T>(x); });
+    break;
+  case ActivationType::ACT_SIGMOID:
+    scale_shift_act(out, s, t, outer, channels, inner,
+                    [](T x) { return ActiFunc::sigmoid<T>(x); });
+    break;
+  case ActivationType::ACT_SWISH:
+    scale_shift_act(out, s, t, outer, channels, inner, [](T x) {
+      return static_cast<T>(x * ActiFunc::sigmoid<T>(x));
+    });
+    break;
+  case ActivationType::ACT_GELU:
+    scale_shift_act(out, s, t, outer, channels, inner, [](T x) {
+      float f = static_cast<float>(x);
+      return static_cast<T>(0.5f * f * (1.0f + std::erf(f * M_SQRT1_2)));
+    });
+    break;
+  default:
+    scale_shift_act(out, s, t, outer, channels, inner, [](T x) { return x; });
+    break;
+  }
+}
+
+} // namespace nntrainer
@@ -0,0 +1,110 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file   fused_epilogue.h
+ * @date   18 October 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @bug    No known bugs except for NYI items
+ * @brief  Epilogue of the batch normalization and the activation fused into
+ * a convolution or fully connected layer for inference
+ *
+ */
+
+#ifndef __FUSED_EPILOGUE_H__
+#define __FUSED_EPILOGUE_H__
+#ifdef __cplusplus
+
+#include <array>
+#include <vector>
+
+#include <common_properties.h>
+#include <tensor.h>
+
+namespace nntrainer {
+
+class InitLayerContext;
+class RunLayerContext;
+
+/**
+ * @class   FusedEpilogue
+ * @brief   Applies the bias, the fused batch normalization and the fused
+ * activation to the output of the layer in place
+ * @note    The batch normalization is folded to out * scale + shift per
+ * channel. The scale and the shift are cached and computed again only when
+ * the statistics or the bias change, e.g. by loading the weights, so the
+ * weights are kept as they are loaded.
+ */
+class FusedEpilogue {
+public:
+  /**
+   * @brief Construct a new FusedEpilogue object which does nothing
+   */
+  FusedEpilogue();
+
+  /**
+   * @brief Request the weights of the fused batch normalization in the order
+   * of the batch normalization layer and set the fused activation
+   *
+   * @param context context of the layer after its own weights are requested
+   * @param out_dim output dimension of the layer
+   * @param bias_axis axis of the output the bias of the layer runs along, 0
+   * if the bias is disabled
+   * @param epsilon epsilon of the fused batch normalization, empty if none
+   * @param bn_name name of the fused batch normalization, the weights are
+   * named after the layer itself if empty
+   * @param act fused activation, empty if none
+   * @throw std::invalid_argument if the activation can not be fused, the
+   * output is not NCHW, or the bias and the statistics of the batch
+   * normalization run along different axes
+   */
+  void finalize(InitLayerContext &context, const TensorDim &out_dim,
+                unsigned int bias_axis, const props::FusedBNEpsilon &epsilon,
+                const props::FusedBNName &bn_name,
+                const props::FusedActivation &act);
+
+  /**
+   * @brief check if anything is fused into the layer
+   *
+   * @return true if nothing is fused
+   */
+  bool empty() const { return !has_bn && act == ActivationType::ACT_NONE; }
+
+  /**
+   * @brief Get the scale and the shift ready for run(), the bias is folded
+   * into the shift. They are computed again only if the statistics or the
+   * bias differ from the last call
+   *
+   * @param context context of the layer
+   * @param bias bias of the layer, nullptr if the bias is disabled
+   */
+  void prepare(RunLayerContext &context, const Tensor *bias);
+
+  /**
+   * @brief Apply the epilogue to the output in place in a single pass. Can be
+   * called on the slices of the output concurrently after prepare()
+   *
+   * @param output output of the layer or a batch slice of it
+   */
+  void run(Tensor &output) const;
+
+private:
+  /**
+   * @brief Apply the epilogue to the output of the data type @a T
+   *
+   * @param output output of the layer or a batch slice of it
+   */
+  template <typename T> void apply(Tensor &output) const;
+
+  bool has_bn;                        /**< batch normalization is fused */
+  ActivationType act;                 /**< fused activation */
+  float epsilon;                      /**< epsilon of the batch normalization */
+  unsigned int axis;                  /**< axis of the channels in the output */
+  std::array<unsigned int, 4> wt_idx; /**< indices of mu, var, gamma, beta */
+  std::vector<Tensor> sources; /**< statistics and bias of the cached scale */
+  Tensor scale;                /**< cached scale, empty if 1 */
+  Tensor shift;                /**< cached shift, empty if 0 */
+};
+
+} // namespace nntrainer
+
+#endif /* __cplusplus */
+#endif /* __FUSED_EPILOGUE_H__ */
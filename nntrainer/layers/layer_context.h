@@ -28,6 +28,7 @@
 namespace nntrainer {
 
 class Var_Grad;
+class KVCacheManager;
 
 /**
  * @class   Layer Context class for all layers
@@ -54,6 +55,7 @@ public:
    * type.
    * @param loss_scale loss scale value for mixed precision training
    * @param mode execution mode.
+   * @param kv_cache_ paged kv cache of the model, nullptr if not used
    */
   InitLayerContext(
     const std::vector<TensorDim> &dim,
@@ -62,7 +64,8 @@ public:
     const float max_norm = 0.0,
     std::array<std::string, 3> tensor_type_ = {"NCHW", "FP32", "FP32"},
     const float loss_scale = 1.0,
-    ml::train::ExecutionMode mode = ml::train::ExecutionMode::TRAIN);
+    ml::train::ExecutionMode mode = ml::train::ExecutionMode::TRAIN,
+    KVCacheManager *kv_cache_ = nullptr);
   /**
    * @brief   get Tensor Format of Layer
    *
@@ -108,6 +111,13 @@ public:
    */
   const ml::train::ExecutionMode &getExecutionMode() const { return mode; }
 
+  /**
+   * @brief   get the paged kv cache of the model
+   *
+   * @return KVCacheManager* kv cache, nullptr if the model has no kv cache
+   */
+  KVCacheManager *getKVCacheManager() const { return kv_cache; }
+
   /**
    * @brief Get the number of inputs for the layer
    *
@@ -354,6 +364,54 @@ public:
    */
   const std::vector<VarGradSpecV2> &getOutSpecs() const;
 
+  /**
+   * @brief request the input @a idx to be placed in the output 0 at @a offset,
+   * so that its producer writes it in place instead of the layer copying it
+   * @note the placement is a hint which takes effect only while both tensors
+   * have batch 1, the layer has to check if the input is at the place before
+   * skipping the copy
+   *
+   * @param idx index of the input
+   * @param offset elementwise offset in a sample of the output
+   */
+  void requestInputPlacement(unsigned int idx, unsigned int offset) {
+    input_placements.emplace_back(idx, offset);
+  }
+
+  /**
+   * @brief request the output @a idx to be placed in the input 0 at @a offset,
+   * so that the output is a part of the input instead of a copy
+   * @note the placement is a hint which takes effect only while both tensors
+   * have batch 1, the layer has to check if the output is at the place before
+   * skipping the copy
+   *
+   * @param idx index of the output
+   * @param offset elementwise offset in a sample of the input
+   */
+  void requestOutputPlacement(unsigned int idx, unsigned int offset) {
+    output_placements.emplace_back(idx, offset);
+  }
+
+  /**
+   * @brief Get the placements of the inputs
+   *
+   * @return pairs of the input index and the offset in the output
+   */
+  const std::vector<std::pair<unsigned int, unsigned int>> &
+  getInputPlacements() const {
+    return input_placements;
+  }
+
+  /**
+   * @brief Get the placements of the outputs
+   *
+   * @return pairs of the output index and the offset in the input
+   */
+  const std::vector<std::pair<unsigned int, unsigned int>> &
+  getOutputPlacements() const {
+    return output_placements;
+  }
+
   /**
    * @brief Validate the context
    *
@@ -407,6 +465,10 @@ private:
   float clip_by_global_norm; /**< max norm value for clip by norm */
 
   std::vector<VarGradSpecV2> output_specs; /**< Specification for the output */
+  std::vector<std::pair<unsigned int, unsigned int>>
+    input_placements; /**< placements of the inputs in the output */
+  std::vector<std::pair<unsigned int, unsigned int>>
+    output_placements; /**< placements of the outputs in the input */
   std::vector<WeightSpec> weights_spec;    /**< Specification for the weights */
   std::vector<TensorSpec>
     tensors_spec; /**< Specification for the var_grad (trainable/non-trainable
@@ -419,6 +481,7 @@ private:
   std::array<std::string, 3> tensor_type;
   float loss_scale; /**< loss_scale value */
   ml::train::ExecutionMode mode;
+  KVCacheManager *kv_cache; /**< paged kv cache of the model */
 };
 
 /**
@@ -727,6 +790,33 @@ public:
    */
   bool isGradientLastAccess(unsigned int idx) const;
 
+  /**
+   * @brief Mark the gradient of the weight as row-sparse
+   * @note only the given rows of the gradient are valid, see
+   * Var_Grad::setGradientRows()
+   *
+   * @param idx index
+   * @param rows sorted unique rows written to the gradient
+   */
+  void setWeightGradientRows(unsigned int idx, std::vector<unsigned int> rows);
+
+  /**
+   * @brief check if the gradient of the weight is row-sparse
+   *
+   * @param idx index
+   * @return bool true if only some rows of the gradient are valid
+   */
+  bool isWeightGradientRowSparse(unsigned int idx) const;
+
+  /**
+   * @brief Get the valid rows of the row-sparse gradient of the weight
+   *
+   * @param idx index
+   * @return const std::vector<unsigned int>& sorted unique rows
+   */
+  const std::vector<unsigned int> &
+  getWeightGradientRows(unsigned int idx) const;
+
   /**
    * @brief check if the gradient is to be clipped by global norm
    *
@@ -933,6 +1023,20 @@ public:
     }
   }
 
+  /**
+   * @brief   set the paged kv cache of the model
+   *
+   * @param kv_cache_ kv cache, nullptr if the model has no kv cache
+   */
+  void setKVCacheManager(KVCacheManager *kv_cache_) { kv_cache = kv_cache_; }
+
+  /**
+   * @brief   get the paged kv cache of the model
+   *
+   * @return KVCacheManager* kv cache, nullptr if the model has no kv cache
+   */
+  KVCacheManager *getKVCacheManager() { return kv_cache; }
+
   /**
    * @brief   set Output Zero Flag.
    *
@@ -951,6 +1055,7 @@ private:
   bool is_inplace;  /**< if the layer is expected to run in-place */
   float loss_scale; /**< loss_scale of the layer */
   bool restoreData; /**< reset output for mixed precsion */
+  KVCacheManager *kv_cache = nullptr; /**< paged kv cache of the model */
 
   std::vector<Weight *> weights;   /**< weights of the layer */
   std::vector<Var_Grad *> inputs;  /**< inputs of the layer */
@@ -586,7 +586,8 @@ void LayerNode::clearOptVar() {
  */
 InitLayerContext LayerNode::finalize(const std::vector<TensorDim> &input_dims,
                                      std::array<std::string, 3> tensor_type,
-                                     ml::train::ExecutionMode mode) {
+                                     ml::train::ExecutionMode mode,
+                                     KVCacheManager *kv_cache) {
   // auto get_tensor_datatype = [](const std::string ty) -> TensorDim::DataType
   // { 			       return from_string(ty);
   // };
@@ -690,7 +691,7 @@ InitLayerContext LayerNode::finalize(const std::vector<TensorDim> &input_dims,
 
   auto context = InitLayerContext(
     actual_input_dims, out_info, getInPlaceType() != InPlaceType::NONE,
-    getName(), scope, max_norm, tensor_type, loss_scale, mode);
+    getName(), scope, max_norm, tensor_type, loss_scale, mode, kv_cache);
 
   layer->finalize(context);
 
@@ -716,8 +717,8 @@ InitLayerContext LayerNode::finalize(const std::vector<TensorDim> &input_dims,
 /**
  * @brief     Refinalize creating the layer node
  */
-InitLayerContext
-LayerNode::refinalize(const std::vector<TensorDim> &input_dims) {
+InitLayerContext LayerNode::refinalize(const std::vector<TensorDim> &input_dims,
+                                       KVCacheManager *kv_cache) {
   std::vector<TensorDim> actual_input_dims;
   auto &prop_dims = std::get<std::vector<props::InputShape>>(*layer_node_props);
   auto &prop_in_layers =
@@ -781,9 +782,10 @@ LayerNode::refinalize(const std::vector<TensorDim> &input_dims) {
     out_info.push_back(true);
   }
 
-  auto context = InitLayerContext(actual_input_dims, out_info,
-                                  getInPlaceType() != InPlaceType::NONE,
-                                  getName(), scope, max_norm);
+  auto context = InitLayerContext(
+    actual_input_dims, out_info, getInPlaceType() != InPlaceType::NONE,
+    getName(), scope, max_norm, {"NCHW", "FP32", "FP32"}, 1.0,
+    ml::train::ExecutionMode::TRAIN, kv_cache);
 
   layer->finalize(context);
 
@@ -954,10 +956,12 @@ void LayerNode::configureRunContext(const std::vector<Weight *> &weights,
                                     const std::vector<Var_Grad *> &inputs,
                                     const std::vector<Var_Grad *> &outputs,
                                     const std::vector<Var_Grad *> &tensors,
-                                    float loss_scale) {
+                                    float loss_scale,
+                                    KVCacheManager *kv_cache) {
   run_context = std::make_unique<RunLayerContext>(
     getName(), getTrainable(), 0.0f, getInPlaceType() != InPlaceType::NONE,
     loss_scale, false, weights, inputs, outputs, tensors);
+  run_context->setKVCacheManager(kv_cache);
 }
 
 /**
@@ -270,7 +270,8 @@ public:
   InitLayerContext
   finalize(const std::vector<TensorDim> &input_dims = {},
            std::array<std::string, 3> tensor_type = {"NCHW", "FP32", "FP32"},
-           ml::train::ExecutionMode mode = ml::train::ExecutionMode::TRAIN);
+           ml::train::ExecutionMode mode = ml::train::ExecutionMode::TRAIN,
+           KVCacheManager *kv_cache = nullptr);
 
   /**
    * @brief     Refinalize creating the layer node
@@ -286,7 +287,8 @@ public:
    * will be made available during execution of the layer with the context.
    * @note configureRunContext() is expected to called right after this.
    */
-  InitLayerContext refinalize(const std::vector<TensorDim> &input_dims = {});
+  InitLayerContext refinalize(const std::vector<TensorDim> &input_dims = {},
+                              KVCacheManager *kv_cache = nullptr);
 
   /**
    * @brief     Forward Propagation of a layer
@@ -365,9 +367,12 @@ public:
    * @brief   Notify that this layer will execute in-place
    *
    * @param val in place state for the layer
+   * @note a layer which does not support in-place may still keep the type it
+   * is initialized with, e.g. RESTRICTING for the layers placing their inputs
+   * or outputs inside one another
    */
   void setInPlaceType(InPlaceType val) {
-    if (val != InPlaceType::NONE && !supportInPlace())
+    if (val != InPlaceType::NONE && val != inplace_type && !supportInPlace())
       throw std::runtime_error("Error setting layer to work in-place");
 
     inplace_type = val;
@@ -844,12 +849,15 @@ public:
    * @param inputs inputs
    * @param outputs outputs
    * @param tensors tensors
+   * @param loss_scale loss scale
+   * @param kv_cache paged kv cache of the model, nullptr if not used
    */
   void configureRunContext(const std::vector<Weight *> &weights,
                            const std::vector<Var_Grad *> &inputs,
                            const std::vector<Var_Grad *> &outputs,
                            const std::vector<Var_Grad *> &tensors,
-                           float loss_scale);
+                           float loss_scale,
+                           KVCacheManager *kv_cache = nullptr);
 
   /**
    * @brief Preset modes for printing summary for the layer
@@ -15,8 +15,10 @@
 #include <algorithm>
 #include <numeric>
 
+#include <blas_interface.h>
 #include <layer_context.h>
 #include <layer_normalization_layer.h>
+#include <nntr_threads.h>
 #include <nntrainer_error.h>
 #include <nntrainer_log.h>
 #include <node_exporter.h>
@@ -36,6 +38,26 @@ enum LNParams {
   temp_normalized_size,
 };
 
+/**
+ * @brief run @a fn for each row, split on the threads. A chunk of rows is
+ * kept large enough to pay off waking up a worker.
+ */
+static void forEachRow(unsigned int rows, unsigned int row_len,
+                       const std::function<void(unsigned int)> &fn) {
+  constexpr unsigned int min_chunk_len = 1u << 15;
+
+  ThreadPool &pool = ThreadPool::Global();
+  const unsigned int num_threads = pool.getNumThreads();
+  const unsigned int grain =
+    std::max((rows + num_threads - 1) / num_threads,
+             (min_chunk_len + row_len - 1) / row_len);
+  pool.parallel_for(0, rows, grain,
+                    [&fn](unsigned int start, unsigned int end, unsigned int) {
+                      for (unsigned int r = start; r < end; ++r)
+                        fn(r);
+                    });
+}
+
 LayerNormalizationLayer::LayerNormalizationLayer() :
   Layer(),
   layer_normalization_props(
@@ -127,8 +149,69 @@ void LayerNormalizationLayer::setProperty(
          std::to_string(values.size());
 }
 
+unsigned int
+LayerNormalizationLayer::fusedRowLength(const Tensor &tensor,
+                                        const Tensor &gamma) const {
+  if (tensor.getDataType() != TensorDim::DataType::FP32 ||
+      gamma.getDataType() != TensorDim::DataType::FP32 ||
+      tensor.getFormat() != TensorDim::Format::NCHW || !tensor.getContiguous())
+    return 0;
+
+  /** normalize axes are sorted, they have to be the last ones */
+  const unsigned int first_axis = TensorDim::MAXDIM - normalize_axes.size();
+  for (unsigned int i = 0; i < normalize_axes.size(); ++i) {
+    if (normalize_axes[i] != first_axis + i)
+      return 0;
+  }
+
+  return gamma.size();
+}
+
+bool LayerNormalizationLayer::fusedForwarding(RunLayerContext &context,
+                                              bool training) {
+  const Tensor &input = context.getInput(SINGLE_INOUT_IDX);
+  const Tensor &gamma = context.getWeight(wt_idx[LNParams::gamma]);
+
+  const unsigned int row_len = fusedRowLength(input, gamma);
+  if (row_len == 0)
+    return false;
+
+  const float epsilon =
+    std::get<props::Epsilon>(layer_normalization_props).get();
+
+  const float *in = input.getData<float>();
+  float *out = context.getOutput(SINGLE_INOUT_IDX).getData<float>();
+  const float *gamma_data = gamma.getData<float>();
+  const float *beta_data =
+    context.getWeight(wt_idx[LNParams::beta]).getData<float>();
+  float *inv_std_dev =
+    context.getTensor(wt_idx[LNParams::inv_std_dev]).getData<float>();
+  /** deviation and variance are only needed by calcDerivative */
+  float *deviation =
+    training ? context.getTensor(wt_idx[LNParams::deviation]).getData<float>()
+             : nullptr;
+  float *variance =
+    training ? context.getTensor(wt_idx[LNParams::variance]).getData<float>()
+             : nullptr;
+
+  forEachRow(input.size() / row_len, row_len, [&](unsigned int r) {
+    const size_t offset = static_cast<size_t>(r) * row_len;
+    const float inv_std =
+      layer_norm(row_len, in + offset, gamma_data, beta_data, epsilon,
+                 out + offset, deviation ? deviation + offset : nullptr);
+    inv_std_dev[r] = inv_std;
+    if (variance)
+      variance[r] = 1.0f / (inv_std * inv_std);
+  });
+
+  return true;
+}
+
 void LayerNormalizationLayer::forwarding(RunLayerContext &context,
                                          bool training) {
+  if (fusedForwarding(context, training))
+    return;
+
   const float epsilon =
     std::get<props::Epsilon>(layer_normalization_props).get();
 
@@ -163,6 +246,9 @@ void LayerNormalizationLayer::incremental_forwarding(RunLayerContext &context,
                                                      unsigned int from,
                                                      unsigned int to,
                                                      bool training) {
+  if (fusedForwarding(context, training))
+    return;
+
   const float epsilon =
     std::get<props::Epsilon>(layer_normalization_props).get();
 
@@ -250,6 +336,34 @@ void LayerNormalizationLayer::calcDerivative(RunLayerContext &context) {
   Tensor &variance = context.getTensor(wt_idx[LNParams::variance]);
   Tensor &inv_std_dev = context.getTensor(wt_idx[LNParams::inv_std_dev]);
 
+  if (const unsigned int row_len = fusedRowLength(incoming_derivative, gamma);
+      row_len != 0 && outgoing_derivative.getContiguous()) {
+    const float *dev = deviation.getData<float>();
+    const float *d_out = incoming_derivative.getData<float>();
+    float *d_in = outgoing_derivative.getData<float>();
+    const float *gamma_data = gamma.getData<float>();
+    const float *inv_std_data = inv_std_dev.getData<float>();
+    const unsigned int rows = incoming_derivative.size() / row_len;
+
+    forEachRow(rows, row_len, [&](unsigned int r) {
+      const size_t offset = static_cast<size_t>(r) * row_len;
+      layer_norm_backward(row_len, d_out + offset, dev + offset, gamma_data,
+                          inv_std_data[r], d_in + offset);
+    });
+
+    if (trainable) {
+      /** d_gamma = sum of d_out * deviation * inv_std over the rows */
+      d_gamma.setZero();
+      float *d_gamma_data = d_gamma.getData<float>();
+      for (unsigned int r = 0; r < rows; ++r) {
+        const size_t offset = static_cast<size_t>(r) * row_len;
+        ele_mul(row_len, d_out + offset, dev + offset, d_gamma_data,
+                inv_std_data[r], 1.0f);
+      }
+    }
+    return;
+  }
+
   Tensor &temp_origin_size =
     context.getTensor(wt_idx[LNParams::temp_origin_size]);
   Tensor &temp_normalized_size =
@@ -132,6 +132,27 @@ private:
              props::BNPARAMS_GAMMA_INIT, props::BNPARAMS_BETA_INIT,
              props::WeightDecay, props::BiasDecay>
     layer_normalization_props;
+
+  /**
+   * @brief length of the rows normalized by the fused kernels, which need
+   * contiguous fp32 rows made of the trailing axes
+   *
+   * @param tensor tensor to normalize or its derivative
+   * @param gamma gamma weight
+   * @return unsigned int length of a row, 0 if the fused kernels do not apply
+   */
+  unsigned int fusedRowLength(const Tensor &tensor, const Tensor &gamma) const;
+
+  /**
+   * @brief forwarding with the fused row-wise kernel, which computes the
+   * statistics and the output of a row in two passes over the row
+   *
+   * @param context context of the layer
+   * @param training true if training
+   * @return true if the fused kernel applied, false if the caller has to
+   * fall back to the tensor operations
+   */
+  bool fusedForwarding(RunLayerContext &context, bool training);
 };
 
 } // namespace nntrainer
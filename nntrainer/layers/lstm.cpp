@@ -42,6 +42,90 @@ enum LSTMParams {
   dropout_mask
 };
 
+/**
+ * @brief apply fn to each pair of the row of the timestep in the batch first
+ * sequence tensor (batch, 1, max_timestep, width) and the row of the step
+ * tensor (batch, 1, 1, width)
+ */
+template <typename F>
+static void forEachTimestepRow(const Tensor &sequence, const Tensor &step,
+                               const unsigned int timestep,
+                               const unsigned int max_timestep, F &&fn) {
+  const unsigned int width = step.width();
+  TensorDim row_dim({width}, step.getTensorType());
+
+  for (unsigned int b = 0; b < step.batch(); ++b) {
+    Tensor sequence_row = sequence.getSharedDataTensor(
+      row_dim, (b * max_timestep + timestep) * width);
+    Tensor step_row = step.getSharedDataTensor(row_dim, b * width);
+    fn(sequence_row, step_row);
+  }
+}
+
+/**
+ * @brief gather the rows of the timestep from the sequence tensor
+ */
+static void getTimestep(const Tensor &sequence, Tensor &step,
+                        const unsigned int timestep,
+                        const unsigned int max_timestep) {
+  forEachTimestepRow(sequence, step, timestep, max_timestep,
+                     [](Tensor &from, Tensor &to) { to.copyData(from); });
+}
+
+/**
+ * @brief scatter the rows of the step tensor to the timestep of the sequence
+ * tensor
+ */
+static void setTimestep(Tensor &sequence, const Tensor &step,
+                        const unsigned int timestep,
+                        const unsigned int max_timestep) {
+  forEachTimestepRow(sequence, step, timestep, max_timestep,
+                     [](Tensor &to, Tensor &from) { to.copyData(from); });
+}
+
+/**
+ * @brief accumulate the rows of the step tensor to the timestep of the
+ * sequence tensor
+ */
+static void addTimestep(Tensor &sequence, const Tensor &step,
+                        const unsigned int timestep,
+                        const unsigned int max_timestep) {
+  forEachTimestepRow(sequence, step, timestep, max_timestep,
+                     [](Tensor &to, Tensor &from) { to.add_i(from); });
+}
+
+/**
+ * @brief run @a fn on the chunks [start, start + len) of the batch, split on
+ * the threads. A chunk is kept large enough to pay off waking up a worker.
+ *
+ * @param batch_size number of samples
+ * @param row_cost number of multiply-adds per sample
+ * @param fn callback for each chunk
+ */
+static void
+forEachBatchChunk(unsigned int batch_size, size_t row_cost,
+                  const std::function<void(unsigned int, unsigned int)> &fn) {
+  constexpr size_t min_chunk_cost = 1u << 15;
+
+  ThreadPool &pool = ThreadPool::Global();
+  const unsigned int num_threads = pool.getNumThreads();
+  const unsigned int grain = std::max<size_t>(
+    (batch_size + num_threads - 1) / num_threads,
+    (min_chunk_cost + row_cost - 1) / std::max<size_t>(row_cost, 1));
+  pool.parallel_for(0, batch_size, grain,
+                    [&fn](unsigned int start, unsigned int end, unsigned int) {
+                      fn(start, end - start);
+                    });
+}
+
+/**
+ * @note The input projection of every timestep of every sample is computed by
+ * a single gemm, and the recurrence advances all the samples of the batch
+ * together, so each timestep runs a (batch x unit) x (unit x 4 unit) gemm
+ * instead of a gemv per sample. The rows of the timestep are gathered into
+ * contiguous step tensors since dot does not take the leading dimension.
+ * The gemms and the gate math are split over the batch on the thread pool.
+ */
 void LSTMLayer::forwardingBatchFirstLSTM(
   unsigned int NUM_GATE, const unsigned int batch_size,
   const unsigned int feature_size, const bool disable_bias,
@@ -55,59 +139,66 @@ void LSTMLayer::forwardingBatchFirstLSTM(
   hidden_state_.setZero();
   cell_state_.setZero();
   TensorDim::TensorType tensor_type = weight_ih.getTensorType();
-  TensorDim input_tensor_dim({feature_size}, tensor_type);
-  TensorDim unit_tensor_dim({unit}, tensor_type);
-  TensorDim num_gate_unit_tensor_dim({NUM_GATE * unit}, tensor_type);
 
-  for (unsigned int batch = 0; batch < batch_size; ++batch) {
-    const Tensor input_sample = input_.getBatchSlice(batch, 1);
-    Tensor hidden_state_sample = hidden_state_.getBatchSlice(batch, 1);
-    Tensor cell_state_sample = cell_state_.getBatchSlice(batch, 1);
-    Tensor ifgo_sample = ifgo_.getBatchSlice(batch, 1);
+  forEachBatchChunk(batch_size,
+                    static_cast<size_t>(max_timestep) * feature_size *
+                      NUM_GATE * unit,
+                    [&](unsigned int start, unsigned int len) {
+                      Tensor ifgo_rows = ifgo_.getBatchSlice(start, len);
+                      input_.getBatchSlice(start, len).dot(weight_ih,
+                                                           ifgo_rows);
+                    });
+
+  Tensor prev_hidden_state(batch_size, 1, 1, unit, tensor_type);
+  Tensor prev_cell_state(batch_size, 1, 1, unit, tensor_type);
+  Tensor hidden_state(batch_size, 1, 1, unit, tensor_type);
+  Tensor cell_state(batch_size, 1, 1, unit, tensor_type);
+  Tensor ifgo(batch_size, 1, 1, NUM_GATE * unit, tensor_type);
+  prev_hidden_state.setZero();
+  prev_cell_state.setZero();
+
+  for (unsigned int t = 0; t < max_timestep; ++t) {
+    const unsigned int timestep = reverse ? max_timestep - 1 - t : t;
+
+    getTimestep(ifgo_, ifgo, timestep, max_timestep);
+    forEachBatchChunk(
+      batch_size, static_cast<size_t>(NUM_GATE) * unit * unit,
+      [&](unsigned int start, unsigned int len) {
+        Tensor ifgo_rows = ifgo.getBatchSlice(start, len);
+        if (t) {
+          prev_hidden_state.getBatchSlice(start, len).dot(
+            weight_hh, ifgo_rows, false, false, 1.0f);
+        }
+        if (!disable_bias) {
+          if (integrate_bias) {
+            ifgo_rows.add_i(bias_h);
+          } else {
+            ifgo_rows.add_i(bias_ih);
+            ifgo_rows.add_i(bias_hh);
+          }
+        }
 
-    for (unsigned int t = 0; t < max_timestep; ++t) {
-      Tensor input = input_sample.getSharedDataTensor(
-        input_tensor_dim, (reverse ? max_timestep - 1 - t : t) * feature_size);
+        Tensor hidden_state_rows = hidden_state.getBatchSlice(start, len);
+        Tensor cell_state_rows = cell_state.getBatchSlice(start, len);
+        forwardLSTMGate(len, unit, acti_func, recurrent_acti_func,
+                        prev_cell_state.getBatchSlice(start, len),
+                        hidden_state_rows, cell_state_rows, ifgo_rows);
+      });
+
+    if (enable_dropout) {
+      forEachTimestepRow(mask_, hidden_state, timestep, max_timestep,
+                         [dropout_rate](Tensor &mask, Tensor &hidden_state) {
+                           mask.dropout_mask(dropout_rate);
+                           hidden_state.multiply_i(mask);
+                         });
+    }
 
-      Tensor prev_hidden_state = Tensor(
-        "prev_hidden_state", weight_ih.getFormat(), weight_ih.getDataType());
+    setTimestep(hidden_state_, hidden_state, timestep, max_timestep);
+    setTimestep(cell_state_, cell_state, timestep, max_timestep);
+    setTimestep(ifgo_, ifgo, timestep, max_timestep);
 
-      if (!t) {
-        prev_hidden_state = Tensor(unit, tensor_type);
-        prev_hidden_state.setZero();
-      } else {
-        prev_hidden_state = hidden_state_sample.getSharedDataTensor(
-          unit_tensor_dim, (reverse ? (max_timestep - t) : (t - 1)) * unit);
-      }
-      Tensor hidden_state = hidden_state_sample.getSharedDataTensor(
-        unit_tensor_dim, (reverse ? max_timestep - 1 - t : t) * unit);
-      Tensor prev_cell_state;
-      if (!t) {
-        prev_cell_state = Tensor(unit, tensor_type);
-        prev_cell_state.setZero();
-      } else {
-        prev_cell_state = cell_state_sample.getSharedDataTensor(
-          unit_tensor_dim, (reverse ? (max_timestep - t) : (t - 1)) * unit);
-      }
-      Tensor cell_state = cell_state_sample.getSharedDataTensor(
-        unit_tensor_dim, (reverse ? max_timestep - 1 - t : t) * unit);
-      Tensor ifgo = ifgo_sample.getSharedDataTensor(
-        num_gate_unit_tensor_dim,
-        (reverse ? max_timestep - 1 - t : t) * NUM_GATE * unit);
-
-      forwardLSTM(1, unit, disable_bias, integrate_bias, acti_func,
-                  recurrent_acti_func, input, prev_hidden_state,
-                  prev_cell_state, hidden_state, cell_state, weight_ih,
-                  weight_hh, bias_h, bias_ih, bias_hh, ifgo);
-
-      if (enable_dropout) {
-        Tensor mask_sample = mask_.getBatchSlice(batch, 1);
-        Tensor mask =
-          mask_sample.getSharedDataTensor(unit_tensor_dim, t * unit);
-        mask.dropout_mask(dropout_rate);
-        hidden_state.multiply_i(mask);
-      }
-    }
+    std::swap(prev_hidden_state, hidden_state);
+    std::swap(prev_cell_state, cell_state);
   }
 }
 
@@ -141,8 +232,6 @@ void LSTMLayer::calcGradientBatchFirstLSTM(
 
   TensorDim::TensorType tensor_type = weight_hh.getTensorType();
   TensorDim unit_tensor_dim({unit}, tensor_type);
-  TensorDim feature_size_tensor_dim({feature_size}, tensor_type);
-  TensorDim num_gate_tensor_dim({NUM_GATE * unit}, tensor_type);
 
   if (return_sequences && !bidirectional && !reverse) {
     if (incoming_derivative.getDataType() == TensorDim::DataType::FP32) {
@@ -183,219 +272,81 @@ void LSTMLayer::calcGradientBatchFirstLSTM(
     d_hidden_state_.multiply_i(mask_);
   }
 
-  auto workers = ParallelBatch(batch_size);
-
-  if (workers.getNumWorkers() > 1) {
-
-    TensorDim weight_ih_d = d_weight_ih.getDim();
-    TensorDim weight_hh_d = d_weight_hh.getDim();
-
-    TensorDim bias_ih_d = d_bias_ih.getDim();
-    TensorDim bias_hh_d = d_bias_hh.getDim();
-    TensorDim bias_h_d = d_bias_h.getDim();
-
-    weight_ih_d.batch(workers.getNumWorkers());
-    weight_hh_d.batch(workers.getNumWorkers());
-    bias_ih_d.batch(workers.getNumWorkers());
-    bias_hh_d.batch(workers.getNumWorkers());
-    bias_h_d.batch(workers.getNumWorkers());
-
-    Tensor sub_d_weight_ih = Tensor(weight_ih_d);
-    Tensor sub_d_weight_hh = Tensor(weight_hh_d);
-    Tensor sub_d_bias_ih = Tensor(bias_ih_d);
-    Tensor sub_d_bias_hh = Tensor(bias_hh_d);
-    Tensor sub_d_bias_h = Tensor(bias_h_d);
-
-    sub_d_weight_ih.setZero();
-    sub_d_weight_hh.setZero();
-    sub_d_bias_ih.setZero();
-    sub_d_bias_hh.setZero();
-    sub_d_bias_h.setZero();
-
-    auto batch_job = [&](unsigned int s, unsigned int e, unsigned int pid,
-                         void *user_data) {
-      for (unsigned int batch = s; batch < e; ++batch) {
-        const Tensor input_sample = input_.getBatchSlice(batch, 1);
-
-        const Tensor hidden_state_sample =
-          hidden_state_.getBatchSlice(batch, 1);
-        Tensor d_hidden_state_sample = d_hidden_state_.getBatchSlice(batch, 1);
-        const Tensor cell_state_sample = cell_state_.getBatchSlice(batch, 1);
-        Tensor d_cell_state_sample = d_cell_state_.getBatchSlice(batch, 1);
-
-        const Tensor ifgo_sample = ifgo_.getBatchSlice(batch, 1);
-        Tensor d_ifgo_sample = d_ifgo_.getBatchSlice(batch, 1);
-
-        Tensor input;
-        Tensor prev_hidden_state;
-        Tensor d_prev_hidden_state;
-        Tensor prev_cell_state;
-        Tensor d_prev_cell_state;
-        Tensor d_hidden_state;
-        Tensor cell_state;
-        Tensor d_cell_state;
-
-        Tensor p_d_weight_ih = sub_d_weight_ih.getBatchSlice(pid, 1);
-        Tensor p_d_weight_hh = sub_d_weight_hh.getBatchSlice(pid, 1);
-        Tensor p_d_bias_ih = sub_d_bias_ih.getBatchSlice(pid, 1);
-        Tensor p_d_bias_hh = sub_d_bias_hh.getBatchSlice(pid, 1);
-        Tensor p_d_bias_h = sub_d_bias_h.getBatchSlice(pid, 1);
-
-        for (int t = max_timestep - 1; t > -1; t--) {
-          input = input_sample.getSharedDataTensor(
-            feature_size_tensor_dim,
-            (reverse ? max_timestep - 1 - t : t) * feature_size);
-
-          if (!t) {
-            prev_hidden_state = Tensor(unit, tensor_type);
-            prev_hidden_state.setZero();
-            d_prev_hidden_state = Tensor(unit, tensor_type);
-            d_prev_hidden_state.setZero();
-          } else {
-            prev_hidden_state = hidden_state_sample.getSharedDataTensor(
-              unit_tensor_dim, (reverse ? (max_timestep - t) : (t - 1)) * unit);
-            d_prev_hidden_state = d_hidden_state_sample.getSharedDataTensor(
-              unit_tensor_dim, (reverse ? (max_timestep - t) : (t - 1)) * unit);
-          }
-          d_hidden_state = d_hidden_state_sample.getSharedDataTensor(
-            unit_tensor_dim, (reverse ? max_timestep - 1 - t : t) * unit);
-
-          if (!t) {
-            prev_cell_state = Tensor(unit, tensor_type);
-            prev_cell_state.setZero();
-            d_prev_cell_state = Tensor(unit, tensor_type);
-            d_prev_cell_state.setZero();
-          } else {
-            prev_cell_state = cell_state_sample.getSharedDataTensor(
-              unit_tensor_dim, (reverse ? (max_timestep - t) : (t - 1)) * unit);
-            d_prev_cell_state = d_cell_state_sample.getSharedDataTensor(
-              unit_tensor_dim, (reverse ? (max_timestep - t) : (t - 1)) * unit);
-          }
-          cell_state = cell_state_sample.getSharedDataTensor(
-            unit_tensor_dim, (reverse ? max_timestep - 1 - t : t) * unit);
-          d_cell_state = d_cell_state_sample.getSharedDataTensor(
-            unit_tensor_dim, (reverse ? max_timestep - 1 - t : t) * unit);
-
-          Tensor ifgo = ifgo_sample.getSharedDataTensor(
-            num_gate_tensor_dim,
-            (reverse ? max_timestep - 1 - t : t) * NUM_GATE * unit);
-          Tensor d_ifgo = d_ifgo_sample.getSharedDataTensor(
-            num_gate_tensor_dim,
-            (reverse ? max_timestep - 1 - t : t) * NUM_GATE * unit);
-
-          // Temporary variable for d_prev_hidden_state. d_prev_hidden_state
-          // already have precalculated values from incomming derivatives
-          Tensor d_prev_hidden_state_temp =
-            Tensor("d_prev_hidden_state_temp", tensor_type.format,
-                   tensor_type.data_type);
-
-          calcGradientLSTM(
-            1, unit, disable_bias, integrate_bias, acti_func,
-            recurrent_acti_func, input, prev_hidden_state,
-            d_prev_hidden_state_temp, prev_cell_state, d_prev_cell_state,
-            d_hidden_state, cell_state, d_cell_state, p_d_weight_ih, weight_hh,
-            p_d_weight_hh, p_d_bias_h, p_d_bias_ih, p_d_bias_hh, ifgo, d_ifgo);
-
-          d_prev_hidden_state.add_i(d_prev_hidden_state_temp);
+  Tensor prev_hidden_state(batch_size, 1, 1, unit, tensor_type);
+  Tensor d_prev_hidden_state(batch_size, 1, 1, unit, tensor_type);
+  Tensor prev_cell_state(batch_size, 1, 1, unit, tensor_type);
+  Tensor d_prev_cell_state(batch_size, 1, 1, unit, tensor_type);
+  Tensor d_hidden_state(batch_size, 1, 1, unit, tensor_type);
+  Tensor cell_state(batch_size, 1, 1, unit, tensor_type);
+  Tensor d_cell_state(batch_size, 1, 1, unit, tensor_type);
+  Tensor ifgo(batch_size, 1, 1, NUM_GATE * unit, tensor_type);
+  Tensor d_ifgo(batch_size, 1, 1, NUM_GATE * unit, tensor_type);
+
+  for (int t = max_timestep - 1; t > -1; t--) {
+    const unsigned int timestep = reverse ? max_timestep - 1 - t : t;
+    const unsigned int prev_timestep = reverse ? timestep + 1 : timestep - 1;
+
+    if (!t) {
+      prev_hidden_state.setZero();
+      prev_cell_state.setZero();
+    } else {
+      getTimestep(hidden_state_, prev_hidden_state, prev_timestep,
+                  max_timestep);
+      getTimestep(cell_state_, prev_cell_state, prev_timestep, max_timestep);
+    }
+    getTimestep(d_hidden_state_, d_hidden_state, timestep, max_timestep);
+    getTimestep(cell_state_, cell_state, timestep, max_timestep);
+    getTimestep(d_cell_state_, d_cell_state, timestep, max_timestep);
+    getTimestep(ifgo_, ifgo, timestep, max_timestep);
+
+    forEachBatchChunk(
+      batch_size, static_cast<size_t>(NUM_GATE) * unit * unit,
+      [&](unsigned int start, unsigned int len) {
+        Tensor d_prev_cell_state_rows =
+          d_prev_cell_state.getBatchSlice(start, len);
+        Tensor d_ifgo_rows = d_ifgo.getBatchSlice(start, len);
+        calcGradientLSTMGate(len, unit, acti_func, recurrent_acti_func,
+                             d_hidden_state.getBatchSlice(start, len),
+                             prev_cell_state.getBatchSlice(start, len),
+                             d_prev_cell_state_rows,
+                             cell_state.getBatchSlice(start, len),
+                             d_cell_state.getBatchSlice(start, len),
+                             ifgo.getBatchSlice(start, len), d_ifgo_rows);
+        if (t) {
+          Tensor d_prev_hidden_state_rows =
+            d_prev_hidden_state.getBatchSlice(start, len);
+          d_ifgo_rows.dot(weight_hh, d_prev_hidden_state_rows, false, true);
         }
-      }
-    };
-
-    workers.setCallback(batch_job, nullptr);
-    workers.run();
-
-    for (unsigned int b = 0; b < workers.getNumWorkers(); ++b) {
-
-      Tensor p_d_weight_ih = sub_d_weight_ih.getBatchSlice(b, 1);
-      Tensor p_d_weight_hh = sub_d_weight_hh.getBatchSlice(b, 1);
-      Tensor p_d_bias_ih = sub_d_bias_ih.getBatchSlice(b, 1);
-      Tensor p_d_bias_hh = sub_d_bias_hh.getBatchSlice(b, 1);
-      Tensor p_d_bias_h = sub_d_bias_h.getBatchSlice(b, 1);
-
-      d_weight_ih.add_i(p_d_weight_ih);
-      d_weight_hh.add_i(p_d_weight_hh);
-      d_bias_ih.add_i(p_d_bias_ih);
-      d_bias_hh.add_i(p_d_bias_hh);
-      d_bias_h.add_i(p_d_bias_h);
+      });
+    setTimestep(d_ifgo_, d_ifgo, timestep, max_timestep);
+
+    if (t) {
+      /// accumulated over the batch, so it is left to a single gemm
+      prev_hidden_state.dot(d_ifgo, d_weight_hh, true, false, 1.0f);
+      addTimestep(d_hidden_state_, d_prev_hidden_state, prev_timestep,
+                  max_timestep);
+      setTimestep(d_cell_state_, d_prev_cell_state, prev_timestep,
+                  max_timestep);
     }
+  }
 
-  } else {
-    for (unsigned int batch = 0; batch < batch_size; ++batch) {
-      const Tensor input_sample = input_.getBatchSlice(batch, 1);
-
-      const Tensor hidden_state_sample = hidden_state_.getBatchSlice(batch, 1);
-      Tensor d_hidden_state_sample = d_hidden_state_.getBatchSlice(batch, 1);
-      const Tensor cell_state_sample = cell_state_.getBatchSlice(batch, 1);
-      Tensor d_cell_state_sample = d_cell_state_.getBatchSlice(batch, 1);
-
-      const Tensor ifgo_sample = ifgo_.getBatchSlice(batch, 1);
-      Tensor d_ifgo_sample = d_ifgo_.getBatchSlice(batch, 1);
-
-      Tensor input;
-      Tensor prev_hidden_state;
-      Tensor d_prev_hidden_state;
-      Tensor prev_cell_state;
-      Tensor d_prev_cell_state;
-      Tensor d_hidden_state;
-      Tensor cell_state;
-      Tensor d_cell_state;
-
-      for (int t = max_timestep - 1; t > -1; t--) {
-        input = input_sample.getSharedDataTensor(
-          feature_size_tensor_dim,
-          (reverse ? max_timestep - 1 - t : t) * feature_size);
-
-        if (!t) {
-          prev_hidden_state = Tensor(unit, tensor_type);
-          prev_hidden_state.setZero();
-          d_prev_hidden_state = Tensor(unit, tensor_type);
-          d_prev_hidden_state.setZero();
-        } else {
-          prev_hidden_state = hidden_state_sample.getSharedDataTensor(
-            unit_tensor_dim, (reverse ? (max_timestep - t) : (t - 1)) * unit);
-          d_prev_hidden_state = d_hidden_state_sample.getSharedDataTensor(
-            unit_tensor_dim, (reverse ? (max_timestep - t) : (t - 1)) * unit);
-        }
-        d_hidden_state = d_hidden_state_sample.getSharedDataTensor(
-          unit_tensor_dim, (reverse ? max_timestep - 1 - t : t) * unit);
-
-        if (!t) {
-          prev_cell_state = Tensor(unit, tensor_type);
-          prev_cell_state.setZero();
-          d_prev_cell_state = Tensor(unit, tensor_type);
-          d_prev_cell_state.setZero();
-        } else {
-          prev_cell_state = cell_state_sample.getSharedDataTensor(
-            unit_tensor_dim, (reverse ? (max_timestep - t) : (t - 1)) * unit);
-          d_prev_cell_state = d_cell_state_sample.getSharedDataTensor(
-            unit_tensor_dim, (reverse ? (max_timestep - t) : (t - 1)) * unit);
-        }
-        cell_state = cell_state_sample.getSharedDataTensor(
-          unit_tensor_dim, (reverse ? max_timestep - 1 - t : t) * unit);
-        d_cell_state = d_cell_state_sample.getSharedDataTensor(
-          unit_tensor_dim, (reverse ? max_timestep - 1 - t : t) * unit);
-
-        Tensor ifgo = ifgo_sample.getSharedDataTensor(
-          num_gate_tensor_dim,
-          (reverse ? max_timestep - 1 - t : t) * NUM_GATE * unit);
-        Tensor d_ifgo = d_ifgo_sample.getSharedDataTensor(
-          num_gate_tensor_dim,
-          (reverse ? max_timestep - 1 - t : t) * NUM_GATE * unit);
-
-        // Temporary variable for d_prev_hidden_state. d_prev_hidden_state
-        // already have precalculated values from incomming derivatives
-        Tensor d_prev_hidden_state_temp =
-          Tensor("d_prev_hidden_state_temp", tensor_type.format,
-                 tensor_type.data_type);
-
-        calcGradientLSTM(1, unit, disable_bias, integrate_bias, acti_func,
-                         recurrent_acti_func, input, prev_hidden_state,
-                         d_prev_hidden_state_temp, prev_cell_state,
-                         d_prev_cell_state, d_hidden_state, cell_state,
-                         d_cell_state, d_weight_ih, weight_hh, d_weight_hh,
-                         d_bias_h, d_bias_ih, d_bias_hh, ifgo, d_ifgo);
-        d_prev_hidden_state.add_i(d_prev_hidden_state_temp);
-      }
+  /** gradients of the input projection and the bias over all timesteps */
+  const Tensor input = input_.getSharedDataTensor(
+    TensorDim(1, 1, batch_size * max_timestep, feature_size, tensor_type), 0);
+  const Tensor d_ifgo_all = d_ifgo_.getSharedDataTensor(
+    TensorDim(1, 1, batch_size * max_timestep, NUM_GATE * unit, tensor_type),
+    0);
+  input.dot(d_ifgo_all, d_weight_ih, true, false, 1.0f);
+
+  if (!disable_bias) {
+    const Tensor d_ifgo_rows = d_ifgo_.getSharedDataTensor(
+      TensorDim(batch_size * max_timestep, 1, 1, NUM_GATE * unit, tensor_type),
+      0);
+    if (integrate_bias) {
+      d_ifgo_rows.sum(0, d_bias_h, 1.0f, 1.0f);
+    } else {
+      d_ifgo_rows.sum(0, d_bias_ih, 1.0f, 1.0f);
+      d_ifgo_rows.sum(0, d_bias_hh, 1.0f, 1.0f);
     }
   }
 }
@@ -800,17 +751,27 @@ void LSTMLayer::calcDerivative(RunLayerContext &context) {
   const Tensor &weight_ih = context.getWeight(wt_idx[LSTMParams::weight_ih]);
   const Tensor &d_ifgos = context.getTensorGrad(wt_idx[LSTMParams::ifgo]);
 
-  calcDerivativeLSTM(outgoing_derivative, weight_ih, d_ifgos);
-
+  const Tensor *reverse_weight_ih = nullptr;
+  const Tensor *reverse_d_ifgos = nullptr;
   if (bidirectional) {
-    const Tensor &reverse_weight_ih =
-      context.getWeight(wt_idx[LSTMParams::reverse_weight_ih]);
-    const Tensor &reverse_d_ifgos =
-      context.getTensorGrad(wt_idx[LSTMParams::reverse_ifgo]);
-
-    calcDerivativeLSTM(outgoing_derivative, reverse_weight_ih, reverse_d_ifgos,
-                       1.0f);
+    reverse_weight_ih =
+      &context.getWeight(wt_idx[LSTMParams::reverse_weight_ih]);
+    reverse_d_ifgos = &context.getTensorGrad(wt_idx[LSTMParams::reverse_ifgo]);
   }
+
+  forEachBatchChunk(
+    outgoing_derivative.batch(),
+    static_cast<size_t>(d_ifgos.getDim().getFeatureLen()) * weight_ih.height(),
+    [&](unsigned int start, unsigned int len) {
+      Tensor outgoing_derivative_rows =
+        outgoing_derivative.getBatchSlice(start, len);
+      calcDerivativeLSTM(outgoing_derivative_rows, weight_ih,
+                         d_ifgos.getBatchSlice(start, len));
+      if (bidirectional) {
+        calcDerivativeLSTM(outgoing_derivative_rows, *reverse_weight_ih,
+                           reverse_d_ifgos->getBatchSlice(start, len), 1.0f);
+      }
+    });
 }
 
 void LSTMLayer::calcGradient(RunLayerContext &context) {
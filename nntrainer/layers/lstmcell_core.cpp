@@ -47,6 +47,16 @@ void LSTMCore::forwardLSTM(const unsigned int batch_size,
     }
   }
 
+  forwardLSTMGate(batch_size, unit, acti_func, recurrent_acti_func,
+                  prev_cell_state, hidden_state, cell_state, ifgo);
+}
+
+void LSTMCore::forwardLSTMGate(const unsigned int batch_size,
+                               const unsigned int unit, ActiFunc &acti_func,
+                               ActiFunc &recurrent_acti_func,
+                               const Tensor &prev_cell_state,
+                               Tensor &hidden_state, Tensor &cell_state,
+                               Tensor &ifgo) {
   TensorDim::TensorType tensor_type = ifgo.getTensorType();
 
   Tensor input_forget_gate = ifgo.getSharedDataTensor(
@@ -87,6 +97,48 @@ void LSTMCore::calcGradientLSTM(
   const Tensor &d_cell_state, Tensor &d_weight_ih, const Tensor &weight_hh,
   Tensor &d_weight_hh, Tensor &d_bias_h, Tensor &d_bias_ih, Tensor &d_bias_hh,
   const Tensor &ifgo, Tensor &d_ifgo) {
+  calcGradientLSTMGate(batch_size, unit, acti_func, recurrent_acti_func,
+                       d_hidden_state, prev_cell_state, d_prev_cell_state,
+                       cell_state, d_cell_state, ifgo, d_ifgo);
+
+  if (!disable_bias) {
+    if (integrate_bias) {
+      d_ifgo.sum(0, d_bias_h, 1.0f, 1.0f);
+    } else {
+      d_ifgo.sum(0, d_bias_ih, 1.0f, 1.0f);
+      d_ifgo.sum(0, d_bias_hh, 1.0f, 1.0f);
+    }
+  }
+
+  if (input.batch() != 1) {
+    input.dot(d_ifgo, d_weight_ih, true, false, 1.0f);
+  } else {
+
+    for (unsigned int i = 0; i < d_weight_ih.height(); ++i) {
+      unsigned int out_width = d_weight_ih.width();
+      d_weight_ih.add_i_partial(out_width, i * out_width, d_ifgo, 1, 1, input,
+                                i);
+    }
+  }
+
+  if (prev_hidden_state.batch() != 1) {
+    prev_hidden_state.dot(d_ifgo, d_weight_hh, true, false, 1.0f);
+  } else {
+    for (unsigned int i = 0; i < d_weight_hh.height(); ++i) {
+      unsigned int out_width = d_weight_hh.width();
+      d_weight_hh.add_i_partial(out_width, i * out_width, d_ifgo, 1, 1,
+                                prev_hidden_state, i);
+    }
+  }
+  d_ifgo.dot(weight_hh, d_prev_hidden_state, false, true);
+}
+
+void LSTMCore::calcGradientLSTMGate(
+  const unsigned int batch_size, const unsigned int unit, ActiFunc &acti_func,
+  ActiFunc &recurrent_acti_func, const Tensor &d_hidden_state,
+  const Tensor &prev_cell_state, Tensor &d_prev_cell_state,
+  const Tensor &cell_state, const Tensor &d_cell_state, const Tensor &ifgo,
+  Tensor &d_ifgo) {
   TensorDim::TensorType tensor_type = ifgo.getTensorType();
   Tensor input_forget_gate = ifgo.getSharedDataTensor(
     {batch_size, 1, 1, unit * 2, tensor_type}, 0, false);
@@ -130,37 +182,6 @@ void LSTMCore::calcGradientLSTM(
   recurrent_acti_func.run_prime_fn(input_forget_gate, d_input_forget_gate,
                                    d_input_forget_gate);
   acti_func.run_prime_fn(memory_cell, d_memory_cell, d_memory_cell);
-
-  if (!disable_bias) {
-    if (integrate_bias) {
-      d_ifgo.sum(0, d_bias_h, 1.0f, 1.0f);
-    } else {
-      d_ifgo.sum(0, d_bias_ih, 1.0f, 1.0f);
-      d_ifgo.sum(0, d_bias_hh, 1.0f, 1.0f);
-    }
-  }
-
-  if (input.batch() != 1) {
-    input.dot(d_ifgo, d_weight_ih, true, false, 1.0f);
-  } else {
-
-    for (unsigned int i = 0; i < d_weight_ih.height(); ++i) {
-      unsigned int out_width = d_weight_ih.width();
-      d_weight_ih.add_i_partial(out_width, i * out_width, d_ifgo, 1, 1, input,
-                                i);
-    }
-  }
-
-  if (prev_hidden_state.batch() != 1) {
-    prev_hidden_state.dot(d_ifgo, d_weight_hh, true, false, 1.0f);
-  } else {
-    for (unsigned int i = 0; i < d_weight_hh.height(); ++i) {
-      unsigned int out_width = d_weight_hh.width();
-      d_weight_hh.add_i_partial(out_width, i * out_width, d_ifgo, 1, 1,
-                                prev_hidden_state, i);
-    }
-  }
-  d_ifgo.dot(weight_hh, d_prev_hidden_state, false, true);
 }
 
 void LSTMCore::setProperty(const std::vector<std::string> &values) {
@@ -69,6 +69,25 @@ public:
                    const Tensor &weight_hh, const Tensor &bias_h,
                    const Tensor &bias_ih, const Tensor &bias_hh, Tensor &ifgo);
 
+  /**
+   * @brief lstm cell forwarding of the gates when ifgo already has the input
+   * and the recurrent projection with the bias
+   *
+   * @param batch_size batch size
+   * @param unit number of output neurons
+   * @param acti_func activation function for memory cell, cell state
+   * @param recurrent_acti_func activation function for input/output/forget
+   * gate
+   * @param prev_cell_state previous cell state
+   * @param hidden_state hidden state
+   * @param cell_state cell state
+   * @param ifgo input gate, forget gate, memory cell, output gate
+   */
+  void forwardLSTMGate(const unsigned int batch_size, const unsigned int unit,
+                       ActiFunc &acti_func, ActiFunc &recurrent_acti_func,
+                       const Tensor &prev_cell_state, Tensor &hidden_state,
+                       Tensor &cell_state, Tensor &ifgo);
+
   /**
    * @brief lstm cell calculate derivative implementation
    *
@@ -122,6 +141,33 @@ public:
                         Tensor &d_bias_ih, Tensor &d_bias_hh,
                         const Tensor &ifgo, Tensor &d_ifgo);
 
+  /**
+   * @brief lstm cell calculate gradient of the gates, which does not include
+   * the gradient of the weights and the bias
+   *
+   * @param batch_size batch size
+   * @param unit number of output neurons
+   * @param acti_func activation function for memory cell, cell state
+   * @param recurrent_acti_func activation function for input/output/forget
+   * gate
+   * @param d_hidden_state hidden state gradient
+   * @param prev_cell_state previous cell state
+   * @param d_prev_cell_state previous cell state gradient
+   * @param cell_state cell state
+   * @param d_cell_state cell state gradient
+   * @param ifgo input gate, forget gate, memory cell, output gate
+   * @param d_ifgo gradient for input gate, forget gate, memory cell, output
+   * gate
+   */
+  void calcGradientLSTMGate(const unsigned int batch_size,
+                            const unsigned int unit, ActiFunc &acti_func,
+                            ActiFunc &recurrent_acti_func,
+                            const Tensor &d_hidden_state,
+                            const Tensor &prev_cell_state,
+                            Tensor &d_prev_cell_state, const Tensor &cell_state,
+                            const Tensor &d_cell_state, const Tensor &ifgo,
+                            Tensor &d_ifgo);
+
   /**
    * @copydoc Layer::setProperty(const PropertyType type, const std::string
    * &value)
@@ -14,8 +14,11 @@
 
 #include <cmath>
 
+#include <blas_interface.h>
+#include <kv_cache_manager.h>
 #include <layer_context.h>
 #include <multi_head_attention_layer.h>
+#include <nntr_threads.h>
 #include <nntrainer_error.h>
 #include <nntrainer_log.h>
 #include <node_exporter.h>
@@ -28,6 +31,7 @@ MultiHeadAttentionLayer::MultiHeadAttentionLayer() :
     props::OutputShape(), props::DropOutRate(), props::ReturnAttentionWeight(),
     props::AverageAttentionWeight()),
   sm(ActivationType::ACT_SOFTMAX),
+  kv_cache_idx(std::numeric_limits<unsigned>::max()),
   epsilon(1e-3) {
   weight_idx.fill(std::numeric_limits<unsigned>::max());
 }
@@ -278,13 +282,20 @@ void MultiHeadAttentionLayer::finalize(InitLayerContext &context) {
     projected_value_dim, "projected_value", Initializer::NONE, true,
     TensorLifespan::ITERATION_LIFESPAN);
 
-  weight_idx[AttentionParams::cache_key] =
-    context.requestTensor(projected_key_dim, "cache_key", Initializer::NONE,
-                          true, TensorLifespan::MAX_LIFESPAN);
+  if (KVCacheManager *kv_cache = context.getKVCacheManager()) {
+    /** keys and values are kept in the pages of the model instead */
+    kv_cache_idx = kv_cache->registerLayer(
+      context.getName(), num_heads * projected_key_dim_prop,
+      num_heads * projected_value_dim_prop, activation_type.data_type);
+  } else {
+    weight_idx[AttentionParams::cache_key] =
+      context.requestTensor(projected_key_dim, "cache_key", Initializer::NONE,
+                            true, TensorLifespan::MAX_LIFESPAN);
 
-  weight_idx[AttentionParams::cache_value] =
-    context.requestTensor(projected_value_dim, "cache_value", Initializer::NONE,
-                          true, TensorLifespan::MAX_LIFESPAN);
+    weight_idx[AttentionParams::cache_value] = context.requestTensor(
+      projected_value_dim, "cache_value", Initializer::NONE, true,
+      TensorLifespan::MAX_LIFESPAN);
+  }
 
   if (provide_attention_mask) {
     /** Intended comment for bool type mask */
@@ -294,13 +305,23 @@ void MultiHeadAttentionLayer::finalize(InitLayerContext &context) {
     //   attention_mask_dim, "attention_mask", Initializer::NONE, false,
     //   TensorLifespan::FORWARD_FUNC_LIFESPAN);
   }
-  /** tensor for attention weight */
-  TensorDim attention_weight_dim(
-    {batch_size, num_heads, query_height, key_height}, activation_type);
-  weight_idx[AttentionParams::attention_weight] = context.requestTensor(
-    attention_weight_dim, "attention_weight", Initializer::NONE, true,
-    TensorLifespan::ITERATION_LIFESPAN);
-  if (dropout_rate > epsilon) {
+  /**
+   * attention weight is not materialized in inference unless it is returned,
+   * as the fused attention computes the output over the tiles of keys
+   */
+  const bool materialize_attention_weight =
+    context.getExecutionMode() == ml::train::ExecutionMode::TRAIN ||
+    return_attention_weight != props::ReturnAttentionWeightInfo::Enum::none;
+
+  if (materialize_attention_weight) {
+    /** tensor for attention weight */
+    TensorDim attention_weight_dim(
+      {batch_size, num_heads, query_height, key_height}, activation_type);
+    weight_idx[AttentionParams::attention_weight] = context.requestTensor(
+      attention_weight_dim, "attention_weight", Initializer::NONE, true,
+      TensorLifespan::ITERATION_LIFESPAN);
+  }
+  if (materialize_attention_weight && dropout_rate > epsilon) {
     /** tensor for dropout mask */
     TensorDim dropout_mask_dim(
       {batch_size, num_heads, query_height, key_height}, activation_type);
@@ -330,6 +351,168 @@ void MultiHeadAttentionLayer::finalize(InitLayerContext &context) {
   }
 }
 
+/**
+ * @brief scaled dot product attention of every batch and head with
+ * flash_attention. query, key, value and output are laid out as [batch, 1,
+ * height, num_heads * dim] so that a head is a strided view of them, and mask
+ * is [batch or 1, num_heads, query height, key height].
+ *
+ * @param causal_offset see flash_attention, negative for no causal mask
+ */
+template <typename T>
+static void fusedAttention(const Tensor &query, const Tensor &key,
+                           const Tensor &value, const Tensor &mask,
+                           Tensor &output, unsigned int num_heads,
+                           int causal_offset) {
+  const unsigned int batch_size = query.batch();
+  const unsigned int q_len = query.height();
+  const unsigned int k_len = key.height();
+  const unsigned int ldq = query.width();
+  const unsigned int ldk = key.width();
+  const unsigned int ldv = value.width();
+  const unsigned int ldo = output.width();
+  const unsigned int dk = ldq / num_heads;
+  const unsigned int dv = ldv / num_heads;
+  const float scale = 1 / std::sqrt((float)dk);
+
+  const T *q = query.getData<T>();
+  const T *k = key.getData<T>();
+  const T *v = value.getData<T>();
+  const T *m = mask.empty() ? nullptr : mask.getData<T>();
+  T *o = output.getData<T>();
+  const size_t mask_batch_stride =
+    mask.empty() || mask.batch() == 1 ? 0 : mask.getDim().getFeatureLen();
+
+  auto attention_job = [&](unsigned int s, unsigned int e, unsigned int pid,
+                           void *user_data) {
+    for (unsigned int i = s; i < e; ++i) {
+      unsigned int b = i / num_heads, h = i % num_heads;
+      const T *mask_head =
+        m == nullptr ? nullptr
+                     : m + b * mask_batch_stride + (size_t)h * q_len * k_len;
+      flash_attention(q_len, k_len, dk, dv,
+                      q + query.getDim().getFeatureLen() * b + h * dk, ldq,
+                      k + key.getDim().getFeatureLen() * b + h * dk, ldk,
+                      v + value.getDim().getFeatureLen() * b + h * dv, ldv,
+                      mask_head, k_len, scale, causal_offset,
+                      o + output.getDim().getFeatureLen() * b + h * dv, ldo);
+    }
+  };
+
+  auto workers = ParallelBatch(attention_job, batch_size * num_heads, nullptr);
+
+  if (workers.getNumWorkers() > 1) {
+    workers.run();
+  } else {
+    attention_job(0, batch_size * num_heads, 0, nullptr);
+  }
+}
+
+/**
+ * @brief fusedAttention for the data type of the tensors
+ */
+static void fusedAttention(const Tensor &query, const Tensor &key,
+                           const Tensor &value, const Tensor &mask,
+                           Tensor &output, unsigned int num_heads,
+                           int causal_offset) {
+  if (query.getDataType() == TensorDim::DataType::FP32) {
+    fusedAttention<float>(query, key, value, mask, output, num_heads,
+                          causal_offset);
+  } else if (query.getDataType() == TensorDim::DataType::FP16) {
+#ifdef ENABLE_FP16
+    fusedAttention<_FP16>(query, key, value, mask, output, num_heads,
+                          causal_offset);
+#else
+    throw std::invalid_argument("Error: enable-fp16 is not enabled");
+#endif
+  }
+}
+
+/**
+ * @brief append the keys and values of the step to the paged kv cache and
+ * attend the queries of the step to the cached tokens of each sequence. The
+ * sequences of a step may have different lengths, so the i-th query of a
+ * sequence of length len attends to the keys up to len + i.
+ */
+template <typename T>
+static void pagedAttention(KVCacheManager &kv_cache, unsigned int layer,
+                           const Tensor &query, const Tensor &key,
+                           const Tensor &value, Tensor &output,
+                           unsigned int num_heads) {
+  const std::vector<unsigned int> &sequences = kv_cache.getActiveSequences();
+  const unsigned int batch_size = query.batch();
+  const unsigned int step = query.height();
+  const unsigned int ldq = query.width();
+  const unsigned int ldk = key.width();
+  const unsigned int ldv = value.width();
+  const unsigned int ldo = output.width();
+  const unsigned int dk = ldq / num_heads;
+  const unsigned int dv = ldv / num_heads;
+  const unsigned int page_size = kv_cache.getPageSize();
+  const float scale = 1 / std::sqrt((float)dk);
+
+  for (unsigned int b = 0; b < batch_size; ++b) {
+    const unsigned int len = kv_cache.getLength(sequences[b]);
+    for (unsigned int t = 0; t < step; ++t) {
+      std::copy_n(key.getAddress<T>(b, 0, t, 0), ldk,
+                  kv_cache.getKey<T>(layer, sequences[b], len + t));
+      std::copy_n(value.getAddress<T>(b, 0, t, 0), ldv,
+                  kv_cache.getValue<T>(layer, sequences[b], len + t));
+    }
+  }
+
+  auto attention_job = [&](unsigned int s, unsigned int e, unsigned int pid,
+                           void *user_data) {
+    std::vector<const T *> key_pages, value_pages;
+    for (unsigned int i = s; i < e; ++i) {
+      unsigned int b = i / num_heads, h = i % num_heads;
+      const unsigned int len = kv_cache.getLength(sequences[b]);
+      const std::vector<unsigned int> &pages =
+        kv_cache.getPageTable(sequences[b]);
+
+      key_pages.clear();
+      value_pages.clear();
+      for (auto page : pages) {
+        key_pages.push_back(kv_cache.getKeyPage<T>(layer, page) + h * dk);
+        value_pages.push_back(kv_cache.getValuePage<T>(layer, page) + h * dv);
+      }
+
+      flash_attention_paged(
+        step, len + step, dk, dv, query.getAddress<T>(b, 0, 0, h * dk), ldq,
+        key_pages.data(), ldk, value_pages.data(), ldv, page_size, scale, len,
+        output.getAddress<T>(b, 0, 0, h * dv), ldo);
+    }
+  };
+
+  auto workers = ParallelBatch(attention_job, batch_size * num_heads, nullptr);
+
+  if (workers.getNumWorkers() > 1) {
+    workers.run();
+  } else {
+    attention_job(0, batch_size * num_heads, 0, nullptr);
+  }
+}
+
+/**
+ * @brief pagedAttention for the data type of the tensors
+ */
+static void pagedAttention(KVCacheManager &kv_cache, unsigned int layer,
+                           const Tensor &query, const Tensor &key,
+                           const Tensor &value, Tensor &output,
+                           unsigned int num_heads) {
+  if (query.getDataType() == TensorDim::DataType::FP32) {
+    pagedAttention<float>(kv_cache, layer, query, key, value, output,
+                          num_heads);
+  } else if (query.getDataType() == TensorDim::DataType::FP16) {
+#ifdef ENABLE_FP16
+    pagedAttention<_FP16>(kv_cache, layer, query, key, value, output,
+                          num_heads);
+#else
+    throw std::invalid_argument("Error: enable-fp16 is not enabled");
+#endif
+  }
+}
+
 void MultiHeadAttentionLayer::forwarding(RunLayerContext &context,
                                          bool training) {
   const bool disable_bias =
@@ -398,8 +581,6 @@ void MultiHeadAttentionLayer::forwarding(RunLayerContext &context,
   Tensor &projected_value =
     context.getTensor(weight_idx[AttentionParams::projected_value]);
 
-  Tensor &attention_weight =
-    context.getTensor(weight_idx[AttentionParams::attention_weight]);
   Tensor &attention_output =
     context.getTensor(weight_idx[AttentionParams::attention_output]);
 
@@ -424,6 +605,26 @@ void MultiHeadAttentionLayer::forwarding(RunLayerContext &context,
     projected_value.add_i(value_fc_bias);
   }
 
+  if (!training &&
+      return_attention_weight == props::ReturnAttentionWeightInfo::Enum::none) {
+    /** dropout is not applied in inference */
+    fusedAttention(projected_query, projected_key, projected_value, mask,
+                   attention_output, num_heads, -1);
+
+    attention_output.reshape(TensorDim(
+      {batch_size * query_height, 1, 1, num_heads * projected_value_dim_prop}));
+    attention_output.dot(fc_weight, output);
+    if (!disable_bias) {
+      output.add_i(fc_bias);
+    }
+    attention_output.reshape(TensorDim(
+      {batch_size, 1, query_height, num_heads * projected_value_dim_prop}));
+    return;
+  }
+
+  Tensor &attention_weight =
+    context.getTensor(weight_idx[AttentionParams::attention_weight]);
+
   projected_query.reshape(
     TensorDim({batch_size, query_height, num_heads, projected_query_dim_prop}));
   projected_key.reshape(
@@ -562,7 +763,6 @@ void MultiHeadAttentionLayer::incremental_forwarding(RunLayerContext &context,
     std::get<props::AverageAttentionWeight>(multi_head_attention_props).get();
 
   const bool provide_attention_mask = context.getNumInputs() == 4;
-  const unsigned int projected_query_dim_prop = projected_key_dim_prop;
   const bool enable_dropout = dropout_rate > epsilon;
 
   /** get inputs/outputs */
@@ -613,67 +813,13 @@ void MultiHeadAttentionLayer::incremental_forwarding(RunLayerContext &context,
   /** get tensors */
   Tensor &projected_query =
     context.getTensor(weight_idx[AttentionParams::projected_query]);
-  Tensor &projected_key =
-    context.getTensor(weight_idx[AttentionParams::projected_key]);
-  Tensor &projected_value =
-    context.getTensor(weight_idx[AttentionParams::projected_value]);
-  Tensor &cache_key = context.getTensor(weight_idx[AttentionParams::cache_key]);
-  Tensor &cache_value =
-    context.getTensor(weight_idx[AttentionParams::cache_value]);
-
-  TensorDim projected_query_dim = projected_query.getDim();
-  TensorDim projected_key_dim = projected_key.getDim();
-  TensorDim projected_value_dim = projected_value.getDim();
-  TensorDim cache_key_dim = cache_key.getDim();
-  TensorDim cache_value_dim = cache_value.getDim();
-
-  TensorDim projected_query_step_dim = projected_query_dim;
-
-  TensorDim projected_key_step_dim = projected_key_dim;
-  TensorDim projected_value_step_dim = projected_value_dim;
-  TensorDim cache_key_step_dim = cache_key_dim;
-  TensorDim cache_value_step_dim = cache_value_dim;
+  TensorDim projected_query_step_dim = projected_query.getDim();
   projected_query_step_dim.height(to - from);
-
-  projected_key_step_dim.height(to);
-  projected_value_step_dim.height(to);
-  cache_key_step_dim.height(to - from);
-  cache_value_step_dim.height(to - from);
-
   Tensor projected_query_step =
     projected_query.getSharedDataTensor(projected_query_step_dim, 0, true);
-  Tensor projected_key_step =
-    projected_key.getSharedDataTensor(projected_key_step_dim, 0, true);
-  Tensor projected_value_step =
-    projected_value.getSharedDataTensor(projected_value_step_dim, 0, true);
-
-  Tensor cache_key_step = cache_key.getSharedDataTensor(
-    cache_key_step_dim, from * cache_key_dim.width(), true);
-  Tensor cache_value_step = cache_value.getSharedDataTensor(
-    cache_value_step_dim, from * cache_value_dim.width(), true);
-
-  TensorDim cached_key_dim = {cache_key_dim.batch(), cache_key_dim.channel(),
-                              to, cache_key_dim.width(),
-                              cache_key.getTensorType()};
-  TensorDim cached_value_dim = {
-    cache_value_dim.batch(), cache_value_dim.channel(), to,
-    cache_value_dim.width(), cache_value.getTensorType()};
-  Tensor cached_key = cache_key.getSharedDataTensor(cached_key_dim, 0, true);
-  Tensor cached_value =
-    cache_value.getSharedDataTensor(cached_value_dim, 0, true);
 
-  Tensor &attention_weight =
-    context.getTensor(weight_idx[AttentionParams::attention_weight]);
   Tensor &attention_output =
     context.getTensor(weight_idx[AttentionParams::attention_output]);
-  TensorDim attention_weight_dim = attention_weight.getDim();
-
-  TensorDim attention_weight_step_dim = attention_weight_dim;
-  attention_weight_step_dim.height(to - from);
-  attention_weight_step_dim.width(to);
-
-  Tensor attention_weight_step =
-    attention_weight.getSharedDataTensor(attention_weight_step_dim, 0, true);
 
   TensorDim attention_output_dim = attention_output.getDim();
   TensorDim attention_output_step_dim = attention_output_dim;
@@ -683,84 +829,96 @@ void MultiHeadAttentionLayer::incremental_forwarding(RunLayerContext &context,
     attention_output.getSharedDataTensor(attention_output_step_dim, 0, true);
 
   const unsigned int batch_size = query_dim.batch();
-  const unsigned int query_height = query_dim.height();
-  const unsigned int key_height = key_dim.height();
-  const unsigned int value_height = value_dim.height();
 
   query.dot(query_fc_weight, projected_query_step);
   if (!disable_bias) {
     projected_query_step.add_i(query_fc_bias);
   }
-  key.dot(key_fc_weight, cache_key_step);
-  if (!disable_bias) {
-    cache_key_step.add_i(key_fc_bias);
-  }
-  value.dot(value_fc_weight, cache_value_step);
-  if (!disable_bias) {
-    cache_value_step.add_i(value_fc_bias);
-  }
 
-  projected_query_step.reshape(
-    TensorDim({batch_size, 1, num_heads, projected_query_dim_prop}));
-  cached_key.reshape(
-    TensorDim({batch_size, to, num_heads, projected_key_dim_prop}));
-  cached_value.reshape(
-    TensorDim({batch_size, to, num_heads, projected_value_dim_prop}));
-
-  projected_query_step.transpose("1:0:2", projected_query_step);
-  cached_key.transpose("1:0:2", projected_key_step);
-  cached_value.transpose("1:0:2", projected_value_step);
-
-  projected_query_step.reshape(
-    TensorDim({batch_size * num_heads, 1, 1, projected_query_dim_prop}));
-  projected_key_step.reshape(
-    TensorDim({batch_size * num_heads, 1, to, projected_key_dim_prop}));
-  projected_value_step.reshape(
-    TensorDim({batch_size * num_heads, 1, to, projected_value_dim_prop}));
-
-  attention_weight_step.reshape(TensorDim({batch_size * num_heads, 1, 1, to}));
-  attention_output_step.reshape(
-    TensorDim({batch_size * num_heads, 1, 1, projected_value_dim_prop}));
-
-  /** scaled dot product attention */
-  projected_query_step.dotBatched(projected_key_step, attention_weight_step,
-                                  false, true);
-  attention_weight_step.multiply_i(1 / sqrt((float)projected_query_dim_prop));
-
-  if (!from) {
-    unsigned int mask_size = attention_weight_step.getDim().width();
-    unsigned int mask_dim_height = mask_size;
-    unsigned int mask_dim_width = mask_size;
-
-    Tensor causal_mask(TensorDim{1, 1, mask_size, mask_size,
-                                 attention_weight_step.getTensorType()});
-
-    causal_mask.setZero();
-
-#ifdef ENABLE_FP16
-#define _MASK_NUM -1e4
-#else
-#define _MASK_NUM -1e10
-#endif
+  if (KVCacheManager *kv_cache = context.getKVCacheManager()) {
+    NNTR_THROW_IF(!kv_cache->inStep(), std::runtime_error)
+      << "kv cache step is not begun for layer " << context.getName();
+    NNTR_THROW_IF(kv_cache->getActiveSequences().size() != batch_size ||
+                    kv_cache->getStepLength() != to - from,
+                  std::invalid_argument)
+      << "kv cache step of " << kv_cache->getActiveSequences().size()
+      << " sequences of length " << kv_cache->getStepLength()
+      << " does not match batch size: " << batch_size
+      << " and step: " << to - from << " for layer " << context.getName();
+
+    Tensor &projected_key =
+      context.getTensor(weight_idx[AttentionParams::projected_key]);
+    Tensor &projected_value =
+      context.getTensor(weight_idx[AttentionParams::projected_value]);
+
+    TensorDim projected_key_step_dim = projected_key.getDim();
+    TensorDim projected_value_step_dim = projected_value.getDim();
+    projected_key_step_dim.height(to - from);
+    projected_value_step_dim.height(to - from);
+
+    Tensor projected_key_step =
+      projected_key.getSharedDataTensor(projected_key_step_dim, 0, true);
+    Tensor projected_value_step =
+      projected_value.getSharedDataTensor(projected_value_step_dim, 0, true);
+
+    key.dot(key_fc_weight, projected_key_step);
+    if (!disable_bias) {
+      projected_key_step.add_i(key_fc_bias);
+    }
+    value.dot(value_fc_weight, projected_value_step);
+    if (!disable_bias) {
+      projected_value_step.add_i(value_fc_bias);
+    }
 
-    for (unsigned int i = 0; i < mask_dim_height; ++i) {
-      for (unsigned int j = i + 1; j < mask_dim_width; ++j) {
-        causal_mask.setValue(0, 0, i, j, _MASK_NUM);
-      }
+    pagedAttention(*kv_cache, kv_cache_idx, projected_query_step,
+                   projected_key_step, projected_value_step,
+                   attention_output_step, num_heads);
+  } else {
+    Tensor &cache_key =
+      context.getTensor(weight_idx[AttentionParams::cache_key]);
+    Tensor &cache_value =
+      context.getTensor(weight_idx[AttentionParams::cache_value]);
+
+    TensorDim cache_key_dim = cache_key.getDim();
+    TensorDim cache_value_dim = cache_value.getDim();
+
+    TensorDim cache_key_step_dim = cache_key_dim;
+    TensorDim cache_value_step_dim = cache_value_dim;
+    cache_key_step_dim.height(to - from);
+    cache_value_step_dim.height(to - from);
+
+    Tensor cache_key_step = cache_key.getSharedDataTensor(
+      cache_key_step_dim, from * cache_key_dim.width(), true);
+    Tensor cache_value_step = cache_value.getSharedDataTensor(
+      cache_value_step_dim, from * cache_value_dim.width(), true);
+
+    TensorDim cached_key_dim = {cache_key_dim.batch(), cache_key_dim.channel(),
+                                to, cache_key_dim.width(),
+                                cache_key.getTensorType()};
+    TensorDim cached_value_dim = {
+      cache_value_dim.batch(), cache_value_dim.channel(), to,
+      cache_value_dim.width(), cache_value.getTensorType()};
+    Tensor cached_key = cache_key.getSharedDataTensor(cached_key_dim, 0, true);
+    Tensor cached_value =
+      cache_value.getSharedDataTensor(cached_value_dim, 0, true);
+
+    key.dot(key_fc_weight, cache_key_step);
+    if (!disable_bias) {
+      cache_key_step.add_i(key_fc_bias);
+    }
+    value.dot(value_fc_weight, cache_value_step);
+    if (!disable_bias) {
+      cache_value_step.add_i(value_fc_bias);
     }
 
-    attention_weight_step.add_i(causal_mask);
+    /**
+     * the i-th query of the step is at from + i, so it attends to the cached
+     * keys up to from + i
+     */
+    fusedAttention(projected_query_step, cached_key, cached_value,
+                   empty_tensor, attention_output_step, num_heads, from);
   }
 
-  sm.run_fn(attention_weight_step, attention_weight_step);
-
-  attention_weight_step.dotBatched(projected_value_step, attention_output_step);
-
-  attention_output_step.reshape(
-    TensorDim({batch_size, num_heads, to - from, projected_value_dim_prop}));
-
-  attention_output_step = attention_output_step.transpose("1:0:2");
-
   attention_output_step.reshape(TensorDim(
     {batch_size * (to - from), 1, 1, num_heads * projected_value_dim_prop}));
 
@@ -1104,12 +1262,20 @@ void MultiHeadAttentionLayer::setBatch(RunLayerContext &context,
   context.updateTensor(weight_idx[AttentionParams::projected_query], batch);
   context.updateTensor(weight_idx[AttentionParams::projected_key], batch);
   context.updateTensor(weight_idx[AttentionParams::projected_value], batch);
-  context.updateTensor(weight_idx[AttentionParams::cache_key], batch);
-  context.updateTensor(weight_idx[AttentionParams::cache_value], batch);
+  /** keys and values are not requested if they are in the paged kv cache */
+  if (weight_idx[AttentionParams::cache_key] !=
+      std::numeric_limits<unsigned>::max()) {
+    context.updateTensor(weight_idx[AttentionParams::cache_key], batch);
+    context.updateTensor(weight_idx[AttentionParams::cache_value], batch);
+  }
   // context.updateTensor(weight_idx[AttentionParams::cache_value], batch);
-  context.updateTensor(weight_idx[AttentionParams::attention_weight], batch);
-  if (dropout_rate > epsilon) {
-    context.updateTensor(weight_idx[AttentionParams::dropout_mask], batch);
+  /** attention weight is not requested for the fused attention */
+  if (weight_idx[AttentionParams::attention_weight] !=
+      std::numeric_limits<unsigned>::max()) {
+    context.updateTensor(weight_idx[AttentionParams::attention_weight], batch);
+    if (dropout_rate > epsilon) {
+      context.updateTensor(weight_idx[AttentionParams::dropout_mask], batch);
+    }
   }
   context.updateTensor(weight_idx[AttentionParams::attention_output], batch);
 }
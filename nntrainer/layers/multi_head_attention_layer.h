@@ -117,6 +117,7 @@ private:
   ActiFunc sm; /** softmax activation operation */
   std::array<unsigned int, 16>
     weight_idx; /**< indices of the weights and tensors */
+  unsigned int kv_cache_idx; /**< index of the layer in the paged kv cache */
 
   /**
    * @brief     to protect overflow
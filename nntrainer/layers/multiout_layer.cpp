@@ -73,10 +73,13 @@ void MultiOutLayer::incremental_forwarding(RunLayerContext &context,
 void MultiOutLayer::calcDerivative(RunLayerContext &context) {
   Tensor &ret = context.getOutgoingDerivative(SINGLE_INOUT_IDX);
   for (unsigned int idx = 0; idx < context.getNumOutputs(); ++idx) {
+    const Tensor &deriv = context.getIncomingDerivative(idx);
     if (idx == 0) {
-      ret.copy(context.getIncomingDerivative(idx));
+      /** the first derivative may share the memory of the outgoing one */
+      if (deriv.getData<char>() != ret.getData<char>())
+        ret.copy(deriv);
     } else {
-      ret.add_i(context.getIncomingDerivative(idx));
+      ret.add_i(deriv);
     }
   }
 }
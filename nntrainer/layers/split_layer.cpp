@@ -23,6 +23,16 @@ namespace nntrainer {
 
 static constexpr size_t SINGLE_INOUT_IDX = 0;
 
+/**
+ * @brief check if @a tensor is at @a offset of a single sample @a target,
+ * which is the case when the tensor manager placed the one in the other
+ */
+static bool isPlacedAt(const Tensor &tensor, const Tensor &target,
+                       unsigned int offset) {
+  return target.batch() == 1 && tensor.getData<char>() != nullptr &&
+         tensor.getData<char>() == target.getData<char>(offset);
+}
+
 SplitLayer::SplitLayer() :
   Layer(),
   leading_helper_dim(1),
@@ -101,6 +111,16 @@ void SplitLayer::finalize(InitLayerContext &context) {
   output_reshape_helper = input_reshape_helper;
   output_reshape_helper.height(split_size);
 
+  /**
+   * When a sample of each output is contiguous in the input, the outputs can
+   * be a part of the input, and the copies below are skipped.
+   */
+  if (leading_helper_dim == 1) {
+    const unsigned int output_len = output_dim[0].getFeatureLen();
+    for (unsigned int idx = 0; idx < output_dim.size(); ++idx)
+      context.requestOutputPlacement(idx, idx * output_len);
+  }
+
   setBatch(in_dim.batch());
 }
 
@@ -115,6 +135,11 @@ void SplitLayer::forwarding(RunLayerContext &context, bool training) {
   for (unsigned int idx = 0; idx < split_number; idx++) {
     Tensor &output_ = context.getOutput(idx);
     const TensorDim out_dim = output_.getDim();
+
+    /** the output is a part of the input already */
+    if (isPlacedAt(output_, input_, idx * out_dim.getFeatureLen()))
+      continue;
+
     output_.reshape(output_reshape_helper);
 
     for (unsigned int batch = 0; batch < input_.batch(); batch++) {
@@ -148,6 +173,11 @@ void SplitLayer::calcDerivative(RunLayerContext &context) {
   for (unsigned int idx = 0; idx < split_number; idx++) {
     Tensor output_ = context.getIncomingDerivative(idx);
     const TensorDim out_dim = output_.getDim();
+
+    /** the derivative is a part of the outgoing derivative already */
+    if (isPlacedAt(output_, input_, idx * out_dim.getFeatureLen()))
+      continue;
+
     output_.reshape(output_reshape_helper);
 
     for (unsigned int batch = 0; batch < input_.batch(); batch++) {
@@ -71,6 +71,13 @@ public:
    */
   bool supportBackwarding() const override { return true; };
 
+  /**
+   * @brief Initialize the in-place settings of the layer
+   * @details the outputs may be placed in the input by the tensor manager
+   * @return InPlaceType
+   */
+  InPlaceType initializeInPlace() override { return InPlaceType::RESTRICTING; }
+
   /**
    * @copydoc Layer::exportTo(Exporter &exporter, ml::train::ExportMethods
    * method)
@@ -28,6 +28,8 @@ TrainingBatchSize::TrainingBatchSize(unsigned int value) { set(value); }
 
 ContinueTrain::ContinueTrain(bool value) { set(value); }
 
+DropLast::DropLast(bool value) { set(value); }
+
 MemoryOptimization::MemoryOptimization(bool value) { set(value); }
 
 MemorySwap::MemorySwap(bool value) { set(value); }
@@ -49,4 +51,30 @@ bool LossScale::isValid(const float &value) const {
   return value != 0;
 }
 
+LossScaleGrowthInterval::LossScaleGrowthInterval(unsigned int value) {
+  set(value);
+}
+
+LossScaleGrowthFactor::LossScaleGrowthFactor(float value) { set(value); }
+
+bool LossScaleGrowthFactor::isValid(const float &value) const {
+  return value >= 1.0f;
+}
+
+LossScaleBackoffFactor::LossScaleBackoffFactor(float value) { set(value); }
+
+bool LossScaleBackoffFactor::isValid(const float &value) const {
+  return value > 0.0f && value <= 1.0f;
+}
+
+LossScaleOverflow::LossScaleOverflow(LossScaleOverflowInfo::Enum value) {
+  set(value);
+}
+
+KVCachePageSize::KVCachePageSize(unsigned int value) { set(value); }
+
+KVCachePages::KVCachePages(unsigned int value) { set(value); }
+
+InferenceFusion::InferenceFusion(bool value) { set(value); }
+
 } // namespace nntrainer::props
@@ -108,6 +108,23 @@ public:
   ContinueTrain(bool value = false);
 };
 
+/**
+ * @brief drop last property, drop the last partial batch of an epoch
+ *
+ */
+class DropLast : public Property<bool> {
+public:
+  static constexpr const char *key = "drop_last"; /**< unique key to access */
+  using prop_tag = bool_prop_tag;                 /**< property type */
+
+  /**
+   * @brief Constructor
+   *
+   * @param value value to set, defaults to true
+   */
+  DropLast(bool value = true);
+};
+
 /**
  * @brief model optimization property
  *
@@ -162,7 +179,9 @@ public:
 };
 
 /**
- * @brief cache file path property
+ * @brief memory swap lookahead property, the number of execution orders to
+ * load ahead. It also bounds the cache to the peak size of lookahead + 1
+ * consecutive execution orders.
  *
  */
 class MemorySwapLookahead : public Property<unsigned int> {
@@ -174,7 +193,7 @@ public:
   /**
    * @brief Constructor
    *
-   * @param value value to set, defaults to current directory
+   * @param value value to set, defaults to 0 which loads on demand
    */
   MemorySwapLookahead(const unsigned int &value = 0);
 };
@@ -248,6 +267,134 @@ public:
   bool isValid(const float &value) const override;
 };
 
+/**
+ * @brief number of consecutive steps without overflow to grow the loss scale
+ *
+ */
+class LossScaleGrowthInterval : public PositiveIntegerProperty {
+public:
+  LossScaleGrowthInterval(unsigned int value = 2000);
+  static constexpr const char *key =
+    "loss_scale_growth_interval"; /**< unique key to access */
+  using prop_tag = uint_prop_tag; /**< property type */
+};
+
+/**
+ * @brief factor to grow the loss scale with
+ *
+ */
+class LossScaleGrowthFactor : public Property<float> {
+public:
+  LossScaleGrowthFactor(float value = 2.0f);
+  static constexpr const char *key =
+    "loss_scale_growth_factor";    /**< unique key to access */
+  using prop_tag = float_prop_tag; /**< property type */
+
+  /**
+   * @brief check if valid
+   *
+   * @param value value to check
+   * @return bool true if valid
+   */
+  bool isValid(const float &value) const override;
+};
+
+/**
+ * @brief factor to shrink the loss scale with when the gradient overflows
+ *
+ */
+class LossScaleBackoffFactor : public Property<float> {
+public:
+  LossScaleBackoffFactor(float value = 0.5f);
+  static constexpr const char *key =
+    "loss_scale_backoff_factor";   /**< unique key to access */
+  using prop_tag = float_prop_tag; /**< property type */
+
+  /**
+   * @brief check if valid
+   *
+   * @param value value to check
+   * @return bool true if valid
+   */
+  bool isValid(const float &value) const override;
+};
+
+/**
+ * @brief     Enumeration of the action on the gradient overflow
+ */
+struct LossScaleOverflowInfo {
+  /**
+   * @brief RETRY recomputes the step from the overflowed layer with the shrunk
+   * scale, SKIP drops the step without updating the weights
+   */
+  enum Enum { RETRY, SKIP };
+  static constexpr std::initializer_list<Enum> EnumList = {Enum::RETRY,
+                                                           Enum::SKIP};
+
+  static constexpr const char *EnumStr[] = {"retry", "skip"};
+};
+
+/**
+ * @brief action on the gradient overflow property
+ *
+ */
+class LossScaleOverflow final : public EnumProperty<LossScaleOverflowInfo> {
+public:
+  using prop_tag = enum_class_prop_tag;
+  static constexpr const char *key = "loss_scale_on_overflow";
+
+  /**
+   * @brief Constructor
+   *
+   * @param value value to set, defaults to RETRY
+   */
+  LossScaleOverflow(
+    LossScaleOverflowInfo::Enum value = LossScaleOverflowInfo::Enum::RETRY);
+};
+
+/**
+ * @brief number of tokens in a page of the kv cache
+ *
+ */
+class KVCachePageSize : public PositiveIntegerProperty {
+public:
+  KVCachePageSize(unsigned int value = 16);
+  static constexpr const char *key =
+    "kv_cache_page_size";         /**< unique key to access */
+  using prop_tag = uint_prop_tag; /**< property type */
+};
+
+/**
+ * @brief number of pages of the kv cache, 0 to disable the kv cache
+ *
+ */
+class KVCachePages : public Property<unsigned int> {
+public:
+  KVCachePages(unsigned int value = 0);
+  static constexpr const char *key =
+    "kv_cache_pages";             /**< unique key to access */
+  using prop_tag = uint_prop_tag; /**< property type */
+};
+
+/**
+ * @brief fold batch normalization and activation layers into the preceding
+ * convolution or fully connected layer when compiled for inference
+ *
+ */
+class InferenceFusion : public Property<bool> {
+public:
+  static constexpr const char *key =
+    "inference_fusion";           /**< unique key to access */
+  using prop_tag = bool_prop_tag; /**< property type */
+
+  /**
+   * @brief Constructor
+   *
+   * @param value value to set, defaults to false
+   */
+  InferenceFusion(bool value = false);
+};
+
 } // namespace nntrainer::props
 
 #endif
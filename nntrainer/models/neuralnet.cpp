@@ -24,16 +24,19 @@
 #include "layer_context.h"
 #include "model_common_properties.h"
 #include <cmath>
+#include <cstdint>
 #include <cstring>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
+#include <unordered_map>
 
 #include <activation_realizer.h>
 #include <common_properties.h>
 #include <databuffer.h>
 #include <flatten_realizer.h>
+#include <fusion_realizer.h>
 #include <ini_interpreter.h>
 #include <ini_wrapper.h>
 #include <input_realizer.h>
@@ -64,15 +67,31 @@
 
 namespace nntrainer {
 
+/**
+ * @brief MODEL_FORMAT_MMAP_BIN starts with the magic and the offset of the
+ * weight pool image, followed by the version, epoch_idx, iter, the size of the
+ * weight pool and the name, offset and size of each weight. The image of the
+ * weight pool starts at the offset, which is aligned to MMAP_BIN_ALIGNMENT.
+ */
+static constexpr char MMAP_BIN_MAGIC[8] = {'N', 'N', 'T', 'R',
+                                           'M', 'M', 'A', 'P'};
+static constexpr uint32_t MMAP_BIN_VERSION = 1;
+static constexpr uint64_t MMAP_BIN_ALIGNMENT =
+  64 * 1024; /**< multiple of the page sizes in use */
+
 NeuralNetwork::NeuralNetwork() :
   model_props(props::LossType(), {}, {}, props::ClipGradByGlobalNorm(),
-              props::LossScale()),
+              props::LossScale(), props::LossScaleGrowthInterval(),
+              props::LossScaleGrowthFactor(), props::LossScaleBackoffFactor(),
+              props::LossScaleOverflow()),
   model_flex_props(props::Epochs(), props::TrainingBatchSize(),
                    props::SavePath(), props::ContinueTrain(),
                    props::SaveBestPath(), props::MemoryOptimization(),
                    props::MemorySwap(), props::MemorySwapPath(),
                    props::MemorySwapLookahead(), props::TensorFormat(),
-                   props::ModelTensorDataType(), props::MemorySwapMode()),
+                   props::ModelTensorDataType(), props::MemorySwapMode(),
+                   props::DropLast(), props::KVCachePageSize(),
+                   props::KVCachePages(), props::InferenceFusion()),
   load_path(std::string()),
   epoch_idx(0),
   iter(0),
@@ -87,13 +106,17 @@ NeuralNetwork::NeuralNetwork() :
 
 NeuralNetwork::NeuralNetwork(AppContext app_context_) :
   model_props(props::LossType(), {}, {}, props::ClipGradByGlobalNorm(),
-              props::LossScale()),
+              props::LossScale(), props::LossScaleGrowthInterval(),
+              props::LossScaleGrowthFactor(), props::LossScaleBackoffFactor(),
+              props::LossScaleOverflow()),
   model_flex_props(props::Epochs(), props::TrainingBatchSize(),
                    props::SavePath(), props::ContinueTrain(),
                    props::SaveBestPath(), props::MemoryOptimization(),
                    props::MemorySwap(), props::MemorySwapPath(),
                    props::MemorySwapLookahead(), props::TensorFormat(),
-                   props::ModelTensorDataType(), props::MemorySwapMode()),
+                   props::ModelTensorDataType(), props::MemorySwapMode(),
+                   props::DropLast(), props::KVCachePageSize(),
+                   props::KVCachePages(), props::InferenceFusion()),
   load_path(std::string()),
   epoch_idx(0),
   iter(0),
@@ -163,6 +186,14 @@ int NeuralNetwork::compile(ExecutionMode mode) {
   /// graph.compile(), neuralnetwork have ownership of list of layer nodes,
   /// which will be passed at compile time.
 
+  /// keep the configuration before realization to create sessions from,
+  /// the nodes cannot be cloned once they are finalized
+  if (!initialized) {
+    original_representation.clear();
+    for (auto &node : graph_representation)
+      original_representation.push_back(node->cloneConfiguration());
+  }
+
   std::vector<std::unique_ptr<GraphRealizer>> realizers;
 
   realizers.emplace_back(new PreviousInputRealizer(
@@ -170,6 +201,10 @@ int NeuralNetwork::compile(ExecutionMode mode) {
   realizers.emplace_back(new MultioutRealizer());
   realizers.emplace_back(new FlattenRealizer());
   realizers.emplace_back(new ActivationRealizer());
+  if (mode == ExecutionMode::INFERENCE &&
+      std::get<props::InferenceFusion>(model_flex_props)) {
+    realizers.emplace_back(new FusionRealizer());
+  }
 
   for (auto &realizer : realizers) {
     graph_representation = realizer->realize(graph_representation);
@@ -192,6 +227,18 @@ int NeuralNetwork::compile(ExecutionMode mode) {
 
   model_graph.setMemoryOptimizations(
     std::get<props::MemoryOptimization>(model_flex_props));
+  if (auto &pages = std::get<props::KVCachePages>(model_flex_props);
+      pages.get() > 0) {
+    model_graph.setKVCache(std::get<props::KVCachePageSize>(model_flex_props),
+                           pages);
+  }
+  model_graph.setLossScaler(DynamicLossScaler(
+    std::get<props::LossScale>(model_props),
+    std::get<props::LossScaleGrowthInterval>(model_props),
+    std::get<props::LossScaleGrowthFactor>(model_props),
+    std::get<props::LossScaleBackoffFactor>(model_props),
+    std::get<props::LossScaleOverflow>(model_props).get() ==
+      props::LossScaleOverflowInfo::Enum::SKIP));
   for (auto &node : graph_representation) {
     if (auto &prop = std::get<props::ClipGradByGlobalNorm>(model_props);
         !prop.empty()) {
@@ -472,9 +519,11 @@ void NeuralNetwork::backwarding(int iteration,
         RunLayerContext &rc = node->getRunContext();
         if (model_graph.isMixedPrecision()) {
           for (auto w : rc.getWeights()) {
-            if (w->hasGradient())
+            if (w->hasGradient()) {
+              w->densifyGradient();
               if (!w->getGradientRef().isValid())
                 return false;
+            }
           }
         }
       }
@@ -560,6 +609,10 @@ void NeuralNetwork::save(const std::string &file_path,
     saveModelIni(file_path);
     break;
 
+  case ml::train::ModelFormat::MODEL_FORMAT_MMAP_BIN:
+    saveWeightImage(file_path);
+    break;
+
   case ml::train::ModelFormat::MODEL_FORMAT_INI_WITH_BIN: {
     auto old_save_path = std::get<props::SavePath>(model_flex_props);
     auto bin_file_name =
@@ -619,6 +672,14 @@ void NeuralNetwork::load(const std::string &file_path,
     ml_logi("read modelfile: %s", file_path.c_str());
     break;
   }
+  case ml::train::ModelFormat::MODEL_FORMAT_MMAP_BIN: {
+    NNTR_THROW_IF(!initialized, std::runtime_error)
+      << "Cannot load if not initialized yet, path: " << file_path
+      << " format: " << static_cast<unsigned>(format);
+
+    loadWeightImage(file_path);
+    break;
+  }
   case ml::train::ModelFormat::MODEL_FORMAT_INI_WITH_BIN: {
     int ret = loadFromConfig(file_path);
     throw_status(ret);
@@ -667,6 +728,124 @@ NeuralNetwork &NeuralNetwork::copy(NeuralNetwork &from) {
   return *this;
 }
 
+void NeuralNetwork::saveWeightImage(const std::string &file_path) {
+  constexpr const char *error_msg =
+    "[NeuralNetwork::saveWeightImage] failed to write";
+  auto locations = model_graph.getWeightLocations();
+  uint64_t pool_size = model_graph.getWeightPoolSize();
+
+  std::ostringstream header;
+  auto put = [&header, error_msg](const auto &value) {
+    checkedWrite(header, reinterpret_cast<const char *>(&value), sizeof(value),
+                 error_msg);
+  };
+  put(MMAP_BIN_VERSION);
+  put(static_cast<uint32_t>(epoch_idx));
+  put(static_cast<uint32_t>(iter));
+  put(pool_size);
+  put(static_cast<uint64_t>(locations.size()));
+  for (auto &loc : locations) {
+    put(static_cast<uint64_t>(loc.name.size()));
+    checkedWrite(header, loc.name.data(), loc.name.size(), error_msg);
+    put(static_cast<uint64_t>(loc.offset));
+    put(static_cast<uint64_t>(loc.bytes));
+  }
+
+  const std::string &body = header.str();
+  uint64_t data_offset =
+    (sizeof(MMAP_BIN_MAGIC) + sizeof(uint64_t) + body.size() +
+     MMAP_BIN_ALIGNMENT - 1) /
+    MMAP_BIN_ALIGNMENT * MMAP_BIN_ALIGNMENT;
+
+  auto model_file = checkedOpenStream<std::ofstream>(
+    file_path, std::ios::out | std::ios::binary | std::ios::trunc);
+  checkedWrite(model_file, MMAP_BIN_MAGIC, sizeof(MMAP_BIN_MAGIC), error_msg);
+  checkedWrite(model_file, reinterpret_cast<const char *>(&data_offset),
+               sizeof(data_offset), error_msg);
+  checkedWrite(model_file, body.data(), body.size(), error_msg);
+
+  /** the file spans the whole pool, so that the pool can be mapped */
+  if (pool_size > 0) {
+    model_file.seekp(data_offset + pool_size - 1);
+    checkedWrite(model_file, "", 1, error_msg);
+  }
+  for (auto &loc : locations) {
+    model_file.seekp(data_offset + loc.offset);
+    checkedWrite(model_file, loc.var->getData<char>(), loc.bytes, error_msg);
+  }
+
+  model_file.close();
+}
+
+void NeuralNetwork::loadWeightImage(const std::string &file_path) {
+  constexpr const char *error_msg =
+    "[NeuralNetwork::loadWeightImage] failed to read";
+  auto model_file = checkedOpenStream<std::ifstream>(
+    file_path, std::ios::in | std::ios::binary);
+  auto get = [&model_file, error_msg](auto &value) {
+    checkedRead(model_file, reinterpret_cast<char *>(&value), sizeof(value),
+                error_msg);
+  };
+
+  char magic[sizeof(MMAP_BIN_MAGIC)];
+  uint32_t version, epoch, iteration;
+  uint64_t data_offset, pool_size, num_weights;
+  checkedRead(model_file, magic, sizeof(magic), error_msg);
+  NNTR_THROW_IF(std::memcmp(magic, MMAP_BIN_MAGIC, sizeof(magic)) != 0,
+                std::invalid_argument)
+    << "Not a weight image, path: " << file_path;
+  get(data_offset);
+  get(version);
+  NNTR_THROW_IF(version != MMAP_BIN_VERSION, std::invalid_argument)
+    << "Unsupported version of the weight image: " << version;
+  get(epoch);
+  get(iteration);
+  get(pool_size);
+  get(num_weights);
+
+  auto locations = model_graph.getWeightLocations();
+  bool same_layout = pool_size == model_graph.getWeightPoolSize() &&
+                     num_weights == locations.size();
+
+  std::unordered_map<std::string, std::pair<uint64_t, uint64_t>> image;
+  for (uint64_t i = 0; i < num_weights; ++i) {
+    uint64_t name_len, offset, bytes;
+    get(name_len);
+    std::string name(name_len, '\0');
+    checkedRead(model_file, name.data(), name_len, error_msg);
+    get(offset);
+    get(bytes);
+
+    same_layout = same_layout && locations[i].name == name &&
+                  locations[i].offset == offset && locations[i].bytes == bytes;
+    image[name] = {offset, bytes};
+  }
+
+  epoch_idx = epoch;
+  iter = iteration;
+
+  if (same_layout) {
+    model_graph.mapWeights(file_path, data_offset);
+    ml_logi("mapped modelfile: %s", file_path.c_str());
+    return;
+  }
+
+  /** the layout differs when the model is configured differently */
+  ml_logw("weight layout of %s differs from the model, reading the weights",
+          file_path.c_str());
+  for (auto &loc : locations) {
+    auto found = image.find(loc.name);
+    NNTR_THROW_IF(found == image.end() || found->second.second != loc.bytes,
+                  std::invalid_argument)
+      << "Weight " << loc.name << " is not found in the weight image";
+
+    model_file.seekg(data_offset + found->second.first);
+    checkedRead(model_file, loc.var->getData<char>(), loc.bytes, error_msg);
+  }
+
+  ml_logi("read modelfile: %s", file_path.c_str());
+}
+
 void NeuralNetwork::saveModelIni(const std::string &file_path) {
   NNTR_THROW_IF(isFileExist(file_path), std::invalid_argument)
     << "There is already a file, overriding to the existing file is not "
@@ -733,6 +912,25 @@ bool NeuralNetwork::validateInput(sharedConstTensors X) {
   return true;
 }
 
+std::unique_ptr<NeuralNetwork> NeuralNetwork::createSession() {
+  NNTR_THROW_IF(!initialized, std::runtime_error)
+    << "Cannot create a session of the model not initialized yet";
+
+  auto session = std::make_unique<NeuralNetwork>(app_context);
+  session->model_props = model_props;
+  session->model_flex_props = model_flex_props;
+  for (auto &node : original_representation)
+    session->addLayer(NodeType(node->cloneConfiguration()));
+
+  throw_status(session->compile(ExecutionMode::INFERENCE));
+  throw_status(session->initialize(ExecutionMode::INFERENCE));
+  session->model_graph.shareWeights(model_graph);
+  session->epoch_idx = epoch_idx;
+  session->iter = iter;
+
+  return session;
+}
+
 sharedConstTensors NeuralNetwork::inference(sharedConstTensors X,
                                             bool free_mem) {
   return inference(X, {}, free_mem);
@@ -749,7 +947,9 @@ sharedConstTensors NeuralNetwork::inference(sharedConstTensors X,
   if (!validateInput(X))
     throw std::invalid_argument("Input validation failed.");
 
-  allocate(ExecutionMode::INFERENCE);
+  /** the tensors allocated by the previous inference are reused as is */
+  if (!model_graph.isAllocated(ExecutionMode::INFERENCE))
+    allocate(ExecutionMode::INFERENCE);
 
   int nn_foward;
   PROFILE_TIME_REGISTER_EVENT(nn_foward, "nn_forward");
@@ -848,6 +1048,40 @@ sharedConstTensors NeuralNetwork::incremental_inference(
   return out;
 }
 
+sharedConstTensors NeuralNetwork::incremental_inference(
+  sharedConstTensors X, const std::vector<unsigned int> &sequences,
+  unsigned int step_len) {
+  KVCacheManager *kv_cache = model_graph.getKVCacheManager();
+  NNTR_THROW_IF(kv_cache == nullptr, std::invalid_argument)
+    << "kv_cache_pages is not set for the model";
+
+  if (model_graph.getBatchSize() != X[0]->batch()) {
+    model_graph.setBatchSize(X[0]->batch());
+  }
+
+  if (!validateInput(X))
+    throw std::invalid_argument("Input validation failed.");
+
+  /** the tensors are kept allocated between the steps */
+  model_graph.allocateTensors(ExecutionMode::INFERENCE);
+
+  sharedConstTensors out;
+  kv_cache->beginStep(sequences, step_len);
+  try {
+    out = incremental_forwarding(0, step_len, X, {}, false);
+  } catch (...) {
+    kv_cache->endStep(false);
+    model_graph.setInputsLabels({}, {});
+    throw;
+  }
+  kv_cache->endStep();
+
+  /** Clear the set inputs and labels */
+  model_graph.setInputsLabels({}, {});
+
+  return out;
+}
+
 std::vector<float *> NeuralNetwork::incremental_inference(
   unsigned int batch_size, const std::vector<float *> &input,
   const std::vector<float *> &label, unsigned int init_seq_len,
@@ -995,8 +1229,8 @@ int NeuralNetwork::train_run(
   }
 
   auto batch_size = std::get<props::TrainingBatchSize>(model_flex_props);
+  bool drop_last = std::get<props::DropLast>(model_flex_props);
 
-  auto const &outputs = model_graph.getOutputTensors();
   auto in_dims = model_graph.getInputDimension();
   auto label_dims = model_graph.getOutputDimension();
 
@@ -1017,7 +1251,7 @@ int NeuralNetwork::train_run(
    * @param on_epoch_end function that will receive reference to stat,
    * buffer which will be called on the epoch end
    */
-  auto run_epoch = [this, &in_dims, &label_dims, &outputs, batch_size](
+  auto run_epoch = [this, &in_dims, &label_dims, batch_size, drop_last](
                      DataBuffer *buffer, bool shuffle,
                      auto &&on_iteration_fetch, auto &&on_iteration_update_stat,
                      auto &&on_epoch_end, RunStats &stat) {
@@ -1029,6 +1263,7 @@ int NeuralNetwork::train_run(
     stat.loss = 0.0;
     stat.num_iterations = 0;
     stat.num_correct_predictions = 0;
+    stat.num_overflows = 0;
     stat.max_epoch = getEpochs();
     stat.epoch_idx = epoch_idx;
 
@@ -1040,19 +1275,32 @@ int NeuralNetwork::train_run(
         break;
       }
       auto &iteration = iter_view.get();
-      if (iteration.batch() != static_cast<unsigned int>(batch_size)) {
-        /// @todo support partial batch
+      unsigned int current_batch = iteration.batch();
+      if (current_batch != static_cast<unsigned int>(batch_size) && drop_last)
         continue;
-      }
 
-      auto const &labels = iteration.getLabelsRef();
-      auto const &inputs = iteration.getInputsRef();
+      std::vector<Tensor> labels = iteration.getLabelsRef();
+      std::vector<Tensor> inputs = iteration.getInputsRef();
+      if (current_batch != model_graph.getBatchSize()) {
+        /** partial batch runs with the shrunk batch of the graph */
+        model_graph.setBatchSize(current_batch);
+      }
+      if (current_batch != static_cast<unsigned int>(batch_size)) {
+        for (auto &t : inputs)
+          t = t.getBatchSlice(0, current_batch);
+        for (auto &t : labels)
+          t = t.getBatchSlice(0, current_batch);
+      }
       model_graph.setInputsLabels(inputs, labels);
 
       on_iteration_fetch(stat, *buffer);
-      on_iteration_update_stat(stat, outputs, labels);
+      on_iteration_update_stat(stat, model_graph.getOutputTensors(), labels);
     }
     future_iq.get();
+
+    if (model_graph.getBatchSize() != static_cast<unsigned int>(batch_size))
+      model_graph.setBatchSize(batch_size);
+
     on_epoch_end(stat, *buffer);
 
     if (stat.num_iterations == 0) {
@@ -1065,9 +1313,15 @@ int NeuralNetwork::train_run(
   auto train_for_iteration =
     [this, stop_cb, stop_user_data](RunStats &stat, DataBuffer &buffer) {
       ml_logi("train for iteration");
+      auto &scaler = model_graph.getLossScaler();
+      unsigned int num_overflows = scaler.getNumOverflows();
+
       forwarding(true, stop_cb, stop_user_data);
       backwarding(iter++, stop_cb, stop_user_data);
 
+      stat.num_overflows += scaler.getNumOverflows() - num_overflows;
+      stat.loss_scale = scaler.getScale();
+
       // To avoid unconsidered memory leak, we need to clear the cache
       model_graph.flushCache();
 
@@ -1118,32 +1372,35 @@ int NeuralNetwork::train_run(
     forwarding(false, stop_cb, stop_user_data);
   };
 
-  auto update_eval_stat = [batch_size, &update_train_stat](
+  unsigned int num_eval_samples = 0;
+  auto update_eval_stat = [&num_eval_samples, &update_train_stat](
                             RunStats &stat, const std::vector<Tensor> &outputs,
                             const std::vector<Tensor> &labels) {
     auto model_out = outputs[0].argmax();
     auto label_out = labels[0].argmax();
 
-    for (unsigned int b = 0; b < batch_size; b++) {
+    for (unsigned int b = 0; b < model_out.size(); b++) {
       if (model_out[b] == label_out[b])
         stat.num_correct_predictions++;
     }
+    num_eval_samples += model_out.size();
 
     update_train_stat(stat, outputs, labels);
   };
 
-  auto eval_epoch_end = [this, batch_size, max_acc = 0.0f,
+  auto eval_epoch_end = [this, &num_eval_samples, max_acc = 0.0f,
                          min_loss = std::numeric_limits<float>::max()](
                           RunStats &stat, DataBuffer &buffer) mutable {
+    unsigned int num_samples = num_eval_samples;
+    num_eval_samples = 0;
     if (stat.num_iterations != 0) {
       stat.loss /= static_cast<float>(stat.num_iterations);
     } else {
       std::cerr << "stat.num_iterations is 0" << std::endl;
       return;
     }
-    stat.accuracy = stat.num_correct_predictions /
-                    static_cast<float>(stat.num_iterations * batch_size) *
-                    100.0f;
+    stat.accuracy =
+      stat.num_correct_predictions / static_cast<float>(num_samples) * 100.0f;
 
     if (stat.accuracy > max_acc ||
         (stat.accuracy == max_acc && stat.loss < min_loss)) {
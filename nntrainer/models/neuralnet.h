@@ -339,6 +339,21 @@ public:
       [](void *epoch_user_data) { return false; },
     void *epoch_user_data = nullptr) override;
 
+  /**
+   * @brief     Create an inference session of this model
+   * @details   A session is a model of the same configuration, compiled and
+   * initialized for inference, whose weights share the memory of the weights
+   * of this model. Each session owns its tensors, inputs and outputs, so
+   * sessions run inference in parallel from different threads while a single
+   * model is not safe to be run from multiple threads.
+   * @note      The weights must not be changed while the sessions run. The
+   * memory of the weights is kept until this model and every session free it.
+   * @retval    created session
+   * @throw     std::invalid_argument when the weights of this model cannot be
+   * shared with the session, e.g., swapped weights or a different layout.
+   */
+  std::unique_ptr<NeuralNetwork> createSession();
+
   /**
    * @brief     Run NeuralNetwork inference
    * @param[in] X input tensor
@@ -393,6 +408,26 @@ s   * @retval shared_ptr<const Tensor>
                                            unsigned int init_seq_len,
                                            unsigned int from, unsigned int to);
 
+  /**
+   * @brief     Run a step of the incremental inference over the paged kv cache
+   * @param[in] X input tensor of the step_len tokens of each sequence
+   * @param[in] sequences kv cache sequence of each batch of X
+   * @param[in] step_len number of tokens of the step
+   * @retval shared_ptr<const Tensor>
+   * @note The tokens are appended to the sequences only if the step succeeds
+   */
+  sharedConstTensors incremental_inference(
+    sharedConstTensors X, const std::vector<unsigned int> &sequences,
+    unsigned int step_len);
+
+  /**
+   * @brief     Get the paged kv cache of the model
+   * @retval KVCacheManager* kv cache, nullptr if kv_cache_pages is not set
+   */
+  KVCacheManager *getKVCacheManager() {
+    return model_graph.getKVCacheManager();
+  }
+
   /**
    * @brief     Run the incremental inference of the model
    * @param[in] batch batch size of current input
@@ -629,11 +664,15 @@ private:
     props::Epochs, props::TrainingBatchSize, props::SavePath,
     props::ContinueTrain, props::SaveBestPath, props::MemoryOptimization,
     props::MemorySwap, props::MemorySwapPath, props::MemorySwapLookahead,
-    props::TensorFormat, props::ModelTensorDataType, props::MemorySwapMode>;
+    props::TensorFormat, props::ModelTensorDataType, props::MemorySwapMode,
+    props::DropLast, props::KVCachePageSize, props::KVCachePages,
+    props::InferenceFusion>;
   using RigidPropTypes =
     std::tuple<props::LossType, std::vector<props::InputConnection>,
                std::vector<props::LabelLayer>, props::ClipGradByGlobalNorm,
-               props::LossScale>;
+               props::LossScale, props::LossScaleGrowthInterval,
+               props::LossScaleGrowthFactor, props::LossScaleBackoffFactor,
+               props::LossScaleOverflow>;
 
   RigidPropTypes model_props;         /**< model props */
   FlexiblePropTypes model_flex_props; /**< model train props */
@@ -678,6 +717,9 @@ private:
 
   NetworkGraph model_graph;                 /** Network Model Graph */
   GraphRepresentation graph_representation; /** Unsorted graph representation */
+  GraphRepresentation
+    original_representation; /** configuration of the layers before the
+                                realization, to create sessions */
 
   DynamicTrainingOptimization dynamic_training_opt; /**< Dynamic fine-tuning
    optimization mode. supported modes are "max" and "norm" */
@@ -691,6 +733,22 @@ private:
    */
   void saveModelIni(const std::string &file_path);
 
+  /**
+   * @brief save the weight pool as an image which can be mapped at load
+   *
+   * @param file_path file path
+   */
+  void saveWeightImage(const std::string &file_path);
+
+  /**
+   * @brief load the weights from the image saved by saveWeightImage()
+   *
+   * @param file_path file path
+   * @details The weight pool maps the image when the layout of the pool is
+   * the same as the saved one. Otherwise, each weight is read from the image.
+   */
+  void loadWeightImage(const std::string &file_path);
+
   /**
    * @brief print function for neuralnet
    * @param[in] out outstream
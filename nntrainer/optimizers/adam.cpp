@@ -15,6 +15,7 @@
 #include <fstream>
 
 #include <adam.h>
+#include <blas_interface.h>
 #include <nntrainer_error.h>
 #include <nntrainer_log.h>
 #include <node_exporter.h>
@@ -22,13 +23,15 @@
 
 namespace nntrainer {
 
-Adam::Adam() : adam_props(PropsB1(), PropsB2(), PropsEpsilon(), TorchRef()) {
+Adam::Adam() :
+  adam_props(PropsB1(), PropsB2(), PropsEpsilon(), TorchRef(), LazyUpdate()) {
   /** default properties */
-  auto &[b1, b2, eps, torch_ref] = adam_props;
+  auto &[b1, b2, eps, torch_ref, lazy_update] = adam_props;
   b1.set(0.9f);
   b2.set(0.999f);
   eps.set(1.0e-7f);
   torch_ref.set(false);
+  lazy_update.set(false);
 }
 
 Adam::~Adam() {}
@@ -58,6 +61,10 @@ void Adam::setProperty(const std::vector<std::string> &values) {
   Optimizer::setProperty(left);
 }
 
+bool Adam::supportsRowSparseGradient() const {
+  return std::get<LazyUpdate>(adam_props).get();
+}
+
 double Adam::getUpdatedLearningRate(unsigned int iteration, double ll) const {
   auto &beta1 = std::get<PropsB1>(adam_props).get();
   auto &beta2 = std::get<PropsB2>(adam_props).get();
@@ -72,57 +79,101 @@ double Adam::getUpdatedLearningRate(unsigned int iteration, double ll) const {
 }
 
 void Adam::applyGradient(RunOptimizerContext &context) {
-  Tensor empty_tensor;
-
-  Tensor &x_grad =
-    context.getGradient().getDataType() == ml::train::TensorDim::DataType::FP32
-      ? context.getGradient()
-      : empty_tensor;
-
-  if (x_grad.empty()) {
-    x_grad = context.getGradient().clone(ml::train::TensorDim::DataType::FP32);
-  }
-
-  context.applyLossScale(x_grad);
-
   auto &beta1 = std::get<PropsB1>(adam_props).get();
   auto &beta2 = std::get<PropsB2>(adam_props).get();
   auto &epsilon = std::get<PropsEpsilon>(adam_props).get();
   auto &torch_ref = std::get<TorchRef>(adam_props).get();
 
-  // This is implementation of adam from original paper.
-  // This is not deleted intentionally.
   unsigned int iteration = context.getIteration();
-  float biasCorrection1 = 1 - pow(beta1, iteration + 1);
-  float biasCorrection2 = 1 - pow(beta2, iteration + 1);
+
+  if (torch_ref) {
+    float biasCorrection1 = 1 - pow(beta1, iteration + 1);
+    float biasCorrection2 = 1 - pow(beta2, iteration + 1);
+    applyFusedAdam(context, beta1, beta2, epsilon,
+                   1.0f / sqrtFloat(biasCorrection2),
+                   context.getLearningRate() / biasCorrection1);
+  } else {
+    // This is implementation of adam from original paper.
+    double lr = getUpdatedLearningRate(iteration, context.getLearningRate());
+    applyFusedAdam(context, beta1, beta2, epsilon, 1.0f, lr);
+  }
+}
+
+void applyFusedAdam(RunOptimizerContext &context, double beta1, double beta2,
+                    float epsilon, float v_scale, float step_size,
+                    float decay) {
+  Tensor &var = context.getWeight();
+  Tensor &grad = context.getGradient();
   Tensor &wm = context.getOptimizerVariable(AdamParams::wm);
   Tensor &wv = context.getOptimizerVariable(AdamParams::wv);
 
-  wm.multiply_i(beta1);
-  wm.add_i(x_grad, 1.0f - beta1);
+  NNTR_THROW_IF(wm.getDataType() != ml::train::TensorDim::DataType::FP32 ||
+                  wv.getDataType() != ml::train::TensorDim::DataType::FP32,
+                std::invalid_argument)
+    << "adam moments should be full precision";
 
-  wv.multiply_i(beta2);
-  wv.add_i(x_grad.multiply(x_grad), 1.0f - beta2);
-
-  if (torch_ref) {
-    Tensor denom = wv.apply<float>(sqrtFloat<float>);
-    denom.divide_i(sqrtFloat(biasCorrection2));
-    denom.add_i(epsilon);
-    wm.divide(denom, x_grad);
+  const bool is_mixed = context.isMixedPrecision();
+  const bool var_fp32 =
+    var.getDataType() == ml::train::TensorDim::DataType::FP32;
+  const float grad_scale = is_mixed ? 1.0f / context.getLossScale() : 1.0f;
+  const unsigned int len = var.size();
 
-    context.applyGradient(context.getLearningRate() / biasCorrection1, x_grad);
+  /** full precision weight to be updated in place */
+  Tensor empty_tensor;
+  Tensor &w32 = var_fp32   ? var
+                : is_mixed ? context.getWeightFP32()
+                           : empty_tensor;
+  if (w32.empty())
+    w32 = var.clone(ml::train::TensorDim::DataType::FP32);
+
+  float *w = w32.getData<float>();
+  float *m = wm.getData<float>();
+  float *v = wv.getData<float>();
+
+  /** spans of {offset, length} to be updated */
+  std::vector<std::pair<size_t, unsigned int>> spans;
+  if (context.isGradientRowSparse()) {
+    const unsigned int width = var.width();
+    for (auto row : context.getGradientRows())
+      spans.emplace_back(static_cast<size_t>(row) * width, width);
+  } else {
+    spans.emplace_back(0, len);
+  }
 
+  if (grad.getDataType() == ml::train::TensorDim::DataType::FP32) {
+    const float *g = grad.getData<float>();
+    for (auto &[off, n] : spans)
+      adam_update(n, g + off, w + off, m + off, v + off, grad_scale, beta1,
+                  beta2, epsilon, v_scale, step_size, decay);
+#ifdef ENABLE_FP16
+  } else if (grad.getDataType() == ml::train::TensorDim::DataType::FP16) {
+    /** half precision weight is written in the same pass */
+    _FP16 *w16 = var.getDataType() == ml::train::TensorDim::DataType::FP16
+                   ? var.getData<_FP16>()
+                   : nullptr;
+    const _FP16 *g = grad.getData<_FP16>();
+    for (auto &[off, n] : spans)
+      adam_update(n, g + off, w + off, w16 ? w16 + off : nullptr, m + off,
+                  v + off, grad_scale, beta1, beta2, epsilon, v_scale,
+                  step_size, decay);
+    if (w16 != nullptr)
+      return;
+#endif
   } else {
-    std::function<double(double)> sqrtEps = [epsilon](double f) {
-      return 1 / (sqrtDouble(f) + epsilon);
-    };
-
-    x_grad = wv.apply<float>(sqrtEps, x_grad);
-    x_grad.multiply_i(wm);
-    context.applyGradient(
-      getUpdatedLearningRate(context.getIteration(), context.getLearningRate()),
-      x_grad);
+    Tensor grad32 = grad.clone(ml::train::TensorDim::DataType::FP32);
+    const float *g = grad32.getData<float>();
+    for (auto &[off, n] : spans)
+      adam_update(n, g + off, w + off, m + off, v + off, grad_scale, beta1,
+                  beta2, epsilon, v_scale, step_size, decay);
   }
+
+  if (var_fp32)
+    return;
+
+  if (is_mixed)
+    context.quantizeWeight();
+  else
+    var.copyData(w32);
 }
 
 } // namespace nntrainer
@@ -62,6 +62,17 @@ public:
   using prop_tag = bool_prop_tag;                 /**< property type */
 };
 
+/**
+ * @brief update only the rows valid in the row-sparse gradient
+ * @details moments of the other rows are not decayed in the iteration
+ *
+ */
+class LazyUpdate : public Property<bool> {
+public:
+  static constexpr const char *key = "lazy_update"; /**< unique key to access */
+  using prop_tag = bool_prop_tag;                   /**< property type */
+};
+
 /**
  * @class   Adam optimizer class
  * @brief   Adam optimizer
@@ -115,8 +126,13 @@ public:
    */
   void setProperty(const std::vector<std::string> &values) override;
 
+  /**
+   * @copydoc Optimizer::supportsRowSparseGradient()
+   */
+  bool supportsRowSparseGradient() const override;
+
 private:
-  std::tuple<PropsB1, PropsB2, PropsEpsilon, TorchRef> adam_props;
+  std::tuple<PropsB1, PropsB2, PropsEpsilon, TorchRef, LazyUpdate> adam_props;
 
   /**
    * @brief Get updated learning rate
@@ -127,6 +143,26 @@ private:
    */
   double getUpdatedLearningRate(unsigned int iteration, double ll) const;
 };
+
+/**
+ * @brief Apply the fused Adam update to the weight of the context
+ * @details Gradient, first and second moments are read once and the moments
+ * and the weight are updated in place. The loss scale of mixed precision
+ * training is removed in the same pass. Only the valid rows are updated if the
+ * gradient is row-sparse.
+ * W = (1 - decay) * W - step_size * m / (sqrt(v) * v_scale + epsilon)
+ *
+ * @param context optimizer context holding the weight and moments
+ * @param beta1 decay rate of the first moment
+ * @param beta2 decay rate of the second moment
+ * @param epsilon epsilon added to the denominator
+ * @param v_scale multiplier for sqrt(v)
+ * @param step_size step size applied to the update
+ * @param decay decoupled weight decay (lr * weight_decay)
+ */
+void applyFusedAdam(RunOptimizerContext &context, double beta1, double beta2,
+                    float epsilon, float v_scale, float step_size,
+                    float decay = 0.0f);
 } /* namespace nntrainer */
 
 #endif /* __cplusplus */
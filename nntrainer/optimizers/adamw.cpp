@@ -23,21 +23,31 @@
 
 namespace nntrainer {
 
-AdamW::AdamW() : adam_props(PropsB1(), PropsB2(), PropsEpsilon(), TorchRef()) {
+AdamW::AdamW() :
+  adam_props(PropsB1(), PropsB2(), PropsEpsilon(), TorchRef(),
+             PropsWeightDecay(), LazyUpdate()) {
   /** default properties */
-  auto &[b1, b2, eps, torch_ref] = adam_props;
+  auto &[b1, b2, eps, torch_ref, weight_decay, lazy_update] = adam_props;
   b1.set(0.9f);
   b2.set(0.999f);
   eps.set(1.0e-7f);
   torch_ref.set(false);
+  weight_decay.set(0.0f);
+  lazy_update.set(false);
 }
 
 AdamW::~AdamW() {}
 
-enum AdamParams { wm, wv };
-
 std::vector<TensorDim> AdamW::getOptimizerVariableDim(const TensorDim &dim) {
-  return {dim, dim};
+  /**
+   * @note moments are kept in full precision as in Adam to maintain the
+   * accuracy in mixed precision training.
+   */
+  TensorDim wm_dim(dim);
+  TensorDim wv_dim(dim);
+  wm_dim.setDataType(ml::train::TensorDim::DataType::FP32);
+  wv_dim.setDataType(ml::train::TensorDim::DataType::FP32);
+  return {wm_dim, wv_dim};
 }
 
 void AdamW::exportTo(Exporter &exporter,
@@ -51,49 +61,24 @@ void AdamW::setProperty(const std::vector<std::string> &values) {
   Optimizer::setProperty(left);
 }
 
-void AdamW::applyGradient(RunOptimizerContext &context) {
-  Tensor empty_tensor;
-
-  Tensor &x_grad =
-    context.getGradient().getDataType() == ml::train::TensorDim::DataType::FP32
-      ? context.getGradient()
-      : empty_tensor;
-
-  if (x_grad.empty()) {
-    x_grad = context.getGradient().clone(ml::train::TensorDim::DataType::FP32);
-  }
-
-  context.applyLossScale(x_grad);
+bool AdamW::supportsRowSparseGradient() const {
+  return std::get<LazyUpdate>(adam_props).get();
+}
 
+void AdamW::applyGradient(RunOptimizerContext &context) {
   auto &beta1 = std::get<PropsB1>(adam_props).get();
   auto &beta2 = std::get<PropsB2>(adam_props).get();
   auto &epsilon = std::get<PropsEpsilon>(adam_props).get();
-  auto &torch_ref = std::get<TorchRef>(adam_props).get();
+  auto &weight_decay = std::get<PropsWeightDecay>(adam_props).get();
 
-  // This is implementation of adam from original paper.
-  // This is not deleted intentionally.
   unsigned int iteration = context.getIteration();
+  double lr = context.getLearningRate();
   float biasCorrection1 = 1 - pow(beta1, iteration + 1);
   float biasCorrection2 = 1 - pow(beta2, iteration + 1);
-  Tensor &wm = context.getOptimizerVariable(AdamParams::wm);
-  Tensor &wv = context.getOptimizerVariable(AdamParams::wv);
-
-  wm.multiply_i(beta1);
-  wm.add_i(x_grad, 1.0f - beta1);
-
-  wv.multiply_i(beta2);
-  wv.add_i(x_grad.multiply(x_grad), 1.0f - beta2);
-
-  wv.divide_i(sqrtFloat(biasCorrection2));
-  std::function<double(double)> sqrtEps = [epsilon](double f) {
-    return 1 / (sqrtDouble(f) + epsilon);
-  };
-  wv.apply<float>(sqrtEps);
-  x_grad = wv;
-  x_grad.divide_i(biasCorrection1);
-  x_grad.multiply_i(wm);
 
-  context.applyGradient(context.getLearningRate(), x_grad);
+  applyFusedAdam(context, beta1, beta2, epsilon,
+                 1.0f / sqrtFloat(biasCorrection2), lr / biasCorrection1,
+                 lr * weight_decay);
 }
 
 } // namespace nntrainer
@@ -24,6 +24,17 @@
 
 namespace nntrainer {
 
+/**
+ * @brief decoupled weight decay props
+ *
+ */
+class PropsWeightDecay : public Property<double> {
+public:
+  static constexpr const char *key =
+    "weight_decay";                 /**< unique key to access */
+  using prop_tag = double_prop_tag; /**< property type */
+};
+
 /**
  * @class   AdamW Optimizer class
  * @brief   AdamW Optimizer
@@ -77,8 +88,15 @@ public:
    */
   void setProperty(const std::vector<std::string> &values) override;
 
+  /**
+   * @copydoc Optimizer::supportsRowSparseGradient()
+   */
+  bool supportsRowSparseGradient() const override;
+
 private:
-  std::tuple<PropsB1, PropsB2, PropsEpsilon, TorchRef> adam_props;
+  std::tuple<PropsB1, PropsB2, PropsEpsilon, TorchRef, PropsWeightDecay,
+             LazyUpdate>
+    adam_props;
 };
 } /* namespace nntrainer */
 
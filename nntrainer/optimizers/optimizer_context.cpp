@@ -62,4 +62,49 @@ void RunOptimizerContext::applyLossScale(Tensor &fp32_grad) {
   float loss_scale = weight->getLossScale();
   fp32_grad.divide_i(loss_scale);
 }
+
+/**
+ * @brief   Check if the weight is trained with mixed precision
+ */
+bool RunOptimizerContext::isMixedPrecision() const {
+  return weight->isMixedPrecision();
+}
+
+/**
+ * @brief   Get the loss scale of the weight
+ */
+float RunOptimizerContext::getLossScale() const {
+  return weight->getLossScale();
+}
+
+/**
+ * @brief   Get the full precision copy of the weight
+ */
+Tensor &RunOptimizerContext::getWeightFP32() const {
+  return weight->getVariableFP32Ref();
+}
+
+/**
+ * @brief   Copy the full precision weight into the weight tensor
+ */
+void RunOptimizerContext::quantizeWeight() const { weight->quantizeWeight(); }
+
+/**
+ * @brief   Check if the gradient is row-sparse
+ */
+bool RunOptimizerContext::isGradientRowSparse() const {
+  return weight->isGradientRowSparse();
+}
+
+/**
+ * @brief   Get the valid rows of the row-sparse gradient
+ */
+const std::vector<unsigned int> &RunOptimizerContext::getGradientRows() const {
+  return weight->getGradientRows();
+}
+
+/**
+ * @brief   Zero the invalid rows of the row-sparse gradient
+ */
+void RunOptimizerContext::densifyGradient() const { weight->densifyGradient(); }
 } // namespace nntrainer
@@ -102,6 +102,52 @@ public:
    */
   void applyLossScale(Tensor &fp32_grad);
 
+  /**
+   * @brief   Check if the weight is trained with mixed precision
+   *
+   * @return true if mixed precision, else false
+   */
+  bool isMixedPrecision() const;
+
+  /**
+   * @brief   Get the loss scale of the weight
+   *
+   * @return loss scale
+   */
+  float getLossScale() const;
+
+  /**
+   * @brief   Get the full precision copy of the weight (mixed precision only)
+   *
+   * @return Tensor& Reference to the full precision weight tensor
+   */
+  Tensor &getWeightFP32() const;
+
+  /**
+   * @brief   Copy the full precision weight into the weight tensor
+   */
+  void quantizeWeight() const;
+
+  /**
+   * @brief   Check if only the rows returned by getGradientRows() of the
+   * gradient are valid
+   *
+   * @return true if the gradient is row-sparse, else false
+   */
+  bool isGradientRowSparse() const;
+
+  /**
+   * @brief   Get the sorted valid rows of the row-sparse gradient
+   *
+   * @return rows of the gradient
+   */
+  const std::vector<unsigned int> &getGradientRows() const;
+
+  /**
+   * @brief   Zero the invalid rows of the row-sparse gradient to make it dense
+   */
+  void densifyGradient() const;
+
 private:
   Weight *weight;       /**< weights for the optimizer */
   size_t iteration;     /**< iteration number */
@@ -96,6 +96,13 @@ public:
    * @retval    Optimizer type
    */
   virtual const std::string getType() const = 0;
+
+  /**
+   * @brief     Check if the optimizer can update only the valid rows of the
+   * row-sparse gradient
+   * @retval    true if supported, else the gradient is made dense beforehand
+   */
+  virtual bool supportsRowSparseGradient() const { return false; }
 };
 
 using CreateOptimizerFunc = nntrainer::Optimizer *(*)();
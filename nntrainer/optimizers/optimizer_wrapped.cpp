@@ -77,6 +77,9 @@ double OptimizerWrapped::getLearningRate(size_t iteration) {
 }
 
 void OptimizerWrapped::applyGradient(RunOptimizerContext &context) {
+  if (context.isGradientRowSparse() && !optimizer->supportsRowSparseGradient())
+    context.densifyGradient();
+
   optimizer->applyGradient(context);
 }
 
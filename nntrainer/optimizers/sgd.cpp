@@ -16,6 +16,25 @@
 namespace nntrainer {
 
 void SGD::applyGradient(RunOptimizerContext &context) {
+  Tensor &var = context.getWeight();
+  Tensor &grad = context.getGradient();
+
+  if (context.isGradientRowSparse()) {
+    if (var.getDataType() == ml::train::TensorDim::DataType::FP32 &&
+        grad.getDataType() == ml::train::TensorDim::DataType::FP32) {
+      /** rows which are not valid in the gradient are left as they are */
+      TensorDim row_dim({1, 1, 1, var.width()}, var.getTensorType());
+      for (auto row : context.getGradientRows()) {
+        Tensor var_row = var.getSharedDataTensor(row_dim, row * var.width());
+        Tensor grad_row = grad.getSharedDataTensor(row_dim, row * var.width());
+        var_row.add_i(grad_row, -context.getLearningRate());
+      }
+      return;
+    }
+
+    context.densifyGradient();
+  }
+
   // @todo This could go inside the context.
   Tensor empty_tensor;
 
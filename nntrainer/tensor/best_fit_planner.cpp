@@ -0,0 +1,275 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file   best_fit_planner.cpp
+ * @date   18 October 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @bug    No known bugs except for NYI items
+ * @brief  This is Best Fit Memory Planner
+ *
+ */
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <best_fit_planner.h>
+
+namespace nntrainer {
+
+namespace {
+
+/**
+ * @brief Placement of the requests over their validity intervals
+ *
+ */
+class StripPacking {
+public:
+  /**
+   * @brief Construct a new Strip Packing object
+   *
+   */
+  StripPacking(
+    const std::vector<size_t> &memory_size,
+    const std::vector<std::pair<unsigned int, unsigned int>> &memory_validity) :
+    size(memory_size), validity(memory_validity), offset(memory_size.size()) {
+    placed.reserve(size.size());
+  }
+
+  /**
+   * @brief Place the requests in the given order
+   *
+   * @param order order of the requests to place
+   * @param bound stop placing once the peak reaches this size
+   * @return peak size of the placement, which is not less than bound if the
+   * placement is stopped
+   */
+  size_t place(const std::vector<unsigned int> &order, size_t bound) {
+    size_t peak = 0;
+    placed.clear();
+
+    for (auto idx : order) {
+      offset[idx] = findOffset(idx);
+      peak = std::max(peak, offset[idx] + size[idx]);
+      if (peak >= bound)
+        return peak;
+
+      auto pos = std::upper_bound(
+        placed.begin(), placed.end(), idx,
+        [this](auto a, auto b) { return offset[a] < offset[b]; });
+      placed.insert(pos, idx);
+    }
+
+    return peak;
+  }
+
+  /**
+   * @brief Get the offsets of the last placement
+   *
+   */
+  const std::vector<size_t> &getOffset() const { return offset; }
+
+private:
+  /**
+   * @brief Find the best fit offset for the request
+   *
+   * @param idx index of the request
+   * @return offset for the request
+   */
+  size_t findOffset(unsigned int idx) const {
+    auto [start, end] = validity[idx];
+    size_t best = std::numeric_limits<size_t>::max();
+    size_t best_gap = std::numeric_limits<size_t>::max();
+    size_t bottom = 0;
+
+    /** placed is sorted by offset, so the gaps are visited from bottom */
+    for (auto p : placed) {
+      if (validity[p].second <= start || end <= validity[p].first)
+        continue;
+
+      if (offset[p] > bottom) {
+        size_t gap = offset[p] - bottom;
+        if (gap >= size[idx] && gap < best_gap) {
+          best = bottom;
+          best_gap = gap;
+        }
+      }
+      bottom = std::max(bottom, offset[p] + size[p]);
+    }
+
+    return best_gap == std::numeric_limits<size_t>::max() ? bottom : best;
+  }
+
+  const std::vector<size_t> &size;
+  const std::vector<std::pair<unsigned int, unsigned int>> &validity;
+  std::vector<size_t> offset;  /**< offsets of the last placement */
+  std::vector<unsigned int> placed; /**< placed requests sorted by offset */
+};
+
+/**
+ * @brief Calculate the largest sum of sizes of the memories in the group valid
+ * at once, which is the lower bound of any layout of the group
+ *
+ */
+size_t calcLowerBound(
+  const std::vector<size_t> &memory_size,
+  const std::vector<std::pair<unsigned int, unsigned int>> &memory_validity,
+  const std::vector<unsigned int> &group) {
+  std::vector<std::pair<unsigned int, long long>> events;
+  events.reserve(group.size() * 2);
+  for (auto idx : group) {
+    events.emplace_back(memory_validity[idx].first, memory_size[idx]);
+    events.emplace_back(memory_validity[idx].second,
+                        -static_cast<long long>(memory_size[idx]));
+  }
+
+  /** free before allocation at the same time as end is exclusive */
+  std::sort(events.begin(), events.end());
+
+  long long current = 0, peak = 0;
+  for (auto &[time, bytes] : events) {
+    current += bytes;
+    peak = std::max(peak, current);
+  }
+
+  return static_cast<size_t>(peak);
+}
+
+/**
+ * @brief Place the requests of the group from offset 0. The requests are
+ * placed in the descending order of size first. If the search is enabled, the
+ * orders by start time, by area (size x validity) and by length of validity
+ * are tried as well, and then the best order is perturbed for search_rounds
+ * times keeping the perturbation which lowers the peak. The search stops early
+ * when the peak reaches the theoretical minimum.
+ *
+ * @param group indices of the requests to place
+ * @param search_rounds number of local search rounds
+ * @param memory_offset offsets of the requests in the group are set
+ * @return size_t peak size of the group
+ */
+size_t placeGroup(
+  const std::vector<size_t> &memory_size,
+  const std::vector<std::pair<unsigned int, unsigned int>> &memory_validity,
+  std::vector<unsigned int> group, unsigned int search_rounds,
+  std::vector<size_t> &memory_offset) {
+  unsigned int n = group.size();
+  if (n == 0)
+    return 0;
+
+  StripPacking packing(memory_size, memory_validity);
+
+  auto length = [&memory_validity](unsigned int idx) {
+    return memory_validity[idx].second - memory_validity[idx].first;
+  };
+
+  std::vector<unsigned int> &order = group;
+  std::stable_sort(order.begin(), order.end(), [&](auto a, auto b) {
+    if (memory_size[a] == memory_size[b])
+      return memory_validity[a].first < memory_validity[b].first;
+    return memory_size[a] > memory_size[b];
+  });
+
+  std::vector<unsigned int> best_order = order;
+  size_t best = packing.place(order, std::numeric_limits<size_t>::max());
+
+  if (search_rounds > 0) {
+    size_t lower_bound = calcLowerBound(memory_size, memory_validity, group);
+
+    auto try_order = [&](const std::vector<unsigned int> &candidate) {
+      size_t peak = packing.place(candidate, best);
+      if (peak < best) {
+        best = peak;
+        best_order = candidate;
+        return true;
+      }
+      return false;
+    };
+
+    /** start time first, longer one first for the same start */
+    std::stable_sort(order.begin(), order.end(), [&](auto a, auto b) {
+      if (memory_validity[a].first == memory_validity[b].first)
+        return memory_validity[a].second > memory_validity[b].second;
+      return memory_validity[a].first < memory_validity[b].first;
+    });
+    try_order(order);
+
+    /** area of the rectangle first */
+    std::stable_sort(order.begin(), order.end(), [&](auto a, auto b) {
+      return memory_size[a] * length(a) > memory_size[b] * length(b);
+    });
+    try_order(order);
+
+    /** longer validity first */
+    std::stable_sort(order.begin(), order.end(), [&](auto a, auto b) {
+      if (length(a) == length(b))
+        return memory_size[a] > memory_size[b];
+      return length(a) > length(b);
+    });
+    try_order(order);
+
+    /** local search by moving a request to the front of the order */
+    std::mt19937 rng(0);
+    for (unsigned int round = 0; round < search_rounds && n > 1; round++) {
+      if (best <= lower_bound)
+        break;
+
+      std::uniform_int_distribution<unsigned int> dist(1, n - 1);
+      unsigned int from = dist(rng);
+      unsigned int to = std::uniform_int_distribution<unsigned int>(
+        0, from - 1)(rng);
+
+      order = best_order;
+      std::rotate(order.begin() + to, order.begin() + from,
+                  order.begin() + from + 1);
+      try_order(order);
+    }
+  }
+
+  packing.place(best_order, std::numeric_limits<size_t>::max());
+  for (auto idx : best_order)
+    memory_offset[idx] = packing.getOffset()[idx];
+
+  return best;
+}
+
+} // namespace
+
+/**
+ * @copydoc MemoryPlanner::planLayout(
+ * const std::vector<size_t> &memory_size,
+ * const std::vector<std::pair<unsigned int, unsigned int>> &memory_validity,
+ * std::vector<size_t> &memory_offset,
+ * std::vector<bool> &memory_is_wgrad);
+ *
+ * @details The weight gradients are kept together above the other requests as
+ * in OptimizedV2Planner, so each group is packed on its own.
+ */
+size_t BestFitPlanner::planLayout(
+  const std::vector<size_t> &memory_size,
+  const std::vector<std::pair<unsigned int, unsigned int>> &memory_validity,
+  std::vector<size_t> &memory_offset, std::vector<bool> &memory_is_wgrad,
+  size_t n_wgrad) const {
+  std::vector<unsigned int> requests, wgrad_requests;
+  requests.reserve(memory_size.size() - n_wgrad);
+  wgrad_requests.reserve(n_wgrad);
+  for (unsigned int idx = 0; idx < memory_size.size(); idx++) {
+    if (n_wgrad && memory_is_wgrad[idx])
+      wgrad_requests.push_back(idx);
+    else
+      requests.push_back(idx);
+  }
+
+  memory_offset.resize(memory_size.size());
+  size_t memory_req = placeGroup(memory_size, memory_validity, requests,
+                                 search_rounds, memory_offset);
+  size_t wgrad_req = placeGroup(memory_size, memory_validity, wgrad_requests,
+                                search_rounds, memory_offset);
+  for (auto idx : wgrad_requests)
+    memory_offset[idx] += memory_req;
+
+  return memory_req + wgrad_req;
+}
+
+} // namespace nntrainer
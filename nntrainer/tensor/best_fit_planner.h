@@ -0,0 +1,80 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file   best_fit_planner.h
+ * @date   18 October 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @bug    No known bugs except for NYI items
+ * @brief  This is Best Fit Memory Planner
+ *
+ * @details The layout is planned as a 2-D strip packing where each request is
+ * a rectangle of its size over its validity interval. The requests are placed
+ * one by one in a given order. For each request, the requests already placed
+ * with overlapping validity are scanned by their offset, and the free gaps
+ * between them are the candidate places; a gap is the coalesced space of any
+ * number of expired memories and is split when the request is smaller than the
+ * gap. The smallest gap which fits is chosen. If no gap fits, the request is
+ * placed right above the highest overlapping memory, so the free space below
+ * the top of the pool is partially reused as well.
+ *
+ * The default order is the descending order of size. With the search enabled,
+ * a few other orders are tried and the best one is refined by a bounded local
+ * search which minimizes the peak pool size.
+ *
+ * The weight gradients are packed on their own and placed above the other
+ * requests, as OptimizedV2Planner groups them.
+ */
+
+#ifndef __BEST_FIT_PLANNER_H_
+#define __BEST_FIT_PLANNER_H_
+
+#include <vector>
+
+#include <memory_planner.h>
+
+namespace nntrainer {
+
+/**
+ * @class   BestFitPlanner
+ * @brief   Best Fit Memory Planner provides the memory layout by best fit
+ * placement over the validity intervals
+ */
+class BestFitPlanner : public MemoryPlanner {
+public:
+  /**
+   * @brief BestFitPlanner constructor
+   *
+   * @param search_rounds number of local search rounds to minimize the peak
+   * size, 0 to use the placement in the descending order of size only
+   */
+  explicit BestFitPlanner(unsigned int search_rounds = 0) :
+    search_rounds(search_rounds) {}
+
+  /**
+   * @copydoc MemoryPlanner::planLayout(
+   * const std::vector<size_t> &memory_size,
+   * const std::vector<std::pair<unsigned int, unsigned int>> &memory_validity,
+   * std::vector<size_t> &memory_offset,
+   * std::vector<bool> &memory_is_wgrad);
+   *
+   */
+  size_t planLayout(
+    const std::vector<size_t> &memory_size,
+    const std::vector<std::pair<unsigned int, unsigned int>> &memory_validity,
+    std::vector<size_t> &memory_offset, std::vector<bool> &memory_is_wgrad,
+    size_t n_wgrad = 0) const;
+
+  /**
+   * @copydoc MemoryPlanner::getType() const
+   *
+   */
+  const std::string &getType() const { return type; }
+
+  inline static const std::string type = "best_fit_planner";
+
+private:
+  unsigned int search_rounds; /**< number of local search rounds */
+};
+
+} // namespace nntrainer
+
+#endif /** __BEST_FIT_PLANNER_H_ */
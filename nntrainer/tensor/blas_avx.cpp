@@ -11,10 +11,15 @@
  *
  */
 
+#include <algorithm>
 #include <cassert>
 #include <chrono>
 #include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <immintrin.h>
+#include <limits>
+#include <new>
 
 #include <blas_avx.h>
 
@@ -289,4 +294,941 @@ void custom_scopy(const unsigned int N, const float *X, const int incX,
   }
 }
 
+/// rows of the register tile computed by the sgemm micro-kernel
+static constexpr unsigned int SGEMM_MR = 6;
+/// columns of the register tile computed by the sgemm micro-kernel
+static constexpr unsigned int SGEMM_NR = 16;
+/// rows of op(A) packed at once, sized so that the packed A block stays in L2
+static constexpr unsigned int SGEMM_MC = 144;
+/// depth of packed panels, sized so that one B micro-panel stays in L1
+static constexpr unsigned int SGEMM_KC = 256;
+/// columns of op(B) packed at once, sized so that the packed B block stays in
+/// L3
+static constexpr unsigned int SGEMM_NC = 2048;
+
+/**
+ * @brief 64-byte aligned scratch buffer reused by the packing routines of a
+ * thread, so that repeated sgemm calls do not hit the allocator.
+ */
+class PackingBuffer {
+public:
+  /**
+   * @brief Destroy the Packing Buffer object
+   */
+  ~PackingBuffer() { _mm_free(data); }
+
+  /**
+   * @brief get buffer which can hold at least @a len floats
+   *
+   * @param len number of floats
+   * @return float* aligned buffer
+   */
+  float *get(size_t len) {
+    if (len > capacity) {
+      _mm_free(data);
+      data = static_cast<float *>(_mm_malloc(len * sizeof(float), 64));
+      if (data == nullptr) {
+        capacity = 0;
+        throw std::bad_alloc();
+      }
+      capacity = len;
+    }
+    return data;
+  }
+
+private:
+  float *data = nullptr;
+  size_t capacity = 0;
+};
+
+static inline __m256 fmadd_ps(__m256 a, __m256 b, __m256 c) {
+#ifdef __FMA__
+  return _mm256_fmadd_ps(a, b, c);
+#else
+  return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+}
+
+static inline float hsum_ps(__m256 v) {
+  __m128 lo =
+    _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+  __m128 shuf = _mm_movehdup_ps(lo);
+  __m128 sums = _mm_add_ps(lo, shuf);
+  shuf = _mm_movehl_ps(shuf, sums);
+  sums = _mm_add_ss(sums, shuf);
+  return _mm_cvtss_f32(sums);
+}
+
+/**
+ * @brief pack mc x kc block of op(A) into micro-panels of SGEMM_MR rows. Each
+ * micro-panel is stored k-major and zero-padded up to SGEMM_MR rows.
+ */
+static void sgemm_pack_A(bool TransA, unsigned int mc, unsigned int kc,
+                         const float *A, unsigned int lda, float *dst) {
+  for (unsigned int i = 0; i < mc; i += SGEMM_MR) {
+    const unsigned int mr = std::min(SGEMM_MR, mc - i);
+    for (unsigned int k = 0; k < kc; ++k) {
+      unsigned int r = 0;
+      if (TransA) {
+        const float *src = A + k * lda + i;
+        for (; r < mr; ++r)
+          dst[r] = src[r];
+      } else {
+        const float *src = A + i * lda + k;
+        for (; r < mr; ++r)
+          dst[r] = src[r * lda];
+      }
+      for (; r < SGEMM_MR; ++r)
+        dst[r] = 0.0f;
+      dst += SGEMM_MR;
+    }
+  }
+}
+
+/**
+ * @brief pack kc x nc block of op(B) into micro-panels of SGEMM_NR columns.
+ * Each micro-panel is stored k-major and zero-padded up to SGEMM_NR columns.
+ */
+static void sgemm_pack_B(bool TransB, unsigned int kc, unsigned int nc,
+                         const float *B, unsigned int ldb, float *dst) {
+  for (unsigned int j = 0; j < nc; j += SGEMM_NR) {
+    const unsigned int nr = std::min(SGEMM_NR, nc - j);
+    if (TransB) {
+      for (unsigned int c = 0; c < nr; ++c) {
+        const float *src = B + (j + c) * ldb;
+        for (unsigned int k = 0; k < kc; ++k)
+          dst[k * SGEMM_NR + c] = src[k];
+      }
+      for (unsigned int c = nr; c < SGEMM_NR; ++c)
+        for (unsigned int k = 0; k < kc; ++k)
+          dst[k * SGEMM_NR + c] = 0.0f;
+    } else if (nr == SGEMM_NR) {
+      for (unsigned int k = 0; k < kc; ++k) {
+        const float *src = B + k * ldb + j;
+        _mm256_store_ps(dst + k * SGEMM_NR, _mm256_loadu_ps(src));
+        _mm256_store_ps(dst + k * SGEMM_NR + 8, _mm256_loadu_ps(src + 8));
+      }
+    } else {
+      for (unsigned int k = 0; k < kc; ++k) {
+        const float *src = B + k * ldb + j;
+        unsigned int c = 0;
+        for (; c < nr; ++c)
+          dst[k * SGEMM_NR + c] = src[c];
+        for (; c < SGEMM_NR; ++c)
+          dst[k * SGEMM_NR + c] = 0.0f;
+      }
+    }
+    dst += kc * SGEMM_NR;
+  }
+}
+
+/**
+ * @brief SGEMM_MR x SGEMM_NR micro-kernel on packed panels.
+ * C[0:mr, 0:nr] = alpha * a * b + beta * C[0:mr, 0:nr]
+ * @note C is not read when beta is zero so that garbage in C is not propagated
+ */
+static void sgemm_kernel_6x16(unsigned int kc, const float *a, const float *b,
+                              float *C, unsigned int ldc, unsigned int mr,
+                              unsigned int nr, float alpha, float beta) {
+  __m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps();
+  __m256 c10 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+  __m256 c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps();
+  __m256 c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps();
+  __m256 c40 = _mm256_setzero_ps(), c41 = _mm256_setzero_ps();
+  __m256 c50 = _mm256_setzero_ps(), c51 = _mm256_setzero_ps();
+
+  for (unsigned int k = 0; k < kc; ++k) {
+    const __m256 b0 = _mm256_load_ps(b);
+    const __m256 b1 = _mm256_load_ps(b + 8);
+    __m256 va;
+
+    va = _mm256_broadcast_ss(a);
+    c00 = fmadd_ps(va, b0, c00);
+    c01 = fmadd_ps(va, b1, c01);
+    va = _mm256_broadcast_ss(a + 1);
+    c10 = fmadd_ps(va, b0, c10);
+    c11 = fmadd_ps(va, b1, c11);
+    va = _mm256_broadcast_ss(a + 2);
+    c20 = fmadd_ps(va, b0, c20);
+    c21 = fmadd_ps(va, b1, c21);
+    va = _mm256_broadcast_ss(a + 3);
+    c30 = fmadd_ps(va, b0, c30);
+    c31 = fmadd_ps(va, b1, c31);
+    va = _mm256_broadcast_ss(a + 4);
+    c40 = fmadd_ps(va, b0, c40);
+    c41 = fmadd_ps(va, b1, c41);
+    va = _mm256_broadcast_ss(a + 5);
+    c50 = fmadd_ps(va, b0, c50);
+    c51 = fmadd_ps(va, b1, c51);
+
+    a += SGEMM_MR;
+    b += SGEMM_NR;
+  }
+
+  const __m256 valpha = _mm256_set1_ps(alpha);
+  const __m256 acc[SGEMM_MR][2] = {{c00, c01}, {c10, c11}, {c20, c21},
+                                   {c30, c31}, {c40, c41}, {c50, c51}};
+
+  if (mr == SGEMM_MR && nr == SGEMM_NR) {
+    const __m256 vbeta = _mm256_set1_ps(beta);
+    for (unsigned int r = 0; r < SGEMM_MR; ++r) {
+      float *c = C + r * ldc;
+      __m256 v0 = _mm256_mul_ps(valpha, acc[r][0]);
+      __m256 v1 = _mm256_mul_ps(valpha, acc[r][1]);
+      if (beta != 0.0f) {
+        v0 = fmadd_ps(vbeta, _mm256_loadu_ps(c), v0);
+        v1 = fmadd_ps(vbeta, _mm256_loadu_ps(c + 8), v1);
+      }
+      _mm256_storeu_ps(c, v0);
+      _mm256_storeu_ps(c + 8, v1);
+    }
+    return;
+  }
+
+  alignas(32) float tile[SGEMM_MR * SGEMM_NR];
+  for (unsigned int r = 0; r < mr; ++r) {
+    _mm256_store_ps(tile + r * SGEMM_NR, _mm256_mul_ps(valpha, acc[r][0]));
+    _mm256_store_ps(tile + r * SGEMM_NR + 8, _mm256_mul_ps(valpha, acc[r][1]));
+  }
+  for (unsigned int r = 0; r < mr; ++r) {
+    float *c = C + r * ldc;
+    const float *t = tile + r * SGEMM_NR;
+    if (beta != 0.0f) {
+      for (unsigned int j = 0; j < nr; ++j)
+        c[j] = t[j] + beta * c[j];
+    } else {
+      for (unsigned int j = 0; j < nr; ++j)
+        c[j] = t[j];
+    }
+  }
+}
+
+/**
+ * @brief C = beta * C for M x N row-major C
+ */
+static void sgemm_scale_C(unsigned int M, unsigned int N, float beta, float *C,
+                          unsigned int ldc) {
+  for (unsigned int m = 0; m < M; ++m) {
+    float *c = C + m * ldc;
+    if (beta == 0.0f) {
+      std::fill(c, c + N, 0.0f);
+    } else if (beta != 1.0f) {
+      for (unsigned int n = 0; n < N; ++n)
+        c[n] *= beta;
+    }
+  }
+}
+
+/**
+ * @brief row-major sgemm. Blocks op(B) into KC x NC and op(A) into MC x KC
+ * panels (GotoBLAS loop order) and feeds them to the micro-kernel.
+ */
+static void sgemm_row_major(bool TransA, bool TransB, unsigned int M,
+                            unsigned int N, unsigned int K, float alpha,
+                            const float *A, unsigned int lda, const float *B,
+                            unsigned int ldb, float beta, float *C,
+                            unsigned int ldc) {
+  if (M == 0 || N == 0)
+    return;
+
+  if (K == 0 || alpha == 0.0f) {
+    sgemm_scale_C(M, N, beta, C, ldc);
+    return;
+  }
+
+  static thread_local PackingBuffer packed_A;
+  static thread_local PackingBuffer packed_B;
+
+  const unsigned int kc_max = std::min(K, SGEMM_KC);
+  const unsigned int mc_max =
+    (std::min(M, SGEMM_MC) + SGEMM_MR - 1) / SGEMM_MR * SGEMM_MR;
+  const unsigned int nc_max =
+    (std::min(N, SGEMM_NC) + SGEMM_NR - 1) / SGEMM_NR * SGEMM_NR;
+
+  float *pa = packed_A.get(static_cast<size_t>(mc_max) * kc_max);
+  float *pb = packed_B.get(static_cast<size_t>(nc_max) * kc_max);
+
+  for (unsigned int jc = 0; jc < N; jc += SGEMM_NC) {
+    const unsigned int nc = std::min(SGEMM_NC, N - jc);
+
+    for (unsigned int pc = 0; pc < K; pc += SGEMM_KC) {
+      const unsigned int kc = std::min(SGEMM_KC, K - pc);
+      const float beta_ = pc == 0 ? beta : 1.0f;
+
+      sgemm_pack_B(TransB, kc, nc,
+                   TransB ? B + jc * ldb + pc : B + pc * ldb + jc, ldb, pb);
+
+      for (unsigned int ic = 0; ic < M; ic += SGEMM_MC) {
+        const unsigned int mc = std::min(SGEMM_MC, M - ic);
+
+        sgemm_pack_A(TransA, mc, kc,
+                     TransA ? A + pc * lda + ic : A + ic * lda + pc, lda, pa);
+
+        for (unsigned int jr = 0; jr < nc; jr += SGEMM_NR) {
+          const unsigned int nr = std::min(SGEMM_NR, nc - jr);
+          for (unsigned int ir = 0; ir < mc; ir += SGEMM_MR) {
+            const unsigned int mr = std::min(SGEMM_MR, mc - ir);
+            sgemm_kernel_6x16(kc, pa + ir * kc, pb + jr * kc,
+                              C + (ic + ir) * ldc + jc + jr, ldc, mr, nr,
+                              alpha, beta_);
+          }
+        }
+      }
+    }
+  }
+}
+
+void sgemm(const unsigned int TStorageOrder, bool TransA, bool TransB,
+           const unsigned int M, const unsigned int N, const unsigned int K,
+           const float alpha, const float *A, const unsigned int lda,
+           const float *B, const unsigned int ldb, const float beta, float *C,
+           const unsigned int ldc) {
+  if (TStorageOrder) {
+    // column-major C = op(A) * op(B) is row-major C**T = op(B)**T * op(A)**T
+    sgemm_row_major(TransB, TransA, N, M, K, alpha, B, ldb, A, lda, beta, C,
+                    ldc);
+  } else {
+    sgemm_row_major(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C,
+                    ldc);
+  }
+}
+
+/**
+ * @brief row-major y = alpha * A * x + beta * y, A is M x N
+ */
+static void sgemv_row_major_noTrans(unsigned int M, unsigned int N, float alpha,
+                                    const float *A, unsigned int lda,
+                                    const float *X, unsigned int incx,
+                                    float beta, float *Y, unsigned int incy) {
+  auto update = [&](unsigned int i, float dot) {
+    float &y = Y[i * incy];
+    y = beta == 0.0f ? alpha * dot : alpha * dot + beta * y;
+  };
+
+  if (incx != 1) {
+    for (unsigned int i = 0; i < M; ++i) {
+      const float *a = A + i * lda;
+      float dot = 0.0f;
+      for (unsigned int j = 0; j < N; ++j)
+        dot += a[j] * X[j * incx];
+      update(i, dot);
+    }
+    return;
+  }
+
+  unsigned int i = 0;
+  for (; i + 4 <= M; i += 4) {
+    const float *a0 = A + i * lda;
+    const float *a1 = a0 + lda;
+    const float *a2 = a1 + lda;
+    const float *a3 = a2 + lda;
+    __m256 s0 = _mm256_setzero_ps(), s1 = _mm256_setzero_ps();
+    __m256 s2 = _mm256_setzero_ps(), s3 = _mm256_setzero_ps();
+    unsigned int j = 0;
+    for (; j + 8 <= N; j += 8) {
+      const __m256 x = _mm256_loadu_ps(X + j);
+      s0 = fmadd_ps(_mm256_loadu_ps(a0 + j), x, s0);
+      s1 = fmadd_ps(_mm256_loadu_ps(a1 + j), x, s1);
+      s2 = fmadd_ps(_mm256_loadu_ps(a2 + j), x, s2);
+      s3 = fmadd_ps(_mm256_loadu_ps(a3 + j), x, s3);
+    }
+    float d0 = hsum_ps(s0), d1 = hsum_ps(s1), d2 = hsum_ps(s2),
+          d3 = hsum_ps(s3);
+    for (; j < N; ++j) {
+      d0 += a0[j] * X[j];
+      d1 += a1[j] * X[j];
+      d2 += a2[j] * X[j];
+      d3 += a3[j] * X[j];
+    }
+    update(i, d0);
+    update(i + 1, d1);
+    update(i + 2, d2);
+    update(i + 3, d3);
+  }
+  for (; i < M; ++i) {
+    const float *a = A + i * lda;
+    __m256 s = _mm256_setzero_ps();
+    unsigned int j = 0;
+    for (; j + 8 <= N; j += 8)
+      s = fmadd_ps(_mm256_loadu_ps(a + j), _mm256_loadu_ps(X + j), s);
+    float dot = hsum_ps(s);
+    for (; j < N; ++j)
+      dot += a[j] * X[j];
+    update(i, dot);
+  }
+}
+
+/**
+ * @brief row-major y = alpha * A**T * x + beta * y, A is M x N
+ */
+static void sgemv_row_major_trans(unsigned int M, unsigned int N, float alpha,
+                                  const float *A, unsigned int lda,
+                                  const float *X, unsigned int incx, float beta,
+                                  float *Y, unsigned int incy) {
+  for (unsigned int j = 0; j < N; ++j) {
+    float &y = Y[j * incy];
+    y = beta == 0.0f ? 0.0f : beta * y;
+  }
+
+  if (incy != 1) {
+    for (unsigned int i = 0; i < M; ++i) {
+      const float *a = A + i * lda;
+      const float x = alpha * X[i * incx];
+      for (unsigned int j = 0; j < N; ++j)
+        Y[j * incy] += x * a[j];
+    }
+    return;
+  }
+
+  unsigned int i = 0;
+  for (; i + 4 <= M; i += 4) {
+    const float *a0 = A + i * lda;
+    const float *a1 = a0 + lda;
+    const float *a2 = a1 + lda;
+    const float *a3 = a2 + lda;
+    const float x0 = alpha * X[i * incx];
+    const float x1 = alpha * X[(i + 1) * incx];
+    const float x2 = alpha * X[(i + 2) * incx];
+    const float x3 = alpha * X[(i + 3) * incx];
+    const __m256 vx0 = _mm256_set1_ps(x0), vx1 = _mm256_set1_ps(x1);
+    const __m256 vx2 = _mm256_set1_ps(x2), vx3 = _mm256_set1_ps(x3);
+    unsigned int j = 0;
+    for (; j + 8 <= N; j += 8) {
+      __m256 y = _mm256_loadu_ps(Y + j);
+      y = fmadd_ps(vx0, _mm256_loadu_ps(a0 + j), y);
+      y = fmadd_ps(vx1, _mm256_loadu_ps(a1 + j), y);
+      y = fmadd_ps(vx2, _mm256_loadu_ps(a2 + j), y);
+      y = fmadd_ps(vx3, _mm256_loadu_ps(a3 + j), y);
+      _mm256_storeu_ps(Y + j, y);
+    }
+    for (; j < N; ++j)
+      Y[j] += x0 * a0[j] + x1 * a1[j] + x2 * a2[j] + x3 * a3[j];
+  }
+  for (; i < M; ++i) {
+    const float *a = A + i * lda;
+    const float x = alpha * X[i * incx];
+    const __m256 vx = _mm256_set1_ps(x);
+    unsigned int j = 0;
+    for (; j + 8 <= N; j += 8)
+      _mm256_storeu_ps(
+        Y + j, fmadd_ps(vx, _mm256_loadu_ps(a + j), _mm256_loadu_ps(Y + j)));
+    for (; j < N; ++j)
+      Y[j] += x * a[j];
+  }
+}
+
+void sgemv(const unsigned int TStorageOrder, bool TransA, const unsigned int M,
+           const unsigned int N, const float alpha, const float *A,
+           const unsigned int lda, const float *X, const int incX,
+           const float beta, float *Y, const int incY) {
+  const unsigned int incx = std::abs(incX);
+  const unsigned int incy = std::abs(incY);
+
+  // column-major M x N matrix is a row-major N x M matrix transposed
+  const unsigned int rows = TStorageOrder ? N : M;
+  const unsigned int cols = TStorageOrder ? M : N;
+  const bool trans = TStorageOrder ? !TransA : TransA;
+
+  if (trans)
+    sgemv_row_major_trans(rows, cols, alpha, A, lda, X, incx, beta, Y, incy);
+  else
+    sgemv_row_major_noTrans(rows, cols, alpha, A, lda, X, incx, beta, Y, incy);
+}
+
+/**
+ * @brief constants shared by the vectorized Adam update
+ */
+struct AdamConstants {
+  __m256 b1, one_m_b1, b2, one_m_b2, eps, v_scale, step, keep;
+  float s_b1, s_one_m_b1, s_b2, s_one_m_b2, s_eps, s_v_scale, s_step, s_keep;
+
+  /** 1 - beta is computed in double as the betas are double properties */
+  AdamConstants(double beta1, double beta2, float epsilon, float vs,
+                float step_size, float decay) :
+    b1(_mm256_set1_ps(beta1)),
+    one_m_b1(_mm256_set1_ps(1.0 - beta1)),
+    b2(_mm256_set1_ps(beta2)),
+    one_m_b2(_mm256_set1_ps(1.0 - beta2)),
+    eps(_mm256_set1_ps(epsilon)),
+    v_scale(_mm256_set1_ps(vs)),
+    step(_mm256_set1_ps(step_size)),
+    keep(_mm256_set1_ps(1.0f - decay)),
+    s_b1(beta1),
+    s_one_m_b1(1.0 - beta1),
+    s_b2(beta2),
+    s_one_m_b2(1.0 - beta2),
+    s_eps(epsilon),
+    s_v_scale(vs),
+    s_step(step_size),
+    s_keep(1.0f - decay) {}
+};
+
+/**
+ * @brief update 8 consecutive elements of W, M, V with unscaled gradient g
+ * @return updated weight
+ */
+static inline __m256 adam_update_ps(__m256 g, float *W, float *M, float *V,
+                                    const AdamConstants &c) {
+  __m256 m = fmadd_ps(c.b1, _mm256_loadu_ps(M), _mm256_mul_ps(c.one_m_b1, g));
+  __m256 v = fmadd_ps(c.b2, _mm256_loadu_ps(V),
+                      _mm256_mul_ps(_mm256_mul_ps(c.one_m_b2, g), g));
+  __m256 denom = fmadd_ps(_mm256_sqrt_ps(v), c.v_scale, c.eps);
+  __m256 upd = _mm256_mul_ps(c.step, _mm256_div_ps(m, denom));
+  __m256 w = _mm256_sub_ps(_mm256_mul_ps(c.keep, _mm256_loadu_ps(W)), upd);
+
+  _mm256_storeu_ps(M, m);
+  _mm256_storeu_ps(V, v);
+  _mm256_storeu_ps(W, w);
+  return w;
+}
+
+/**
+ * @brief scalar version of adam_update_ps for the remainder
+ * @return updated weight
+ */
+static inline float adam_update_ss(float g, float *W, float *M, float *V,
+                                   const AdamConstants &c) {
+  float m = c.s_b1 * *M + c.s_one_m_b1 * g;
+  float v = c.s_b2 * *V + c.s_one_m_b2 * g * g;
+  *M = m;
+  *V = v;
+  *W = c.s_keep * *W - c.s_step * m / (std::sqrt(v) * c.s_v_scale + c.s_eps);
+  return *W;
+}
+
+void adam_update(const unsigned int N, const float *G, float *W, float *M,
+                 float *V, const float grad_scale, const double beta1,
+                 const double beta2, const float epsilon, const float v_scale,
+                 const float step_size, const float decay) {
+  const AdamConstants c(beta1, beta2, epsilon, v_scale, step_size, decay);
+  const __m256 gs = _mm256_set1_ps(grad_scale);
+
+  unsigned int i = 0;
+  for (; i + 8 <= N; i += 8)
+    adam_update_ps(_mm256_mul_ps(gs, _mm256_loadu_ps(G + i)), W + i, M + i,
+                   V + i, c);
+  for (; i < N; ++i)
+    adam_update_ss(grad_scale * G[i], W + i, M + i, V + i, c);
+}
+
+/**
+ * @brief exp of 8 floats. exp(x) = 2^n * exp(r) with n = round(x / ln2), and
+ * exp(r) is approximated by the polynomial of cephes expf.
+ */
+static inline __m256 exp_ps(__m256 x) {
+  /** keep 2^n in the range of normal numbers */
+  x = _mm256_min_ps(x, _mm256_set1_ps(88.3762626647949f));
+  x = _mm256_max_ps(x, _mm256_set1_ps(-87.3365478515625f));
+
+  __m256 n = _mm256_round_ps(
+    _mm256_mul_ps(x, _mm256_set1_ps(1.44269504088896341f)),
+    _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  /** r = x - n * ln2, where ln2 is split for the precision */
+  __m256 r = _mm256_sub_ps(x, _mm256_mul_ps(n, _mm256_set1_ps(0.693359375f)));
+  r = _mm256_add_ps(r, _mm256_mul_ps(n, _mm256_set1_ps(2.12194440e-4f)));
+
+  __m256 y = _mm256_set1_ps(1.9875691500E-4f);
+  y = fmadd_ps(y, r, _mm256_set1_ps(1.3981999507E-3f));
+  y = fmadd_ps(y, r, _mm256_set1_ps(8.3334519073E-3f));
+  y = fmadd_ps(y, r, _mm256_set1_ps(4.1665795894E-2f));
+  y = fmadd_ps(y, r, _mm256_set1_ps(1.6666665459E-1f));
+  y = fmadd_ps(y, r, _mm256_set1_ps(5.0000001201E-1f));
+  y = fmadd_ps(y, _mm256_mul_ps(r, r), _mm256_add_ps(r, _mm256_set1_ps(1.0f)));
+
+  __m256i e = _mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127));
+  return _mm256_mul_ps(y, _mm256_castsi256_ps(_mm256_slli_epi32(e, 23)));
+}
+
+float exp_sub_sum(const unsigned int N, float *X, const float max) {
+  const __m256 vmax = _mm256_set1_ps(max);
+  __m256 vsum = _mm256_setzero_ps();
+
+  unsigned int i = 0;
+  for (; i + 8 <= N; i += 8) {
+    __m256 x = exp_ps(_mm256_sub_ps(_mm256_loadu_ps(X + i), vmax));
+    _mm256_storeu_ps(X + i, x);
+    vsum = _mm256_add_ps(vsum, x);
+  }
+
+  float sum = hsum_ps(vsum);
+  for (; i < N; ++i) {
+    X[i] = std::exp(X[i] - max);
+    sum += X[i];
+  }
+  return sum;
+}
+
+/**
+ * @brief load 8 int8 weights as float
+ */
+static inline __m256 load_q8(const int8_t *B) {
+  return _mm256_cvtepi32_ps(
+    _mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i *)B)));
+}
+
+/**
+ * @brief load 8 int4 weights packed in 4 bytes as float
+ */
+static inline __m256 load_q4(const uint8_t *B) {
+  const __m128i mask = _mm_set1_epi8(0x0F);
+  const __m128i eight = _mm_set1_epi8(8);
+
+  int32_t packed;
+  std::memcpy(&packed, B, sizeof(packed));
+  __m128i p = _mm_cvtsi32_si128(packed);
+  /** low nibble is the even column and high nibble is the odd one */
+  __m128i q = _mm_unpacklo_epi8(_mm_and_si128(p, mask),
+                                _mm_and_si128(_mm_srli_epi16(p, 4), mask));
+  /** sign extend 4 bits : (q ^ 8) - 8 */
+  q = _mm_sub_epi8(_mm_xor_si128(q, eight), eight);
+  return _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(q));
+}
+
+/**
+ * @brief R rows x 8 columns of C = A * dequantize(B). Each row of B is
+ * dequantized once in the register and shared by the R rows of A.
+ */
+template <unsigned int R, typename T, typename Load>
+static void qgemm_tile(const unsigned int K, const float *A,
+                       const unsigned int lda, const T *B,
+                       const unsigned int ldb, const float *scales,
+                       const unsigned int lds, const unsigned int group_size,
+                       float *C, const unsigned int ldc, Load load) {
+  __m256 out[R], acc[R];
+  for (unsigned int r = 0; r < R; ++r)
+    out[r] = _mm256_setzero_ps();
+
+  for (unsigned int k0 = 0; k0 < K; k0 += group_size) {
+    for (unsigned int r = 0; r < R; ++r)
+      acc[r] = _mm256_setzero_ps();
+
+    for (unsigned int k = k0; k < k0 + group_size; ++k) {
+      __m256 b = load(B + k * ldb);
+      for (unsigned int r = 0; r < R; ++r)
+        acc[r] = fmadd_ps(_mm256_set1_ps(A[r * lda + k]), b, acc[r]);
+    }
+
+    __m256 s = _mm256_loadu_ps(scales + (k0 / group_size) * lds);
+    for (unsigned int r = 0; r < R; ++r)
+      out[r] = fmadd_ps(acc[r], s, out[r]);
+  }
+
+  for (unsigned int r = 0; r < R; ++r)
+    _mm256_storeu_ps(C + r * ldc, out[r]);
+}
+
+/**
+ * @brief C = A * dequantize(B) over the tiles of 4 rows x 8 columns
+ */
+template <unsigned int cols_per_elem, typename T, typename Load>
+static void qgemm_impl(const unsigned int M, const unsigned int N,
+                       const unsigned int K, const float *A,
+                       const unsigned int lda, const T *B,
+                       const unsigned int ldb, const float *scales,
+                       const unsigned int lds, const unsigned int group_size,
+                       float *C, const unsigned int ldc, Load load) {
+  for (unsigned int n = 0; n + 8 <= N; n += 8) {
+    const T *b = B + n / cols_per_elem;
+    unsigned int m = 0;
+    for (; m + 4 <= M; m += 4)
+      qgemm_tile<4>(K, A + m * lda, lda, b, ldb, scales + n, lds, group_size,
+                    C + m * ldc + n, ldc, load);
+
+    switch (M - m) {
+    case 3:
+      qgemm_tile<3>(K, A + m * lda, lda, b, ldb, scales + n, lds, group_size,
+                    C + m * ldc + n, ldc, load);
+      break;
+    case 2:
+      qgemm_tile<2>(K, A + m * lda, lda, b, ldb, scales + n, lds, group_size,
+                    C + m * ldc + n, ldc, load);
+      break;
+    case 1:
+      qgemm_tile<1>(K, A + m * lda, lda, b, ldb, scales + n, lds, group_size,
+                    C + m * ldc + n, ldc, load);
+      break;
+    default:
+      break;
+    }
+  }
+}
+
+void qgemm_q8(const unsigned int M, const unsigned int N, const unsigned int K,
+              const float *A, const unsigned int lda, const int8_t *B,
+              const unsigned int ldb, const float *scales,
+              const unsigned int lds, const unsigned int group_size, float *C,
+              const unsigned int ldc) {
+  qgemm_impl<1>(M, N, K, A, lda, B, ldb, scales, lds, group_size, C, ldc,
+                [](const int8_t *b) { return load_q8(b); });
+}
+
+void qgemm_q4(const unsigned int M, const unsigned int N, const unsigned int K,
+              const float *A, const unsigned int lda, const uint8_t *B,
+              const unsigned int ldb, const float *scales,
+              const unsigned int lds, const unsigned int group_size, float *C,
+              const unsigned int ldc) {
+  qgemm_impl<2>(M, N, K, A, lda, B, ldb, scales, lds, group_size, C, ldc,
+                [](const uint8_t *b) { return load_q4(b); });
+}
+
+/**
+ * @brief Y = op(X) over 8 floats at a time. The tail is padded to a full
+ * vector so that every element goes through the same approximation.
+ */
+template <typename Op>
+static inline void unary_ps(const unsigned int N, const float *X, float *Y,
+                            Op op) {
+  unsigned int i = 0;
+  for (; i + 8 <= N; i += 8)
+    _mm256_storeu_ps(Y + i, op(_mm256_loadu_ps(X + i)));
+
+  if (i < N) {
+    alignas(32) float tail[8] = {0};
+    std::memcpy(tail, X + i, (N - i) * sizeof(float));
+    _mm256_store_ps(tail, op(_mm256_load_ps(tail)));
+    std::memcpy(Y + i, tail, (N - i) * sizeof(float));
+  }
+}
+
+/**
+ * @brief 1 / (1 + exp(-x)) of 8 floats
+ */
+static inline __m256 sigmoid_ps(__m256 x) {
+  const __m256 one = _mm256_set1_ps(1.0f);
+  return _mm256_div_ps(
+    one, _mm256_add_ps(one, exp_ps(_mm256_sub_ps(_mm256_setzero_ps(), x))));
+}
+
+/**
+ * @brief tanh of 8 floats, 2 * sigmoid(2x) - 1
+ */
+static inline __m256 tanh_ps(__m256 x) {
+  const __m256 one = _mm256_set1_ps(1.0f);
+  __m256 s = sigmoid_ps(_mm256_add_ps(x, x));
+  return _mm256_sub_ps(_mm256_add_ps(s, s), one);
+}
+
+/**
+ * @brief erf of 8 floats by Abramowitz and Stegun 7.1.26, |error| < 1.5e-7
+ */
+static inline __m256 erf_ps(__m256 x) {
+  const __m256 sign_mask = _mm256_set1_ps(-0.0f);
+  const __m256 one = _mm256_set1_ps(1.0f);
+
+  __m256 sign = _mm256_and_ps(x, sign_mask);
+  __m256 a = _mm256_andnot_ps(sign_mask, x);
+  __m256 t =
+    _mm256_div_ps(one, fmadd_ps(_mm256_set1_ps(0.3275911f), a, one));
+
+  __m256 y = _mm256_set1_ps(1.061405429f);
+  y = fmadd_ps(y, t, _mm256_set1_ps(-1.453152027f));
+  y = fmadd_ps(y, t, _mm256_set1_ps(1.421413741f));
+  y = fmadd_ps(y, t, _mm256_set1_ps(-0.284496736f));
+  y = fmadd_ps(y, t, _mm256_set1_ps(0.254829592f));
+  y = _mm256_mul_ps(y, t);
+
+  __m256 e = exp_ps(_mm256_sub_ps(_mm256_setzero_ps(), _mm256_mul_ps(a, a)));
+  y = _mm256_sub_ps(one, _mm256_mul_ps(y, e));
+  return _mm256_or_ps(y, sign);
+}
+
+void ele_sigmoid(const unsigned int N, const float *X, float *Y) {
+  unary_ps(N, X, Y, sigmoid_ps);
+}
+
+void ele_tanh(const unsigned int N, const float *X, float *Y) {
+  unary_ps(N, X, Y, tanh_ps);
+}
+
+void ele_swish(const unsigned int N, const float *X, float *Y) {
+  unary_ps(N, X, Y, [](__m256 x) { return _mm256_mul_ps(x, sigmoid_ps(x)); });
+}
+
+void ele_gelu(const unsigned int N, const float *X, float *Y) {
+  unary_ps(N, X, Y, [](__m256 x) {
+    const __m256 half = _mm256_set1_ps(0.5f);
+    __m256 e = erf_ps(_mm256_mul_ps(x, _mm256_set1_ps(0.70710678118654752f)));
+    return _mm256_mul_ps(_mm256_mul_ps(half, x),
+                         _mm256_add_ps(_mm256_set1_ps(1.0f), e));
+  });
+}
+
+void ele_tanh_gelu(const unsigned int N, const float *X, float *Y) {
+  unary_ps(N, X, Y, [](__m256 x) {
+    const __m256 half = _mm256_set1_ps(0.5f);
+    __m256 x3 = _mm256_mul_ps(_mm256_mul_ps(x, x), x);
+    __m256 u = _mm256_mul_ps(_mm256_set1_ps(0.79788456080286536f),
+                             fmadd_ps(_mm256_set1_ps(0.044715f), x3, x));
+    return _mm256_mul_ps(_mm256_mul_ps(half, x),
+                         _mm256_add_ps(_mm256_set1_ps(1.0f), tanh_ps(u)));
+  });
+}
+
+void ele_sigmoid_gelu(const unsigned int N, const float *X, float *Y) {
+  unary_ps(N, X, Y, [](__m256 x) {
+    return _mm256_mul_ps(
+      x, sigmoid_ps(_mm256_mul_ps(_mm256_set1_ps(1.702f), x)));
+  });
+}
+
+/**
+ * @brief merge the Welford statistics of b into a
+ */
+static inline void welford_merge(float &count_a, float &mean_a, float &m2_a,
+                                 const float count_b, const float mean_b,
+                                 const float m2_b) {
+  const float count = count_a + count_b;
+  if (count_b == 0.0f || count == 0.0f)
+    return;
+
+  const float delta = mean_b - mean_a;
+  mean_a += delta * count_b / count;
+  m2_a += m2_b + delta * delta * count_a * count_b / count;
+  count_a = count;
+}
+
+float layer_norm(const unsigned int N, const float *X, const float *gamma,
+                 const float *beta, const float epsilon, float *Y,
+                 float *Xdev) {
+  /** Welford's algorithm on each lane, then the lanes are merged */
+  __m256 mean_v = _mm256_setzero_ps();
+  __m256 m2_v = _mm256_setzero_ps();
+  unsigned int i = 0, n = 0;
+  for (; i + 8 <= N; i += 8) {
+    __m256 x = _mm256_loadu_ps(X + i);
+    __m256 delta = _mm256_sub_ps(x, mean_v);
+    mean_v = fmadd_ps(delta, _mm256_set1_ps(1.0f / ++n), mean_v);
+    m2_v = fmadd_ps(delta, _mm256_sub_ps(x, mean_v), m2_v);
+  }
+
+  alignas(32) float means[8], m2s[8];
+  _mm256_store_ps(means, mean_v);
+  _mm256_store_ps(m2s, m2_v);
+  float count = 0.0f, mean = 0.0f, m2 = 0.0f;
+  for (unsigned int l = 0; l < 8; ++l)
+    welford_merge(count, mean, m2, n, means[l], m2s[l]);
+  for (; i < N; ++i)
+    welford_merge(count, mean, m2, 1.0f, X[i], 0.0f);
+
+  const float inv_std = 1.0f / std::sqrt(m2 / N + epsilon);
+
+  const __m256 vmean = _mm256_set1_ps(mean);
+  const __m256 vinv_std = _mm256_set1_ps(inv_std);
+  for (i = 0; i + 8 <= N; i += 8) {
+    __m256 dev = _mm256_sub_ps(_mm256_loadu_ps(X + i), vmean);
+    if (Xdev)
+      _mm256_storeu_ps(Xdev + i, dev);
+    __m256 x_hat = _mm256_mul_ps(dev, vinv_std);
+    if (gamma)
+      x_hat = _mm256_mul_ps(x_hat, _mm256_loadu_ps(gamma + i));
+    if (beta)
+      x_hat = _mm256_add_ps(x_hat, _mm256_loadu_ps(beta + i));
+    _mm256_storeu_ps(Y + i, x_hat);
+  }
+  for (; i < N; ++i) {
+    float dev = X[i] - mean;
+    if (Xdev)
+      Xdev[i] = dev;
+    Y[i] = dev * inv_std * (gamma ? gamma[i] : 1.0f) + (beta ? beta[i] : 0.0f);
+  }
+
+  return inv_std;
+}
+
+float rms_norm(const unsigned int N, const float *X, const float *gamma,
+               const float epsilon, float *Y) {
+  __m256 sum_v = _mm256_setzero_ps();
+  unsigned int i = 0;
+  for (; i + 8 <= N; i += 8) {
+    __m256 x = _mm256_loadu_ps(X + i);
+    sum_v = fmadd_ps(x, x, sum_v);
+  }
+  float sum = hsum_ps(sum_v);
+  for (unsigned int j = i; j < N; ++j)
+    sum += X[j] * X[j];
+
+  const float inv_rms = 1.0f / std::sqrt(sum / N + epsilon);
+
+  const __m256 vinv_rms = _mm256_set1_ps(inv_rms);
+  for (i = 0; i + 8 <= N; i += 8) {
+    __m256 y = _mm256_mul_ps(_mm256_loadu_ps(X + i), vinv_rms);
+    if (gamma)
+      y = _mm256_mul_ps(y, _mm256_loadu_ps(gamma + i));
+    _mm256_storeu_ps(Y + i, y);
+  }
+  for (; i < N; ++i)
+    Y[i] = X[i] * inv_rms * (gamma ? gamma[i] : 1.0f);
+
+  return inv_rms;
+}
+
+void layer_norm_backward(const unsigned int N, const float *dY,
+                         const float *Xdev, const float *gamma,
+                         const float inv_std, float *dX) {
+  __m256 sum_g_v = _mm256_setzero_ps();
+  __m256 sum_gd_v = _mm256_setzero_ps();
+  unsigned int i = 0;
+  for (; i + 8 <= N; i += 8) {
+    __m256 g = _mm256_loadu_ps(dY + i);
+    if (gamma)
+      g = _mm256_mul_ps(g, _mm256_loadu_ps(gamma + i));
+    sum_g_v = _mm256_add_ps(sum_g_v, g);
+    sum_gd_v = fmadd_ps(g, _mm256_loadu_ps(Xdev + i), sum_gd_v);
+  }
+  float sum_g = hsum_ps(sum_g_v);
+  float sum_gd = hsum_ps(sum_gd_v);
+  for (unsigned int j = i; j < N; ++j) {
+    float g = dY[j] * (gamma ? gamma[j] : 1.0f);
+    sum_g += g;
+    sum_gd += g * Xdev[j];
+  }
+
+  /** Xhat = Xdev * inv_std, so coef * Xdev = mean(G * Xhat) * Xhat */
+  const float mean_g = sum_g / N;
+  const float coef = sum_gd / N * inv_std * inv_std;
+
+  const __m256 vmean_g = _mm256_set1_ps(mean_g);
+  const __m256 vcoef = _mm256_set1_ps(coef);
+  const __m256 vinv_std = _mm256_set1_ps(inv_std);
+  for (i = 0; i + 8 <= N; i += 8) {
+    __m256 g = _mm256_loadu_ps(dY + i);
+    if (gamma)
+      g = _mm256_mul_ps(g, _mm256_loadu_ps(gamma + i));
+    __m256 d = _mm256_sub_ps(
+      _mm256_sub_ps(g, vmean_g),
+      _mm256_mul_ps(_mm256_loadu_ps(Xdev + i), vcoef));
+    _mm256_storeu_ps(dX + i, _mm256_mul_ps(d, vinv_std));
+  }
+  for (; i < N; ++i) {
+    float g = dY[i] * (gamma ? gamma[i] : 1.0f);
+    dX[i] = inv_std * (g - mean_g - Xdev[i] * coef);
+  }
+}
+
+#ifdef ENABLE_FP16
+void adam_update(const unsigned int N, const _Float16 *G, float *W,
+                 _Float16 *W16, float *M, float *V, const float grad_scale,
+                 const double beta1, const double beta2, const float epsilon,
+                 const float v_scale, const float step_size,
+                 const float decay) {
+  const AdamConstants c(beta1, beta2, epsilon, v_scale, step_size, decay);
+  const __m256 gs = _mm256_set1_ps(grad_scale);
+
+  unsigned int i = 0;
+  for (; i + 8 <= N; i += 8) {
+    __m256 g = _mm256_cvtph_ps(_mm_loadu_si128((const __m128i *)(G + i)));
+    __m256 w = adam_update_ps(_mm256_mul_ps(gs, g), W + i, M + i, V + i, c);
+    if (W16)
+      _mm_storeu_si128((__m128i *)(W16 + i),
+                       _mm256_cvtps_ph(w, _MM_FROUND_TO_NEAREST_INT));
+  }
+  for (; i < N; ++i) {
+    float w = adam_update_ss(grad_scale * static_cast<float>(G[i]), W + i,
+                             M + i, V + i, c);
+    if (W16)
+      W16[i] = static_cast<_Float16>(w);
+  }
+}
+#endif
+
 } // namespace nntrainer::avx
@@ -70,6 +70,246 @@ bool isValid(const size_t N, const float *X);
 void custom_scopy(const unsigned int N, const float *X, const int incX,
                   float *Y, const int incY);
 
+/**
+ * @brief     sgemm computation : C = alpha*op(A)*op(B) + beta*C,
+ * where op(X) is one of X or X**T. Matrices are packed into cache-sized
+ * panels and multiplied with a 6x16 AVX2/FMA micro-kernel.
+ * @param[in] TStorageOrder row major if 0, column major otherwise
+ * @param[in] TransA whether op(A) is A**T
+ * @param[in] TransB whether op(B) is B**T
+ * @param[in] M number of op(A)'s and C's row
+ * @param[in] N number of op(B)'s and C's columns
+ * @param[in] K number of op(A)'s columns and op(B)'s rows
+ * @param[in] alpha float number
+ * @param[in] A float * for Matrix A
+ * @param[in] lda leading dimension of A
+ * @param[in] B float * for Matrix B
+ * @param[in] ldb leading dimension of B
+ * @param[in] beta float number
+ * @param[in] C float * for Matrix C
+ * @param[in] ldc leading dimension of C
+ */
+void sgemm(const unsigned int TStorageOrder, bool TransA, bool TransB,
+           const unsigned int M, const unsigned int N, const unsigned int K,
+           const float alpha, const float *A, const unsigned int lda,
+           const float *B, const unsigned int ldb, const float beta, float *C,
+           const unsigned int ldc);
+
+/**
+ * @brief     sgemv computation : Y = alpha*op(A)*X + beta*Y
+ * @param[in] TStorageOrder row major if 0, column major otherwise
+ * @param[in] TransA whether op(A) is A**T
+ * @param[in] M number of A's row
+ * @param[in] N number of A's columns
+ * @param[in] alpha float number
+ * @param[in] A float * for Matrix A
+ * @param[in] lda leading dimension of A
+ * @param[in] X float * for Vector X
+ * @param[in] incX increment of X
+ * @param[in] beta float number
+ * @param[in] Y float * for Vector Y
+ * @param[in] incY increment of Y
+ */
+void sgemv(const unsigned int TStorageOrder, bool TransA, const unsigned int M,
+           const unsigned int N, const float alpha, const float *A,
+           const unsigned int lda, const float *X, const int incX,
+           const float beta, float *Y, const int incY);
+
+/**
+ * @brief     fused Adam/AdamW update done in a single pass over the buffers
+ *            g = grad_scale * G
+ *            M = beta1 * M + (1 - beta1) * g
+ *            V = beta2 * V + (1 - beta2) * g * g
+ *            W = (1 - decay) * W - step_size * M / (sqrt(V) * v_scale + eps)
+ * @param[in] N length of the vectors
+ * @param[in] G float * for gradient
+ * @param[in/out] W float * for weight
+ * @param[in/out] M float * for first moment
+ * @param[in/out] V float * for second moment
+ * @param[in] grad_scale multiplier for gradient (e.g. 1 / loss scale)
+ * @param[in] beta1 decay rate of the first moment
+ * @param[in] beta2 decay rate of the second moment
+ * @param[in] epsilon epsilon added to the denominator
+ * @param[in] v_scale multiplier for sqrt(V)
+ * @param[in] step_size step size applied to the update
+ * @param[in] decay decoupled weight decay (lr * weight_decay)
+ */
+void adam_update(const unsigned int N, const float *G, float *W, float *M,
+                 float *V, const float grad_scale, const double beta1,
+                 const double beta2, const float epsilon, const float v_scale,
+                 const float step_size, const float decay);
+
+/**
+ * @brief     X = exp(X - max) in place with avx
+ * @param[in] N length of the vector
+ * @param[in/out] X float * for Vector X
+ * @param[in] max value subtracted from X before exp
+ * @return sum of the updated X
+ */
+float exp_sub_sum(const unsigned int N, float *X, const float max);
+
+/**
+ * @brief     weight-only quantized gemm with avx : C = A * dequantize(B).
+ *            B is dequantized in the register as 8 columns at a time, so the
+ *            columns of the tail (N % 8) are left to the caller.
+ * @param[in] M number of rows of A and C
+ * @param[in] N number of columns of B and C
+ * @param[in] K number of columns of A and rows of B
+ * @param[in] A float * for the input (M x K)
+ * @param[in] lda leading dimension of A
+ * @param[in] B int8_t * for the 8-bit weight (K x N)
+ * @param[in] ldb leading dimension of B in bytes
+ * @param[in] scales float * for the scales (K / group_size x N)
+ * @param[in] lds leading dimension of scales
+ * @param[in] group_size number of rows of B sharing a scale
+ * @param[out] C float * for the output (M x N)
+ * @param[in] ldc leading dimension of C
+ */
+void qgemm_q8(const unsigned int M, const unsigned int N, const unsigned int K,
+              const float *A, const unsigned int lda, const int8_t *B,
+              const unsigned int ldb, const float *scales,
+              const unsigned int lds, const unsigned int group_size, float *C,
+              const unsigned int ldc);
+
+/**
+ * @brief     weight-only quantized gemm with avx : C = A * dequantize(B).
+ *            B is dequantized in the register as 8 columns at a time, so the
+ *            columns of the tail (N % 8) are left to the caller.
+ * @param[in] M number of rows of A and C
+ * @param[in] N number of columns of B and C
+ * @param[in] K number of columns of A and rows of B
+ * @param[in] A float * for the input (M x K)
+ * @param[in] lda leading dimension of A
+ * @param[in] B uint8_t * for the 4-bit weight (K x N), two
+ *            columns packed in a byte with the even one in the low nibble
+ * @param[in] ldb leading dimension of B in bytes
+ * @param[in] scales float * for the scales (K / group_size x N)
+ * @param[in] lds leading dimension of scales
+ * @param[in] group_size number of rows of B sharing a scale
+ * @param[out] C float * for the output (M x N)
+ * @param[in] ldc leading dimension of C
+ */
+void qgemm_q4(const unsigned int M, const unsigned int N, const unsigned int K,
+              const float *A, const unsigned int lda, const uint8_t *B,
+              const unsigned int ldb, const float *scales,
+              const unsigned int lds, const unsigned int group_size, float *C,
+              const unsigned int ldc);
+
+/**
+ * @brief     Y = 1 / (1 + exp(-X)) with avx
+ * @param[in] N length of the vector
+ * @param[in] X float * for Vector X
+ * @param[out] Y float * for Vector Y, may be X
+ */
+void ele_sigmoid(const unsigned int N, const float *X, float *Y);
+
+/**
+ * @brief     Y = tanh(X) with avx
+ * @param[in] N length of the vector
+ * @param[in] X float * for Vector X
+ * @param[out] Y float * for Vector Y, may be X
+ */
+void ele_tanh(const unsigned int N, const float *X, float *Y);
+
+/**
+ * @brief     Y = X * sigmoid(X) with avx
+ * @param[in] N length of the vector
+ * @param[in] X float * for Vector X
+ * @param[out] Y float * for Vector Y, may be X
+ */
+void ele_swish(const unsigned int N, const float *X, float *Y);
+
+/**
+ * @brief     Y = 0.5 * X * (1 + erf(X / sqrt(2))) with avx
+ * @param[in] N length of the vector
+ * @param[in] X float * for Vector X
+ * @param[out] Y float * for Vector Y, may be X
+ */
+void ele_gelu(const unsigned int N, const float *X, float *Y);
+
+/**
+ * @brief     Y = gelu(X) approximated with tanh with avx
+ * @param[in] N length of the vector
+ * @param[in] X float * for Vector X
+ * @param[out] Y float * for Vector Y, may be X
+ */
+void ele_tanh_gelu(const unsigned int N, const float *X, float *Y);
+
+/**
+ * @brief     Y = X * sigmoid(1.702 * X) with avx
+ * @param[in] N length of the vector
+ * @param[in] X float * for Vector X
+ * @param[out] Y float * for Vector Y, may be X
+ */
+void ele_sigmoid_gelu(const unsigned int N, const float *X, float *Y);
+
+/**
+ * @brief     layer normalization of a row with avx :
+ *            Y = (X - mean) * inv_std * gamma + beta
+ * @param[in] N length of the row
+ * @param[in] X float * for the row
+ * @param[in] gamma float * for the scale, nullptr for 1
+ * @param[in] beta float * for the shift, nullptr for 0
+ * @param[in] epsilon epsilon added to the variance
+ * @param[out] Y float * for the output, may be X
+ * @param[out] Xdev float * for X - mean, nullptr if not needed
+ * @return inv_std, 1 / sqrt(variance + epsilon)
+ */
+float layer_norm(const unsigned int N, const float *X, const float *gamma,
+                 const float *beta, const float epsilon, float *Y,
+                 float *Xdev);
+
+/**
+ * @brief     RMS normalization of a row with avx :
+ *            Y = X * inv_rms * gamma
+ * @param[in] N length of the row
+ * @param[in] X float * for the row
+ * @param[in] gamma float * for the scale, nullptr for 1
+ * @param[in] epsilon epsilon added to the mean square
+ * @param[out] Y float * for the output, may be X
+ * @return inv_rms, 1 / sqrt(mean(X^2) + epsilon)
+ */
+float rms_norm(const unsigned int N, const float *X, const float *gamma,
+               const float epsilon, float *Y);
+
+/**
+ * @brief     derivative of layer_norm with respect to the row with avx
+ * @param[in] N length of the row
+ * @param[in] dY float * for the incoming derivative
+ * @param[in] Xdev float * for X - mean saved by layer_norm
+ * @param[in] gamma float * for the scale, nullptr for 1
+ * @param[in] inv_std inverse standard deviation of the row
+ * @param[out] dX float * for the outgoing derivative, may be dY
+ */
+void layer_norm_backward(const unsigned int N, const float *dY,
+                         const float *Xdev, const float *gamma,
+                         const float inv_std, float *dX);
+
+#ifdef ENABLE_FP16
+/**
+ * @brief     fused Adam/AdamW update with half-precision gradient. The
+ *            updated weight is also written to W16 when it is not null.
+ * @param[in] N length of the vectors
+ * @param[in] G _Float16 * for gradient
+ * @param[in/out] W float * for weight
+ * @param[out] W16 _Float16 * for half-precision copy of the weight
+ * @param[in/out] M float * for first moment
+ * @param[in/out] V float * for second moment
+ * @param[in] grad_scale multiplier for gradient (e.g. 1 / loss scale)
+ * @param[in] beta1 decay rate of the first moment
+ * @param[in] beta2 decay rate of the second moment
+ * @param[in] epsilon epsilon added to the denominator
+ * @param[in] v_scale multiplier for sqrt(V)
+ * @param[in] step_size step size applied to the update
+ * @param[in] decay decoupled weight decay (lr * weight_decay)
+ */
+void adam_update(const unsigned int N, const _Float16 *G, float *W,
+                 _Float16 *W16, float *M, float *V, const float grad_scale,
+                 const double beta1, const double beta2, const float epsilon,
+                 const float v_scale, const float step_size,
+                 const float decay);
+#endif
+
 } // namespace nntrainer::avx
 
 #endif /* __cplusplus */
@@ -30,7 +30,11 @@ extern "C" {
 }
 #endif
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
+#include <type_traits>
+#include <vector>
 
 #define sgemv_loop(ci, cj, cM, cN)           \
   do {                                       \
@@ -95,6 +99,132 @@ static inline void transpose_fallback(unsigned int M, unsigned int N,
   }
 }
 
+/**
+ * @brief number of queries and keys in a tile of flash_attention
+ */
+static constexpr unsigned int ATTENTION_TILE_Q = 32;
+static constexpr unsigned int ATTENTION_TILE_K = 128;
+
+/**
+ * @brief get rows x cols of X as a float matrix. float matrix is used as it is,
+ * and the others are converted into buf.
+ *
+ * @param[out] ld_f leading dimension of the returned matrix
+ */
+template <typename T>
+static inline const float *load_tile(const T *X, unsigned int ld,
+                                     unsigned int rows, unsigned int cols,
+                                     std::vector<float> &buf,
+                                     unsigned int &ld_f) {
+  if constexpr (std::is_same_v<T, float>) {
+    ld_f = ld;
+    return X;
+  } else {
+    for (unsigned int r = 0; r < rows; ++r)
+      scopy(cols, X + r * ld, 1, buf.data() + r * cols, 1);
+    ld_f = cols;
+    return buf.data();
+  }
+}
+
+/**
+ * @brief flash_attention for T. The tiles of half precision are converted to
+ * float, so the scores and the output are accumulated in float regardless.
+ * The keys and values are given as pages of page_len rows, and a tile never
+ * crosses a page.
+ */
+template <typename T>
+static void flash_attention_impl(
+  const unsigned int q_len, const unsigned int k_len, const unsigned int dk,
+  const unsigned int dv, const T *Q, const unsigned int ldq,
+  const T *const *K_pages, const unsigned int ldk, const T *const *V_pages,
+  const unsigned int ldv, const unsigned int page_len, const T *mask,
+  const unsigned int ldm, const float scale, const int causal_offset, T *O,
+  const unsigned int ldo) {
+  constexpr unsigned int Br = ATTENTION_TILE_Q;
+  constexpr unsigned int Bc = ATTENTION_TILE_K;
+  const float neg_inf = -std::numeric_limits<float>::infinity();
+
+  std::vector<float> q_buf, k_buf, v_buf;
+  if constexpr (!std::is_same_v<T, float>) {
+    q_buf.resize(Br * dk);
+    k_buf.resize(Bc * dk);
+    v_buf.resize(Bc * dv);
+  }
+
+  /** scores of a tile, running max, sum and unnormalized output of the rows */
+  std::vector<float> S(Br * Bc), row_max(Br), row_sum(Br), acc(Br * dv);
+
+  for (unsigned int i0 = 0; i0 < q_len; i0 += Br) {
+    const unsigned int rows = std::min(Br, q_len - i0);
+    unsigned int ldq_f, ldk_f, ldv_f;
+    const float *q = load_tile(Q + i0 * ldq, ldq, rows, dk, q_buf, ldq_f);
+
+    std::fill_n(row_max.begin(), rows, neg_inf);
+    std::fill_n(row_sum.begin(), rows, 0.0f);
+    std::fill_n(acc.begin(), rows * dv, 0.0f);
+
+    /** the keys after the causal range of the last row are never visited */
+    unsigned int k_end = k_len;
+    if (causal_offset >= 0)
+      k_end = std::min<long long>(k_len, (long long)i0 + rows + causal_offset);
+
+    for (unsigned int j0 = 0; j0 < k_end;) {
+      const unsigned int page = j0 / page_len, row = j0 % page_len;
+      const unsigned int cols = std::min({Bc, k_end - j0, page_len - row});
+      const float *k =
+        load_tile(K_pages[page] + row * ldk, ldk, cols, dk, k_buf, ldk_f);
+      const float *v =
+        load_tile(V_pages[page] + row * ldv, ldv, cols, dv, v_buf, ldv_f);
+
+      sgemm(0, false, true, rows, cols, dk, scale, q, ldq_f, k, ldk_f, 0.0f,
+            S.data(), Bc);
+
+      for (unsigned int r = 0; r < rows; ++r) {
+        float *s = S.data() + r * Bc;
+        if (mask != nullptr) {
+          const T *m = mask + (i0 + r) * ldm + j0;
+          for (unsigned int c = 0; c < cols; ++c)
+            s[c] += static_cast<float>(m[c]);
+        }
+
+        unsigned int valid = cols;
+        if (causal_offset >= 0)
+          valid = std::clamp<long long>(
+            (long long)i0 + r + causal_offset - j0 + 1, 0, cols);
+
+        float new_max =
+          valid == 0 ? neg_inf
+                     : std::max(row_max[r], *std::max_element(s, s + valid));
+        if (new_max == neg_inf) {
+          /** every key is masked out so far */
+          std::fill(s, s + cols, 0.0f);
+          continue;
+        }
+
+        float correction = std::exp(row_max[r] - new_max);
+        row_sum[r] = row_sum[r] * correction + exp_sub_sum(valid, s, new_max);
+        std::fill(s + valid, s + cols, 0.0f);
+        if (correction != 1.0f)
+          sscal(dv, correction, acc.data() + r * dv, 1);
+        row_max[r] = new_max;
+      }
+
+      sgemm(0, false, false, rows, dv, cols, 1.0f, S.data(), Bc, v, ldv_f,
+            1.0f, acc.data(), dv);
+      j0 += cols;
+    }
+
+    for (unsigned int r = 0; r < rows; ++r) {
+      float inv_sum = row_sum[r] > 0.0f ? 1.0f / row_sum[r] : 0.0f;
+      const float *a = acc.data() + r * dv;
+      T *o = O + (i0 + r) * ldo;
+      for (unsigned int c = 0; c < dv; ++c)
+        o[c] = static_cast<T>(a[c] * inv_sum);
+    }
+  }
+}
+
 #ifdef ENABLE_FP16
 static void saxpy_FP16(const unsigned int N, const float alpha, const _FP16 *X,
                        const int incX, _FP16 *Y, const int incY) {
@@ -560,6 +690,57 @@ void transpose_matrix(const unsigned int M, const unsigned int N,
   transpose_fallback<_FP16>(M, N, src, ld_src, dst, ld_dst);
 #endif
 }
+
+void adam_update(const unsigned int N, const _FP16 *G, float *W, _FP16 *W16,
+                 float *M, float *V, const float grad_scale, const double beta1,
+                 const double beta2, const float epsilon, const float v_scale,
+                 const float step_size, const float decay) {
+#ifdef USE_NEON
+  nntrainer::neon::adam_update(N, G, W, W16, M, V, grad_scale, beta1, beta2,
+                               epsilon, v_scale, step_size, decay);
+#elif USE_AVX
+  nntrainer::avx::adam_update(N, G, W, W16, M, V, grad_scale, beta1, beta2,
+                              epsilon, v_scale, step_size, decay);
+#else
+  const float b1 = beta1, one_m_b1 = 1.0 - beta1;
+  const float b2 = beta2, one_m_b2 = 1.0 - beta2;
+  for (unsigned int i = 0; i < N; ++i) {
+    float g = grad_scale * static_cast<float>(G[i]);
+    M[i] = b1 * M[i] + one_m_b1 * g;
+    V[i] = b2 * V[i] + one_m_b2 * g * g;
+    W[i] = (1.0f - decay) * W[i] -
+           step_size * M[i] / (std::sqrt(V[i]) * v_scale + epsilon);
+    if (W16)
+      W16[i] = static_cast<_FP16>(W[i]);
+  }
+#endif
+}
+
+void flash_attention(const unsigned int q_len, const unsigned int k_len,
+                     const unsigned int dk, const unsigned int dv,
+                     const _FP16 *Q, const unsigned int ldq, const _FP16 *K,
+                     const unsigned int ldk, const _FP16 *V,
+                     const unsigned int ldv, const _FP16 *mask,
+                     const unsigned int ldm, const float scale,
+                     const int causal_offset, _FP16 *O,
+                     const unsigned int ldo) {
+  flash_attention_impl(q_len, k_len, dk, dv, Q, ldq, &K, ldk, &V, ldv,
+                       std::max(k_len, 1u), mask, ldm, scale, causal_offset, O,
+                       ldo);
+}
+
+void flash_attention_paged(const unsigned int q_len, const unsigned int k_len,
+                           const unsigned int dk, const unsigned int dv,
+                           const _FP16 *Q, const unsigned int ldq,
+                           const _FP16 *const *K_pages, const unsigned int ldk,
+                           const _FP16 *const *V_pages, const unsigned int ldv,
+                           const unsigned int page_len, const float scale,
+                           const int causal_offset, _FP16 *O,
+                           const unsigned int ldo) {
+  flash_attention_impl(q_len, k_len, dk, dv, Q, ldq, K_pages, ldk, V_pages,
+                       ldv, page_len, (_FP16 *)nullptr, 0, scale, causal_offset,
+                       O, ldo);
+}
 #endif
 
 #ifndef USE_BLAS
@@ -571,6 +752,7 @@ static void saxpy_raw(const unsigned int N, const float alpha, const float *X,
     Y[i * incY] = Y[i * incY] + X[i * incX] * alpha;
 }
 
+#if !USE_AVX
 static void sgemv_raw(const unsigned int TStorageOrder, bool TransA,
                       const unsigned int M, const unsigned int N,
                       const float alpha, const float *A, const unsigned int lda,
@@ -586,6 +768,7 @@ static void sgemv_raw(const unsigned int TStorageOrder, bool TransA,
     sgemv_loop(j, i, M, N);
   }
 }
+#endif
 
 static float sdot_raw(const unsigned int N, const float *X,
                       const unsigned int incX, const float *Y,
@@ -617,6 +800,7 @@ static float snrm2_raw(const unsigned int N, const float *X, const int incX) {
   return sqrt(sum);
 }
 
+#if !USE_AVX
 static void sgemm_raw(const unsigned int TStorageOrder, bool TransA,
                       bool TransB, const unsigned int M, const unsigned int N,
                       const unsigned int K, const float alpha, const float *A,
@@ -640,6 +824,7 @@ static void sgemm_raw(const unsigned int TStorageOrder, bool TransA,
     }
   }
 }
+#endif
 
 static unsigned int isamax_raw(const unsigned int N, const float *X,
                                const int incX) {
@@ -781,6 +966,11 @@ void sgemm(const unsigned int TStorageOrder, bool TransA, bool TransB,
     cblas_sgemm(
       order, transA, transB, M, N, K, alpha, static_cast<const float *>(A), lda,
       static_cast<const float *>(B), ldb, beta, static_cast<float *>(C), ldc);
+#elif USE_AVX
+    nntrainer::avx::sgemm(TStorageOrder, TransA, TransB, M, N, K, alpha,
+                          static_cast<const float *>(A), lda,
+                          static_cast<const float *>(B), ldb, beta,
+                          static_cast<float *>(C), ldc);
 #else
     sgemm_raw(TStorageOrder, TransA, TransB, M, N, K, alpha,
               static_cast<const float *>(A), lda, static_cast<const float *>(B),
@@ -839,6 +1029,9 @@ void sgemm(const unsigned int TStorageOrder, bool TransA, bool TransB,
   CBLAS_ORDER order = TStorageOrder ? CblasColMajor : CblasRowMajor;
   cblas_sgemm(order, transA, transB, M, N, K, alpha, A, lda, B, ldb, beta, C,
               ldc);
+#elif USE_AVX
+  nntrainer::avx::sgemm(TStorageOrder, TransA, TransB, M, N, K, alpha, A, lda,
+                        B, ldb, beta, C, ldc);
 #else
   sgemm_raw(TStorageOrder, TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta,
             C, ldc);
@@ -963,6 +1156,10 @@ void sgemv(const unsigned int TStorageOrder, bool TransA, const unsigned int M,
     return cblas_sgemv(
       order, transA, M, N, alpha, static_cast<const float *>(A), lda,
       static_cast<const float *>(X), incX, beta, static_cast<float *>(Y), incY);
+#elif USE_AVX
+    return nntrainer::avx::sgemv(
+      TStorageOrder, TransA, M, N, alpha, static_cast<const float *>(A), lda,
+      static_cast<const float *>(X), incX, beta, static_cast<float *>(Y), incY);
 #else
     return sgemv_raw(
       TStorageOrder, TransA, M, N, alpha, static_cast<const float *>(A), lda,
@@ -991,6 +1188,9 @@ void sgemv(const unsigned int TStorageOrder, bool TransA, const unsigned int M,
   CBLAS_ORDER order = TStorageOrder ? CblasColMajor : CblasRowMajor;
   return cblas_sgemv(order, transA, M, N, alpha, A, lda, X, incX, beta, Y,
                      incY);
+#elif USE_AVX
+  return nntrainer::avx::sgemv(TStorageOrder, TransA, M, N, alpha, A, lda, X,
+                               incX, beta, Y, incY);
 #else
   return sgemv_raw(TStorageOrder, TransA, M, N, alpha, A, lda, X, incX, beta, Y,
                    incY);
@@ -1147,6 +1347,346 @@ void ele_div(const unsigned int N, const float *X, const float *Y, float *Z,
     ele_div_fallback(N, X, Y, Z, alpha, beta, i_stride, o_stride);
 }
 
+void adam_update(const unsigned int N, const float *G, float *W, float *M,
+                 float *V, const float grad_scale, const double beta1,
+                 const double beta2, const float epsilon, const float v_scale,
+                 const float step_size, const float decay) {
+#ifdef USE_NEON
+  nntrainer::neon::adam_update(N, G, W, M, V, grad_scale, beta1, beta2,
+                               epsilon, v_scale, step_size, decay);
+#elif USE_AVX
+  nntrainer::avx::adam_update(N, G, W, M, V, grad_scale, beta1, beta2, epsilon,
+                              v_scale, step_size, decay);
+#else
+  const float b1 = beta1, one_m_b1 = 1.0 - beta1;
+  const float b2 = beta2, one_m_b2 = 1.0 - beta2;
+  for (unsigned int i = 0; i < N; ++i) {
+    float g = grad_scale * G[i];
+    M[i] = b1 * M[i] + one_m_b1 * g;
+    V[i] = b2 * V[i] + one_m_b2 * g * g;
+    W[i] = (1.0f - decay) * W[i] -
+           step_size * M[i] / (std::sqrt(V[i]) * v_scale + epsilon);
+  }
+#endif
+}
+
+float exp_sub_sum(const unsigned int N, float *X, const float max) {
+#ifdef USE_NEON
+  return nntrainer::neon::exp_sub_sum(N, X, max);
+#elif USE_AVX
+  return nntrainer::avx::exp_sub_sum(N, X, max);
+#else
+  float sum = 0.0f;
+  for (unsigned int i = 0; i < N; ++i) {
+    X[i] = std::exp(X[i] - max);
+    sum += X[i];
+  }
+  return sum;
+#endif
+}
+
+/**
+ * @brief the n-th weight of the int8 row
+ */
+static inline float dequant_q8(const int8_t *row, unsigned int n) {
+  return row[n];
+}
+
+/**
+ * @brief the n-th weight of the packed int4 row
+ */
+static inline float dequant_q4(const uint8_t *row, unsigned int n) {
+  uint8_t nibble = (n % 2) ? row[n / 2] >> 4 : row[n / 2] & 0x0F;
+  /** sign extend 4 bits */
+  return static_cast<int>(nibble ^ 8) - 8;
+}
+
+/**
+ * @brief weight-only quantized gemm for the columns which simd does not cover
+ */
+template <typename T, typename Dequant>
+static void qgemm_fallback(const unsigned int M, const unsigned int N,
+                           const unsigned int K, const float *A,
+                           const unsigned int lda, const T *B,
+                           const unsigned int ldb, const float *scales,
+                           const unsigned int lds,
+                           const unsigned int group_size, float *C,
+                           const unsigned int ldc, Dequant dequant) {
+  for (unsigned int m = 0; m < M; ++m) {
+    for (unsigned int n = 0; n < N; ++n) {
+      float sum = 0.0f;
+      for (unsigned int k0 = 0; k0 < K; k0 += group_size) {
+        float acc = 0.0f;
+        for (unsigned int k = k0; k < k0 + group_size; ++k)
+          acc += A[m * lda + k] * dequant(B + k * ldb, n);
+        sum += acc * scales[(k0 / group_size) * lds + n];
+      }
+      C[m * ldc + n] = sum;
+    }
+  }
+}
+
+void qgemm_q8(const unsigned int M, const unsigned int N, const unsigned int K,
+              const float *A, const unsigned int lda, const int8_t *B,
+              const unsigned int ldb, const float *scales,
+              const unsigned int lds, const unsigned int group_size, float *C,
+              const unsigned int ldc) {
+  NNTR_THROW_IF(group_size == 0 || K % group_size, std::invalid_argument)
+    << "K: " << K << " is not a multiple of the group size: " << group_size;
+
+  unsigned int n = 0;
+#ifdef USE_NEON
+  n = N / 8 * 8;
+  nntrainer::neon::qgemm_q8(M, n, K, A, lda, B, ldb, scales, lds, group_size,
+                            C, ldc);
+#elif USE_AVX
+  n = N / 8 * 8;
+  nntrainer::avx::qgemm_q8(M, n, K, A, lda, B, ldb, scales, lds, group_size,
+                           C, ldc);
+#endif
+  qgemm_fallback(M, N - n, K, A, lda, B + n, ldb, scales + n, lds, group_size,
+                 C + n, ldc, dequant_q8);
+}
+
+void qgemm_q4(const unsigned int M, const unsigned int N, const unsigned int K,
+              const float *A, const unsigned int lda, const uint8_t *B,
+              const unsigned int ldb, const float *scales,
+              const unsigned int lds, const unsigned int group_size, float *C,
+              const unsigned int ldc) {
+  NNTR_THROW_IF(group_size == 0 || K % group_size, std::invalid_argument)
+    << "K: " << K << " is not a multiple of the group size: " << group_size;
+
+  unsigned int n = 0;
+#ifdef USE_NEON
+  n = N / 8 * 8;
+  nntrainer::neon::qgemm_q4(M, n, K, A, lda, B, ldb, scales, lds, group_size,
+                            C, ldc);
+#elif USE_AVX
+  n = N / 8 * 8;
+  nntrainer::avx::qgemm_q4(M, n, K, A, lda, B, ldb, scales, lds, group_size,
+                           C, ldc);
+#endif
+  /** n is even, so the tail starts at a byte boundary */
+  qgemm_fallback(M, N - n, K, A, lda, B + n / 2, ldb, scales + n, lds,
+                 group_size, C + n, ldc, dequant_q4);
+}
+
+/**
+ * @brief symmetric quantization of W to [-qmax, qmax] for each group of rows
+ * of each column
+ */
+template <typename Store>
+static void quantize_symmetric(const unsigned int K, const unsigned int N,
+                               const float *W, const unsigned int ldw,
+                               float *scales, const unsigned int lds,
+                               const unsigned int group_size, const int qmax,
+                               Store store) {
+  NNTR_THROW_IF(group_size == 0 || K % group_size, std::invalid_argument)
+    << "K: " << K << " is not a multiple of the group size: " << group_size;
+
+  for (unsigned int k0 = 0; k0 < K; k0 += group_size) {
+    for (unsigned int n = 0; n < N; ++n) {
+      float amax = 0.0f;
+      for (unsigned int k = k0; k < k0 + group_size; ++k)
+        amax = std::max(amax, std::abs(W[k * ldw + n]));
+
+      float scale = amax / qmax;
+      float inv_scale = scale > 0.0f ? 1.0f / scale : 0.0f;
+      scales[(k0 / group_size) * lds + n] = scale;
+
+      for (unsigned int k = k0; k < k0 + group_size; ++k) {
+        long q = std::lround(W[k * ldw + n] * inv_scale);
+        store(k, n, static_cast<int>(std::clamp<long>(q, -qmax, qmax)));
+      }
+    }
+  }
+}
+
+void quantize_q8(const unsigned int K, const unsigned int N, const float *W,
+                 const unsigned int ldw, int8_t *B, const unsigned int ldb,
+                 float *scales, const unsigned int lds,
+                 const unsigned int group_size) {
+  quantize_symmetric(K, N, W, ldw, scales, lds, group_size, 127,
+                     [B, ldb](unsigned int k, unsigned int n, int q) {
+                       B[k * ldb + n] = static_cast<int8_t>(q);
+                     });
+}
+
+void quantize_q4(const unsigned int K, const unsigned int N, const float *W,
+                 const unsigned int ldw, uint8_t *B, const unsigned int ldb,
+                 float *scales, const unsigned int lds,
+                 const unsigned int group_size) {
+  quantize_symmetric(K, N, W, ldw, scales, lds, group_size, 7,
+                     [B, ldb](unsigned int k, unsigned int n, int q) {
+                       uint8_t &byte = B[k * ldb + n / 2];
+                       uint8_t nibble = static_cast<uint8_t>(q) & 0x0F;
+                       byte = (n % 2) ? (byte & 0x0F) | (nibble << 4)
+                                      : (byte & 0xF0) | nibble;
+                     });
+}
+
+void ele_sigmoid(const unsigned int N, const float *X, float *Y) {
+#ifdef USE_NEON
+  nntrainer::neon::ele_sigmoid(N, X, Y);
+#elif USE_AVX
+  nntrainer::avx::ele_sigmoid(N, X, Y);
+#else
+  std::transform(X, X + N, Y,
+                 [](float x) { return 1.0f / (1.0f + std::exp(-x)); });
+#endif
+}
+
+void ele_tanh(const unsigned int N, const float *X, float *Y) {
+#ifdef USE_NEON
+  nntrainer::neon::ele_tanh(N, X, Y);
+#elif USE_AVX
+  nntrainer::avx::ele_tanh(N, X, Y);
+#else
+  std::transform(X, X + N, Y, [](float x) { return std::tanh(x); });
+#endif
+}
+
+void ele_swish(const unsigned int N, const float *X, float *Y) {
+#ifdef USE_NEON
+  nntrainer::neon::ele_swish(N, X, Y);
+#elif USE_AVX
+  nntrainer::avx::ele_swish(N, X, Y);
+#else
+  std::transform(X, X + N, Y,
+                 [](float x) { return x / (1.0f + std::exp(-x)); });
+#endif
+}
+
+void ele_gelu(const unsigned int N, const float *X, float *Y) {
+#ifdef USE_NEON
+  nntrainer::neon::ele_gelu(N, X, Y);
+#elif USE_AVX
+  nntrainer::avx::ele_gelu(N, X, Y);
+#else
+  std::transform(X, X + N, Y, [](float x) {
+    return 0.5f * x * (1.0f + std::erf(x * 0.70710678118654752f));
+  });
+#endif
+}
+
+void ele_tanh_gelu(const unsigned int N, const float *X, float *Y) {
+#ifdef USE_NEON
+  nntrainer::neon::ele_tanh_gelu(N, X, Y);
+#elif USE_AVX
+  nntrainer::avx::ele_tanh_gelu(N, X, Y);
+#else
+  std::transform(X, X + N, Y, [](float x) {
+    float u = 0.79788456080286536f * (x + 0.044715f * x * x * x);
+    return 0.5f * x * (1.0f + std::tanh(u));
+  });
+#endif
+}
+
+void ele_sigmoid_gelu(const unsigned int N, const float *X, float *Y) {
+#ifdef USE_NEON
+  nntrainer::neon::ele_sigmoid_gelu(N, X, Y);
+#elif USE_AVX
+  nntrainer::avx::ele_sigmoid_gelu(N, X, Y);
+#else
+  std::transform(X, X + N, Y,
+                 [](float x) { return x / (1.0f + std::exp(-1.702f * x)); });
+#endif
+}
+
+float layer_norm(const unsigned int N, const float *X, const float *gamma,
+                 const float *beta, const float epsilon, float *Y,
+                 float *Xdev) {
+#ifdef USE_NEON
+  return nntrainer::neon::layer_norm(N, X, gamma, beta, epsilon, Y, Xdev);
+#elif USE_AVX
+  return nntrainer::avx::layer_norm(N, X, gamma, beta, epsilon, Y, Xdev);
+#else
+  float mean = 0.0f, m2 = 0.0f;
+  for (unsigned int i = 0; i < N; ++i) {
+    float delta = X[i] - mean;
+    mean += delta / (i + 1);
+    m2 += delta * (X[i] - mean);
+  }
+
+  const float inv_std = 1.0f / std::sqrt(m2 / N + epsilon);
+  for (unsigned int i = 0; i < N; ++i) {
+    float dev = X[i] - mean;
+    if (Xdev)
+      Xdev[i] = dev;
+    Y[i] = dev * inv_std * (gamma ? gamma[i] : 1.0f) + (beta ? beta[i] : 0.0f);
+  }
+  return inv_std;
+#endif
+}
+
+float rms_norm(const unsigned int N, const float *X, const float *gamma,
+               const float epsilon, float *Y) {
+#ifdef USE_NEON
+  return nntrainer::neon::rms_norm(N, X, gamma, epsilon, Y);
+#elif USE_AVX
+  return nntrainer::avx::rms_norm(N, X, gamma, epsilon, Y);
+#else
+  float sum = 0.0f;
+  for (unsigned int i = 0; i < N; ++i)
+    sum += X[i] * X[i];
+
+  const float inv_rms = 1.0f / std::sqrt(sum / N + epsilon);
+  for (unsigned int i = 0; i < N; ++i)
+    Y[i] = X[i] * inv_rms * (gamma ? gamma[i] : 1.0f);
+  return inv_rms;
+#endif
+}
+
+void layer_norm_backward(const unsigned int N, const float *dY,
+                         const float *Xdev, const float *gamma,
+                         const float inv_std, float *dX) {
+#ifdef USE_NEON
+  nntrainer::neon::layer_norm_backward(N, dY, Xdev, gamma, inv_std, dX);
+#elif USE_AVX
+  nntrainer::avx::layer_norm_backward(N, dY, Xdev, gamma, inv_std, dX);
+#else
+  float sum_g = 0.0f, sum_gd = 0.0f;
+  for (unsigned int i = 0; i < N; ++i) {
+    float g = dY[i] * (gamma ? gamma[i] : 1.0f);
+    sum_g += g;
+    sum_gd += g * Xdev[i];
+  }
+
+  const float mean_g = sum_g / N;
+  const float coef = sum_gd / N * inv_std * inv_std;
+  for (unsigned int i = 0; i < N; ++i) {
+    float g = dY[i] * (gamma ? gamma[i] : 1.0f);
+    dX[i] = inv_std * (g - mean_g - Xdev[i] * coef);
+  }
+#endif
+}
+
+void flash_attention(const unsigned int q_len, const unsigned int k_len,
+                     const unsigned int dk, const unsigned int dv,
+                     const float *Q, const unsigned int ldq, const float *K,
+                     const unsigned int ldk, const float *V,
+                     const unsigned int ldv, const float *mask,
+                     const unsigned int ldm, const float scale,
+                     const int causal_offset, float *O,
+                     const unsigned int ldo) {
+  flash_attention_impl(q_len, k_len, dk, dv, Q, ldq, &K, ldk, &V, ldv,
+                       std::max(k_len, 1u), mask, ldm, scale, causal_offset, O,
+                       ldo);
+}
+
+void flash_attention_paged(const unsigned int q_len, const unsigned int k_len,
+                           const unsigned int dk, const unsigned int dv,
+                           const float *Q, const unsigned int ldq,
+                           const float *const *K_pages, const unsigned int ldk,
+                           const float *const *V_pages, const unsigned int ldv,
+                           const unsigned int page_len, const float scale,
+                           const int causal_offset, float *O,
+                           const unsigned int ldo) {
+  flash_attention_impl(q_len, k_len, dk, dv, Q, ldq, K_pages, ldk, V_pages,
+                       ldv, page_len, (float *)nullptr, 0, scale, causal_offset,
+                       O, ldo);
+}
+
 bool is_valid(const size_t N, ml::train::TensorDim::DataType d_type,
               const void *X) {
   if (d_type == ml::train::TensorDim::DataType::FP16) {
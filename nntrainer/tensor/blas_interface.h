@@ -228,6 +228,88 @@ void inv_sqrt_inplace(const unsigned int N, _FP16 *X);
 void transpose_matrix(const unsigned int M, const unsigned int N,
                       const _FP16 *src, unsigned int ld_src, _FP16 *dst,
                       unsigned int ld_dst);
+
+/**
+ * @brief     fused Adam/AdamW update with half-precision gradient. The updated
+ * full-precision weight is also written to W16 when it is not null.
+ * @param[in] N length of the vectors
+ * @param[in] G _FP16 * for gradient
+ * @param[in] W float * for weight
+ * @param[in] W16 _FP16 * for half-precision copy of the weight (nullable)
+ * @param[in] M float * for first moment
+ * @param[in] V float * for second moment
+ * @param[in] grad_scale multiplier for gradient (e.g. 1 / loss scale)
+ * @param[in] beta1 decay rate of the first moment
+ * @param[in] beta2 decay rate of the second moment
+ * @param[in] epsilon epsilon added to the denominator
+ * @param[in] v_scale multiplier for sqrt(V)
+ * @param[in] step_size step size applied to the update
+ * @param[in] decay decoupled weight decay (lr * weight_decay)
+ */
+void adam_update(const unsigned int N, const _FP16 *G, float *W, _FP16 *W16,
+                 float *M, float *V, const float grad_scale, const double beta1,
+                 const double beta2, const float epsilon, const float v_scale,
+                 const float step_size, const float decay);
+
+/**
+ * @brief     scaled dot product attention of a head, computed over the tiles
+ * of keys with online softmax so that the q_len x k_len attention weight is
+ * never materialized : O = softmax(scale * Q * K**T + mask) * V
+ * @param[in] q_len number of queries
+ * @param[in] k_len number of keys and values
+ * @param[in] dk dimension of query and key
+ * @param[in] dv dimension of value
+ * @param[in] Q _FP16 * for query (q_len x dk)
+ * @param[in] ldq leading dimension of Q
+ * @param[in] K _FP16 * for key (k_len x dk)
+ * @param[in] ldk leading dimension of K
+ * @param[in] V _FP16 * for value (k_len x dv)
+ * @param[in] ldv leading dimension of V
+ * @param[in] mask _FP16 * for additive mask (q_len x k_len), nullptr if none
+ * @param[in] ldm leading dimension of mask
+ * @param[in] scale multiplier for Q * K**T
+ * @param[in] causal_offset if not negative, the i-th query attends to the keys
+ * up to (i + causal_offset) only
+ * @param[out] O _FP16 * for output (q_len x dv)
+ * @param[in] ldo leading dimension of O
+ */
+void flash_attention(const unsigned int q_len, const unsigned int k_len,
+                     const unsigned int dk, const unsigned int dv,
+                     const _FP16 *Q, const unsigned int ldq, const _FP16 *K,
+                     const unsigned int ldk, const _FP16 *V,
+                     const unsigned int ldv, const _FP16 *mask,
+                     const unsigned int ldm, const float scale,
+                     const int causal_offset, _FP16 *O, const unsigned int ldo);
+
+/**
+ * @brief     flash_attention over the keys and values split into pages, as in
+ * a paged key/value cache. The j-th key is the (j % page_len)-th row of
+ * K_pages[j / page_len], and so is the value.
+ * @param[in] q_len number of queries
+ * @param[in] k_len number of keys and values
+ * @param[in] dk dimension of query and key
+ * @param[in] dv dimension of value
+ * @param[in] Q _FP16 * for query (q_len x dk)
+ * @param[in] ldq leading dimension of Q
+ * @param[in] K_pages _FP16 * for each page of key (page_len x dk)
+ * @param[in] ldk leading dimension of a page of key
+ * @param[in] V_pages _FP16 * for each page of value (page_len x dv)
+ * @param[in] ldv leading dimension of a page of value
+ * @param[in] page_len number of keys in a page
+ * @param[in] scale multiplier for Q * K**T
+ * @param[in] causal_offset if not negative, the i-th query attends to the keys
+ * up to (i + causal_offset) only
+ * @param[out] O _FP16 * for output (q_len x dv)
+ * @param[in] ldo leading dimension of O
+ */
+void flash_attention_paged(const unsigned int q_len, const unsigned int k_len,
+                           const unsigned int dk, const unsigned int dv,
+                           const _FP16 *Q, const unsigned int ldq,
+                           const _FP16 *const *K_pages, const unsigned int ldk,
+                           const _FP16 *const *V_pages, const unsigned int ldv,
+                           const unsigned int page_len, const float scale,
+                           const int causal_offset, _FP16 *O,
+                           const unsigned int ldo);
 #endif
 /**
  * @brief     sscal computation : X = alpha * X
@@ -478,6 +560,275 @@ void ele_div(const unsigned N, const float *X, const float *Y, float *Z,
              float alpha = 1.f, float beta = 0.f, unsigned int i_stride = 1,
              unsigned int o_stride = 1);
 
+/**
+ * @brief     fused Adam/AdamW update in a single pass over G, W, M and V
+ *            g = grad_scale * G
+ *            M = beta1 * M + (1 - beta1) * g
+ *            V = beta2 * V + (1 - beta2) * g * g
+ *            W = (1 - decay) * W - step_size * M / (sqrt(V) * v_scale + eps)
+ * @param[in] N length of the vectors
+ * @param[in] G float * for gradient
+ * @param[in] W float * for weight
+ * @param[in] M float * for first moment
+ * @param[in] V float * for second moment
+ * @param[in] grad_scale multiplier for gradient (e.g. 1 / loss scale)
+ * @param[in] beta1 decay rate of the first moment
+ * @param[in] beta2 decay rate of the second moment
+ * @param[in] epsilon epsilon added to the denominator
+ * @param[in] v_scale multiplier for sqrt(V)
+ * @param[in] step_size step size applied to the update
+ * @param[in] decay decoupled weight decay (lr * weight_decay)
+ */
+void adam_update(const unsigned int N, const float *G, float *W, float *M,
+                 float *V, const float grad_scale, const double beta1,
+                 const double beta2, const float epsilon, const float v_scale,
+                 const float step_size, const float decay);
+
+/**
+ * @brief     X = exp(X - max) in place
+ * @param[in] N length of the vector
+ * @param[in/out] X float * for Vector X
+ * @param[in] max value subtracted from X before exp, usually the maximum of X
+ * @return sum of the updated X
+ */
+float exp_sub_sum(const unsigned int N, float *X, const float max);
+
+/**
+ * @brief     weight-only quantized gemm : C = A * dequantize(B), where
+ *            dequantize(B)[k][n] = B[k][n] * scales[k / group_size][n]. The
+ *            weight is dequantized in the register and never materialized.
+ * @param[in] M number of rows of A and C
+ * @param[in] N number of columns of B and C
+ * @param[in] K number of columns of A and rows of B
+ * @param[in] A float * for the input (M x K)
+ * @param[in] lda leading dimension of A
+ * @param[in] B int8_t * for the weight (K x N)
+ * @param[in] ldb leading dimension of B in bytes
+ * @param[in] scales float * for the scales (K / group_size x N)
+ * @param[in] lds leading dimension of scales
+ * @param[in] group_size number of rows of B sharing a scale, K for per
+ * channel scales
+ * @param[out] C float * for the output (M x N)
+ * @param[in] ldc leading dimension of C
+ */
+void qgemm_q8(const unsigned int M, const unsigned int N, const unsigned int K,
+              const float *A, const unsigned int lda, const int8_t *B,
+              const unsigned int ldb, const float *scales,
+              const unsigned int lds, const unsigned int group_size, float *C,
+              const unsigned int ldc);
+
+/**
+ * @brief     weight-only quantized gemm with the 4-bit weight. Two columns of
+ *            B are packed in a byte, the even column in the low nibble, as a
+ *            signed 4-bit integer.
+ * @param[in] M number of rows of A and C
+ * @param[in] N number of columns of B and C
+ * @param[in] K number of columns of A and rows of B
+ * @param[in] A float * for the input (M x K)
+ * @param[in] lda leading dimension of A
+ * @param[in] B uint8_t * for the packed weight (K x (N + 1) / 2 bytes)
+ * @param[in] ldb leading dimension of B in bytes
+ * @param[in] scales float * for the scales (K / group_size x N)
+ * @param[in] lds leading dimension of scales
+ * @param[in] group_size number of rows of B sharing a scale, K for per
+ * channel scales
+ * @param[out] C float * for the output (M x N)
+ * @param[in] ldc leading dimension of C
+ */
+void qgemm_q4(const unsigned int M, const unsigned int N, const unsigned int K,
+              const float *A, const unsigned int lda, const uint8_t *B,
+              const unsigned int ldb, const float *scales,
+              const unsigned int lds, const unsigned int group_size, float *C,
+              const unsigned int ldc);
+
+/**
+ * @brief     symmetric quantization of the weight for qgemm_q8, with a scale
+ *            of max(abs(W)) / 127 for each group of rows of each column
+ * @param[in] K number of rows of W
+ * @param[in] N number of columns of W
+ * @param[in] W float * for the weight (K x N)
+ * @param[in] ldw leading dimension of W
+ * @param[out] B int8_t * for the quantized weight (K x N)
+ * @param[in] ldb leading dimension of B in bytes
+ * @param[out] scales float * for the scales (K / group_size x N)
+ * @param[in] lds leading dimension of scales
+ * @param[in] group_size number of rows sharing a scale
+ */
+void quantize_q8(const unsigned int K, const unsigned int N, const float *W,
+                 const unsigned int ldw, int8_t *B, const unsigned int ldb,
+                 float *scales, const unsigned int lds,
+                 const unsigned int group_size);
+
+/**
+ * @brief     symmetric quantization of the weight for qgemm_q4, with a scale
+ *            of max(abs(W)) / 7 for each group of rows of each column
+ * @param[in] K number of rows of W
+ * @param[in] N number of columns of W
+ * @param[in] W float * for the weight (K x N)
+ * @param[in] ldw leading dimension of W
+ * @param[out] B uint8_t * for the packed weight (K x (N + 1) / 2 bytes)
+ * @param[in] ldb leading dimension of B in bytes
+ * @param[out] scales float * for the scales (K / group_size x N)
+ * @param[in] lds leading dimension of scales
+ * @param[in] group_size number of rows sharing a scale
+ */
+void quantize_q4(const unsigned int K, const unsigned int N, const float *W,
+                 const unsigned int ldw, uint8_t *B, const unsigned int ldb,
+                 float *scales, const unsigned int lds,
+                 const unsigned int group_size);
+
+/**
+ * @brief     Y = 1 / (1 + exp(-X))
+ * @param[in] N length of the vector
+ * @param[in] X float * for Vector X
+ * @param[out] Y float * for Vector Y, may be X
+ */
+void ele_sigmoid(const unsigned int N, const float *X, float *Y);
+
+/**
+ * @brief     Y = tanh(X)
+ * @param[in] N length of the vector
+ * @param[in] X float * for Vector X
+ * @param[out] Y float * for Vector Y, may be X
+ */
+void ele_tanh(const unsigned int N, const float *X, float *Y);
+
+/**
+ * @brief     Y = X * sigmoid(X)
+ * @param[in] N length of the vector
+ * @param[in] X float * for Vector X
+ * @param[out] Y float * for Vector Y, may be X
+ */
+void ele_swish(const unsigned int N, const float *X, float *Y);
+
+/**
+ * @brief     Y = 0.5 * X * (1 + erf(X / sqrt(2)))
+ * @param[in] N length of the vector
+ * @param[in] X float * for Vector X
+ * @param[out] Y float * for Vector Y, may be X
+ */
+void ele_gelu(const unsigned int N, const float *X, float *Y);
+
+/**
+ * @brief     Y = 0.5 * X * (1 + tanh(sqrt(2 / pi) * (X + 0.044715 * X^3)))
+ * @param[in] N length of the vector
+ * @param[in] X float * for Vector X
+ * @param[out] Y float * for Vector Y, may be X
+ */
+void ele_tanh_gelu(const unsigned int N, const float *X, float *Y);
+
+/**
+ * @brief     Y = X * sigmoid(1.702 * X)
+ * @param[in] N length of the vector
+ * @param[in] X float * for Vector X
+ * @param[out] Y float * for Vector Y, may be X
+ */
+void ele_sigmoid_gelu(const unsigned int N, const float *X, float *Y);
+
+/**
+ * @brief     layer normalization of a row :
+ *            Y = (X - mean) * inv_std * gamma + beta. The mean and the
+ *            variance are computed in a single pass by Welford's algorithm.
+ * @param[in] N length of the row
+ * @param[in] X float * for the row
+ * @param[in] gamma float * for the scale, nullptr for 1
+ * @param[in] beta float * for the shift, nullptr for 0
+ * @param[in] epsilon epsilon added to the variance
+ * @param[out] Y float * for the output, may be X
+ * @param[out] Xdev float * for X - mean, nullptr if not needed
+ * @return inv_std, 1 / sqrt(variance + epsilon)
+ */
+float layer_norm(const unsigned int N, const float *X, const float *gamma,
+                 const float *beta, const float epsilon, float *Y,
+                 float *Xdev = nullptr);
+
+/**
+ * @brief     RMS normalization of a row : Y = X * inv_rms * gamma
+ * @param[in] N length of the row
+ * @param[in] X float * for the row
+ * @param[in] gamma float * for the scale, nullptr for 1
+ * @param[in] epsilon epsilon added to the mean square
+ * @param[out] Y float * for the output, may be X
+ * @return inv_rms, 1 / sqrt(mean(X^2) + epsilon)
+ */
+float rms_norm(const unsigned int N, const float *X, const float *gamma,
+               const float epsilon, float *Y);
+
+/**
+ * @brief     derivative of layer_norm with respect to the row :
+ *            dX = inv_std * (G - mean(G) - Xhat * mean(G * Xhat)),
+ *            where G = dY * gamma and Xhat = Xdev * inv_std
+ * @param[in] N length of the row
+ * @param[in] dY float * for the incoming derivative
+ * @param[in] Xdev float * for X - mean saved by layer_norm
+ * @param[in] gamma float * for the scale, nullptr for 1
+ * @param[in] inv_std inverse standard deviation of the row
+ * @param[out] dX float * for the outgoing derivative, may be dY
+ */
+void layer_norm_backward(const unsigned int N, const float *dY,
+                         const float *Xdev, const float *gamma,
+                         const float inv_std, float *dX);
+
+/**
+ * @brief     scaled dot product attention of a head, computed over the tiles
+ * of keys with online softmax so that the q_len x k_len attention weight is
+ * never materialized : O = softmax(scale * Q * K**T + mask) * V
+ * @param[in] q_len number of queries
+ * @param[in] k_len number of keys and values
+ * @param[in] dk dimension of query and key
+ * @param[in] dv dimension of value
+ * @param[in] Q float * for query (q_len x dk)
+ * @param[in] ldq leading dimension of Q
+ * @param[in] K float * for key (k_len x dk)
+ * @param[in] ldk leading dimension of K
+ * @param[in] V float * for value (k_len x dv)
+ * @param[in] ldv leading dimension of V
+ * @param[in] mask float * for additive mask (q_len x k_len), nullptr if none
+ * @param[in] ldm leading dimension of mask
+ * @param[in] scale multiplier for Q * K**T
+ * @param[in] causal_offset if not negative, the i-th query attends to the keys
+ * up to (i + causal_offset) only
+ * @param[out] O float * for output (q_len x dv)
+ * @param[in] ldo leading dimension of O
+ */
+void flash_attention(const unsigned int q_len, const unsigned int k_len,
+                     const unsigned int dk, const unsigned int dv,
+                     const float *Q, const unsigned int ldq, const float *K,
+                     const unsigned int ldk, const float *V,
+                     const unsigned int ldv, const float *mask,
+                     const unsigned int ldm, const float scale,
+                     const int causal_offset, float *O, const unsigned int ldo);
+
+/**
+ * @brief     flash_attention over the keys and values split into pages, as in
+ * a paged key/value cache. The j-th key is the (j % page_len)-th row of
+ * K_pages[j / page_len], and so is the value.
+ * @param[in] q_len number of queries
+ * @param[in] k_len number of keys and values
+ * @param[in] dk dimension of query and key
+ * @param[in] dv dimension of value
+ * @param[in] Q float * for query (q_len x dk)
+ * @param[in] ldq leading dimension of Q
+ * @param[in] K_pages float * for each page of key (page_len x dk)
+ * @param[in] ldk leading dimension of a page of key
+ * @param[in] V_pages float * for each page of value (page_len x dv)
+ * @param[in] ldv leading dimension of a page of value
+ * @param[in] page_len number of keys in a page
+ * @param[in] scale multiplier for Q * K**T
+ * @param[in] causal_offset if not negative, the i-th query attends to the keys
+ * up to (i + causal_offset) only
+ * @param[out] O float * for output (q_len x dv)
+ * @param[in] ldo leading dimension of O
+ */
+void flash_attention_paged(const unsigned int q_len, const unsigned int k_len,
+                           const unsigned int dk, const unsigned int dv,
+                           const float *Q, const unsigned int ldq,
+                           const float *const *K_pages, const unsigned int ldk,
+                           const float *const *V_pages, const unsigned int ldv,
+                           const unsigned int page_len, const float scale,
+                           const int causal_offset, float *O,
+                           const unsigned int ldo);
+
 /**
  * @brief     check if X array has NaN or inf
  * @param[in] N  length of the vector
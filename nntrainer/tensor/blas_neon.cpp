@@ -14,6 +14,7 @@
 
 #include <blas_neon.h>
 #include <blas_neon_setting.h>
+#include <cstring>
 #include <hgemm.h>
 #include <memory>
 #include <nntrainer_error.h>
@@ -610,6 +611,419 @@ void custom_scopy(const unsigned int N, const float *X, const int incX,
   }
 }
 
+/**
+ * @brief update 4 consecutive elements of W, M, V with unscaled gradient g
+ * @return updated weight
+ */
+static inline float32x4_t adam_update_kernel(float32x4_t g, float *W, float *M,
+                                             float *V, const float beta1,
+                                             const float one_m_beta1,
+                                             const float beta2,
+                                             const float one_m_beta2,
+                                             const float32x4_t eps,
+                                             const float v_scale,
+                                             const float step_size,
+                                             const float keep) {
+  float32x4_t m = vmulq_n_f32(vld1q_f32(M), beta1);
+  m = vfmaq_n_f32(m, g, one_m_beta1);
+  float32x4_t v = vmulq_n_f32(vld1q_f32(V), beta2);
+  v = vfmaq_f32(v, vmulq_n_f32(g, one_m_beta2), g);
+  float32x4_t denom = vfmaq_n_f32(eps, vsqrtq_f32(v), v_scale);
+  float32x4_t w = vmulq_n_f32(vld1q_f32(W), keep);
+  w = vfmsq_f32(w, vdivq_f32(m, denom), vdupq_n_f32(step_size));
+
+  vst1q_f32(M, m);
+  vst1q_f32(V, v);
+  vst1q_f32(W, w);
+  return w;
+}
+
+void adam_update(const unsigned int N, const float *G, float *W, float *M,
+                 float *V, const float grad_scale, const double beta1,
+                 const double beta2, const float epsilon, const float v_scale,
+                 const float step_size, const float decay) {
+  const float keep = 1.0f - decay;
+  const float32x4_t eps = vdupq_n_f32(epsilon);
+  const float b1 = beta1, one_m_b1 = 1.0 - beta1;
+  const float b2 = beta2, one_m_b2 = 1.0 - beta2;
+
+  unsigned int i = 0;
+  for (; i + 4 <= N; i += 4)
+    adam_update_kernel(vmulq_n_f32(vld1q_f32(G + i), grad_scale), W + i, M + i,
+                       V + i, b1, one_m_b1, b2, one_m_b2, eps, v_scale,
+                       step_size, keep);
+  for (; i < N; ++i) {
+    float g = grad_scale * G[i];
+    M[i] = b1 * M[i] + one_m_b1 * g;
+    V[i] = b2 * V[i] + one_m_b2 * g * g;
+    W[i] = keep * W[i] -
+           step_size * M[i] / (std::sqrt(V[i]) * v_scale + epsilon);
+  }
+}
+
+float exp_sub_sum(const unsigned int N, float *X, const float max) {
+  const float32x4_t vmax = vdupq_n_f32(max);
+  float32x4_t vsum = vdupq_n_f32(0.0f);
+
+  unsigned int i = 0;
+  for (; i + 4 <= N; i += 4) {
+    float32x4_t x = exp_ps(vsubq_f32(vld1q_f32(X + i), vmax));
+    vst1q_f32(X + i, x);
+    vsum = vaddq_f32(vsum, x);
+  }
+
+  float sum = vaddvq_f32(vsum);
+  for (; i < N; ++i) {
+    X[i] = std::exp(X[i] - max);
+    sum += X[i];
+  }
+  return sum;
+}
+
+/**
+ * @brief convert 8 int8 weights to float
+ */
+static inline void cvt_q8(int8x8_t q, float32x4_t &lo, float32x4_t &hi) {
+  int16x8_t w = vmovl_s8(q);
+  lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(w)));
+  hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(w)));
+}
+
+/**
+ * @brief unpack 8 int4 weights packed in 4 bytes
+ */
+static inline int8x8_t unpack_q4(const uint8_t *B) {
+  uint32_t packed;
+  std::memcpy(&packed, B, sizeof(packed));
+  uint8x8_t p = vreinterpret_u8_u32(vdup_n_u32(packed));
+  /** low nibble is the even column and high nibble is the odd one */
+  uint8x8_t q = vzip_u8(vand_u8(p, vdup_n_u8(0x0F)), vshr_n_u8(p, 4)).val[0];
+  /** sign extend 4 bits : (q ^ 8) - 8 */
+  return vsub_s8(vreinterpret_s8_u8(veor_u8(q, vdup_n_u8(8))), vdup_n_s8(8));
+}
+
+/**
+ * @brief R rows x 8 columns of C = A * dequantize(B). Each row of B is
+ * dequantized once in the register and shared by the R rows of A.
+ */
+template <unsigned int R, typename T, typename Load>
+static void qgemm_tile(const unsigned int K, const float *A,
+                       const unsigned int lda, const T *B,
+                       const unsigned int ldb, const float *scales,
+                       const unsigned int lds, const unsigned int group_size,
+                       float *C, const unsigned int ldc, Load load) {
+  float32x4_t out[R][2], acc[R][2];
+  for (unsigned int r = 0; r < R; ++r)
+    out[r][0] = out[r][1] = vdupq_n_f32(0.0f);
+
+  for (unsigned int k0 = 0; k0 < K; k0 += group_size) {
+    for (unsigned int r = 0; r < R; ++r)
+      acc[r][0] = acc[r][1] = vdupq_n_f32(0.0f);
+
+    for (unsigned int k = k0; k < k0 + group_size; ++k) {
+      float32x4_t b_lo, b_hi;
+      cvt_q8(load(B + k * ldb), b_lo, b_hi);
+      for (unsigned int r = 0; r < R; ++r) {
+        float32x4_t a = vdupq_n_f32(A[r * lda + k]);
+        acc[r][0] = vfmaq_f32(acc[r][0], a, b_lo);
+        acc[r][1] = vfmaq_f32(acc[r][1], a, b_hi);
+      }
+    }
+
+    const float *s = scales + (k0 / group_size) * lds;
+    float32x4_t s_lo = vld1q_f32(s), s_hi = vld1q_f32(s + 4);
+    for (unsigned int r = 0; r < R; ++r) {
+      out[r][0] = vfmaq_f32(out[r][0], acc[r][0], s_lo);
+      out[r][1] = vfmaq_f32(out[r][1], acc[r][1], s_hi);
+    }
+  }
+
+  for (unsigned int r = 0; r < R; ++r) {
+    vst1q_f32(C + r * ldc, out[r][0]);
+    vst1q_f32(C + r * ldc + 4, out[r][1]);
+  }
+}
+
+/**
+ * @brief C = A * dequantize(B) over the tiles of 4 rows x 8 columns
+ */
+template <unsigned int cols_per_elem, typename T, typename Load>
+static void qgemm_impl(const unsigned int M, const unsigned int N,
+                       const unsigned int K, const float *A,
+                       const unsigned int lda, const T *B,
+                       const unsigned int ldb, const float *scales,
+                       const unsigned int lds, const unsigned int group_size,
+                       float *C, const unsigned int ldc, Load load) {
+  for (unsigned int n = 0; n + 8 <= N; n += 8) {
+    const T *b = B + n / cols_per_elem;
+    unsigned int m = 0;
+    for (; m + 4 <= M; m += 4)
+      qgemm_tile<4>(K, A + m * lda, lda, b, ldb, scales + n, lds, group_size,
+                    C + m * ldc + n, ldc, load);
+
+    switch (M - m) {
+    case 3:
+      qgemm_tile<3>(K, A + m * lda, lda, b, ldb, scales + n, lds, group_size,
+                    C + m * ldc + n, ldc, load);
+      break;
+    case 2:
+      qgemm_tile<2>(K, A + m * lda, lda, b, ldb, scales + n, lds, group_size,
+                    C + m * ldc + n, ldc, load);
+      break;
+    case 1:
+      qgemm_tile<1>(K, A + m * lda, lda, b, ldb, scales + n, lds, group_size,
+                    C + m * ldc + n, ldc, load);
+      break;
+    default:
+      break;
+    }
+  }
+}
+
+void qgemm_q8(const unsigned int M, const unsigned int N, const unsigned int K,
+              const float *A, const unsigned int lda, const int8_t *B,
+              const unsigned int ldb, const float *scales,
+              const unsigned int lds, const unsigned int group_size, float *C,
+              const unsigned int ldc) {
+  qgemm_impl<1>(M, N, K, A, lda, B, ldb, scales, lds, group_size, C, ldc,
+                [](const int8_t *b) { return vld1_s8(b); });
+}
+
+void qgemm_q4(const unsigned int M, const unsigned int N, const unsigned int K,
+              const float *A, const unsigned int lda, const uint8_t *B,
+              const unsigned int ldb, const float *scales,
+              const unsigned int lds, const unsigned int group_size, float *C,
+              const unsigned int ldc) {
+  qgemm_impl<2>(M, N, K, A, lda, B, ldb, scales, lds, group_size, C, ldc,
+                [](const uint8_t *b) { return unpack_q4(b); });
+}
+
+/**
+ * @brief Y = op(X) over 4 floats at a time. The tail is padded to a full
+ * vector so that every element goes through the same approximation.
+ */
+template <typename Op>
+static inline void unary_ps(const unsigned int N, const float *X, float *Y,
+                            Op op) {
+  unsigned int i = 0;
+  for (; i + 4 <= N; i += 4)
+    vst1q_f32(Y + i, op(vld1q_f32(X + i)));
+
+  if (i < N) {
+    float tail[4] = {0};
+    std::memcpy(tail, X + i, (N - i) * sizeof(float));
+    vst1q_f32(tail, op(vld1q_f32(tail)));
+    std::memcpy(Y + i, tail, (N - i) * sizeof(float));
+  }
+}
+
+/**
+ * @brief 1 / (1 + exp(-x)) of 4 floats
+ */
+static inline float32x4_t sigmoid_ps(float32x4_t x) {
+  const float32x4_t one = vdupq_n_f32(1.0f);
+  return vdivq_f32(one, vaddq_f32(one, exp_ps(vnegq_f32(x))));
+}
+
+/**
+ * @brief tanh of 4 floats, 2 * sigmoid(2x) - 1
+ */
+static inline float32x4_t tanh_ps(float32x4_t x) {
+  float32x4_t s = sigmoid_ps(vaddq_f32(x, x));
+  return vsubq_f32(vaddq_f32(s, s), vdupq_n_f32(1.0f));
+}
+
+/**
+ * @brief erf of 4 floats by Abramowitz and Stegun 7.1.26, |error| < 1.5e-7
+ */
+static inline float32x4_t erf_ps(float32x4_t x) {
+  const float32x4_t one = vdupq_n_f32(1.0f);
+
+  float32x4_t a = vabsq_f32(x);
+  float32x4_t t =
+    vdivq_f32(one, vfmaq_f32(one, a, vdupq_n_f32(0.3275911f)));
+
+  float32x4_t y = vdupq_n_f32(1.061405429f);
+  y = vfmaq_f32(vdupq_n_f32(-1.453152027f), y, t);
+  y = vfmaq_f32(vdupq_n_f32(1.421413741f), y, t);
+  y = vfmaq_f32(vdupq_n_f32(-0.284496736f), y, t);
+  y = vfmaq_f32(vdupq_n_f32(0.254829592f), y, t);
+  y = vmulq_f32(y, t);
+
+  float32x4_t e = exp_ps(vnegq_f32(vmulq_f32(a, a)));
+  y = vsubq_f32(one, vmulq_f32(y, e));
+  /** copy the sign of x */
+  return vbslq_f32(vdupq_n_u32(0x80000000), x, y);
+}
+
+void ele_sigmoid(const unsigned int N, const float *X, float *Y) {
+  unary_ps(N, X, Y, sigmoid_ps);
+}
+
+void ele_tanh(const unsigned int N, const float *X, float *Y) {
+  unary_ps(N, X, Y, tanh_ps);
+}
+
+void ele_swish(const unsigned int N, const float *X, float *Y) {
+  unary_ps(N, X, Y, [](float32x4_t x) { return vmulq_f32(x, sigmoid_ps(x)); });
+}
+
+void ele_gelu(const unsigned int N, const float *X, float *Y) {
+  unary_ps(N, X, Y, [](float32x4_t x) {
+    float32x4_t e = erf_ps(vmulq_n_f32(x, 0.70710678118654752f));
+    return vmulq_f32(vmulq_n_f32(x, 0.5f), vaddq_f32(vdupq_n_f32(1.0f), e));
+  });
+}
+
+void ele_tanh_gelu(const unsigned int N, const float *X, float *Y) {
+  unary_ps(N, X, Y, [](float32x4_t x) {
+    float32x4_t x3 = vmulq_f32(vmulq_f32(x, x), x);
+    float32x4_t u = vmulq_n_f32(vfmaq_n_f32(x, x3, 0.044715f),
+                                0.79788456080286536f);
+    return vmulq_f32(vmulq_n_f32(x, 0.5f),
+                     vaddq_f32(vdupq_n_f32(1.0f), tanh_ps(u)));
+  });
+}
+
+void ele_sigmoid_gelu(const unsigned int N, const float *X, float *Y) {
+  unary_ps(N, X, Y, [](float32x4_t x) {
+    return vmulq_f32(x, sigmoid_ps(vmulq_n_f32(x, 1.702f)));
+  });
+}
+
+/**
+ * @brief merge the Welford statistics of b into a
+ */
+static inline void welford_merge(float &count_a, float &mean_a, float &m2_a,
+                                 const float count_b, const float mean_b,
+                                 const float m2_b) {
+  const float count = count_a + count_b;
+  if (count_b == 0.0f || count == 0.0f)
+    return;
+
+  const float delta = mean_b - mean_a;
+  mean_a += delta * count_b / count;
+  m2_a += m2_b + delta * delta * count_a * count_b / count;
+  count_a = count;
+}
+
+float layer_norm(const unsigned int N, const float *X, const float *gamma,
+                 const float *beta, const float epsilon, float *Y,
+                 float *Xdev) {
+  /** Welford's algorithm on each lane, then the lanes are merged */
+  float32x4_t mean_v = vdupq_n_f32(0.0f);
+  float32x4_t m2_v = vdupq_n_f32(0.0f);
+  unsigned int i = 0, n = 0;
+  for (; i + 4 <= N; i += 4) {
+    float32x4_t x = vld1q_f32(X + i);
+    float32x4_t delta = vsubq_f32(x, mean_v);
+    mean_v = vfmaq_f32(mean_v, delta, vdupq_n_f32(1.0f / ++n));
+    m2_v = vfmaq_f32(m2_v, delta, vsubq_f32(x, mean_v));
+  }
+
+  float means[4], m2s[4];
+  vst1q_f32(means, mean_v);
+  vst1q_f32(m2s, m2_v);
+  float count = 0.0f, mean = 0.0f, m2 = 0.0f;
+  for (unsigned int l = 0; l < 4; ++l)
+    welford_merge(count, mean, m2, n, means[l], m2s[l]);
+  for (; i < N; ++i)
+    welford_merge(count, mean, m2, 1.0f, X[i], 0.0f);
+
+  const float inv_std = 1.0f / std::sqrt(m2 / N + epsilon);
+
+  const float32x4_t vmean = vdupq_n_f32(mean);
+  const float32x4_t vinv_std = vdupq_n_f32(inv_std);
+  for (i = 0; i + 4 <= N; i += 4) {
+    float32x4_t dev = vsubq_f32(vld1q_f32(X + i), vmean);
+    if (Xdev)
+      vst1q_f32(Xdev + i, dev);
+    float32x4_t x_hat = vmulq_f32(dev, vinv_std);
+    if (gamma)
+      x_hat = vmulq_f32(x_hat, vld1q_f32(gamma + i));
+    if (beta)
+      x_hat = vaddq_f32(x_hat, vld1q_f32(beta + i));
+    vst1q_f32(Y + i, x_hat);
+  }
+  for (; i < N; ++i) {
+    float dev = X[i] - mean;
+    if (Xdev)
+      Xdev[i] = dev;
+    Y[i] = dev * inv_std * (gamma ? gamma[i] : 1.0f) + (beta ? beta[i] : 0.0f);
+  }
+
+  return inv_std;
+}
+
+float rms_norm(const unsigned int N, const float *X, const float *gamma,
+               const float epsilon, float *Y) {
+  float32x4_t sum_v = vdupq_n_f32(0.0f);
+  unsigned int i = 0;
+  for (; i + 4 <= N; i += 4) {
+    float32x4_t x = vld1q_f32(X + i);
+    sum_v = vfmaq_f32(sum_v, x, x);
+  }
+  float sum = vaddvq_f32(sum_v);
+  for (unsigned int j = i; j < N; ++j)
+    sum += X[j] * X[j];
+
+  const float inv_rms = 1.0f / std::sqrt(sum / N + epsilon);
+
+  const float32x4_t vinv_rms = vdupq_n_f32(inv_rms);
+  for (i = 0; i + 4 <= N; i += 4) {
+    float32x4_t y = vmulq_f32(vld1q_f32(X + i), vinv_rms);
+    if (gamma)
+      y = vmulq_f32(y, vld1q_f32(gamma + i));
+    vst1q_f32(Y + i, y);
+  }
+  for (; i < N; ++i)
+    Y[i] = X[i] * inv_rms * (gamma ? gamma[i] : 1.0f);
+
+  return inv_rms;
+}
+
+void layer_norm_backward(const unsigned int N, const float *dY,
+                         const float *Xdev, const float *gamma,
+                         const float inv_std, float *dX) {
+  float32x4_t sum_g_v = vdupq_n_f32(0.0f);
+  float32x4_t sum_gd_v = vdupq_n_f32(0.0f);
+  unsigned int i = 0;
+  for (; i + 4 <= N; i += 4) {
+    float32x4_t g = vld1q_f32(dY + i);
+    if (gamma)
+      g = vmulq_f32(g, vld1q_f32(gamma + i));
+    sum_g_v = vaddq_f32(sum_g_v, g);
+    sum_gd_v = vfmaq_f32(sum_gd_v, g, vld1q_f32(Xdev + i));
+  }
+  float sum_g = vaddvq_f32(sum_g_v);
+  float sum_gd = vaddvq_f32(sum_gd_v);
+  for (unsigned int j = i; j < N; ++j) {
+    float g = dY[j] * (gamma ? gamma[j] : 1.0f);
+    sum_g += g;
+    sum_gd += g * Xdev[j];
+  }
+
+  /** Xhat = Xdev * inv_std, so coef * Xdev = mean(G * Xhat) * Xhat */
+  const float mean_g = sum_g / N;
+  const float coef = sum_gd / N * inv_std * inv_std;
+
+  const float32x4_t vmean_g = vdupq_n_f32(mean_g);
+  const float32x4_t vcoef = vdupq_n_f32(coef);
+  const float32x4_t vinv_std = vdupq_n_f32(inv_std);
+  for (i = 0; i + 4 <= N; i += 4) {
+    float32x4_t g = vld1q_f32(dY + i);
+    if (gamma)
+      g = vmulq_f32(g, vld1q_f32(gamma + i));
+    float32x4_t d = vsubq_f32(vsubq_f32(g, vmean_g),
+                              vmulq_f32(vld1q_f32(Xdev + i), vcoef));
+    vst1q_f32(dX + i, vmulq_f32(d, vinv_std));
+  }
+  for (; i < N; ++i) {
+    float g = dY[i] * (gamma ? gamma[i] : 1.0f);
+    dX[i] = inv_std * (g - mean_g - Xdev[i] * coef);
+  }
+}
+
 #ifdef ENABLE_FP16
 
 void hgemv(const __fp16 *A, const __fp16 *X, __fp16 *Y, uint32_t M, uint32_t N,
@@ -1818,5 +2232,34 @@ bool isValid(const size_t N, const __fp16 *input) {
   return true;
 }
 
+void adam_update(const unsigned int N, const __fp16 *G, float *W, __fp16 *W16,
+                 float *M, float *V, const float grad_scale, const double beta1,
+                 const double beta2, const float epsilon, const float v_scale,
+                 const float step_size, const float decay) {
+  const float keep = 1.0f - decay;
+  const float32x4_t eps = vdupq_n_f32(epsilon);
+  const float b1 = beta1, one_m_b1 = 1.0 - beta1;
+  const float b2 = beta2, one_m_b2 = 1.0 - beta2;
+
+  unsigned int i = 0;
+  for (; i + 4 <= N; i += 4) {
+    float32x4_t g = vmulq_n_f32(vcvt_f32_f16(vld1_f16(G + i)), grad_scale);
+    float32x4_t w =
+      adam_update_kernel(g, W + i, M + i, V + i, b1, one_m_b1, b2, one_m_b2,
+                         eps, v_scale, step_size, keep);
+    if (W16)
+      vst1_f16(W16 + i, vcvt_f16_f32(w));
+  }
+  for (; i < N; ++i) {
+    float g = grad_scale * static_cast<float>(G[i]);
+    M[i] = b1 * M[i] + one_m_b1 * g;
+    V[i] = b2 * V[i] + one_m_b2 * g * g;
+    W[i] = keep * W[i] -
+           step_size * M[i] / (std::sqrt(V[i]) * v_scale + epsilon);
+    if (W16)
+      W16[i] = static_cast<__fp16>(W[i]);
+  }
+}
+
 #endif
 } // namespace nntrainer::neon
@@ -167,6 +167,176 @@ bool isValid(const size_t N, const float *input);
 void custom_scopy(const unsigned int N, const float *X, const int incX,
                   float *Y, const int incY);
 
+/**
+ * @brief     fused Adam/AdamW update with neon in a single pass
+ *            g = grad_scale * G
+ *            M = beta1 * M + (1 - beta1) * g
+ *            V = beta2 * V + (1 - beta2) * g * g
+ *            W = (1 - decay) * W - step_size * M / (sqrt(V) * v_scale + eps)
+ * @param[in] N length of the vectors
+ * @param[in] G float * for gradient
+ * @param[in/out] W float * for weight
+ * @param[in/out] M float * for first moment
+ * @param[in/out] V float * for second moment
+ * @param[in] grad_scale multiplier for gradient (e.g. 1 / loss scale)
+ * @param[in] beta1 decay rate of the first moment
+ * @param[in] beta2 decay rate of the second moment
+ * @param[in] epsilon epsilon added to the denominator
+ * @param[in] v_scale multiplier for sqrt(V)
+ * @param[in] step_size step size applied to the update
+ * @param[in] decay decoupled weight decay (lr * weight_decay)
+ */
+void adam_update(const unsigned int N, const float *G, float *W, float *M,
+                 float *V, const float grad_scale, const double beta1,
+                 const double beta2, const float epsilon, const float v_scale,
+                 const float step_size, const float decay);
+
+/**
+ * @brief     X = exp(X - max) in place with neon
+ * @param[in] N length of the vector
+ * @param[in/out] X float * for Vector X
+ * @param[in] max value subtracted from X before exp
+ * @return sum of the updated X
+ */
+float exp_sub_sum(const unsigned int N, float *X, const float max);
+
+/**
+ * @brief     weight-only quantized gemm with neon : C = A * dequantize(B).
+ *            B is dequantized in the register as 8 columns at a time, so the
+ *            columns of the tail (N % 8) are left to the caller.
+ * @param[in] M number of rows of A and C
+ * @param[in] N number of columns of B and C
+ * @param[in] K number of columns of A and rows of B
+ * @param[in] A float * for the input (M x K)
+ * @param[in] lda leading dimension of A
+ * @param[in] B int8_t * for the 8-bit weight (K x N)
+ * @param[in] ldb leading dimension of B in bytes
+ * @param[in] scales float * for the scales (K / group_size x N)
+ * @param[in] lds leading dimension of scales
+ * @param[in] group_size number of rows of B sharing a scale
+ * @param[out] C float * for the output (M x N)
+ * @param[in] ldc leading dimension of C
+ */
+void qgemm_q8(const unsigned int M, const unsigned int N, const unsigned int K,
+              const float *A, const unsigned int lda, const int8_t *B,
+              const unsigned int ldb, const float *scales,
+              const unsigned int lds, const unsigned int group_size, float *C,
+              const unsigned int ldc);
+
+/**
+ * @brief     weight-only quantized gemm with neon : C = A * dequantize(B).
+ *            B is dequantized in the register as 8 columns at a time, so the
+ *            columns of the tail (N % 8) are left to the caller.
+ * @param[in] M number of rows of A and C
+ * @param[in] N number of columns of B and C
+ * @param[in] K number of columns of A and rows of B
+ * @param[in] A float * for the input (M x K)
+ * @param[in] lda leading dimension of A
+ * @param[in] B uint8_t * for the 4-bit weight (K x N), two
+ *            columns packed in a byte with the even one in the low nibble
+ * @param[in] ldb leading dimension of B in bytes
+ * @param[in] scales float * for the scales (K / group_size x N)
+ * @param[in] lds leading dimension of scales
+ * @param[in] group_size number of rows of B sharing a scale
+ * @param[out] C float * for the output (M x N)
+ * @param[in] ldc leading dimension of C
+ */
+void qgemm_q4(const unsigned int M, const unsigned int N, const unsigned int K,
+              const float *A, const unsigned int lda, const uint8_t *B,
+              const unsigned int ldb, const float *scales,
+              const unsigned int lds, const unsigned int group_size, float *C,
+              const unsigned int ldc);
+
+/**
+ * @brief     Y = 1 / (1 + exp(-X)) with neon
+ * @param[in] N length of the vector
+ * @param[in] X float * for Vector X
+ * @param[out] Y float * for Vector Y, may be X
+ */
+void ele_sigmoid(const unsigned int N, const float *X, float *Y);
+
+/**
+ * @brief     Y = tanh(X) with neon
+ * @param[in] N length of the vector
+ * @param[in] X float * for Vector X
+ * @param[out] Y float * for Vector Y, may be X
+ */
+void ele_tanh(const unsigned int N, const float *X, float *Y);
+
+/**
+ * @brief     Y = X * sigmoid(X) with neon
+ * @param[in] N length of the vector
+ * @param[in] X float * for Vector X
+ * @param[out] Y float * for Vector Y, may be X
+ */
+void ele_swish(const unsigned int N, const float *X, float *Y);
+
+/**
+ * @brief     Y = 0.5 * X * (1 + erf(X / sqrt(2))) with neon
+ * @param[in] N length of the vector
+ * @param[in] X float * for Vector X
+ * @param[out] Y float * for Vector Y, may be X
+ */
+void ele_gelu(const unsigned int N, const float *X, float *Y);
+
+/**
+ * @brief     Y = gelu(X) approximated with tanh with neon
+ * @param[in] N length of the vector
+ * @param[in] X float * for Vector X
+ * @param[out] Y float * for Vector Y, may be X
+ */
+void ele_tanh_gelu(const unsigned int N, const float *X, float *Y);
+
+/**
+ * @brief     Y = X * sigmoid(1.702 * X) with neon
+ * @param[in] N length of the vector
+ * @param[in] X float * for Vector X
+ * @param[out] Y float * for Vector Y, may be X
+ */
+void ele_sigmoid_gelu(const unsigned int N, const float *X, float *Y);
+
+/**
+ * @brief     layer normalization of a row with neon :
+ *            Y = (X - mean) * inv_std * gamma + beta
+ * @param[in] N length of the row
+ * @param[in] X float * for the row
+ * @param[in] gamma float * for the scale, nullptr for 1
+ * @param[in] beta float * for the shift, nullptr for 0
+ * @param[in] epsilon epsilon added to the variance
+ * @param[out] Y float * for the output, may be X
+ * @param[out] Xdev float * for X - mean, nullptr if not needed
+ * @return inv_std, 1 / sqrt(variance + epsilon)
+ */
+float layer_norm(const unsigned int N, const float *X, const float *gamma,
+                 const float *beta, const float epsilon, float *Y,
+                 float *Xdev);
+
+/**
+ * @brief     RMS normalization of a row with neon :
+ *            Y = X * inv_rms * gamma
+ * @param[in] N length of the row
+ * @param[in] X float * for the row
+ * @param[in] gamma float * for the scale, nullptr for 1
+ * @param[in] epsilon epsilon added to the mean square
+ * @param[out] Y float * for the output, may be X
+ * @return inv_rms, 1 / sqrt(mean(X^2) + epsilon)
+ */
+float rms_norm(const unsigned int N, const float *X, const float *gamma,
+               const float epsilon, float *Y);
+
+/**
+ * @brief     derivative of layer_norm with respect to the row with neon
+ * @param[in] N length of the row
+ * @param[in] dY float * for the incoming derivative
+ * @param[in] Xdev float * for X - mean saved by layer_norm
+ * @param[in] gamma float * for the scale, nullptr for 1
+ * @param[in] inv_std inverse standard deviation of the row
+ * @param[out] dX float * for the outgoing derivative, may be dY
+ */
+void layer_norm_backward(const unsigned int N, const float *dY,
+                         const float *Xdev, const float *gamma,
+                         const float inv_std, float *dX);
+
 #ifdef ENABLE_FP16
 /**
  * @brief     hgemv computation with neon : Y = alpha*A*X + beta*Y
@@ -366,6 +536,28 @@ void inv_sqrt_inplace(const unsigned int N, __fp16 *X);
  * @param[out] false if it has NaN or Inf
  */
 bool isValid(const size_t N, const __fp16 *X);
+
+/**
+ * @brief     fused Adam/AdamW update with neon and half-precision gradient.
+ *            The updated weight is also written to W16 when it is not null.
+ * @param[in] N length of the vectors
+ * @param[in] G __fp16 * for gradient
+ * @param[in/out] W float * for weight
+ * @param[out] W16 __fp16 * for half-precision copy of the weight
+ * @param[in/out] M float * for first moment
+ * @param[in/out] V float * for second moment
+ * @param[in] grad_scale multiplier for gradient (e.g. 1 / loss scale)
+ * @param[in] beta1 decay rate of the first moment
+ * @param[in] beta2 decay rate of the second moment
+ * @param[in] epsilon epsilon added to the denominator
+ * @param[in] v_scale multiplier for sqrt(V)
+ * @param[in] step_size step size applied to the update
+ * @param[in] decay decoupled weight decay (lr * weight_decay)
+ */
+void adam_update(const unsigned int N, const __fp16 *G, float *W, __fp16 *W16,
+                 float *M, float *V, const float grad_scale, const double beta1,
+                 const double beta2, const float epsilon, const float v_scale,
+                 const float step_size, const float decay);
 #endif
 
 } // namespace nntrainer::neon
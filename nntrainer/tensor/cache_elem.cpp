@@ -47,6 +47,17 @@ inline bool checkDeallocOnly(CachePolicy policy, CacheElem::Options opt) {
            !(opt & CacheElem::Options::FIRST_WRITE)));
 }
 
+/**
+ * @brief check if the data can be modified while it is loaded
+ * @note a tensor which is not written back is read only once it is synced,
+ * only the first write of a write-once tensor reaches the device
+ */
+inline bool checkWritable(CachePolicy policy, CacheElem::Options opt) {
+  return !(policy & CachePolicy::NO_WRITE_BACK) ||
+         ((policy & FRIST_WRITE_CONSIST) &&
+          (opt & CacheElem::Options::FIRST_WRITE));
+}
+
 } // namespace
 
 void CacheElem::swapIn(Options opt) {
@@ -57,6 +68,7 @@ void CacheElem::swapIn(Options opt) {
   void *buf = device->getBuffer(offset, length, alloc_only);
 
   initial_opt = static_cast<Options>(initial_opt & ~Options::FIRST_ACCESS);
+  dirty = checkWritable(policy, opt);
   mem_data->setAddr((void *)buf);
   mem_data->setValid(true);
   active = true;
@@ -72,11 +84,12 @@ void CacheElem::swapOut(Options opt) {
   std::lock_guard<std::mutex> lock(device_mutex);
 
   opt = static_cast<Options>(opt | initial_opt);
-  bool dealloc_only = checkDeallocOnly(policy, opt);
+  bool dealloc_only = !dirty || checkDeallocOnly(policy, opt);
   void *buf = (void *)mem_data->getAddr();
 
   initial_opt = static_cast<Options>(initial_opt & ~Options::FIRST_WRITE);
   device->putBuffer(buf, dealloc_only);
+  dirty = false;
   mem_data->setAddr(nullptr);
   mem_data->setValid(false);
   active = false;
@@ -86,4 +99,13 @@ void CacheElem::swapOut(Options opt) {
 #endif
 }
 
+void CacheElem::prefetch() {
+  std::lock_guard<std::mutex> lock(device_mutex);
+
+  if (active || checkAllocOnly(policy, initial_opt))
+    return;
+
+  device->prefetch(offset, length);
+}
+
 } // namespace nntrainer
@@ -66,6 +66,7 @@ public:
     initial_opt(Options::FIRST_ACCESS_WRITE),
     device(dev),
     active(false),
+    dirty(false),
     id(mem_id),
     offset(off),
     length(len),
@@ -92,6 +93,12 @@ public:
    */
   void swapOut(Options opt = Options::NONE);
 
+  /**
+   * @brief start loading data from swap device in background
+   *
+   */
+  void prefetch();
+
   /**
    * @brief unload data to swap device
    *
@@ -102,6 +109,16 @@ public:
     return active;
   }
 
+  /**
+   * @brief check if the loaded data is written back when it is unloaded
+   *
+   * @return true if the data may be modified while it is loaded
+   */
+  bool isDirty() const {
+    std::scoped_lock lg(device_mutex);
+    return dirty;
+  }
+
   /**
    * @brief get length of cache element
    *
@@ -127,6 +144,7 @@ private:
   mutable std::mutex device_mutex;      /**< protect device */
   std::shared_ptr<SwapDevice> device;   /**< swap device */
   bool active;                          /**< element is loaded */
+  bool dirty; /**< loaded data may differ from the device */
   unsigned int id;                      /**< memory id */
   size_t offset;                        /**< element offset from swap device */
   size_t length;                        /**< element size */
@@ -77,6 +77,31 @@ int CacheLoader::loadAsync(unsigned int order,
   return task_executor->run(task, complete);
 }
 
+int CacheLoader::loadAsync(unsigned int order, unsigned int from,
+                           size_t budget,
+                           TaskExecutor::CompleteCallback complete) {
+  if (!task_executor) {
+    ml_loge("init is needed");
+    return ML_ERROR_INVALID_PARAMETER;
+  }
+
+  Task::Work work = [this, from, budget](std::atomic_bool &running,
+                                         void *data) {
+    unsigned int exe_order = (unsigned int)(std::uintptr_t)data;
+
+    pool->evictExcept(from, exe_order, budget);
+    pool->loadExec(exe_order);
+
+    return ML_ERROR_NONE;
+  };
+
+  auto task =
+    std::make_shared<TaskAsync<>>(work, (void *)(std::uintptr_t)order);
+  task->setTimeout(LONG_MAX);
+
+  return task_executor->run(task, complete);
+}
+
 int CacheLoader::cancelAsync(int id) {
   try {
     task_executor->cancel(id);
@@ -84,6 +84,19 @@ public:
                         TaskExecutor::CompleteCallback callback,
                         long timeout_ms);
 
+  /**
+   * @brief Load cache data asynchronously with execution order, keeping the
+   * cache data used from @a from within @a budget
+   *
+   * @param order execution order to load
+   * @param from execution order running now
+   * @param budget cache size to keep in bytes, see CachePool::evictExcept()
+   * @param complete complete callback
+   * @return async task id
+   */
+  virtual int loadAsync(unsigned int order, unsigned int from, size_t budget,
+                        TaskExecutor::CompleteCallback callback);
+
   /**
    * @brief Cancel async task
    *
@@ -13,8 +13,10 @@
 
 #include "cache_pool.h"
 
+#include <algorithm>
 #include <limits>
 #include <numeric>
+#include <set>
 #include <stdexcept>
 #include <vector>
 
@@ -99,7 +101,10 @@ CachePool::CachePool(const std::string &n) :
   swap_device(std::make_shared<SwapDevice>(n + "_" + std::to_string(getpid()) +
                                            "_" + std::to_string(pool_id++))) {}
 
-CachePool::CachePool(const std::string &path, const std::string &n) : name(n) {
+CachePool::CachePool(const std::string &path, const std::string &n,
+                     size_t alignment) :
+  MemoryPool(alignment),
+  name(n) {
   if (path.empty())
     swap_device = std::make_shared<SwapDevice>(
       n + "_" + std::to_string(getpid()) + "_" + std::to_string(pool_id++));
@@ -140,7 +145,16 @@ void CachePool::deallocate() {
   swap_device->finish();
 }
 
+size_t CachePool::residentSize() {
+  size_t resident = 0;
+  for (auto &elem : actives)
+    resident += elem->getLength();
+
+  return resident;
+}
+
 void CachePool::validate(unsigned int id) {
+  std::scoped_lock lock(mod_mutex);
   if (!elems[id]->isActive()) {
     elems[id]->swapIn();
     actives.push_back(elems[id]);
@@ -148,6 +162,7 @@ void CachePool::validate(unsigned int id) {
 }
 
 void CachePool::invalidate(unsigned int id) {
+  std::scoped_lock lock(mod_mutex);
   if (elems[id]->isActive()) {
     actives.remove(elems[id]);
     elems[id]->swapOut();
@@ -209,6 +224,7 @@ void CachePool::flush() {
 }
 
 void CachePool::flushExcept(unsigned int order) {
+  std::scoped_lock lock(mod_mutex);
   auto exe_orders = getMemoryExecOrder();
 
   actives.remove_if([&, order](auto elem) -> bool {
@@ -233,6 +249,7 @@ void CachePool::flushExcept(unsigned int order) {
 }
 
 void CachePool::flushExcept(std::vector<unsigned int> order) {
+  std::scoped_lock lock(mod_mutex);
   auto exe_orders = getMemoryExecOrder();
 
   actives.remove_if([&, order](const auto elem) -> bool {
@@ -257,6 +274,65 @@ void CachePool::flushExcept(std::vector<unsigned int> order) {
   });
 }
 
+void CachePool::evictExcept(unsigned int from, unsigned int to,
+                            size_t budget) {
+  std::scoped_lock lock(mod_mutex);
+  auto &exe_orders = getMemoryExecOrder();
+
+  size_t resident = 0;
+  for (auto &elem : actives)
+    resident += elem->getLength();
+  for (auto &id : exec_ids[to]) {
+    if (!elems[id]->isActive())
+      resident += elems[id]->getLength();
+  }
+
+  /** <next execution order to use, element> of the elements out of window */
+  std::vector<std::pair<unsigned int, std::shared_ptr<CacheElem>>> victims;
+  for (auto &elem : actives) {
+    unsigned int next = std::numeric_limits<unsigned int>::max();
+    for (auto &o : exe_orders.at(elem->getId() - 1)) {
+      if (o >= from)
+        next = std::min(next, o);
+    }
+    if (next > to)
+      victims.emplace_back(next, elem);
+  }
+
+  std::stable_sort(victims.begin(), victims.end(),
+                   [](auto &lhs, auto &rhs) { return lhs.first > rhs.first; });
+
+  for (auto &[next, elem] : victims) {
+    if (budget > 0 && resident <= budget)
+      break;
+
+    /** not used anymore in the iteration, as in flushExcept() */
+    elem->swapOut(next == std::numeric_limits<unsigned int>::max()
+                    ? CacheElem::LAST_ACCESS
+                    : CacheElem::NONE);
+    actives.remove(elem);
+    resident -= elem->getLength();
+  }
+}
+
+size_t CachePool::getPeakWindowSize(unsigned int window) {
+  std::scoped_lock lock(mod_mutex);
+  size_t peak = 0;
+  for (auto begin = exec_ids.begin(); begin != exec_ids.end(); ++begin) {
+    std::set<unsigned int> ids;
+    for (auto it = begin;
+         it != exec_ids.end() && it->first - begin->first < window; ++it)
+      ids.insert(it->second.begin(), it->second.end());
+
+    size_t size = 0;
+    for (auto &id : ids)
+      size += elems[id]->getLength();
+    peak = std::max(peak, size);
+  }
+
+  return peak;
+}
+
 void CachePool::clear() {
   flush();
   deallocate();
@@ -267,6 +343,10 @@ void CachePool::clear() {
 bool CachePool::isAllocated() const { return swap_device->isOperating(); }
 
 void CachePool::loadExec(unsigned int order) {
+  /** issue all reads first to keep them in flight together */
+  for (auto &id : exec_ids[order])
+    elems[id]->prefetch();
+
   for (auto &id : exec_ids[order])
     validate(id);
 }
@@ -291,6 +371,11 @@ bool CachePool::loadExecOnce(unsigned int order, ExecIdsIter &iter) {
   if (iter == exec_ids[order].end())
     return true;
 
+  if (iter == exec_ids[order].begin()) {
+    for (auto &id : exec_ids[order])
+      elems[id]->prefetch();
+  }
+
   validate(*iter);
 
   iter++;
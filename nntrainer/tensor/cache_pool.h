@@ -47,8 +47,12 @@ public:
   /**
    * @brief CachePool constructor with cache path
    *
+   * @param path path of the swap file
+   * @param name name of the cache pool
+   * @param alignment alignment of the offset of each memory in bytes
    */
-  explicit CachePool(const std::string &path, const std::string &name);
+  explicit CachePool(const std::string &path, const std::string &name,
+                     size_t alignment = 1);
 
   /**
    * @brief MemoryPool destructor
@@ -68,6 +72,19 @@ public:
    */
   virtual void deallocate() override;
 
+  /**
+   * @brief Free all the allocated cache, the swap device is not kept
+   *
+   */
+  virtual void detach() override { deallocate(); }
+
+  /**
+   * @brief Get the cached memory resident in RAM
+   *
+   * @return The total size of the active cache elements in bytes
+   */
+  virtual size_t residentSize() override;
+
   /**
    * @brief Request Memory from memory pool
    * @note start_time is inclusive, but end_time is exclusive
@@ -116,6 +133,27 @@ public:
    */
   virtual void flushExcept(std::vector<unsigned int> order);
 
+  /**
+   * @brief Evict the cache data not used from @a from to @a to execution
+   * order, the data used the farthest first, until the cache fits in
+   * @a budget together with the data to load for @a to
+   *
+   * @param from execution order running now
+   * @param to execution order to load next
+   * @param budget cache size to keep in bytes. With 0, all the data not used
+   * from @a from to @a to is evicted.
+   */
+  virtual void evictExcept(unsigned int from, unsigned int to, size_t budget);
+
+  /**
+   * @brief Get the peak size of the cache data used in @a window consecutive
+   * execution orders
+   *
+   * @param window number of execution orders
+   * @return size in bytes
+   */
+  virtual size_t getPeakWindowSize(unsigned int window);
+
   /**
    * @brief Clear the memory pool
    *
@@ -0,0 +1,261 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file   kv_cache_manager.cpp
+ * @date   18 October 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @bug    No known bugs except for NYI items
+ * @brief  Paged key/value cache for the incremental inference
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include <kv_cache_manager.h>
+#include <nntrainer_error.h>
+#include <nntrainer_log.h>
+
+namespace nntrainer {
+
+KVCacheManager::KVCacheManager(unsigned int page_size,
+                               unsigned int num_pages) :
+  page_size(page_size),
+  num_pages(num_pages),
+  ref_count(num_pages, 0),
+  next_sequence(0),
+  step(0),
+  step_len(0) {
+  NNTR_THROW_IF(page_size == 0 || num_pages == 0, std::invalid_argument)
+    << "page size and number of pages of kv cache must be positive";
+
+  /** pages are taken from the back, so the lower pages are used first */
+  free_pages.resize(num_pages);
+  for (unsigned int i = 0; i < num_pages; ++i)
+    free_pages[i] = num_pages - 1 - i;
+}
+
+unsigned int KVCacheManager::registerLayer(const std::string &name,
+                                           unsigned int key_width,
+                                           unsigned int value_width,
+                                           TensorDim::DataType data_type) {
+  TensorDim::TensorType type(TensorDim::Format::NCHW, data_type);
+  TensorDim key_dim(num_pages, 1, page_size, key_width, type);
+  TensorDim value_dim(num_pages, 1, page_size, value_width, type);
+
+  auto it = std::find_if(layers.begin(), layers.end(),
+                         [&name](auto &l) { return l.name == name; });
+  if (it != layers.end()) {
+    NNTR_THROW_IF(it->key.getDim() != key_dim ||
+                    it->value.getDim() != value_dim,
+                  std::invalid_argument)
+      << "kv cache of " << name << " is registered with another shape";
+    return std::distance(layers.begin(), it);
+  }
+
+  NNTR_THROW_IF(!sequences.empty(), std::runtime_error)
+    << "registering " << name << " while kv cache is in use";
+
+  layers.push_back({name, Tensor(key_dim, false), Tensor(value_dim, false)});
+  return layers.size() - 1;
+}
+
+void KVCacheManager::allocate() {
+  for (auto &l : layers) {
+    if (!l.key.isAllocated())
+      l.key.allocate();
+    if (!l.value.isAllocated())
+      l.value.allocate();
+  }
+}
+
+void KVCacheManager::deallocate() {
+  NNTR_THROW_IF(inStep(), std::runtime_error)
+    << "deallocating kv cache during a step";
+
+  for (auto &[id, sequence] : sequences)
+    releasePages(sequence);
+  sequences.clear();
+
+  for (auto &l : layers) {
+    l.key.deallocate();
+    l.value.deallocate();
+  }
+}
+
+unsigned int KVCacheManager::createSequence() {
+  sequences[next_sequence] = Sequence();
+  return next_sequence++;
+}
+
+unsigned int KVCacheManager::forkSequence(unsigned int parent) {
+  Sequence &p = getSequence(parent);
+  NNTR_THROW_IF(p.evicted, std::invalid_argument)
+    << "forking evicted sequence " << parent;
+
+  for (auto page : p.pages)
+    ref_count[page]++;
+
+  /** p might be invalidated by the insertion */
+  Sequence child = p;
+  child.last_used = step;
+  sequences[next_sequence] = std::move(child);
+  return next_sequence++;
+}
+
+void KVCacheManager::releaseSequence(unsigned int seq) {
+  NNTR_THROW_IF(std::find(active.begin(), active.end(), seq) != active.end(),
+                std::runtime_error)
+    << "releasing sequence " << seq << " during its step";
+
+  releasePages(getSequence(seq));
+  sequences.erase(seq);
+}
+
+bool KVCacheManager::isEvicted(unsigned int seq) const {
+  return getSequence(seq).evicted;
+}
+
+unsigned int KVCacheManager::getLength(unsigned int seq) const {
+  return getSequence(seq).length;
+}
+
+const std::vector<unsigned int> &
+KVCacheManager::getPageTable(unsigned int seq) const {
+  return getSequence(seq).pages;
+}
+
+void KVCacheManager::beginStep(const std::vector<unsigned int> &seqs,
+                               unsigned int len) {
+  NNTR_THROW_IF(inStep(), std::runtime_error)
+    << "kv cache step is already begun";
+  NNTR_THROW_IF(seqs.empty(), std::invalid_argument)
+    << "kv cache step without sequence";
+
+  allocate();
+  step++;
+  active = seqs;
+  step_len = len;
+
+  try {
+    for (auto seq : active) {
+      Sequence &s = getSequence(seq);
+      NNTR_THROW_IF(s.evicted, std::invalid_argument)
+        << "sequence " << seq << " is evicted from kv cache";
+      NNTR_THROW_IF(std::count(active.begin(), active.end(), seq) > 1,
+                    std::invalid_argument)
+        << "sequence " << seq << " appears twice in a step";
+      s.last_used = step;
+    }
+
+    for (auto seq : active) {
+      unsigned int first = getSequence(seq).length / page_size;
+      unsigned int last = (getSequence(seq).length + len + page_size - 1) /
+                          page_size;
+
+      for (unsigned int i = first; i < last; ++i) {
+        /** the sequence is looked up again as allocPage() may evict others */
+        if (i == getSequence(seq).pages.size()) {
+          unsigned int page = allocPage();
+          getSequence(seq).pages.push_back(page);
+          continue;
+        }
+
+        unsigned int shared = getSequence(seq).pages[i];
+        if (ref_count[shared] == 1)
+          continue;
+
+        /** copy on write */
+        unsigned int page = allocPage();
+        for (auto &l : layers) {
+          size_t key_bytes = l.key.getDim().getFeatureLen() *
+                             l.key.getDim().getDataTypeSize();
+          size_t value_bytes = l.value.getDim().getFeatureLen() *
+                               l.value.getDim().getDataTypeSize();
+          std::memcpy(l.key.getAddress<char>(page, 0, 0, 0),
+                      l.key.getAddress<char>(shared, 0, 0, 0), key_bytes);
+          std::memcpy(l.value.getAddress<char>(page, 0, 0, 0),
+                      l.value.getAddress<char>(shared, 0, 0, 0), value_bytes);
+        }
+        releasePage(shared);
+        getSequence(seq).pages[i] = page;
+      }
+    }
+  } catch (...) {
+    endStep(false);
+    throw;
+  }
+}
+
+void KVCacheManager::endStep(bool commit) {
+  if (commit) {
+    for (auto seq : active)
+      getSequence(seq).length += step_len;
+  }
+
+  active.clear();
+  step_len = 0;
+}
+
+KVCacheManager::Sequence &KVCacheManager::getSequence(unsigned int seq) {
+  auto it = sequences.find(seq);
+  NNTR_THROW_IF(it == sequences.end(), std::invalid_argument)
+    << "sequence " << seq << " does not exist in kv cache";
+  return it->second;
+}
+
+const KVCacheManager::Sequence &
+KVCacheManager::getSequence(unsigned int seq) const {
+  auto it = sequences.find(seq);
+  NNTR_THROW_IF(it == sequences.end(), std::invalid_argument)
+    << "sequence " << seq << " does not exist in kv cache";
+  return it->second;
+}
+
+unsigned int KVCacheManager::getPage(unsigned int seq, unsigned int pos) const {
+  const Sequence &s = getSequence(seq);
+  NNTR_THROW_IF(pos / page_size >= s.pages.size(), std::out_of_range)
+    << "token " << pos << " of sequence " << seq << " is not reserved";
+  return s.pages[pos / page_size];
+}
+
+unsigned int KVCacheManager::allocPage() {
+  while (free_pages.empty()) {
+    Sequence *victim = nullptr;
+    unsigned int victim_id = 0;
+    for (auto &[id, s] : sequences) {
+      if (s.evicted || s.pages.empty() ||
+          std::find(active.begin(), active.end(), id) != active.end())
+        continue;
+      if (victim == nullptr || s.last_used < victim->last_used) {
+        victim = &s;
+        victim_id = id;
+      }
+    }
+
+    NNTR_THROW_IF(victim == nullptr, std::runtime_error)
+      << "kv cache is out of pages, number of pages: " << num_pages;
+
+    ml_logw("evicting sequence %u from kv cache", victim_id);
+    releasePages(*victim);
+    victim->evicted = true;
+    victim->length = 0;
+  }
+
+  unsigned int page = free_pages.back();
+  free_pages.pop_back();
+  ref_count[page] = 1;
+  return page;
+}
+
+void KVCacheManager::releasePage(unsigned int page) {
+  if (--ref_count[page] == 0)
+    free_pages.push_back(page);
+}
+
+void KVCacheManager::releasePages(Sequence &sequence) {
+  for (auto page : sequence.pages)
+    releasePage(page);
+  sequence.pages.clear();
+}
+
+} // namespace nntrainer
@@ -0,0 +1,276 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file   kv_cache_manager.h
+ * @date   18 October 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @bug    No known bugs except for NYI items
+ * @brief  Paged key/value cache for the incremental inference
+ *
+ * @details The cache is split into pages of page_size tokens. A page id is
+ * shared by every registered layer, so a sequence has a single page table
+ * which maps its i-th page_size tokens to a page, and each layer keeps the
+ * keys and values of the page in its own storage. A sequence forked from
+ * another shares the pages of the parent until either of them writes to the
+ * shared page, which is then copied (copy on write). When no page is free,
+ * the least recently used sequence which is not in the current step is
+ * evicted.
+ */
+
+#ifndef __KV_CACHE_MANAGER_H__
+#define __KV_CACHE_MANAGER_H__
+#ifdef __cplusplus
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <tensor.h>
+
+namespace nntrainer {
+
+/**
+ * @class   KVCacheManager
+ * @brief   Block-paged key/value cache shared by the attention layers
+ */
+class KVCacheManager {
+public:
+  /**
+   * @brief Construct a new KVCacheManager object
+   *
+   * @param page_size number of tokens in a page
+   * @param num_pages number of pages
+   */
+  KVCacheManager(unsigned int page_size, unsigned int num_pages);
+
+  /**
+   * @brief Register a layer which stores its keys and values in the cache
+   *
+   * @param name name of the layer, registering the same name again returns the
+   * same index
+   * @param key_width number of elements of a key of a token
+   * @param value_width number of elements of a value of a token
+   * @param data_type data type of the keys and values
+   * @return index of the layer in the cache
+   */
+  unsigned int registerLayer(const std::string &name, unsigned int key_width,
+                             unsigned int value_width,
+                             TensorDim::DataType data_type);
+
+  /**
+   * @brief Allocate the pages of the registered layers
+   * @note pages are allocated by beginStep() as well if not allocated yet
+   */
+  void allocate();
+
+  /**
+   * @brief Free the pages of the registered layers. Every sequence is released.
+   */
+  void deallocate();
+
+  /**
+   * @brief Create an empty sequence
+   *
+   * @return id of the sequence
+   */
+  unsigned int createSequence();
+
+  /**
+   * @brief Create a sequence which shares the cached tokens of the parent
+   *
+   * @param parent id of the sequence to fork
+   * @return id of the sequence
+   */
+  unsigned int forkSequence(unsigned int parent);
+
+  /**
+   * @brief Release the sequence and its pages
+   *
+   * @param seq id of the sequence
+   */
+  void releaseSequence(unsigned int seq);
+
+  /**
+   * @brief Check if the sequence is evicted. An evicted sequence has no cached
+   * token and must be released.
+   *
+   * @param seq id of the sequence
+   */
+  bool isEvicted(unsigned int seq) const;
+
+  /**
+   * @brief Get the number of cached tokens of the sequence
+   *
+   * @param seq id of the sequence
+   */
+  unsigned int getLength(unsigned int seq) const;
+
+  /**
+   * @brief Begin a step which appends step_len tokens to each sequence. The
+   * pages for the new tokens are reserved, and the pages shared with the other
+   * sequences are copied before being written.
+   *
+   * @param sequences sequence of each batch of the step
+   * @param step_len number of tokens to append to each sequence
+   * @throw std::runtime_error if there are not enough pages
+   */
+  void beginStep(const std::vector<unsigned int> &sequences,
+                 unsigned int step_len);
+
+  /**
+   * @brief End the step and append the tokens to the sequences
+   *
+   * @param commit false to discard the tokens of the step
+   */
+  void endStep(bool commit = true);
+
+  /**
+   * @brief Check if a step is running
+   */
+  bool inStep() const { return !active.empty(); }
+
+  /**
+   * @brief Get the sequence of each batch of the current step
+   */
+  const std::vector<unsigned int> &getActiveSequences() const {
+    return active;
+  }
+
+  /**
+   * @brief Get the number of tokens appended by the current step
+   */
+  unsigned int getStepLength() const { return step_len; }
+
+  /**
+   * @brief Get the page table of the sequence
+   *
+   * @param seq id of the sequence
+   */
+  const std::vector<unsigned int> &getPageTable(unsigned int seq) const;
+
+  /**
+   * @brief Get the number of tokens in a page
+   */
+  unsigned int getPageSize() const { return page_size; }
+
+  /**
+   * @brief Get the number of free pages
+   */
+  unsigned int getNumFreePages() const { return free_pages.size(); }
+
+  /**
+   * @brief Get the keys of the first token of the page
+   *
+   * @param layer index of the layer
+   * @param page id of the page
+   * @return keys of the page, laid out as [page_size, key_width]
+   */
+  template <typename T = float> T *getKeyPage(unsigned int layer,
+                                              unsigned int page) {
+    return layers.at(layer).key.getAddress<T>(page, 0, 0, 0);
+  }
+
+  /**
+   * @brief Get the values of the first token of the page
+   *
+   * @param layer index of the layer
+   * @param page id of the page
+   * @return values of the page, laid out as [page_size, value_width]
+   */
+  template <typename T = float> T *getValuePage(unsigned int layer,
+                                                unsigned int page) {
+    return layers.at(layer).value.getAddress<T>(page, 0, 0, 0);
+  }
+
+  /**
+   * @brief Get the keys of the token of the sequence
+   *
+   * @param layer index of the layer
+   * @param seq id of the sequence
+   * @param pos position of the token, which must be reserved
+   */
+  template <typename T = float> T *getKey(unsigned int layer, unsigned int seq,
+                                          unsigned int pos) {
+    return layers.at(layer).key.getAddress<T>(getPage(seq, pos), 0,
+                                              pos % page_size, 0);
+  }
+
+  /**
+   * @brief Get the values of the token of the sequence
+   *
+   * @param layer index of the layer
+   * @param seq id of the sequence
+   * @param pos position of the token, which must be reserved
+   */
+  template <typename T = float>
+  T *getValue(unsigned int layer, unsigned int seq, unsigned int pos) {
+    return layers.at(layer).value.getAddress<T>(getPage(seq, pos), 0,
+                                                pos % page_size, 0);
+  }
+
+private:
+  /**
+   * @brief keys and values of a layer
+   */
+  struct LayerCache {
+    std::string name;
+    Tensor key;   /**< [num_pages, 1, page_size, key_width] */
+    Tensor value; /**< [num_pages, 1, page_size, value_width] */
+  };
+
+  /**
+   * @brief cached tokens of a sequence
+   */
+  struct Sequence {
+    std::vector<unsigned int> pages; /**< page table */
+    unsigned int length = 0;         /**< number of cached tokens */
+    unsigned long last_used = 0;     /**< step which used the sequence last */
+    bool evicted = false;            /**< pages are evicted */
+  };
+
+  /**
+   * @brief Get the sequence, throws if it does not exist
+   */
+  Sequence &getSequence(unsigned int seq);
+
+  /**
+   * @copydoc getSequence(unsigned int seq)
+   */
+  const Sequence &getSequence(unsigned int seq) const;
+
+  /**
+   * @brief Get the page of the token, throws if it is not reserved
+   */
+  unsigned int getPage(unsigned int seq, unsigned int pos) const;
+
+  /**
+   * @brief Take a free page, evicting the least recently used sequence if
+   * there is no free page
+   */
+  unsigned int allocPage();
+
+  /**
+   * @brief Drop a reference of the page
+   */
+  void releasePage(unsigned int page);
+
+  /**
+   * @brief Release the pages of the sequence
+   */
+  void releasePages(Sequence &sequence);
+
+  unsigned int page_size;                /**< number of tokens in a page */
+  unsigned int num_pages;                /**< number of pages */
+  std::vector<LayerCache> layers;        /**< registered layers */
+  std::vector<unsigned int> ref_count;   /**< references of each page */
+  std::vector<unsigned int> free_pages;  /**< pages without reference */
+  std::unordered_map<unsigned int, Sequence> sequences; /**< sequences */
+  unsigned int next_sequence;            /**< id of the next sequence */
+  unsigned long step;                    /**< number of the steps begun */
+  std::vector<unsigned int> active;      /**< sequences of the current step */
+  unsigned int step_len;                 /**< tokens of the current step */
+};
+
+} // namespace nntrainer
+
+#endif /* __cplusplus */
+#endif /* __KV_CACHE_MANAGER_H__ */
@@ -23,6 +23,7 @@
 #include <fcntl.h>
 #include <functional>
 #include <limits>
+#include <set>
 #include <stdexcept>
 #include <sys/mman.h>
 #include <sys/stat.h>
@@ -151,7 +152,60 @@ void Manager::allocateWeights(unsigned int max_exec_order_, bool init) {
   }
 }
 
-void Manager::deallocateWeights() { weight_pool.deallocate(); }
+void Manager::deallocateWeights() {
+  waitPrefetch(std::numeric_limits<unsigned int>::max());
+  weight_pool.deallocate();
+}
+
+void Manager::mapWeights(unsigned int max_exec_order_, const std::string &path,
+                         size_t offset) {
+  NNTR_THROW_IF(enable_swap, std::invalid_argument)
+    << "Swapped weights cannot be mapped from a file";
+
+  reallocateWeights(max_exec_order_,
+                    MemoryAllocator::createFileMapped(path, offset));
+}
+
+void Manager::shareWeights(unsigned int max_exec_order_, Manager &from) {
+  auto locations = getWeightLocations();
+  auto from_locations = from.getWeightLocations();
+  bool same_layout = weight_pool.size() == from.weight_pool.size() &&
+                     locations.size() == from_locations.size();
+  for (unsigned int i = 0; same_layout && i < locations.size(); ++i) {
+    same_layout = locations[i].name == from_locations[i].name &&
+                  locations[i].offset == from_locations[i].offset &&
+                  locations[i].bytes == from_locations[i].bytes;
+  }
+  NNTR_THROW_IF(!same_layout, std::invalid_argument)
+    << "Weights of a different layout cannot be shared";
+
+  reallocateWeights(max_exec_order_, from.weight_pool.shareMemory());
+}
+
+void Manager::reallocateWeights(unsigned int max_exec_order_,
+                                std::shared_ptr<MemoryAllocator> allocator) {
+  deallocateWeights();
+  weight_pool.setAllocator(allocator);
+  allocateWeights(max_exec_order_, false);
+}
+
+std::vector<Manager::WeightLocation> Manager::getWeightLocations() {
+  NNTR_THROW_IF(enable_swap, std::invalid_argument)
+    << "Swapped weights do not have locations in the memory";
+
+  std::vector<WeightLocation> locations;
+  std::set<std::string> listed;
+  for (auto &w : weights_v2) {
+    if (!listed.insert(w->getName()).second)
+      continue;
+
+    Tensor &var = w->getVariableRef();
+    locations.push_back(
+      {&var, w->getName(), weight_pool.getOffsetOf(var), var.bytes()});
+  }
+
+  return locations;
+}
 
 static Tensor *requestTensor_(const TensorSpecV2 &spec,
                               const GraphNode::ExecutionOrder &exec_order,
@@ -261,11 +315,12 @@ void Manager::allocateTensors(unsigned int max_exec_order_) {
 /**
  * @brief Deallocate memory for all the managed tensors
  */
-void Manager::deallocateTensors(bool dealloc_weights) {
+void Manager::deallocateTensors(bool dealloc_weights, bool keep_memory) {
+  waitPrefetch(std::numeric_limits<unsigned int>::max());
   if (dealloc_weights)
     deallocateWeights();
 
-  tensor_pool.deallocate();
+  tensor_pool.deallocate(keep_memory);
 }
 
 #ifdef LAYER_V1
@@ -723,56 +778,140 @@ Manager::getWeights(const std::function<bool(const Weight *)> &condition) {
   return conditional_weights;
 }
 
+/**
+ * @brief convert the duration to milliseconds
+ */
+static float toMilliseconds(std::chrono::steady_clock::duration d) {
+  return std::chrono::duration<float, std::milli>(d).count();
+}
+
+/**
+ * @brief update the running average of a measured cost
+ */
+static void updateAverage(float &avg, float ms) {
+  avg = avg > 0.0f ? 0.5f * (avg + ms) : ms;
+}
+
 void Manager::flushCache() {
   if (!swap_lookahead) {
     weight_pool.flushCache();
     tensor_pool.flushCache();
+  } else {
+    waitPrefetch(std::numeric_limits<unsigned int>::max());
   }
 }
 
 void Manager::flushCacheExcept(unsigned int order) {
-  auto loadAsync = [&](TensorPool &pool, unsigned int order) {
-    return pool.loadCacheExecAsync(
-      order, [&](int id, TaskExecutor::CompleteStatus status) {
-        std::scoped_lock<std::mutex> lock(completed_mutex);
-        completed[id].set_value(true);
-      });
-  };
-
-  auto waitComplete = [&](unsigned int o) {
-    auto &tasks = async_task_eos[o];
+  if (!swap_lookahead) {
+    weight_pool.flushCacheExcept(order);
+    tensor_pool.flushCacheExcept(order);
+    return;
+  }
 
-    std::unique_lock<std::mutex> lock(completed_mutex);
-    auto w_fut = completed[std::get<0>(tasks)].get_future();
-    auto t_fut = completed[std::get<1>(tasks)].get_future();
-    lock.unlock();
+  if (order == 0 || order < swap_order) {
+    /** a new iteration, the tensors may have been reallocated since */
+    waitPrefetch(std::numeric_limits<unsigned int>::max());
+    swap_budget = {weight_pool.getCachePeakSize(swap_lookahead + 1),
+                   tensor_pool.getCachePeakSize(swap_lookahead + 1)};
+    swap_compute_ms = 0.0f;
+  } else {
+    /** an order may be flushed again, e.g. calcGradient of a frozen layer */
+    swap_compute_ms += toMilliseconds(Clock::now() - swap_time);
+    if (order > swap_order) {
+      updateAverage(getSwapCost(swap_order).compute_ms, swap_compute_ms);
+      swap_compute_ms = 0.0f;
+    }
+  }
+  swap_order = order;
+  swap_end = std::max(swap_end, order);
 
-    w_fut.wait();
-    t_fut.wait();
+  waitPrefetch(order);
 
-    async_task_eos.erase(o);
+  auto complete = [this](int id, TaskExecutor::CompleteStatus status) {
+    std::scoped_lock<std::mutex> lock(completed_mutex);
+    completed[id].set_value(Clock::now());
   };
 
-  // TODO: lookahead > 1 is required.
-  if (swap_lookahead == 1) {
-    if (async_task_eos.count(order) == 1)
-      waitComplete(order);
+  /**
+   * Issue the loads in order, each as late as it is still hidden. Loading
+   * next at the next step is still in time if the pending loads up to next
+   * end before the compute of the orders up to next, without this order.
+   * Without the costs measured, the whole lookahead is issued.
+   */
+  unsigned int last = order + swap_lookahead;
+  if (swap_end > order)
+    last = std::min(last, swap_end);
+
+  float io_ms = 0.0f, slack_ms = 0.0f;
+  for (unsigned int next = order + 1; next <= last; ++next) {
+    slack_ms += getSwapCost(next - 1).compute_ms;
+    io_ms += getSwapCost(next).load_ms;
+    if (async_task_eos.count(next) == 1)
+      continue;
+
+    if (next > order + 1 &&
+        io_ms <= slack_ms - getSwapCost(order).compute_ms)
+      break;
 
-    auto load_weight = loadAsync(weight_pool, order + 1);
-    auto load_tensor = loadAsync(tensor_pool, order + 1);
+    auto load_weight =
+      weight_pool.loadCacheExecAsync(next, order, swap_budget[0], complete);
+    auto load_tensor =
+      tensor_pool.loadCacheExecAsync(next, order, swap_budget[1], complete);
 
     NNTR_THROW_IF(load_weight < 0 || load_tensor < 0, std::runtime_error)
       << "Failed to launch preloading task";
-    async_task_eos[order + 1] = std::make_tuple(load_weight, load_tensor);
-  } else {
-    weight_pool.flushCacheExcept(order);
-    tensor_pool.flushCacheExcept(order);
+    async_task_eos[next] =
+      std::make_tuple(load_weight, load_tensor, Clock::now());
   }
+
+  swap_time = Clock::now();
+}
+
+void Manager::waitPrefetch(unsigned int order) {
+  while (!async_task_eos.empty() && async_task_eos.begin()->first <= order) {
+    auto &[task_order, task] = *async_task_eos.begin();
+    auto &[load_weight, load_tensor, issued] = task;
+
+    float load_ms = 0.0f;
+    std::array<int, 2> ids = {load_weight, load_tensor};
+    for (unsigned int i = 0; i < ids.size(); ++i) {
+      /** 0 when the pool does not cache */
+      if (ids[i] == 0)
+        continue;
+
+      std::unique_lock<std::mutex> lock(completed_mutex);
+      auto fut = completed[ids[i]].get_future();
+      lock.unlock();
+
+      Clock::time_point done = fut.get();
+
+      lock.lock();
+      completed.erase(ids[i]);
+      lock.unlock();
+
+      /** the loads of a pool run one by one */
+      Clock::time_point begin = std::max(issued, swap_loaded[i]);
+      swap_loaded[i] = done;
+      load_ms = std::max(load_ms, toMilliseconds(done - begin));
+    }
+
+    updateAverage(getSwapCost(task_order).load_ms, load_ms);
+    async_task_eos.erase(async_task_eos.begin());
+  }
+}
+
+Manager::SwapCost &Manager::getSwapCost(unsigned int order) {
+  if (order >= swap_costs.size())
+    swap_costs.resize(order + 1);
+
+  return swap_costs[order];
 }
 
 void Manager::finalizeTensorPool(TensorPool &pool, unsigned int start,
                                  unsigned int end) {
-  if (enable_optimizations)
+  if (memory_planner)
+    pool.finalize(*memory_planner, start, end);
+  else if (enable_optimizations)
     pool.finalize(OptimizedV1Planner(), start, end);
   else
     pool.finalize(BasicPlanner(), start, end);
@@ -23,6 +23,8 @@
 #include "tensor_wrap_specs.h"
 #ifdef __cplusplus
 
+#include <array>
+#include <chrono>
 #include <functional>
 #include <memory>
 #include <unordered_map>
@@ -32,6 +34,7 @@
 #include <basic_planner.h>
 #include <common.h>
 #include <graph_node.h>
+#include <kv_cache_manager.h>
 #include <tensor_pool.h>
 #include <var_grad.h>
 #include <weight.h>
@@ -132,6 +135,10 @@ public:
    * @brief     Constructor of Manager
    */
   Manager() :
+    swap_budget({0, 0}),
+    swap_order(0),
+    swap_end(0),
+    swap_compute_ms(0.0f),
     enable_optimizations(true),
     swap_lookahead(0),
     tensor_format("NCHW"),
@@ -148,6 +155,10 @@ public:
     weight_pool(enable_swap_, swap_path, "weight_pool"),
     tensor_pool(enable_swap_ && (exec_mode_ == ExecutionMode::TRAIN), swap_path,
                 "tensor_pool"),
+    swap_budget({0, 0}),
+    swap_order(0),
+    swap_end(0),
+    swap_compute_ms(0.0f),
     enable_optimizations(true),
     swap_lookahead(lookahead),
     tensor_format(tensor_format_),
@@ -353,6 +364,15 @@ public:
     tensor_pool.setBatchSize(name, batch);
   }
 
+  /**
+   * @brief Place the tensor @a dest inside the tensor @a host at @a offset
+   * @copydetails TensorPool::place
+   */
+  bool placeTensor(const std::string &dest, const std::string &host,
+                   unsigned int offset) {
+    return tensor_pool.place(dest, host, offset);
+  }
+
   /**
    * @brief Allocate memory for all the managed tensors
    *
@@ -368,8 +388,13 @@ public:
 
   /**
    * @brief Deallocate memory for all the managed tensors
+   *
+   * @param dealloc_weights deallocate the weights as well
+   * @param keep_memory keep the memory of the tensors to be reused by the
+   * next allocation, the memory of the weights is not kept
    */
-  void deallocateTensors(bool dealloc_weights = false);
+  void deallocateTensors(bool dealloc_weights = false,
+                         bool keep_memory = false);
 
   /**
    * @brief Allocate memory for all the managed weights
@@ -392,6 +417,61 @@ public:
    */
   void deallocateWeights();
 
+  /**
+   * @brief Allocate the weights as a private mapping of the given file
+   *
+   * @param[in] max_exec_order The maximum order of execution to determine
+   * memory layout
+   * @param[in] path file which holds the image of the weight pool
+   * @param[in] offset offset of the image in the file, aligned to the page
+   * size
+   *
+   * @note The weights are not initialized. They alias the pages of the file,
+   * which are read on the first touch and copied only when written.
+   */
+  void mapWeights(unsigned int max_exec_order_, const std::string &path,
+                  size_t offset);
+
+  /**
+   * @brief Allocate the weights in the memory of the weights of another
+   * manager
+   *
+   * @param[in] max_exec_order The maximum order of execution to determine
+   * memory layout
+   * @param[in] from manager whose weights are shared
+   * @throw std::invalid_argument when the layouts of the weights differ
+   *
+   * @note The weights are not initialized. A write to the weights is seen by
+   * every manager sharing them, and the memory is freed when the last of
+   * them deallocates the weights.
+   */
+  void shareWeights(unsigned int max_exec_order_, Manager &from);
+
+  /**
+   * @brief location of a weight in the weight pool
+   */
+  struct WeightLocation {
+    Tensor *var;      /**< variable of the weight */
+    std::string name; /**< name of the weight */
+    size_t offset;    /**< offset in the weight pool in bytes */
+    size_t bytes;     /**< size of the weight in bytes */
+  };
+
+  /**
+   * @brief Get the locations of the allocated weights in the weight pool
+   *
+   * @return locations in the order of request, a shared weight is listed once
+   * @throw std::invalid_argument when the weights are swapped
+   */
+  std::vector<WeightLocation> getWeightLocations();
+
+  /**
+   * @brief Get the size of the weight pool
+   *
+   * @return size of the weight pool in bytes
+   */
+  size_t getWeightPoolSize() { return weight_pool.size(); }
+
   /**
    * @brief Set optimizations for manager
    *
@@ -399,6 +479,35 @@ public:
    */
   void setOptimizations(bool val) { enable_optimizations = val; }
 
+  /**
+   * @brief Set the memory planner to lay out the tensor pools
+   *
+   * @param planner memory planner, nullptr to use the planner chosen by the
+   * optimizations
+   * @note This must be set before the pools are finalized. BestFitPlanner is
+   * not the default and is used only if it is set here
+   */
+  void setMemoryPlanner(std::shared_ptr<MemoryPlanner> planner) {
+    memory_planner = planner;
+  }
+
+  /**
+   * @brief Set the paged kv cache for the incremental inference
+   *
+   * @param page_size number of tokens in a page
+   * @param num_pages number of pages
+   */
+  void setKVCache(unsigned int page_size, unsigned int num_pages) {
+    kv_cache = std::make_unique<KVCacheManager>(page_size, num_pages);
+  }
+
+  /**
+   * @brief Get the paged kv cache
+   *
+   * @return KVCacheManager* kv cache, nullptr if it is not set
+   */
+  KVCacheManager *getKVCacheManager() { return kv_cache.get(); }
+
   /**
    * @brief Update externally dependent tensors
    *
@@ -479,10 +588,11 @@ public:
    * @brief flush cache data except the order
    *
    * @param order except execution order
-   * @param lookahead preloading size
-   * @note preloading loads execution order data asynchronously,
-   *       for lookahead size. If new flush request arrives,
-   *       it waits previous preloading is completed and invokes new one.
+   * @note With the swap lookahead, the data of up to lookahead orders ahead is
+   * loaded asynchronously. Each load is issued as late as the measured compute
+   * time of the orders before it still hides its measured load time. The
+   * cache is kept within the peak size of lookahead + 1 consecutive orders,
+   * evicting the data used the farthest first.
    */
   void flushCacheExcept(unsigned int order);
 
@@ -520,16 +630,41 @@ private:
   TensorPool weight_pool; /**< tensor pool to request tensors */
   TensorPool tensor_pool; /**< tensor pool to request tensors */
 
-  std::map<unsigned int, std::tuple<int, int>> async_task_eos;
+  using Clock = std::chrono::steady_clock;
+
+  std::map<unsigned int, std::tuple<int, int, Clock::time_point>>
+    async_task_eos;
   /**< async tasks <execution order, <weight_pool completed id, tensor_pool
-   * completed id>>
+   * completed id, issued time>>
    */
-  std::map<int, std::promise<bool>> completed;
-  /**< async tasks completion <task id, promise> */
+  std::map<int, std::promise<Clock::time_point>> completed;
+  /**< async tasks completion <task id, promise of the completed time> */
   std::mutex completed_mutex; /**< mutex for async tasks completion */
 
+  /**
+   * @brief measured cost of an execution order for the swap prefetching
+   */
+  struct SwapCost {
+    float compute_ms = 0.0f; /**< time running the order */
+    float load_ms = 0.0f;    /**< time loading the data of the order */
+  };
+
+  std::vector<SwapCost> swap_costs; /**< swap costs by execution order */
+  std::array<size_t, 2> swap_budget; /**< cache budget of weight, tensor pool */
+  std::array<Clock::time_point, 2>
+    swap_loaded;            /**< last load completed of weight, tensor pool */
+  unsigned int swap_order;  /**< execution order running */
+  unsigned int swap_end;    /**< last execution order seen */
+  Clock::time_point swap_time; /**< time the running order was resumed */
+  float swap_compute_ms;       /**< compute time of the running order */
+
   bool enable_optimizations; /**< to enable memory optimizations */
 
+  std::shared_ptr<MemoryPlanner>
+    memory_planner; /**< planner given instead of the default one */
+
+  std::unique_ptr<KVCacheManager> kv_cache; /**< paged kv cache */
+
   unsigned int swap_lookahead; /** lookahead for memory swap */
 
   std::string tensor_format;
@@ -540,6 +675,22 @@ private:
 
   bool enable_swap;
 
+  /**
+   * @brief Wait the swap prefetching up to the execution order, measuring the
+   * load time of each order
+   *
+   * @param order execution order to wait for
+   */
+  void waitPrefetch(unsigned int order);
+
+  /**
+   * @brief Get the swap cost of the execution order
+   *
+   * @param order execution order
+   * @return SwapCost& swap cost
+   */
+  SwapCost &getSwapCost(unsigned int order);
+
   /**
    * @brief Finalize the given tensor pool
    *
@@ -549,6 +700,15 @@ private:
    */
   void finalizeTensorPool(TensorPool &pool, unsigned int start,
                           unsigned int end);
+
+  /**
+   * @brief Allocate the weights again with the given allocator
+   *
+   * @param max_exec_order_ The maximum order of execution
+   * @param allocator allocation backend of the weight pool
+   */
+  void reallocateWeights(unsigned int max_exec_order_,
+                         std::shared_ptr<MemoryAllocator> allocator);
 };
 
 } // namespace nntrainer
@@ -0,0 +1,344 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file   memory_allocator.cpp
+ * @date   18 October 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @bug    No known bugs except for NYI items
+ * @brief  Allocation backends for the memory pool
+ */
+
+#include <cstdint>
+#include <cstdlib>
+#include <fcntl.h>
+#include <mutex>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+#include <memory_allocator.h>
+#include <nntrainer_error.h>
+#include <nntrainer_log.h>
+
+namespace nntrainer {
+
+namespace {
+
+constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+size_t getPageSize() {
+  static const size_t page_size = sysconf(_SC_PAGE_SIZE);
+  return page_size;
+}
+
+size_t alignUp(size_t size, size_t alignment) {
+  return (size + alignment - 1) / alignment * alignment;
+}
+
+/**
+ * @brief allocator with calloc
+ * @note calloc itself gets large blocks from mmap, so the memset is skipped
+ * there, but the block may be carved from the heap otherwise.
+ */
+class MallocAllocator : public MemoryAllocator {
+public:
+  void *alloc(size_t size) override {
+    /** keep the pointer from calloc right before the aligned pointer */
+    size_t extra = DEFAULT_ALIGNMENT + sizeof(void *);
+    void *raw = calloc(size + extra, 1);
+    NNTR_THROW_IF(raw == nullptr, std::runtime_error)
+      << "Failed to allocate memory: " << size << "bytes";
+
+    uintptr_t addr = reinterpret_cast<uintptr_t>(raw) + sizeof(void *);
+    addr = alignUp(addr, DEFAULT_ALIGNMENT);
+    reinterpret_cast<void **>(addr)[-1] = raw;
+    return reinterpret_cast<void *>(addr);
+  }
+
+  void free(void *ptr, size_t size) override {
+    if (ptr != nullptr)
+      ::free(static_cast<void **>(ptr)[-1]);
+  }
+
+  const std::string getType() const override { return "malloc"; }
+};
+
+/**
+ * @brief allocator with anonymous mmap
+ * @note pages are zero-filled by the kernel on the first touch
+ */
+class MmapAllocator : public MemoryAllocator {
+public:
+  /**
+   * @brief Construct a new Mmap Allocator object
+   *
+   * @param huge_page advise transparent huge page for the mapping
+   */
+  MmapAllocator(bool huge_page) : huge_page(huge_page) {}
+
+  void *alloc(size_t size) override {
+    void *ptr = map(mapSize(size), 0);
+    NNTR_THROW_IF(ptr == nullptr, std::runtime_error)
+      << "Failed to allocate memory: " << size << "bytes";
+
+    return ptr;
+  }
+
+  void free(void *ptr, size_t size) override {
+    if (ptr != nullptr)
+      munmap(ptr, mapSize(size));
+  }
+
+  const std::string getType() const override {
+    return huge_page ? "thp" : "mmap";
+  }
+
+protected:
+  /**
+   * @brief mapped size for the requested size
+   */
+  virtual size_t mapSize(size_t size) const {
+    if (huge_page && size >= HUGE_PAGE_SIZE)
+      return alignUp(size, HUGE_PAGE_SIZE);
+    return alignUp(size, getPageSize());
+  }
+
+  /**
+   * @brief map anonymous memory
+   *
+   * @param size size to map
+   * @param flags additional flags for mmap
+   * @return mapped memory, nullptr on failure
+   */
+  void *map(size_t size, int flags) {
+    void *ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | flags, -1, 0);
+    if (ptr == MAP_FAILED)
+      return nullptr;
+
+#ifdef MADV_HUGEPAGE
+    if (huge_page && size >= HUGE_PAGE_SIZE &&
+        madvise(ptr, size, MADV_HUGEPAGE) != 0)
+      ml_logd("madvise(MADV_HUGEPAGE) is not supported");
+#endif
+
+    return ptr;
+  }
+
+  bool huge_page;
+};
+
+/**
+ * @brief allocator with the reserved huge pages
+ * @note falls back to transparent huge page when the reserved huge pages are
+ * not available
+ */
+class HugeTlbAllocator : public MmapAllocator {
+public:
+  HugeTlbAllocator() : MmapAllocator(true) {}
+
+  void *alloc(size_t size) override {
+#ifdef MAP_HUGETLB
+    void *ptr = map(mapSize(size), MAP_HUGETLB);
+    if (ptr != nullptr)
+      return ptr;
+
+    ml_logw("Failed to allocate %zu bytes from huge pages, using thp instead",
+            size);
+#endif
+    return MmapAllocator::alloc(size);
+  }
+
+  const std::string getType() const override { return "hugetlb"; }
+
+protected:
+  size_t mapSize(size_t size) const override {
+    /** munmap of MAP_HUGETLB requires the length aligned to huge page */
+    return alignUp(size, HUGE_PAGE_SIZE);
+  }
+};
+
+/**
+ * @brief allocator with a private mapping of a file
+ * @note the memory is not zero-filled but holds the contents of the file
+ */
+class FileMappedAllocator : public MemoryAllocator {
+public:
+  /**
+   * @brief Construct a new File Mapped Allocator object
+   *
+   * @param path file to map
+   * @param offset offset of the memory in the file
+   */
+  FileMappedAllocator(const std::string &path, size_t offset) :
+    path(path),
+    offset(offset) {}
+
+  void *alloc(size_t size) override {
+    int fd = open(path.c_str(), O_RDONLY);
+    NNTR_THROW_IF(fd < 0, std::runtime_error)
+      << "Failed to open file to map: " << path;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 ||
+        static_cast<size_t>(st.st_size) < offset + size) {
+      close(fd);
+      throw std::runtime_error("File is smaller than the memory to map: " +
+                               path);
+    }
+
+    void *ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd,
+                     static_cast<off_t>(offset));
+    close(fd);
+    NNTR_THROW_IF(ptr == MAP_FAILED, std::runtime_error)
+      << "Failed to map " << size << "bytes of file: " << path;
+
+    return ptr;
+  }
+
+  void free(void *ptr, size_t size) override {
+    if (ptr != nullptr)
+      munmap(ptr, size);
+  }
+
+  const std::string getType() const override { return "file"; }
+
+private:
+  std::string path;
+  size_t offset;
+};
+
+/**
+ * @brief allocator which gives one memory to every pool sharing it
+ * @note the memory holds the contents written by the pools sharing it. Once
+ * the last pool frees it, the base allocator gives new memory.
+ */
+class SharedAllocator : public MemoryAllocator {
+public:
+  /**
+   * @brief Construct a new Shared Allocator object
+   *
+   * @param base allocator which allocated the memory
+   * @param ptr memory to share
+   * @param size size of the memory
+   */
+  SharedAllocator(std::shared_ptr<MemoryAllocator> base, void *ptr,
+                  size_t size) :
+    base(base),
+    ptr(ptr),
+    size(size),
+    users(1) {}
+
+  void *alloc(size_t size_) override {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (ptr == nullptr)
+      return base->alloc(size_);
+
+    NNTR_THROW_IF(size_ > size, std::invalid_argument)
+      << "Shared memory of " << size << "bytes is smaller than " << size_
+      << "bytes";
+
+    users++;
+    return ptr;
+  }
+
+  void free(void *ptr_, size_t size_) override {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (ptr_ == nullptr)
+      return;
+
+    if (ptr_ != ptr) {
+      base->free(ptr_, size_);
+      return;
+    }
+
+    if (--users == 0) {
+      base->free(ptr, size);
+      ptr = nullptr;
+    }
+  }
+
+  const std::string getType() const override { return "shared"; }
+
+private:
+  std::shared_ptr<MemoryAllocator> base;
+  void *ptr;
+  size_t size;
+  unsigned int users; /**< number of the pools holding the memory */
+  std::mutex mutex;
+};
+
+} // namespace
+
+std::unique_ptr<MemoryAllocator>
+MemoryAllocator::create(const std::string &type) {
+  if (type == "malloc")
+    return std::make_unique<MallocAllocator>();
+  if (type == "mmap")
+    return std::make_unique<MmapAllocator>(false);
+  if (type == "thp")
+    return std::make_unique<MmapAllocator>(true);
+  if (type == "hugetlb")
+    return std::make_unique<HugeTlbAllocator>();
+
+  throw std::invalid_argument("Unknown memory allocator: " + type);
+}
+
+std::unique_ptr<MemoryAllocator> MemoryAllocator::createDefault() {
+  const char *type = std::getenv("NNTR_MEMORY_ALLOCATOR");
+  if (type == nullptr)
+    return create("thp");
+
+  try {
+    return create(type);
+  } catch (std::invalid_argument &e) {
+    ml_logw("ignoring invalid NNTR_MEMORY_ALLOCATOR=%s", type);
+    return create("thp");
+  }
+}
+
+std::unique_ptr<MemoryAllocator>
+MemoryAllocator::createFileMapped(const std::string &path, size_t offset) {
+  NNTR_THROW_IF(offset % getPageSize() != 0, std::invalid_argument)
+    << "Offset of the file mapping is not aligned to the page size, offset: "
+    << offset;
+
+  return std::make_unique<FileMappedAllocator>(path, offset);
+}
+
+std::shared_ptr<MemoryAllocator>
+MemoryAllocator::createShared(std::shared_ptr<MemoryAllocator> base, void *ptr,
+                              size_t size) {
+  NNTR_THROW_IF(base == nullptr || ptr == nullptr, std::invalid_argument)
+    << "Sharing memory which is not allocated";
+
+  return std::make_shared<SharedAllocator>(base, ptr, size);
+}
+
+size_t getResidentSize(const void *ptr, size_t size) {
+  if (ptr == nullptr || size == 0)
+    return 0;
+
+  size_t page_size = getPageSize();
+  uintptr_t start = reinterpret_cast<uintptr_t>(ptr) / page_size * page_size;
+  uintptr_t end = alignUp(reinterpret_cast<uintptr_t>(ptr) + size, page_size);
+  size_t n_pages = (end - start) / page_size;
+
+#if defined(__APPLE__)
+  std::vector<char> vec(n_pages);
+#else
+  std::vector<unsigned char> vec(n_pages);
+#endif
+  if (mincore(reinterpret_cast<void *>(start), end - start, vec.data()) != 0) {
+    ml_logw("Failed to get resident size of the memory");
+    return 0;
+  }
+
+  size_t resident = 0;
+  for (auto v : vec)
+    resident += (v & 1) ? page_size : 0;
+
+  return resident;
+}
+
+} // namespace nntrainer
@@ -0,0 +1,120 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file   memory_allocator.h
+ * @date   18 October 2026
+ * @see    https://github.com/nnstreamer/nntrainer
+ * @bug    No known bugs except for NYI items
+ * @brief  Allocation backends for the memory pool
+ *
+ * @note   The backend is chosen with NNTR_MEMORY_ALLOCATOR environment
+ * variable, which is one of "malloc", "mmap", "thp" and "hugetlb". "thp" is
+ * used when it is not given.
+ */
+
+#ifndef __MEMORY_ALLOCATOR_H__
+#define __MEMORY_ALLOCATOR_H__
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace nntrainer {
+
+/**
+ * @class   MemoryAllocator
+ * @brief   Allocation backend which provides a memory block for the pool
+ *
+ * @details Every backend returns zero-filled memory aligned to at least
+ * DEFAULT_ALIGNMENT bytes, except the file mapping which returns the contents
+ * of the file. The mmap based backends leave zeroing to the kernel, so
+ * untouched pages of the pool are neither memset nor resident.
+ */
+class MemoryAllocator {
+public:
+  static constexpr size_t DEFAULT_ALIGNMENT = 64; /**< cache line size */
+
+  /**
+   * @brief MemoryAllocator destructor
+   */
+  virtual ~MemoryAllocator() = default;
+
+  /**
+   * @brief Allocate zero-filled memory
+   *
+   * @param size size of the memory in bytes
+   * @return pointer to the memory, aligned to at least DEFAULT_ALIGNMENT
+   * @throw std::runtime_error when allocation fails
+   */
+  virtual void *alloc(size_t size) = 0;
+
+  /**
+   * @brief Free the memory given by alloc()
+   *
+   * @param ptr pointer returned by alloc()
+   * @param size size given to alloc()
+   */
+  virtual void free(void *ptr, size_t size) = 0;
+
+  /**
+   * @brief Get the type of the allocator
+   *
+   * @return type name which is accepted by create()
+   */
+  virtual const std::string getType() const = 0;
+
+  /**
+   * @brief Create the allocator of the given type
+   *
+   * @param type one of "malloc", "mmap", "thp" and "hugetlb"
+   * @return created allocator
+   * @throw std::invalid_argument for unknown type
+   */
+  static std::unique_ptr<MemoryAllocator> create(const std::string &type);
+
+  /**
+   * @brief Create the allocator given by NNTR_MEMORY_ALLOCATOR
+   *
+   * @return created allocator
+   */
+  static std::unique_ptr<MemoryAllocator> createDefault();
+
+  /**
+   * @brief Create the allocator which maps the given file privately
+   *
+   * @param path file to map
+   * @param offset offset of the memory in the file, aligned to the page size
+   * @return created allocator
+   * @throw std::invalid_argument when the offset is not aligned
+   * @note The pages are read from the page cache on the first touch and
+   * copied only when written, so clean pages are shared between the
+   * processes which map the same file.
+   */
+  static std::unique_ptr<MemoryAllocator>
+  createFileMapped(const std::string &path, size_t offset = 0);
+
+  /**
+   * @brief Create the allocator which shares an allocated memory
+   *
+   * @param base allocator which allocated the memory
+   * @param ptr memory allocated by @a base
+   * @param size size of the memory in bytes
+   * @return created allocator, which gives @a ptr on each alloc()
+   * @note The memory is counted as allocated once by the creation, and it is
+   * freed by @a base when every alloc() and the creation are freed.
+   */
+  static std::shared_ptr<MemoryAllocator>
+  createShared(std::shared_ptr<MemoryAllocator> base, void *ptr, size_t size);
+};
+
+/**
+ * @brief Get the number of bytes of the given memory resident in RAM
+ *
+ * @param ptr start of the memory
+ * @param size size of the memory in bytes
+ * @return resident size in bytes, counted in pages
+ */
+size_t getResidentSize(const void *ptr, size_t size);
+
+} // namespace nntrainer
+
+#endif /** __MEMORY_ALLOCATOR_H__ */
@@ -10,6 +10,7 @@
  * @brief  This is Memory Pool Class
  */
 
+#include <cstring>
 #include <limits>
 #include <numeric>
 #include <vector>
@@ -72,15 +73,39 @@ double MemoryPool::planLayout(const MemoryPlanner &planner) {
   if (memory_size.empty())
     throw std::runtime_error("Planning memory layout for empty pool");
 
+  /** reuse the layout planned for the same requests */
+  for (auto it = planned_layouts.begin(); it != planned_layouts.end(); ++it) {
+    if (it->planner != planner.getType() || it->size != memory_size ||
+        it->validity != memory_validity || it->is_wgrad != memory_is_wgrad)
+      continue;
+
+    memory_offset = it->offset;
+    pool_size = it->pool_size;
+    min_pool_size = it->min_pool_size;
+    planned_layouts.splice(planned_layouts.begin(), planned_layouts, it);
+    return double(min_pool_size) / double(pool_size);
+  }
+
   /** calculate min_pool_size if not already calculated */
   if (min_pool_size == 0)
     min_pool_size = calcMinMemoryRequirement();
 
-  pool_size = planner.planLayout(memory_size, memory_validity, memory_offset,
+  /** planners lay out the aligned sizes to keep every offset aligned */
+  std::vector<size_t> aligned_size(memory_size);
+  for (auto &size : aligned_size)
+    size = (size + alignment - 1) & ~(alignment - 1);
+
+  pool_size = planner.planLayout(aligned_size, memory_validity, memory_offset,
                                  memory_is_wgrad, n_wgrad);
   if (pool_size < min_pool_size || !validateLayout())
     throw std::runtime_error("Planned layout is not feasible");
 
+  planned_layouts.push_front({planner.getType(), memory_size, memory_validity,
+                              memory_is_wgrad, memory_offset, pool_size,
+                              min_pool_size});
+  if (planned_layouts.size() > MAX_PLANNED_LAYOUTS)
+    planned_layouts.pop_back();
+
   return double(min_pool_size) / double(pool_size);
 }
 
@@ -95,10 +120,24 @@ void MemoryPool::allocate() {
   if (mem_pool != nullptr)
     throw std::runtime_error("Memory pool is already allocated");
 
-  mem_pool = calloc(pool_size, 1);
-  if (mem_pool == nullptr)
-    throw std::runtime_error(
-      "Failed to allocate memory: " + std::to_string(pool_size) + "bytes");
+  if (kept_pool != nullptr && kept_size >= pool_size) {
+    /** zero-filled as if it is allocated, the last layout is left in it */
+    std::memset(kept_pool, 0, pool_size);
+    mem_pool = kept_pool;
+    mem_size = kept_size;
+    kept_pool = nullptr;
+    kept_size = 0;
+    return;
+  }
+
+  /** free the kept memory first not to hold both at once */
+  releaseKept();
+
+  if (allocator == nullptr)
+    allocator = MemoryAllocator::createDefault();
+
+  mem_pool = allocator->alloc(pool_size);
+  mem_size = pool_size;
 
 #ifdef PROFILE
   static long long seq = 0;
@@ -129,11 +168,46 @@ std::shared_ptr<MemoryData> MemoryPool::getMemory(unsigned int idx) {
  */
 void MemoryPool::deallocate() {
   if (mem_pool != nullptr) {
-    free(mem_pool);
+    allocator->free(mem_pool, mem_size);
     PROFILE_MEM_DEALLOC(mem_pool);
   }
 
   mem_pool = nullptr;
+  mem_size = 0;
+  releaseKept();
+
+  /** the shared memory may still be held, allocate new memory next time */
+  if (unshared_allocator != nullptr) {
+    allocator = unshared_allocator;
+    unshared_allocator = nullptr;
+  }
+}
+
+void MemoryPool::detach() {
+  if (mem_pool == nullptr)
+    return;
+
+  /** the shared memory cannot be reused while other pools hold it */
+  if (unshared_allocator != nullptr) {
+    deallocate();
+    return;
+  }
+
+  releaseKept();
+  kept_pool = mem_pool;
+  kept_size = mem_size;
+  mem_pool = nullptr;
+  mem_size = 0;
+}
+
+void MemoryPool::releaseKept() {
+  if (kept_pool != nullptr) {
+    allocator->free(kept_pool, kept_size);
+    PROFILE_MEM_DEALLOC(kept_pool);
+  }
+
+  kept_pool = nullptr;
+  kept_size = 0;
 }
 
 /**
@@ -142,6 +216,14 @@ void MemoryPool::deallocate() {
  */
 size_t MemoryPool::size() { return pool_size; }
 
+/**
+ * @brief Get the memory of the pool resident in RAM
+ *
+ */
+size_t MemoryPool::residentSize() {
+  return getResidentSize(mem_pool, mem_pool ? pool_size : 0);
+}
+
 /**
  * @brief Get the minimum theoretical memory requirement
  *
@@ -335,4 +417,33 @@ void MemoryPool::clear() {
  */
 bool MemoryPool::isAllocated() const { return mem_pool != nullptr; }
 
+void MemoryPool::setAllocator(std::shared_ptr<MemoryAllocator> allocator_) {
+  if (mem_pool != nullptr)
+    throw std::runtime_error("Cannot set allocator of allocated memory pool");
+
+  releaseKept();
+  allocator = allocator_;
+}
+
+std::shared_ptr<MemoryAllocator> MemoryPool::share() {
+  if (mem_pool == nullptr)
+    throw std::runtime_error("Sharing memory pool before allocation");
+
+  if (allocator->getType() != "shared") {
+    unshared_allocator = allocator;
+    allocator = MemoryAllocator::createShared(allocator, mem_pool, mem_size);
+  }
+
+  return allocator;
+}
+
+size_t MemoryPool::getOffsetOf(const void *ptr) const {
+  const char *base = static_cast<const char *>(mem_pool);
+  const char *addr = static_cast<const char *>(ptr);
+  if (mem_pool == nullptr || addr < base || addr >= base + pool_size)
+    throw std::invalid_argument("The address is not in the memory pool");
+
+  return addr - base;
+}
+
 } // namespace nntrainer
@@ -9,7 +9,6 @@
  * @bug    No known bugs except for NYI items
  * @brief  This is Memory Pool Class
  *
- * @todo   Support an external allocator for different backends and alignment
  * @todo   Support releaseMemory(token) - this need not release actual memory
  * until deallocate
  * @todo   Support maximum memory size for the memory pool as an argument
@@ -20,9 +19,12 @@
 #define __MEMORY_POOL_H__
 
 #include <functional>
+#include <list>
 #include <memory>
+#include <stdexcept>
 #include <vector>
 
+#include <memory_allocator.h>
 #include <memory_data.h>
 #include <memory_planner.h>
 #include <tensor_wrap_specs.h>
@@ -38,12 +40,24 @@ public:
   /**
    * @brief MemoryPool default constructor
    *
+   * @param alignment alignment of the offset of each memory in bytes
+   * @param allocator allocation backend for the pool, default backend is used
+   * if nullptr
    */
-  explicit MemoryPool() :
+  explicit MemoryPool(size_t alignment = 1,
+                      std::shared_ptr<MemoryAllocator> allocator = nullptr) :
     mem_pool(nullptr),
+    mem_size(0),
+    kept_pool(nullptr),
+    kept_size(0),
     pool_size(0),
     min_pool_size(0),
-    n_wgrad(0) {}
+    n_wgrad(0),
+    alignment(alignment),
+    allocator(allocator) {
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0)
+      throw std::invalid_argument("Alignment must be a power of 2");
+  }
 
   /**
    * @brief MemoryPool destructor
@@ -111,6 +125,17 @@ public:
    */
   virtual void deallocate();
 
+  /**
+   * @brief Release the allocated memory from the layout, but keep it for the
+   * next allocate()
+   *
+   * @details allocate() reuses the kept memory if the layout planned in the
+   * meantime fits in it, so re-planning for another batch size or execution
+   * mode does not allocate again. The reused range is zeroed like new memory.
+   * deallocate() frees the kept memory.
+   */
+  virtual void detach();
+
   /**
    * @brief Get the maximum real memory requirement
    *
@@ -118,6 +143,20 @@ public:
    */
   size_t size();
 
+  /**
+   * @brief Get the memory of the pool resident in RAM
+   *
+   * @return The resident size in bytes
+   */
+  virtual size_t residentSize();
+
+  /**
+   * @brief Get the alignment of each memory in the pool
+   *
+   * @return The alignment in bytes
+   */
+  size_t getAlignment() const { return alignment; }
+
   /**
    * @brief Get the minimum theoretical memory requirement
    *
@@ -138,6 +177,35 @@ public:
    */
   virtual bool isAllocated() const;
 
+  /**
+   * @brief Set the allocation backend of the pool
+   *
+   * @param allocator_ allocation backend, default backend is used if nullptr
+   * @throw std::runtime_error when the pool is already allocated
+   */
+  void setAllocator(std::shared_ptr<MemoryAllocator> allocator_);
+
+  /**
+   * @brief Share the allocated memory with other pools
+   *
+   * @return allocator giving the memory of this pool, to be set to the pools
+   * of the same layout
+   * @throw std::runtime_error when the pool is not allocated
+   * @note The memory is freed when every pool sharing it is deallocated.
+   * This pool allocates new memory after deallocate(), and detach() does not
+   * keep the shared memory.
+   */
+  std::shared_ptr<MemoryAllocator> share();
+
+  /**
+   * @brief Get the offset of the given address in the allocated pool
+   *
+   * @param ptr address in the pool
+   * @return offset from the start of the pool in bytes
+   * @throw std::invalid_argument when the address is not in the pool
+   */
+  size_t getOffsetOf(const void *ptr) const;
+
 protected:
   /**
    * @brief  Get memory offset
@@ -198,6 +266,11 @@ private:
    */
   std::vector<unsigned int> getSortedPermutation();
 
+  /**
+   * @brief Free the memory kept by detach()
+   */
+  void releaseKept();
+
   std::vector<size_t> memory_size; /**< various sizes memory requested */
   std::vector<std::pair<unsigned int, unsigned int>>
     memory_validity; /**< validity intervals for each requested memory */
@@ -208,13 +281,48 @@ private:
   std::vector<bool>
     memory_is_wgrad; /**< index for identification of weight gradient */
 
+  /**
+   * @brief layout planned for a list of requests
+   */
+  struct PlannedLayout {
+    std::string planner;           /**< type of the planner */
+    std::vector<size_t> size;      /**< requested sizes */
+    std::vector<std::pair<unsigned int, unsigned int>>
+      validity;                    /**< requested validity intervals */
+    std::vector<bool> is_wgrad;    /**< requested weight gradient flags */
+    std::vector<size_t> offset;    /**< planned offsets */
+    size_t pool_size;              /**< planned pool size */
+    size_t min_pool_size;          /**< minimum memory requirement */
+  };
+
+  /** number of the layouts kept to be reused by planLayout() */
+  static constexpr unsigned int MAX_PLANNED_LAYOUTS = 4;
+
+  std::list<PlannedLayout>
+    planned_layouts; /**< recently planned layouts, most recent first */
+
   void *mem_pool; /**< memory pool allocated at once */
 
+  size_t mem_size; /**< size of the allocated memory, at least pool_size */
+
+  void *kept_pool; /**< memory kept by detach() for the next allocate() */
+
+  size_t kept_size; /**< size of the kept memory */
+
   size_t pool_size; /**< memory requirement for this pool */
 
   size_t min_pool_size; /**< minimum theoretical memory requirement */
 
   size_t n_wgrad;
+
+  size_t alignment; /**< alignment of memory offsets */
+
+  std::shared_ptr<MemoryAllocator>
+    allocator; /**< allocation backend of the pool */
+
+  std::shared_ptr<MemoryAllocator>
+    unshared_allocator; /**< allocator replaced by share(), restored by
+                           deallocate() */
 };
 
 } // namespace nntrainer
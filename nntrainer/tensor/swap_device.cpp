@@ -11,6 +11,11 @@
  *
  */
 
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <errno.h>
 #include <fcntl.h>
 #include <malloc.h>
 #include <profiler.h>
@@ -18,7 +23,18 @@
 #include <string.h>
 #include <sys/mman.h>
 #include <sys/types.h>
+#include <sys/uio.h>
+#include <thread>
 #include <unistd.h>
+#include <vector>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define SWAP_IO_URING
+#endif
+#endif
 
 #include <nntrainer_error.h>
 #include <nntrainer_log.h>
@@ -26,32 +42,537 @@
 
 namespace nntrainer {
 
+#ifndef USE_MMAP
+
+namespace {
+
+constexpr unsigned int SWAP_IO_QUEUE_DEPTH = 16; /**< max in-flight requests */
+constexpr unsigned int SWAP_IO_THREADS = 2; /**< threads of fallback backend */
+constexpr size_t SWAP_BUFFER_POOL_SIZE = 32 * 1024 * 1024; /**< idle buffers */
+constexpr size_t SWAP_PREFETCH_MAX = SWAP_IO_QUEUE_DEPTH; /**< max prefetch */
+
+} // namespace
+
+/**
+ * @brief in-flight io request of the swap device
+ */
+struct SwapRequest {
+  char *buf;       /**< data buffer */
+  size_t len;      /**< remaining length */
+  off_t offset;    /**< remaining offset */
+  bool write;      /**< write if true, read otherwise */
+  struct iovec iov; /**< io vector for the submission */
+
+  std::mutex m;              /**< protect done */
+  std::condition_variable cv; /**< notify done */
+  bool done = false;          /**< request is completed */
+  int error = 0;              /**< errno of the request */
+
+  /**
+   * @brief Construct a new Request object
+   */
+  SwapRequest(void *b, size_t l, off_t off, bool w) :
+    buf(static_cast<char *>(b)), len(l), offset(off), write(w) {}
+
+  /**
+   * @brief advance the request by the transferred bytes
+   *
+   * @param ret return value of the io
+   * @return true if the request is finished
+   */
+  bool advance(ssize_t ret) {
+    if (ret < 0 && (ret == -EINTR || ret == -EAGAIN))
+      return false;
+    if (ret < 0 || (ret == 0 && !write)) {
+      complete(ret < 0 ? static_cast<int>(-ret) : EIO);
+      return true;
+    }
+
+    buf += ret;
+    offset += ret;
+    len -= ret;
+    if (len == 0) {
+      complete(0);
+      return true;
+    }
+    return false;
+  }
+
+  /**
+   * @brief mark the request as completed
+   *
+   * @param err errno of the request
+   */
+  void complete(int err) {
+    std::lock_guard<std::mutex> lock(m);
+    error = err;
+    done = true;
+    cv.notify_all();
+  }
+
+  /**
+   * @brief check if the request is completed without blocking
+   *
+   * @return true if completed
+   */
+  bool finished() {
+    std::lock_guard<std::mutex> lock(m);
+    return done;
+  }
+
+  /**
+   * @brief wait until the request is completed
+   *
+   * @return errno of the request
+   */
+  int wait() {
+    std::unique_lock<std::mutex> lock(m);
+    cv.wait(lock, [this] { return done; });
+    return error;
+  }
+};
+
+/**
+ * @class   SwapIO
+ * @brief   asynchronous io backend of the swap device
+ */
+class SwapIO {
+public:
+  using Request = SwapRequest;
+
+  /**
+   * @brief Destroy the SwapIO object
+   */
+  virtual ~SwapIO() = default;
+
+  /**
+   * @brief submit io request
+   *
+   * @param req request to submit
+   */
+  virtual void submit(std::shared_ptr<Request> req) = 0;
+
+  /**
+   * @brief create io backend. io_uring is used where available, and
+   * pread/pwrite with worker threads otherwise.
+   *
+   * @param fd file descriptor of the swap device
+   * @return io backend
+   */
+  static std::unique_ptr<SwapIO> create(int fd);
+};
+
+/**
+ * @class   ThreadSwapIO
+ * @brief   pread/pwrite backend running on worker threads
+ */
+class ThreadSwapIO : public SwapIO {
+public:
+  /**
+   * @brief Construct a new ThreadSwapIO object
+   */
+  ThreadSwapIO(int fd_, unsigned int num_threads) : fd(fd_), stopping(false) {
+    for (unsigned int i = 0; i < num_threads; ++i)
+      workers.emplace_back([this] { run(); });
+  }
+
+  /**
+   * @brief Destroy the ThreadSwapIO object
+   */
+  ~ThreadSwapIO() {
+    {
+      std::lock_guard<std::mutex> lock(queue_mutex);
+      stopping = true;
+    }
+    queue_cv.notify_all();
+    for (auto &worker : workers)
+      worker.join();
+  }
+
+  /**
+   * @copydoc SwapIO::submit
+   */
+  void submit(std::shared_ptr<Request> req) override {
+    {
+      std::lock_guard<std::mutex> lock(queue_mutex);
+      queue.push_back(std::move(req));
+    }
+    queue_cv.notify_one();
+  }
+
+private:
+  /**
+   * @brief worker loop
+   */
+  void run() {
+    while (true) {
+      std::shared_ptr<Request> req;
+      {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        queue_cv.wait(lock, [this] { return stopping || !queue.empty(); });
+        if (queue.empty())
+          return;
+        req = std::move(queue.front());
+        queue.pop_front();
+      }
+
+      bool finished = false;
+      while (!finished) {
+        ssize_t ret = req->write ? pwrite(fd, req->buf, req->len, req->offset)
+                                 : pread(fd, req->buf, req->len, req->offset);
+        finished = req->advance(ret < 0 ? -errno : ret);
+      }
+    }
+  }
+
+  int fd;                                    /**< swap device file */
+  bool stopping;                             /**< stop workers */
+  std::mutex queue_mutex;                    /**< protect queue */
+  std::condition_variable queue_cv;          /**< notify queue */
+  std::deque<std::shared_ptr<Request>> queue; /**< pending requests */
+  std::vector<std::thread> workers;           /**< worker threads */
+};
+
+#ifdef SWAP_IO_URING
+/**
+ * @class   UringSwapIO
+ * @brief   io_uring backend keeping multiple requests in flight
+ */
+class UringSwapIO : public SwapIO {
+public:
+  /**
+   * @brief Construct a new UringSwapIO object
+   * @throw std::runtime_error when io_uring is not available
+   */
+  UringSwapIO(int fd_, unsigned int depth) : fd(fd_), inflight(0) {
+    struct io_uring_params p;
+    std::memset(&p, 0, sizeof(p));
+    ring_fd = syscall(__NR_io_uring_setup, depth, &p);
+    NNTR_THROW_IF(ring_fd < 0, std::runtime_error)
+      << "SwapDevice: io_uring_setup failed: " << errno;
+
+    sq_size = p.sq_off.array + p.sq_entries * sizeof(unsigned int);
+    cq_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    if (p.features & IORING_FEAT_SINGLE_MMAP)
+      sq_size = cq_size = std::max(sq_size, cq_size);
+    sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+
+    sq_ptr = mmap(NULL, sq_size, PROT_READ | PROT_WRITE,
+                  MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+    cq_ptr = (p.features & IORING_FEAT_SINGLE_MMAP)
+               ? sq_ptr
+               : mmap(NULL, cq_size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_CQ_RING);
+    void *sqe_ptr = mmap(NULL, sqes_size, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+    if (sq_ptr == MAP_FAILED || cq_ptr == MAP_FAILED || sqe_ptr == MAP_FAILED) {
+      unmap(sqe_ptr);
+      throw std::runtime_error("SwapDevice: io_uring mmap failed");
+    }
+
+    char *sq = static_cast<char *>(sq_ptr);
+    char *cq = static_cast<char *>(cq_ptr);
+    sq_tail = reinterpret_cast<unsigned int *>(sq + p.sq_off.tail);
+    sq_mask = *reinterpret_cast<unsigned int *>(sq + p.sq_off.ring_mask);
+    sq_array = reinterpret_cast<unsigned int *>(sq + p.sq_off.array);
+    sqes = static_cast<struct io_uring_sqe *>(sqe_ptr);
+    cq_head = reinterpret_cast<unsigned int *>(cq + p.cq_off.head);
+    cq_tail = reinterpret_cast<unsigned int *>(cq + p.cq_off.tail);
+    cq_mask = *reinterpret_cast<unsigned int *>(cq + p.cq_off.ring_mask);
+    cqes = reinterpret_cast<struct io_uring_cqe *>(cq + p.cq_off.cqes);
+    max_inflight = p.sq_entries;
+
+    reaper = std::thread([this] { reap(); });
+  }
+
+  /**
+   * @brief Destroy the UringSwapIO object
+   */
+  ~UringSwapIO() {
+    {
+      std::unique_lock<std::mutex> lock(sq_mutex);
+      /** nop without user data wakes the reaper up to stop */
+      struct io_uring_sqe *sqe = getSqe();
+      sqe->opcode = IORING_OP_NOP;
+      enter(lock, 1);
+    }
+    reaper.join();
+    unmap(sqes);
+  }
+
+  /**
+   * @copydoc SwapIO::submit
+   */
+  void submit(std::shared_ptr<Request> req) override {
+    std::unique_lock<std::mutex> lock(sq_mutex);
+    sq_cv.wait(lock, [this] { return inflight < max_inflight; });
+    inflight++;
+    queue(lock, std::move(req));
+  }
+
+private:
+  /**
+   * @brief get a free submission entry, must be called with sq_mutex
+   */
+  struct io_uring_sqe *getSqe() {
+    unsigned int tail = *sq_tail;
+    unsigned int idx = tail & sq_mask;
+    struct io_uring_sqe *sqe = &sqes[idx];
+    std::memset(sqe, 0, sizeof(*sqe));
+    sq_array[idx] = idx;
+    return sqe;
+  }
+
+  /**
+   * @brief publish the submission entry and enter the kernel
+   */
+  void enter(std::unique_lock<std::mutex> &lock, unsigned int to_submit) {
+    __atomic_store_n(sq_tail, *sq_tail + 1, __ATOMIC_RELEASE);
+    while (syscall(__NR_io_uring_enter, ring_fd, to_submit, 0, 0, NULL, 0) <
+             0 &&
+           (errno == EINTR || errno == EAGAIN))
+      ;
+  }
+
+  /**
+   * @brief queue the request to the submission ring
+   */
+  void queue(std::unique_lock<std::mutex> &lock, std::shared_ptr<Request> req) {
+    struct io_uring_sqe *sqe = getSqe();
+    req->iov.iov_base = req->buf;
+    req->iov.iov_len = req->len;
+    sqe->opcode = req->write ? IORING_OP_WRITEV : IORING_OP_READV;
+    sqe->fd = fd;
+    sqe->off = req->offset;
+    sqe->addr = reinterpret_cast<uint64_t>(&req->iov);
+    sqe->len = 1;
+    sqe->user_data = reinterpret_cast<uint64_t>(req.get());
+    submitted[req.get()] = std::move(req);
+    enter(lock, 1);
+  }
+
+  /**
+   * @brief reaper loop to complete requests
+   */
+  void reap() {
+    while (true) {
+      syscall(__NR_io_uring_enter, ring_fd, 0, 1, IORING_ENTER_GETEVENTS, NULL,
+              0);
+
+      unsigned int head = *cq_head;
+      unsigned int tail = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+      bool stop = false;
+      for (; head != tail; ++head) {
+        struct io_uring_cqe *cqe = &cqes[head & cq_mask];
+        Request *raw = reinterpret_cast<Request *>(cqe->user_data);
+        if (raw == nullptr) {
+          stop = true;
+          continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sq_mutex);
+        if (!raw->advance(cqe->res)) {
+          /** partial or interrupted io, submit the rest again */
+          queue(lock, submitted[raw]);
+          continue;
+        }
+        submitted.erase(raw);
+        inflight--;
+        sq_cv.notify_one();
+      }
+      __atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+
+      if (stop)
+        return;
+    }
+  }
+
+  /**
+   * @brief unmap the rings and close io_uring
+   */
+  void unmap(void *sqe_ptr) {
+    if (sqe_ptr != MAP_FAILED)
+      munmap(sqe_ptr, sqes_size);
+    if (cq_ptr != MAP_FAILED && cq_ptr != sq_ptr)
+      munmap(cq_ptr, cq_size);
+    if (sq_ptr != MAP_FAILED)
+      munmap(sq_ptr, sq_size);
+    close(ring_fd);
+  }
+
+  int fd;                 /**< swap device file */
+  int ring_fd;            /**< io_uring file */
+  size_t sq_size;         /**< submission ring size */
+  size_t cq_size;         /**< completion ring size */
+  size_t sqes_size;       /**< submission entries size */
+  void *sq_ptr;           /**< submission ring */
+  void *cq_ptr;           /**< completion ring */
+  unsigned int *sq_tail;  /**< submission ring tail */
+  unsigned int sq_mask;   /**< submission ring mask */
+  unsigned int *sq_array; /**< submission ring index array */
+  struct io_uring_sqe *sqes; /**< submission entries */
+  unsigned int *cq_head;     /**< completion ring head */
+  unsigned int *cq_tail;     /**< completion ring tail */
+  unsigned int cq_mask;      /**< completion ring mask */
+  struct io_uring_cqe *cqes; /**< completion entries */
+
+  unsigned int inflight;     /**< number of in-flight requests */
+  unsigned int max_inflight; /**< max number of in-flight requests */
+  std::mutex sq_mutex;       /**< protect submission ring */
+  std::condition_variable sq_cv; /**< notify when inflight decreases */
+  std::map<Request *, std::shared_ptr<Request>> submitted; /**< in flight */
+  std::thread reaper; /**< completion thread */
+};
+#endif
+
+std::unique_ptr<SwapIO> SwapIO::create(int fd) {
+#ifdef SWAP_IO_URING
+  try {
+    return std::make_unique<UringSwapIO>(fd, SWAP_IO_QUEUE_DEPTH);
+  } catch (std::exception &e) {
+    ml_logw("%s, fall back to pread/pwrite", e.what());
+  }
+#endif
+  return std::make_unique<ThreadSwapIO>(fd, SWAP_IO_THREADS);
+}
+
+#else
+
+/**
+ * @brief io backend is not used with mmap
+ */
+class SwapIO {};
+
+#endif
+
+SwapDevice::SwapDevice(const std::string &name) :
+  dev_path(swap_device_default_path + name),
+  fd(-1)
+#ifndef USE_MMAP
+  ,
+  pool_bytes(0)
+#endif
+{
+}
+
+SwapDevice::SwapDevice(const std::string &path, const std::string &name) :
+  dev_path(path + "/" + name),
+  fd(-1)
+#ifndef USE_MMAP
+  ,
+  pool_bytes(0)
+#endif
+{
+}
+
+SwapDevice::~SwapDevice() {
+  try {
+    finish();
+  } catch (...) {
+    ml_loge("SwapDevice: failed to finish %s", dev_path.c_str());
+  }
+}
+
 void SwapDevice::start(size_t size) {
   if (fd > 0)
     return;
 
-  fd =
-    open(dev_path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_SYNC, (mode_t)0666);
+  fd = open(dev_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, (mode_t)0666);
   NNTR_THROW_IF(fd < 0, std::runtime_error)
     << "SwapDevice: open file: " << dev_path;
 
-  off_t off;
-
   /* make sparse file */
-  off = lseek(fd, size - 1, SEEK_SET);
-  NNTR_THROW_IF(off < 0, std::runtime_error)
-    << "SwapDevice: seek file: " << dev_path;
-
-  ssize_t len;
-  len = write(fd, "", 1);
+  ssize_t len = pwrite(fd, "", 1, size - 1);
   NNTR_THROW_IF(len != 1, std::runtime_error)
     << "SwapDevice: write file: " << dev_path;
 
-  off = lseek(fd, 0, SEEK_SET);
-  NNTR_THROW_IF(off < 0, std::runtime_error)
-    << "SwapDevice: seek file: " << dev_path;
+#ifndef USE_MMAP
+  io = SwapIO::create(fd);
+#endif
+}
+
+#ifndef USE_MMAP
+SwapDevice::Staging SwapDevice::acquire(size_t size) {
+  static const size_t page_size = sysconf(_SC_PAGE_SIZE);
+  size_t capacity = (size + page_size - 1) / page_size * page_size;
+
+  reapWrites();
+
+  /** best fit, but do not waste more than half of the buffer */
+  auto it = pool.lower_bound(capacity);
+  if (it != pool.end() && it->first <= capacity * 2) {
+    Staging buf = {it->second, it->first, 0, size, nullptr};
+    pool_bytes -= it->first;
+    pool.erase(it);
+    return buf;
+  }
+
+  void *ptr = nullptr;
+  int ret = posix_memalign(&ptr, page_size, capacity);
+  NNTR_THROW_IF(ret != 0 || ptr == nullptr, std::runtime_error)
+    << "SwapDevice: memory alloc failed";
+
+  return {ptr, capacity, 0, size, nullptr};
+}
+
+void SwapDevice::release(Staging &buf) {
+  if (pool_bytes + buf.capacity > SWAP_BUFFER_POOL_SIZE) {
+    free(buf.ptr);
+  } else {
+    pool.emplace(buf.capacity, buf.ptr);
+    pool_bytes += buf.capacity;
+  }
+  buf.ptr = nullptr;
+}
+
+void SwapDevice::wait(std::unique_lock<std::mutex> &lock, Staging &buf) {
+  if (!buf.request)
+    return;
+
+  auto req = buf.request;
+  lock.unlock();
+  int err = req->wait();
+  lock.lock();
+  buf.request.reset();
+
+  const size_t error_buflen = 100;
+  char error_buf[error_buflen];
+  NNTR_THROW_IF(err != 0, std::runtime_error)
+    << "SwapDevice: " << (req->write ? "write" : "read")
+    << " file: " << dev_path << ": "
+    << std::string(strerror_r(err, error_buf, error_buflen));
 }
 
+void SwapDevice::reapWrites() {
+  for (auto it = writing.begin(); it != writing.end();) {
+    if (!it->second.request->finished()) {
+      ++it;
+      continue;
+    }
+
+    int err = it->second.request->error;
+    if (err != 0 && write_error.empty()) {
+      const size_t error_buflen = 100;
+      char error_buf[error_buflen];
+      write_error = "SwapDevice: write file: " + dev_path + " at " +
+                    std::to_string(it->second.offset) + ": " +
+                    std::string(strerror_r(err, error_buf, error_buflen));
+    }
+    release(it->second);
+    it = writing.erase(it);
+  }
+}
+
+void SwapDevice::throwWriteError() {
+  if (write_error.empty())
+    return;
+
+  std::string msg;
+  std::swap(msg, write_error);
+  throw std::runtime_error(msg);
+}
+#endif
+
 void *SwapDevice::getBuffer(off_t offset, size_t size, bool alloc_only) {
   NNTR_THROW_IF(fd <= 0, std::runtime_error)
     << "SwapDevice: Device is not started";
@@ -75,27 +596,57 @@ void *SwapDevice::getBuffer(off_t offset, size_t size, bool alloc_only) {
 
   return buf;
 #else
-  off_t off;
-  ssize_t len;
-  void *ptr;
-
-  ptr = calloc(1, size);
-  NNTR_THROW_IF(ptr == NULL, std::runtime_error)
-    << "SwapDevice: memory alloc failed";
-
-  if (!alloc_only) {
-    off = lseek(fd, offset, SEEK_SET);
-    NNTR_THROW_IF(off < 0, std::runtime_error)
-      << "SwapDevice: seek file: " << dev_path;
+  std::unique_lock<std::mutex> lock(device_mutex);
+
+  /** take the prefetched buffer */
+  auto pre = prefetched.find(offset);
+  if (pre != prefetched.end()) {
+    Staging buf = pre->second;
+    prefetched.erase(pre);
+    wait(lock, buf);
+    if (!alloc_only && buf.size == size) {
+      allocated[buf.ptr] = buf;
+      return buf.ptr;
+    }
+    release(buf);
+  }
 
-    len = read(fd, ptr, size);
-    NNTR_THROW_IF(len != (size_t)size, std::runtime_error)
-      << "SwapDevice: read file: " << dev_path;
+  /** wait for the writes overlapped, reuse the buffer if it is the same */
+  Staging buf = {nullptr, 0, offset, size, nullptr};
+  for (auto it = writing.begin(); it != writing.end();) {
+    if (it->second.offset >= (off_t)(offset + size) ||
+        offset >= (off_t)(it->second.offset + it->second.size)) {
+      ++it;
+      continue;
+    }
+
+    Staging w = it->second;
+    writing.erase(it);
+    wait(lock, w);
+    if (buf.ptr == nullptr && w.offset == offset && w.size == size)
+      buf = w;
+    else
+      release(w);
+    /** the map might be changed while waiting */
+    it = writing.begin();
   }
 
-  allocated[ptr] = std::make_pair(offset, (ssize_t)size);
+  if (buf.ptr == nullptr) {
+    buf = acquire(size);
+    buf.offset = offset;
+
+    if (alloc_only) {
+      std::memset(buf.ptr, 0, size);
+    } else {
+      buf.request =
+        std::make_shared<SwapRequest>(buf.ptr, size, offset, /*write*/ false);
+      io->submit(buf.request);
+      wait(lock, buf);
+    }
+  }
 
-  return ptr;
+  allocated[buf.ptr] = buf;
+  return buf.ptr;
 #endif
 }
 
@@ -108,17 +659,12 @@ void SwapDevice::putBuffer(void *ptr, bool dealloc_only) {
   NNTR_THROW_IF(mapped.find(ptr) == mapped.end(), std::runtime_error)
     << "Couldn't find buffer";
 
-  off_t off;
   ssize_t len;
 
   auto info = mapped[ptr];
   if (!dealloc_only) {
-    off = lseek(fd, std::get<2>(info), SEEK_SET);
-    NNTR_THROW_IF(off < 0, std::runtime_error)
-      << "SwapDevice: seek file: " << dev_path;
-
     ssize_t size = std::get<3>(info);
-    len = write(fd, ptr, size);
+    len = pwrite(fd, ptr, size, std::get<2>(info));
     NNTR_THROW_IF(len != size, std::runtime_error)
       << "SwapDevice: write file: " << len << "::" << std::to_string(size)
       << dev_path;
@@ -138,31 +684,77 @@ void SwapDevice::putBuffer(void *ptr, bool dealloc_only) {
 #endif
 
 #else
-  off_t off;
-  ssize_t len;
+  std::unique_lock<std::mutex> lock(device_mutex);
 
-  NNTR_THROW_IF(allocated.find(ptr) == allocated.end(), std::invalid_argument)
+  reapWrites();
+  throwWriteError();
+
+  auto found = allocated.find(ptr);
+  NNTR_THROW_IF(found == allocated.end(), std::invalid_argument)
     << "SwapDevice: Couldn't find buffer";
 
-  auto [offset, size] = allocated[ptr];
+  Staging buf = found->second;
+  allocated.erase(found);
 
-  if (!dealloc_only) {
-    off = lseek(fd, offset, SEEK_SET);
-    NNTR_THROW_IF(off < 0, std::runtime_error)
-      << "SwapDevice: seek file: " << dev_path;
+  if (dealloc_only) {
+    release(buf);
+    return;
+  }
 
-    len = write(fd, ptr, size);
-    NNTR_THROW_IF(len != size, std::runtime_error)
-      << "SwapDevice: write file: " << dev_path;
+  /** prefetched data overlapped becomes stale */
+  for (auto it = prefetched.begin(); it != prefetched.end();) {
+    if (it->second.offset >= (off_t)(buf.offset + buf.size) ||
+        buf.offset >= (off_t)(it->second.offset + it->second.size)) {
+      ++it;
+      continue;
+    }
+
+    Staging stale = it->second;
+    prefetched.erase(it);
+    wait(lock, stale);
+    release(stale);
+    /** the map might be changed while waiting */
+    it = prefetched.begin();
   }
 
-  free(ptr);
-  allocated.erase(ptr);
+  /** keep the writes to the same area in order */
+  auto prev = writing.find(buf.offset);
+  if (prev != writing.end()) {
+    Staging w = prev->second;
+    writing.erase(prev);
+    wait(lock, w);
+    release(w);
+  }
 
-#ifndef __ANDROID__
-  malloc_trim(0);
+  buf.request = std::make_shared<SwapRequest>(buf.ptr, buf.size, buf.offset,
+                                              /*write*/ true);
+  io->submit(buf.request);
+  writing[buf.offset] = buf;
 #endif
+}
+
+void SwapDevice::prefetch(off_t offset, size_t size) {
+#ifndef USE_MMAP
+  if (fd <= 0)
+    return;
 
+  std::unique_lock<std::mutex> lock(device_mutex);
+  if (prefetched.size() >= SWAP_PREFETCH_MAX ||
+      prefetched.find(offset) != prefetched.end())
+    return;
+
+  /** data being written will be reused or waited by getBuffer */
+  for (auto &[off, w] : writing) {
+    if (w.offset < (off_t)(offset + size) &&
+        offset < (off_t)(w.offset + w.size))
+      return;
+  }
+
+  Staging buf = acquire(size);
+  buf.offset = offset;
+  buf.request = std::make_shared<SwapRequest>(buf.ptr, size, offset, false);
+  io->submit(buf.request);
+  prefetched[offset] = buf;
 #endif
 }
 
@@ -176,12 +768,28 @@ void SwapDevice::finish() {
 
 #ifdef USE_MMAP
   for (auto &[ptr, info] : mapped)
-    free(ptr);
+    munmap(std::get<void *>(info), std::get<size_t>(info));
   mapped.clear();
 #else
-  for (auto &alloc : allocated)
-    free(alloc.first);
-  allocated.clear();
+  {
+    std::unique_lock<std::mutex> lock(device_mutex);
+    for (auto &[off, buf] : writing)
+      buf.request->wait();
+    reapWrites();
+    for (auto &[off, buf] : prefetched) {
+      buf.request->wait();
+      free(buf.ptr);
+    }
+    prefetched.clear();
+    for (auto &[ptr, buf] : allocated)
+      free(ptr);
+    allocated.clear();
+    for (auto &[capacity, ptr] : pool)
+      free(ptr);
+    pool.clear();
+    pool_bytes = 0;
+  }
+  io.reset();
 #endif
 
   close(fd);
@@ -190,6 +798,10 @@ void SwapDevice::finish() {
 
   NNTR_THROW_IF(status, std::runtime_error)
     << "SwapDevice: Couldn't remove " << dev_path.c_str();
+
+#ifndef USE_MMAP
+  throwWriteError();
+#endif
 }
 
 } // namespace nntrainer
@@ -14,9 +14,11 @@
 #ifndef __SWAP_DEVICE_H__
 #define __SWAP_DEVICE_H__
 
+#include <cstdint>
 #include <fcntl.h>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <sys/mman.h>
 #include <sys/stat.h>
@@ -25,11 +27,17 @@
 #include <unistd.h>
 #include <utility>
 
-/* Uncomment this to use mmap for swap data */
+/* mmap is used for swap data unless the asynchronous device is enabled with
+ * the enable-async-swap option */
+#ifndef ENABLE_ASYNC_SWAP
 #define USE_MMAP
+#endif
 
 namespace nntrainer {
 
+class SwapIO;
+struct SwapRequest;
+
 /**
  * @class   SwapDevice
  * @brief   A device used to storing data with long access time
@@ -46,23 +54,19 @@ public:
    * @brief SwapDevice default constructor
    *
    */
-  explicit SwapDevice(const std::string &name) :
-    dev_path(swap_device_default_path + name),
-    fd(-1) {}
+  explicit SwapDevice(const std::string &name);
 
   /**
    * @brief SwapDevice default constructor
    *
    */
-  explicit SwapDevice(const std::string &path, const std::string &name) :
-    dev_path(path + "/" + name),
-    fd(-1) {}
+  explicit SwapDevice(const std::string &path, const std::string &name);
 
   /**
    * @brief SwapDevice destructor
    *
    */
-  virtual ~SwapDevice() = default;
+  virtual ~SwapDevice();
 
   /**
    * @brief Start device
@@ -80,6 +84,8 @@ public:
    * @param alloc_only only allocate buffer without reading data
    *
    * @return The pointer of the swap space
+   * @note If the same area was requested with prefetch(), this waits for the
+   * issued read instead of reading again.
    *
    */
   void *getBuffer(off_t offset, size_t size, bool alloc_only = false);
@@ -89,12 +95,24 @@ public:
    *
    * @param ptr The pointer obtained from getBuffer
    * @param dealloc_only only deallocate buffer without writing data
+   * @note Writing is asynchronous. The caller passes @a dealloc_only when the
+   * buffer is not modified since it was read from the device.
+   * @throw std::runtime_error if a write issued before has failed
    */
   void putBuffer(void *ptr, bool dealloc_only = false);
 
+  /**
+   * @brief Start reading data in background to be taken by getBuffer
+   *
+   * @param offset Requested offset of swap device file
+   * @param size Requested size.
+   */
+  void prefetch(off_t offset, size_t size);
+
   /**
    * @brief Close device
    *
+   * @throw std::runtime_error if a write not reported yet has failed
    */
   void finish();
 
@@ -122,8 +140,61 @@ private:
   std::map<void *, std::tuple<void *, size_t, off_t, ssize_t>>
     mapped; /**< <pointer, <orig_pointer, size, offset, origianl size>> */
 #else
-  std::map<void *, std::pair<off_t, ssize_t>>
-    allocated; /**< <pointer, <offset, size>> */
+  /**
+   * @brief staging buffer holding data of the swap device
+   */
+  struct Staging {
+    void *ptr;                        /**< buffer address */
+    size_t capacity;                  /**< allocated size */
+    off_t offset;                     /**< offset of swap device file */
+    size_t size;                      /**< size of data */
+    std::shared_ptr<SwapRequest> request; /**< in-flight io request */
+  };
+
+  /**
+   * @brief get a staging buffer from the pool, allocate if there is none
+   *
+   * @param size requested size
+   * @return staging buffer
+   */
+  Staging acquire(size_t size);
+
+  /**
+   * @brief return a staging buffer to the pool
+   *
+   * @param buf staging buffer
+   */
+  void release(Staging &buf);
+
+  /**
+   * @brief wait for in-flight request of the buffer
+   *
+   * @param lock lock of the device, unlocked while waiting
+   * @param buf staging buffer
+   */
+  void wait(std::unique_lock<std::mutex> &lock, Staging &buf);
+
+  /**
+   * @brief release the buffers whose write is completed, the error of a
+   * failed write is kept to be reported
+   *
+   */
+  void reapWrites();
+
+  /**
+   * @brief throw the error of the failed write kept by reapWrites()
+   *
+   */
+  void throwWriteError();
+
+  std::unique_ptr<SwapIO> io;  /**< asynchronous io backend */
+  std::mutex device_mutex;     /**< protect staging buffers */
+  size_t pool_bytes;           /**< size of idle buffers in the pool */
+  std::multimap<size_t, void *> pool; /**< <capacity, pointer> */
+  std::map<void *, Staging> allocated; /**< buffers handed out */
+  std::map<off_t, Staging> prefetched; /**< buffers being prefetched */
+  std::map<off_t, Staging> writing;    /**< buffers being written */
+  std::string write_error; /**< failed write not reported yet, empty if none */
 #endif
 };
 
@@ -12,6 +12,7 @@
 #include <char_tensor.h>
 #include <float_tensor.h>
 #include <lazy_tensor.h>
+#include <nntr_threads.h>
 #include <tensor.h>
 #include <uint_tensor.h>
 
@@ -1264,6 +1265,29 @@ TensorDim Tensor::calculateConcatOutputDim(const std::vector<Tensor> &tensors,
   return out_dim;
 }
 
+void Tensor::parallelize(
+  unsigned int len, const std::function<void(unsigned int, unsigned int)> &fn) {
+  /// below this, waking up the workers costs more than the work itself
+  constexpr unsigned int min_span = 1u << 15;
+
+  ThreadPool &pool = ThreadPool::Global();
+  const unsigned int num_threads = pool.getNumThreads();
+  if (num_threads == 1 || len < 2 * min_span) {
+    fn(0, len);
+    return;
+  }
+
+  /// keep the spans a multiple of the vector length of the kernels
+  unsigned int span =
+    std::max((len + num_threads - 1) / num_threads, min_span);
+  span = (span + 15) & ~15u;
+  pool.parallel_for(
+    0, len, span,
+    [&fn](unsigned int start, unsigned int end, unsigned int) {
+      fn(start, end);
+    });
+}
+
 std::ostream &operator<<(std::ostream &out, Tensor const &input) {
   input.print(out);
   return out;
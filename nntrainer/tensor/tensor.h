@@ -22,6 +22,7 @@
   } while (0);
 
 #include <cstddef>
+#include <type_traits>
 
 #include <blas_interface.h>
 #include <nntrainer_log.h>
@@ -683,6 +684,57 @@ public:
   Tensor &apply(std::function<Tensor &(Tensor, Tensor &)> f,
                 Tensor &output) const;
 
+  /**
+   * @brief     Apply a kernel element by element. Unlike apply(), @a op is
+   * not type-erased, so it is inlined in the loop over the data and the loop
+   * is split over the threads for a large tensor.
+   * @tparam T type of the element
+   * @tparam Op either T(T) applied to each element, or
+   * void(unsigned int N, const T *X, T *Y) applied to a contiguous span
+   * @param[in] op kernel to apply
+   * @param[out] output output tensor, may be this tensor. A strided output
+   * must have the same dimension as this tensor
+   * @retval    Tensor
+   */
+  template <typename T = float, typename Op>
+  Tensor &apply_op(Op op, Tensor &output) const {
+    CREATE_IF_EMPTY_DIMS(output, getDim(), nullptr);
+
+    if (size() != output.size() || getDataType() != output.getDataType()) {
+      throw std::invalid_argument(
+        "[Tensor::apply_op] output dimension does not match");
+    }
+
+    if (getContiguous() && output.getContiguous()) {
+      const T *in = getData<T>();
+      T *out = output.getData<T>();
+      parallelize(size(), [&](unsigned int start, unsigned int end) {
+        applySpan<T>(op, end - start, in + start, out + start);
+      });
+      return output;
+    }
+
+    /** @todo parallelize the strided case as well */
+    const bool row_contiguous =
+      getStrides()[3] == 1 && output.getStrides()[3] == 1;
+    for (unsigned int b = 0; b < batch(); ++b) {
+      for (unsigned int c = 0; c < channel(); ++c) {
+        for (unsigned int h = 0; h < height(); ++h) {
+          if (row_contiguous) {
+            applySpan<T>(op, width(), getAddress<T>(b, c, h, 0),
+                         output.getAddress<T>(b, c, h, 0));
+            continue;
+          }
+          for (unsigned int w = 0; w < width(); ++w)
+            applySpan<T>(op, 1, getAddress<T>(b, c, h, w),
+                         output.getAddress<T>(b, c, h, w));
+        }
+      }
+    }
+
+    return output;
+  }
+
   /**
    * @brief     Multiply Tensor Elementwise
    * @param[in] m Tensor to be multiplied
@@ -1692,6 +1744,35 @@ private:
    */
   static TensorDim calculateConcatOutputDim(const std::vector<Tensor> &tensors,
                                             int axis);
+
+  /**
+   * @brief Run @a fn over [0, len) split into spans, which are run on the
+   * threads when len is large enough
+   *
+   * @param[in] len length of the range
+   * @param[in] fn callback run on [start, end) of each span
+   */
+  static void
+  parallelize(unsigned int len,
+              const std::function<void(unsigned int, unsigned int)> &fn);
+
+  /**
+   * @brief Apply @a op to the span of N elements
+   *
+   * @param[in] op kernel of apply_op()
+   * @param[in] N number of elements
+   * @param[in] X input
+   * @param[out] Y output
+   */
+  template <typename T, typename Op>
+  static void applySpan(Op &op, unsigned int N, const T *X, T *Y) {
+    if constexpr (std::is_invocable_v<Op &, unsigned int, const T *, T *>) {
+      op(N, X, Y);
+    } else {
+      for (unsigned int i = 0; i < N; ++i)
+        Y[i] = op(X[i]);
+    }
+  }
 };
 
 /**
@@ -14,6 +14,8 @@
  * @todo   check before allocate that finalize is done
  */
 
+#include <algorithm>
+
 #include <memory_pool.h>
 #include <nntrainer_log.h>
 #include <tensor.h>
@@ -121,14 +123,64 @@ void TensorPool::finalize(const MemoryPlanner &planner,
   bool persist_end_order = false;
   unsigned int old_end_order = end_order;
 
-  for (auto &spec : pool) {
+  /** a placement holds only while a sample is the whole tensor */
+  for (auto &p : placements) {
+    p.active = pool[p.dest].tensor->batch() == 1 &&
+               pool[p.host].tensor->batch() == 1;
+  }
 
-    auto details = std::get_if<SourceDetails>(&spec.details);
-    if (!details || details->lifespan == TensorLifespan::UNMANAGED ||
-        details->exec_order.empty()) {
+  /**
+   * the host of a placed tensor has to be valid whenever the tensor is. The
+   * merged orders are rebuilt in every finalize, as the active placements
+   * change with the batch size.
+   */
+  std::unordered_map<unsigned int /**< host index */, SourceDetails> merged;
+  for (auto &p : placements) {
+    if (!p.active)
       continue;
+
+    unsigned int offset;
+    const unsigned int host_idx = resolvePlacement(p.dest, offset);
+    auto &host =
+      merged
+        .try_emplace(host_idx, std::get<SourceDetails>(pool[host_idx].details))
+        .first->second;
+    auto &details = std::get<SourceDetails>(pool[p.dest].details);
+    for (auto order : details.exec_order) {
+      if (std::find(host.exec_order.begin(), host.exec_order.end(), order) ==
+          host.exec_order.end())
+        host.exec_order.push_back(order);
     }
-    details->token = 0;
+    host.lifespan = enum_class_or<TensorLifespan>(host.lifespan,
+                                                  details.lifespan);
+  }
+
+  auto is_placed = [this](const RequestSpec &spec) {
+    return std::any_of(placements.begin(), placements.end(),
+                       [this, &spec](const Placement &p) {
+                         return p.active &&
+                                pool[p.dest].tensor.get() == spec.tensor.get();
+                       });
+  };
+
+  for (unsigned int idx = 0; idx < pool.size(); ++idx) {
+    auto &spec = pool[idx];
+
+    auto source = std::get_if<SourceDetails>(&spec.details);
+    if (!source || source->lifespan == TensorLifespan::UNMANAGED ||
+        source->exec_order.empty()) {
+      continue;
+    }
+    source->token = 0;
+
+    /** a placed tensor lives in the memory of its host */
+    if (is_placed(spec))
+      continue;
+
+    /** a host is planned with the orders of the tensors placed in it */
+    auto merged_iter = merged.find(idx);
+    auto details =
+      merged_iter == merged.end() ? source : &merged_iter->second;
 
     /**
      * 1. create the validity ranges for the all the requested tensors.
@@ -186,11 +238,11 @@ void TensorPool::finalize(const MemoryPlanner &planner,
      * 3. requestMemory for all the tensors and set their tokens
      * @note +1 is to make the validity_end exlusive in the interval range
      */
-    details->token = mem_pool->requestMemory(
+    source->token = mem_pool->requestMemory(
       spec.tensor->bytes(), validity_start, validity_end + 1,
       details->exec_order, details->lifespan, spec.is_weight_grad);
 #ifdef DEBUG
-    if (details->token == 0)
+    if (source->token == 0)
       throw std::runtime_error("Received invalid token from memory pool");
 #endif
 
@@ -233,6 +285,19 @@ void TensorPool::allocate(bool init) {
     syncDependents(spec);
   }
 
+  /** set the placed tensors after all the hosts are set */
+  for (auto &p : placements) {
+    if (!p.active)
+      continue;
+
+    unsigned int offset;
+    auto &host = pool[resolvePlacement(p.dest, offset)];
+    auto &spec = pool[p.dest];
+    spec.tensor->setData(host.tensor->getMemoryData(),
+                         host.tensor->getOffset() + offset, init);
+    syncDependents(spec);
+  }
+
   if (cache_loader)
     cache_loader->init();
 }
@@ -240,11 +305,14 @@ void TensorPool::allocate(bool init) {
 /**
  * @brief Deallocate memory for all the managed tensors
  */
-void TensorPool::deallocate() {
+void TensorPool::deallocate(bool keep_memory) {
   if (cache_loader)
     cache_loader->finish();
 
-  mem_pool->deallocate();
+  if (keep_memory)
+    mem_pool->detach();
+  else
+    mem_pool->deallocate();
 
   /** nullify the data pointers for the tensors */
   for (auto &spec : pool) {
@@ -252,6 +320,22 @@ void TensorPool::deallocate() {
   }
 }
 
+void TensorPool::setAllocator(std::shared_ptr<MemoryAllocator> allocator) {
+  NNTR_THROW_IF(dynamic_cast<CachePool *>(mem_pool.get()),
+                std::invalid_argument)
+    << "Cache pool does not take an allocator";
+
+  mem_pool->setAllocator(allocator);
+}
+
+std::shared_ptr<MemoryAllocator> TensorPool::shareMemory() {
+  NNTR_THROW_IF(dynamic_cast<CachePool *>(mem_pool.get()),
+                std::invalid_argument)
+    << "Cache pool cannot be shared";
+
+  return mem_pool->share();
+}
+
 const std::vector<unsigned int> &
 TensorPool::getExecutionOrder(const std::string &name) {
   return std::get<SourceDetails>(getSourceSpec(name).details).exec_order;
@@ -421,6 +505,65 @@ void TensorPool::reidentifySource(const std::string &dest,
   old_spec.details = DependentDetails{new_parent_idx, base_offset};
 }
 
+bool TensorPool::place(const std::string &dest, const std::string &host,
+                       unsigned int offset) {
+  unsigned int dest_idx = name_map.at(dest);
+  const unsigned int host_idx = name_map.at(host);
+
+  /** a view can be placed only if it is the whole of its source */
+  if (auto dep = std::get_if<DependentDetails>(&pool[dest_idx].details)) {
+    if (dep->offset != 0 ||
+        pool[dep->parent_idx].tensor->size() != pool[dest_idx].tensor->size())
+      return false;
+    dest_idx = dep->parent_idx;
+  }
+
+  unsigned int host_offset;
+  const unsigned int root = resolvePlacement(host_idx, host_offset, true);
+  auto is_managed = [this](unsigned int idx) {
+    return std::get<SourceDetails>(pool[idx].details).lifespan !=
+           TensorLifespan::UNMANAGED;
+  };
+  auto already_placed = std::any_of(
+    placements.begin(), placements.end(),
+    [dest_idx](const Placement &p) { return p.dest == dest_idx; });
+  if (root == dest_idx || already_placed || !is_managed(dest_idx) ||
+      !is_managed(root))
+    return false;
+
+  const TensorDim &dest_dim = pool[dest_idx].tensor->getDim();
+  const TensorDim &host_dim = pool[host_idx].tensor->getDim();
+  if (dest_dim.getDataType() != host_dim.getDataType() ||
+      dest_dim.getFormat() != host_dim.getFormat() ||
+      offset + dest_dim.getFeatureLen() > host_dim.getFeatureLen())
+    return false;
+
+  placements.push_back({dest_idx, host_idx, offset, false});
+  return true;
+}
+
+unsigned int TensorPool::resolvePlacement(unsigned int idx,
+                                          unsigned int &offset,
+                                          bool all) const {
+  offset = 0;
+  while (true) {
+    if (auto dep = std::get_if<DependentDetails>(&pool[idx].details)) {
+      offset += dep->offset;
+      idx = dep->parent_idx;
+    }
+
+    auto p = std::find_if(placements.begin(), placements.end(),
+                          [idx, all](const Placement &p) {
+                            return p.dest == idx && (all || p.active);
+                          });
+    if (p == placements.end())
+      return idx;
+
+    offset += p->offset;
+    idx = p->host;
+  }
+}
+
 bool TensorPool::tensorExist(const std::string &name) {
   /// @todo consider use a helper function to check, eg) something like
   /// getTensor()
@@ -473,6 +616,22 @@ int TensorPool::loadCacheExecAsync(
     return -1;
 }
 
+int TensorPool::loadCacheExecAsync(
+  unsigned int order, unsigned int from, size_t budget,
+  TaskExecutor::CompleteCallback complete_callback) {
+  if (dynamic_cast<CachePool *>(mem_pool.get()))
+    return cache_loader->loadAsync(order, from, budget, complete_callback);
+  else
+    return 0;
+}
+
+size_t TensorPool::getCachePeakSize(unsigned int window) {
+  if (auto pool = dynamic_cast<CachePool *>(mem_pool.get()))
+    return pool->getPeakWindowSize(window);
+  else
+    return 0;
+}
+
 void TensorPool::loadCacheCancel(int id) {
   if (dynamic_cast<CachePool *>(mem_pool.get()) == nullptr)
     return;
@@ -43,7 +43,8 @@ public:
    * @brief     Constructor of TensorPool
    */
   TensorPool() :
-    mem_pool(std::make_unique<MemoryPool>()), cache_loader(nullptr) {}
+    mem_pool(std::make_unique<MemoryPool>(MemoryAllocator::DEFAULT_ALIGNMENT)),
+    cache_loader(nullptr) {}
 
   /**
    * @brief     Constructor of TensorPool
@@ -51,11 +52,13 @@ public:
   TensorPool(bool enable_swap, const std::string &swap_path = "",
              const std::string &swap_name = "") {
     if (enable_swap) {
-      auto cache_pool = std::make_shared<CachePool>(swap_path, swap_name);
+      auto cache_pool = std::make_shared<CachePool>(
+        swap_path, swap_name, MemoryAllocator::DEFAULT_ALIGNMENT);
       cache_loader = std::make_unique<CacheLoader>(cache_pool);
       mem_pool = cache_pool;
     } else {
-      mem_pool = std::make_shared<MemoryPool>();
+      mem_pool =
+        std::make_shared<MemoryPool>(MemoryAllocator::DEFAULT_ALIGNMENT);
     }
   }
 
@@ -69,7 +72,8 @@ public:
    */
   void reinitialize() {
     name_map.clear();
-    mem_pool = std::make_shared<MemoryPool>();
+    placements.clear();
+    mem_pool = std::make_shared<MemoryPool>(MemoryAllocator::DEFAULT_ALIGNMENT);
   }
 
   /**
@@ -96,8 +100,10 @@ public:
 
   /**
    * @brief Deallocate memory for all the managed tensors
+   *
+   * @param keep_memory keep the memory to be reused by the next allocate()
    */
-  void deallocate();
+  void deallocate(bool keep_memory = false);
 
   /**
    * @brief     Get execution order for the given tensor
@@ -113,6 +119,13 @@ public:
    */
   size_t size() { return mem_pool->size(); }
 
+  /**
+   * @brief Get the memory of the pool resident in RAM
+   *
+   * @return The resident size in bytes
+   */
+  size_t residentSize() { return mem_pool->residentSize(); }
+
   /**
    * @brief Get the minimum theoretical memory requirement
    *
@@ -127,6 +140,33 @@ public:
    */
   bool isAllocated() const { return mem_pool->isAllocated(); }
 
+  /**
+   * @brief Set the allocation backend of the memory pool
+   *
+   * @param allocator allocation backend, default backend is used if nullptr
+   * @throw std::invalid_argument when the pool is a cache pool
+   */
+  void setAllocator(std::shared_ptr<MemoryAllocator> allocator);
+
+  /**
+   * @brief Share the allocated memory pool with other tensor pools
+   *
+   * @return allocator to be set to the tensor pools of the same layout
+   * @throw std::invalid_argument when the pool is a cache pool
+   */
+  std::shared_ptr<MemoryAllocator> shareMemory();
+
+  /**
+   * @brief Get the offset of the tensor data in the memory pool
+   *
+   * @param t tensor allocated from this pool
+   * @return offset from the start of the memory pool in bytes
+   * @throw std::invalid_argument when the tensor is not in the memory pool
+   */
+  size_t getOffsetOf(const Tensor &t) const {
+    return mem_pool->getOffsetOf(t.getData<char>());
+  }
+
   /**
    * @brief Get the tensor of the given name
    *
@@ -258,6 +298,25 @@ public:
   void reidentifySource(const std::string &dest, const std::string &new_src,
                         unsigned int offset);
 
+  /**
+   * @brief place the source of @a dest inside @a host at @a offset, so that
+   * @a dest does not take a memory slot of its own.
+   * @note unlike reidentifySource(), the placement is checked again in every
+   * finalize() and only holds while both @a dest and @a host have the batch
+   * size of 1, as a sample of @a dest is not contiguous in @a host for a
+   * larger batch. Otherwise @a dest is allocated as usual.
+   *
+   * @param dest identifier for the tensor to place, which has to be its
+   * source or a view of the whole source
+   * @param host identifier for the tensor to place in
+   * @param offset elementwise offset in a sample of @a host
+   * @retval true if placed
+   * @retval false if the placement is not possible, e.g. @a dest is already
+   * placed, or one of them is not managed by the pool
+   */
+  bool place(const std::string &dest, const std::string &host,
+             unsigned int offset);
+
   /**
    * @brief flush cache data
    *
@@ -288,6 +347,27 @@ public:
   int loadCacheExecAsync(unsigned int order,
                          TaskExecutor::CompleteCallback complete_callback);
 
+  /**
+   * @brief load cache data by execution order, keeping the cache data used
+   * from @a from within @a budget
+   *
+   * @param order execution order to load
+   * @param from execution order running now
+   * @param budget cache size to keep in bytes
+   * @return async task id, 0 if the pool does not cache
+   */
+  int loadCacheExecAsync(unsigned int order, unsigned int from, size_t budget,
+                         TaskExecutor::CompleteCallback complete_callback);
+
+  /**
+   * @brief get the peak size of the cache data used in @a window consecutive
+   * execution orders
+   *
+   * @param window number of execution orders
+   * @return size in bytes, 0 if the pool does not cache
+   */
+  size_t getCachePeakSize(unsigned int window);
+
   /**
    * @brief load cache data by execution order
    *
@@ -317,6 +397,17 @@ private:
     unsigned int offset;     /**< elementwise offset */
   };
 
+  /**
+   * @brief Placement of a source tensor inside another tensor
+   *
+   */
+  struct Placement {
+    unsigned int dest;   /**< index of the placed source */
+    unsigned int host;   /**< index of the tensor to place in */
+    unsigned int offset; /**< elementwise offset in the host */
+    bool active;         /**< true if the placement holds for the batch */
+  };
+
   /**
    * @brief Spec for storing each request of tensor from tensor pool
    * @todo move tensor initialization from tensor class to RequestSpec
@@ -377,6 +468,18 @@ private:
    */
   void syncDependents(const RequestSpec &spec);
 
+  /**
+   * @brief find the source holding the memory of a tensor through the views
+   * and the active placements
+   *
+   * @param idx index of the tensor
+   * @param[out] offset elementwise offset of the tensor in the source
+   * @param all follow the inactive placements as well
+   * @return unsigned int index of the source
+   */
+  unsigned int resolvePlacement(unsigned int idx, unsigned int &offset,
+                                bool all = false) const;
+
   /**
    * @brief register a spec after creation
    *
@@ -393,6 +496,7 @@ private:
     name_map;                           /**< indexing of requested tensors */
   std::shared_ptr<MemoryPool> mem_pool; /**< memory pool for the tensors */
   std::unique_ptr<CacheLoader> cache_loader; /**< memory pool for the tensors */
+  std::vector<Placement> placements; /**< placements of the sources */
 
   /**
    * @brief     Check if the lifespan leads to long term valitidy
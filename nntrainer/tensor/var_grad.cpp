@@ -11,6 +11,8 @@
  *
  */
 
+#include <cmath>
+
 #include <util_func.h>
 #include <var_grad.h>
 
@@ -77,4 +79,48 @@ void Var_Grad::initializeGradient(const Tensor &preallocated) {
   /** intentionally not initialized tensor memory for shared tensors */
 }
 
+float Var_Grad::getGradientNorm() const {
+  if (!is_grad_row_sparse)
+    return grad->l2norm();
+
+  const unsigned int width = grad->width();
+  TensorDim row_dim = grad->getDim();
+  row_dim.batch(1);
+  row_dim.channel(1);
+  row_dim.height(1);
+
+  float sum = 0.0f;
+  for (auto row : grad_rows) {
+    float norm =
+      grad->getSharedDataTensor(row_dim, row * width, true).l2norm();
+    sum += norm * norm;
+  }
+  return std::sqrt(sum);
+}
+
+void Var_Grad::densifyGradient() {
+  if (!is_grad_row_sparse)
+    return;
+
+  const unsigned int width = grad->width();
+  const unsigned int num_rows = grad->size() / width;
+  TensorDim rows_dim = grad->getDim();
+  rows_dim.batch(1);
+  rows_dim.channel(1);
+
+  /** zero the gaps between the valid rows */
+  unsigned int begin = 0;
+  for (unsigned int i = 0; i <= grad_rows.size(); ++i) {
+    unsigned int end = i < grad_rows.size() ? grad_rows[i] : num_rows;
+    if (end > begin) {
+      rows_dim.height(end - begin);
+      grad->getSharedDataTensor(rows_dim, begin * width, true).setZero();
+    }
+    begin = end + 1;
+  }
+
+  grad_rows.clear();
+  is_grad_row_sparse = false;
+}
+
 } // namespace nntrainer
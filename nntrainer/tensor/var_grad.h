@@ -15,6 +15,7 @@
 #define __VAR_GRAD_H__
 
 #include <tuple>
+#include <vector>
 
 #include <tensor.h>
 #include <tensor_wrap_specs.h>
@@ -308,7 +309,45 @@ public:
    *
    * @return float l2 norm of the gradient
    */
-  float getGradientNorm() const { return grad->l2norm(); }
+  float getGradientNorm() const;
+
+  /**
+   * @brief Mark the gradient as row-sparse. Only the given rows of the
+   * gradient, seen as a [size / width, width] matrix, are valid and the other
+   * rows are zero regardless of their memory.
+   *
+   * @param rows sorted unique rows of the gradient
+   * @note The writer of the gradient owns the mark, so it must set the rows
+   * again or clear them whenever it writes the gradient. The weights sharing
+   * the gradient do not see the mark, so a shared gradient is kept dense.
+   */
+  void setGradientRows(std::vector<unsigned int> rows) {
+    grad_rows = std::move(rows);
+    is_grad_row_sparse = true;
+  }
+
+  /**
+   * @brief Check if the gradient is row-sparse
+   *
+   * @return true if only getGradientRows() of the gradient are valid
+   */
+  bool isGradientRowSparse() const { return is_grad_row_sparse; }
+
+  /**
+   * @brief Get the valid rows of the row-sparse gradient
+   *
+   * @return const std::vector<unsigned int>& sorted unique rows
+   */
+  const std::vector<unsigned int> &getGradientRows() const {
+    return grad_rows;
+  }
+
+  /**
+   * @brief Zero the rows of the row-sparse gradient which are not valid, so
+   * that the gradient can be read as a dense tensor. This is a no-op for a
+   * dense gradient.
+   */
+  void densifyGradient();
 
   inline static const std::string grad_suffix = ":grad";
 
@@ -322,6 +361,9 @@ protected:
 
   std::shared_ptr<Tensor> var;  /**< variable to be updated and used */
   std::shared_ptr<Tensor> grad; /**< gradient for the variable */
+
+  bool is_grad_row_sparse = false; /**< only grad_rows of grad are valid */
+  std::vector<unsigned int> grad_rows; /**< valid rows of the gradient */
 };
 
 } // namespace nntrainer
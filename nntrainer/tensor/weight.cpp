@@ -141,6 +141,27 @@ void Weight::applyGradient(double lr, Tensor &updated_grad) {
   }
 }
 
+void Weight::clipGradientByGlobalNorm(const float global_norm) {
+  if ((global_norm + epsilon) <= clip_by_global_norm)
+    return;
+
+  const float scale = clip_by_global_norm / (global_norm + epsilon);
+  if (!isGradientRowSparse()) {
+    grad->multiply_i(scale);
+    return;
+  }
+
+  TensorDim row_dim = grad->getDim();
+  row_dim.batch(1);
+  row_dim.channel(1);
+  row_dim.height(1);
+  for (auto row : getGradientRows()) {
+    Tensor grad_row =
+      grad->getSharedDataTensor(row_dim, row * grad->width(), true);
+    grad_row.multiply_i(scale);
+  }
+}
+
 void Weight::quantizeWeight() {
   if (!isMixedPrecision())
     return;
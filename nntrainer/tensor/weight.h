@@ -273,16 +273,20 @@ public:
    * @brief     Calculate gradient from the regularization of the weight
    */
   void calcRegularizationGradient() {
-    if (isWeightRegularizerL2Norm())
+    if (isWeightRegularizerL2Norm()) {
+      densifyGradient();
       grad->add_i(*var.get(), regularizer_constant);
+    }
   }
 
   /**
    * @brief     Calculate gradient from the decay of the weight
    */
   void calcWeightDecayGradient() {
-    if (isWeightDecay())
+    if (isWeightDecay()) {
+      densifyGradient();
       applyWeightDecay();
+    }
   }
 
   /**
@@ -332,10 +336,7 @@ public:
    *
    * @param global_norm the global norm for all the weights
    */
-  void clipGradientByGlobalNorm(const float global_norm) {
-    if ((global_norm + epsilon) > clip_by_global_norm)
-      grad->multiply_i(clip_by_global_norm / (global_norm + epsilon));
-  }
+  void clipGradientByGlobalNorm(const float global_norm);
 
   /**
    * @brief Get the variable FP32 tensor (by reference)
@@ -11,7 +11,14 @@
  */
 
 #include <algorithm>
+#include <cstdlib>
+#include <exception>
 #include <nntr_threads.h>
+#include <nntrainer_log.h>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
 
 #ifdef NNTR_NUM_THREADS
 static const unsigned int nntr_num_threads = NNTR_NUM_THREADS;
@@ -21,17 +28,242 @@ static const unsigned int nntr_num_threads = 1;
 
 namespace nntrainer {
 
+/**
+ * @brief completion state shared by the jobs of a parallel_for() call
+ */
+struct ThreadPool::Batch {
+  std::atomic<unsigned int> remaining;
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::exception_ptr error;
+};
+
+/**
+ * @brief read a non-negative integer from an environment variable
+ *
+ * @param name name of the variable
+ * @param fallback value used if the variable is not set or invalid
+ * @return unsigned int parsed value
+ */
+static unsigned int getEnvUInt(const char *name, unsigned int fallback) {
+  const char *value = std::getenv(name);
+  if (value == nullptr)
+    return fallback;
+
+  char *end = nullptr;
+  long parsed = std::strtol(value, &end, 10);
+  if (end == value || *end != '\0' || parsed < 0) {
+    ml_logw("ignoring invalid %s=%s", name, value);
+    return fallback;
+  }
+  return static_cast<unsigned int>(parsed);
+}
+
+ThreadPool &ThreadPool::Global() {
+  static ThreadPool pool(getEnvUInt("NNTR_NUM_THREADS", nntr_num_threads),
+                         getEnvUInt("NNTR_THREAD_AFFINITY", 0) != 0);
+  return pool;
+}
+
+ThreadPool::ThreadPool(unsigned int num_threads_, bool affinity_) :
+  num_threads(std::max(num_threads_, 1u)),
+  affinity(affinity_),
+  pending(0),
+  next_queue(0),
+  stopping(false) {
+  start();
+}
+
+ThreadPool::~ThreadPool() { stop(); }
+
+void ThreadPool::setNumThreads(unsigned int num_threads_) {
+  num_threads_ = std::max(num_threads_, 1u);
+  if (num_threads_ == num_threads)
+    return;
+
+  stop();
+  num_threads = num_threads_;
+  start();
+}
+
+void ThreadPool::setAffinity(bool enable) {
+  if (enable == affinity)
+    return;
+
+  stop();
+  affinity = enable;
+  start();
+}
+
+void ThreadPool::start() {
+  stopping = false;
+  /// the calling thread is one of the threads, so spawn one less
+  unsigned int num_workers = num_threads - 1;
+  queues.clear();
+  for (unsigned int i = 0; i < num_workers; ++i)
+    queues.emplace_back(std::make_unique<Queue>());
+  for (unsigned int i = 0; i < num_workers; ++i)
+    workers.emplace_back(&ThreadPool::workerLoop, this, i);
+}
+
+void ThreadPool::stop() {
+  {
+    std::lock_guard<std::mutex> lock(wake_mutex);
+    stopping = true;
+  }
+  wake_cv.notify_all();
+  std::for_each(workers.begin(), workers.end(),
+                std::mem_fn(&std::thread::join));
+  workers.clear();
+}
+
+void ThreadPool::workerLoop(unsigned int id) {
+#ifdef __linux__
+  if (affinity) {
+    unsigned int num_cores = std::max(std::thread::hardware_concurrency(), 1u);
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    /// leave core 0 to the calling thread
+    CPU_SET((id + 1) % num_cores, &cpu_set);
+    if (sched_setaffinity(0, sizeof(cpu_set), &cpu_set) != 0)
+      ml_logw("failed to set affinity of nntrainer worker %u", id);
+  }
+#endif
+
+  while (true) {
+    Job *job = takeJob(id);
+    if (job != nullptr) {
+      runJob(job);
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(wake_mutex);
+    wake_cv.wait(lock, [this] { return stopping || pending > 0; });
+    if (stopping)
+      return;
+  }
+}
+
+ThreadPool::Job *ThreadPool::takeJob(unsigned int id) {
+  const unsigned int num_queues = queues.size();
+  if (num_queues == 0)
+    return nullptr;
+
+  {
+    Queue &own = *queues[id % num_queues];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (!own.jobs.empty()) {
+      Job *job = own.jobs.back();
+      own.jobs.pop_back();
+      pending--;
+      return job;
+    }
+  }
+
+  for (unsigned int i = 1; i < num_queues; ++i) {
+    Queue &victim = *queues[(id + i) % num_queues];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.jobs.empty()) {
+      Job *job = victim.jobs.front();
+      victim.jobs.pop_front();
+      pending--;
+      return job;
+    }
+  }
+
+  return nullptr;
+}
+
+void ThreadPool::runJob(Job *job) {
+  Batch &batch = *job->batch;
+  try {
+    (*job->fn)(job->start, job->end, job->chunk_id);
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(batch.mutex);
+    if (!batch.error)
+      batch.error = std::current_exception();
+  }
+
+  /// the batch lives on the stack of parallel_for(), which returns as soon
+  /// as it sees remaining == 0 under the lock, so count down and notify while
+  /// holding it and do not touch the batch afterwards
+  std::lock_guard<std::mutex> lock(batch.mutex);
+  if (--batch.remaining == 0)
+    batch.cv.notify_all();
+}
+
+void ThreadPool::parallel_for(unsigned int begin, unsigned int end,
+                              unsigned int grain, const RangeFunc &fn) {
+  if (begin >= end)
+    return;
+
+  const unsigned int len = end - begin;
+  if (grain == 0)
+    grain = (len + num_threads - 1) / num_threads;
+
+  const unsigned int num_chunks = (len + grain - 1) / grain;
+  if (num_chunks == 1 || queues.empty()) {
+    for (unsigned int i = 0; i < num_chunks; ++i) {
+      unsigned int s = begin + i * grain;
+      fn(s, std::min(s + grain, end), i);
+    }
+    return;
+  }
+
+  Batch batch;
+  batch.remaining = num_chunks;
+
+  std::vector<Job> jobs(num_chunks);
+  const unsigned int num_queues = queues.size();
+  const unsigned int first_queue = next_queue++;
+  for (unsigned int i = 0; i < num_chunks; ++i) {
+    unsigned int s = begin + i * grain;
+    jobs[i] = {&fn, s, std::min(s + grain, end), i, &batch};
+
+    /// count the job under the lock it is popped with, so that pending
+    /// never underflows and never counts a job which is not queued yet
+    Queue &queue = *queues[(first_queue + i) % num_queues];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.jobs.push_back(&jobs[i]);
+    pending++;
+  }
+
+  /// a worker checks pending under wake_mutex before it sleeps
+  {
+    std::lock_guard<std::mutex> lock(wake_mutex);
+    wake_cv.notify_all();
+  }
+
+  /// help the workers instead of idling, this also serves nested calls
+  while (batch.remaining > 0) {
+    Job *job = takeJob(first_queue);
+    if (job == nullptr)
+      break;
+    runJob(job);
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(batch.mutex);
+    batch.cv.wait(lock, [&batch] { return batch.remaining == 0; });
+  }
+
+  if (batch.error)
+    std::rethrow_exception(batch.error);
+}
+
 ParallelBatch::ParallelBatch(unsigned int batch_size) :
   cb(nullptr),
   batch(batch_size),
-  num_workers(nntr_num_threads > batch ? 1 : nntr_num_threads),
+  num_workers(std::max(
+    std::min(ThreadPool::Global().getNumThreads(), batch_size), 1u)),
   user_data_prop(new props::PropsUserData(nullptr)){};
 
 ParallelBatch::ParallelBatch(threaded_cb threaded_cb_, unsigned int batch_size,
                              void *user_data_) :
   cb(threaded_cb_),
   batch(batch_size),
-  num_workers(nntr_num_threads > batch ? 1 : nntr_num_threads),
+  num_workers(std::max(
+    std::min(ThreadPool::Global().getNumThreads(), batch_size), 1u)),
   user_data_prop(new props::PropsUserData(user_data_)) {}
 
 ParallelBatch::~ParallelBatch() {}
@@ -42,21 +274,14 @@ void ParallelBatch::run() {
     throw std::invalid_argument("nntrainer threads: callback is not defined");
   }
 
-  unsigned int start = 0;
-  unsigned int end = batch;
-
-  unsigned int chunk = (end - start + (num_workers - 1)) / num_workers;
+  unsigned int chunk = (batch + (num_workers - 1)) / num_workers;
+  void *user_data = user_data_prop->get();
 
-  for (unsigned int i = 0; i < num_workers; ++i) {
-    unsigned int s = start + i * chunk;
-    unsigned int e = s + chunk;
-    if (e > end)
-      e = end;
-    workers.push_back(std::thread(cb, s, e, i, user_data_prop->get()));
-  }
-
-  std::for_each(workers.begin(), workers.end(),
-                std::mem_fn(&std::thread::join));
+  ThreadPool::Global().parallel_for(
+    0, batch, chunk,
+    [this, user_data](unsigned int s, unsigned int e, unsigned int pid) {
+      cb(s, e, pid, user_data);
+    });
 }
 
 void ParallelBatch::setCallback(threaded_cb threaded_cb_, void *user_data_) {
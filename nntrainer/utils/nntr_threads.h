@@ -12,6 +12,12 @@
 #ifndef __NNTR_THREADS_H__
 #define __NNTR_THREADS_H__
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
 #include <vector>
@@ -27,6 +33,147 @@ typedef std::function<std::remove_pointer<loop_cb>::type> threaded_cb;
 
 namespace nntrainer {
 
+/**
+ * @brief Process-wide pool of persistent worker threads.
+ * @details parallel_for() splits a range into chunks and spreads them over
+ * per-worker queues. A worker pops from the back of its own queue and steals
+ * from the front of the others once it runs dry. The calling thread takes
+ * part in the work too, so nested parallel_for() calls do not deadlock.
+ */
+class ThreadPool {
+public:
+  /**
+   * @brief callback run on [start, end) of a range. chunk_id is the index of
+   * the chunk, which is less than the number of chunks the range is split into
+   */
+  using RangeFunc = std::function<void(unsigned int start, unsigned int end,
+                                       unsigned int chunk_id)>;
+
+  /**
+   * @brief Get the process-wide pool
+   * @details the initial number of threads is read from the NNTR_NUM_THREADS
+   * environment variable, falling back to the nntr-num-threads build option.
+   * Setting NNTR_THREAD_AFFINITY=1 pins each worker to a core.
+   *
+   * @return ThreadPool& global pool
+   */
+  static ThreadPool &Global();
+
+  /**
+   * @brief Construct a new Thread Pool object
+   *
+   * @param num_threads number of threads including the calling thread
+   * @param affinity pin each worker to a core if true
+   */
+  explicit ThreadPool(unsigned int num_threads, bool affinity = false);
+
+  /**
+   * @brief Destroy the Thread Pool object, joins all workers
+   */
+  ~ThreadPool();
+
+  /**
+   * @brief Set the number of threads, workers are respawned
+   * @note must not be called while parallel_for() is running
+   *
+   * @param num_threads number of threads including the calling thread
+   */
+  void setNumThreads(unsigned int num_threads);
+
+  /**
+   * @brief Get the number of threads including the calling thread
+   *
+   * @return unsigned int number of threads
+   */
+  unsigned int getNumThreads() const { return num_threads; }
+
+  /**
+   * @brief Set whether each worker is pinned to a core, workers are respawned
+   * @note must not be called while parallel_for() is running
+   *
+   * @param enable pin workers if true
+   */
+  void setAffinity(bool enable);
+
+  /**
+   * @brief Run @a fn over [begin, end) in chunks of @a grain elements, and
+   * return once every chunk is done. An exception thrown by @a fn is
+   * rethrown to the caller after all chunks have finished.
+   *
+   * @param begin start of the range
+   * @param end end of the range (exclusive)
+   * @param grain number of elements per chunk, 0 splits the range evenly
+   * over the threads
+   * @param fn callback to run for each chunk
+   */
+  void parallel_for(unsigned int begin, unsigned int end, unsigned int grain,
+                    const RangeFunc &fn);
+
+private:
+  struct Batch;
+
+  /**
+   * @brief a chunk of a range waiting in a queue
+   */
+  struct Job {
+    const RangeFunc *fn;
+    unsigned int start;
+    unsigned int end;
+    unsigned int chunk_id;
+    Batch *batch;
+  };
+
+  /**
+   * @brief per-worker queue of jobs
+   */
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Job *> jobs;
+  };
+
+  /**
+   * @brief spawn workers for the current configuration
+   */
+  void start();
+
+  /**
+   * @brief stop and join all workers
+   */
+  void stop();
+
+  /**
+   * @brief main loop of a worker
+   *
+   * @param id worker index
+   */
+  void workerLoop(unsigned int id);
+
+  /**
+   * @brief pop a job from queue @a id or steal one from the other queues
+   *
+   * @param id index of the queue to try first
+   * @return Job* job, nullptr if every queue is empty
+   */
+  Job *takeJob(unsigned int id);
+
+  /**
+   * @brief run a job and signal its batch when it is the last one
+   *
+   * @param job job to run
+   */
+  void runJob(Job *job);
+
+  unsigned int num_threads;
+  bool affinity;
+  std::vector<std::thread> workers;
+  std::vector<std::unique_ptr<Queue>> queues;
+  std::atomic<unsigned int> pending;
+  std::atomic<unsigned int> next_queue;
+  bool stopping;
+  std::mutex wake_mutex;
+  std::condition_variable wake_cv;
+};
+
 /**
  * @brief ParallelBatch class to parallelize along batch direction
  *
@@ -57,7 +204,9 @@ public:
   ~ParallelBatch();
 
   /**
-   * @brief Run the workders
+   * @brief Run the callback over the batch on the global ThreadPool. The
+   * batch is split into getNumWorkers() chunks and the chunk index is given
+   * to the callback as pid.
    *
    */
   void run();
@@ -80,7 +229,6 @@ private:
   threaded_cb cb;
   unsigned int batch;
   unsigned int num_workers;
-  std::vector<std::thread> workers;
   std::unique_ptr<props::PropsUserData> user_data_prop;
 };
 
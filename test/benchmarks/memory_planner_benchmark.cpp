@@ -0,0 +1,184 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file memory_planner_benchmark.cpp
+ * @date 18 October 2026
+ * @brief Compare the peak pool size of the memory planners on the models
+ * @see	https://github.com/nnstreamer/nntrainer
+ * @bug No known bugs except for NYI items
+ *
+ * @note usage: memory_planner_benchmark [search_rounds] [model.ini ...]
+ * The models of Applications are used if no model is given.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <basic_planner.h>
+#include <best_fit_planner.h>
+#include <memory_allocator.h>
+#include <memory_pool.h>
+#include <neuralnet.h>
+#include <optimized_v1_planner.h>
+#include <optimized_v2_planner.h>
+#include <optimized_v3_planner.h>
+
+namespace {
+
+/**
+ * @brief memory requests of a pool
+ */
+struct Requests {
+  std::vector<size_t> size;
+  std::vector<std::pair<unsigned int, unsigned int>> validity;
+  std::vector<bool> is_wgrad;
+};
+
+/**
+ * @brief planner which records the requests and plans with the optimized v1
+ * planner
+ */
+class RecordingPlanner : public nntrainer::MemoryPlanner {
+public:
+  size_t planLayout(
+    const std::vector<size_t> &memory_size,
+    const std::vector<std::pair<unsigned int, unsigned int>> &memory_validity,
+    std::vector<size_t> &memory_offset, std::vector<bool> &memory_is_wgrad,
+    size_t n_wgrad) const override {
+    requests.push_back({memory_size, memory_validity, memory_is_wgrad});
+    return nntrainer::OptimizedV1Planner().planLayout(
+      memory_size, memory_validity, memory_offset, memory_is_wgrad, n_wgrad);
+  }
+
+  const std::string &getType() const override { return type; }
+
+  inline static const std::string type = "recording_planner";
+
+  mutable std::vector<Requests> requests; /**< recorded requests */
+};
+
+/**
+ * @brief plan the requests with the planner and return the pool size
+ */
+size_t plan(const Requests &req, const nntrainer::MemoryPlanner &planner) {
+  nntrainer::MemoryPool pool(nntrainer::MemoryAllocator::DEFAULT_ALIGNMENT);
+  for (unsigned int idx = 0; idx < req.size.size(); idx++)
+    pool.requestMemory(req.size[idx], req.validity[idx].first,
+                       req.validity[idx].second, {},
+                       nntrainer::TensorLifespan::MAX_LIFESPAN,
+                       req.is_wgrad[idx]);
+
+  /** planLayout throws if the layout is not valid */
+  pool.planLayout(planner);
+  return pool.size();
+}
+
+/**
+ * @brief get the requests of the weight and tensor pools of the model
+ */
+std::vector<Requests> getRequests(const std::string &path) {
+  nntrainer::NeuralNetwork model;
+  auto recorder = std::make_shared<RecordingPlanner>();
+
+  if (model.loadFromConfig(path) != ML_ERROR_NONE ||
+      model.compile() != ML_ERROR_NONE)
+    throw std::invalid_argument("failed to compile " + path);
+
+  /** the graph shares the tensor manager with the model */
+  model.getNetworkGraph().setMemoryPlanner(recorder);
+  if (model.initialize() != ML_ERROR_NONE ||
+      model.allocate(ml::train::ExecutionMode::TRAIN) != ML_ERROR_NONE)
+    throw std::invalid_argument("failed to initialize " + path);
+
+  return recorder->requests;
+}
+
+const std::vector<std::string> application_models = {
+  "AlexNet/res/alex.ini",
+  "Layers/res/LSTM.ini",
+  "Layers/res/Model_A_Conv.ini",
+  "Layers/res/Model_C_Conv.ini",
+  "LogisticRegression/res/LogisticRegression.ini",
+  "MNIST/res/mnist.ini",
+  "ProductRatings/res/product_ratings_model.ini",
+  "Resnet/res/resnet18.ini",
+  "VGG/res/vgg.ini",
+};
+
+} // namespace
+
+int main(int argc, char **argv) {
+  unsigned int search_rounds = argc > 1 ? std::atoi(argv[1]) : 1000;
+
+  std::vector<std::string> models(argv + std::min(argc, 2), argv + argc);
+  if (models.empty()) {
+    for (auto &model : application_models)
+      models.push_back(std::string(APPLICATIONS_DIR) + "/" + model);
+  }
+
+  std::vector<std::pair<std::string, std::shared_ptr<nntrainer::MemoryPlanner>>>
+    planners = {
+      {"v1", std::make_shared<nntrainer::OptimizedV1Planner>()},
+      {"v2", std::make_shared<nntrainer::OptimizedV2Planner>()},
+      {"v3", std::make_shared<nntrainer::OptimizedV3Planner>()},
+      {"best_fit", std::make_shared<nntrainer::BestFitPlanner>()},
+      {"best_fit_search",
+       std::make_shared<nntrainer::BestFitPlanner>(search_rounds)},
+    };
+
+  std::cout << std::left << std::setw(48) << "model" << std::right
+            << std::setw(14) << "min";
+  for (auto &[name, planner] : planners)
+    std::cout << std::setw(16) << name;
+  std::cout << std::setw(12) << "search(ms)" << std::endl;
+
+  int status = EXIT_SUCCESS;
+  for (auto &path : models) {
+    std::vector<Requests> requests;
+    try {
+      requests = getRequests(path);
+    } catch (std::exception &e) {
+      std::cerr << "skipping " << path << ": " << e.what() << std::endl;
+      continue;
+    }
+
+    size_t min_size = 0;
+    for (auto &req : requests) {
+      nntrainer::MemoryPool pool(
+        nntrainer::MemoryAllocator::DEFAULT_ALIGNMENT);
+      for (unsigned int idx = 0; idx < req.size.size(); idx++)
+        pool.requestMemory(req.size[idx], req.validity[idx].first,
+                           req.validity[idx].second);
+      min_size += pool.minMemoryRequirement();
+    }
+
+    std::string name = path.substr(path.find_last_of('/') + 1);
+    std::cout << std::left << std::setw(48) << name << std::right
+              << std::setw(14) << min_size;
+
+    double elapsed = 0;
+    for (auto &[planner_name, planner] : planners) {
+      size_t total = 0;
+      try {
+        auto start = std::chrono::steady_clock::now();
+        for (auto &req : requests)
+          total += plan(req, *planner);
+        elapsed = std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - start)
+                    .count();
+        std::cout << std::setw(16) << total;
+      } catch (std::exception &e) {
+        std::cout << std::setw(16) << "invalid";
+        status = EXIT_FAILURE;
+      }
+    }
+    std::cout << std::setw(12) << std::fixed << std::setprecision(1) << elapsed
+              << std::endl;
+  }
+
+  return status;
+}
@@ -10,6 +10,7 @@
  * @bug         No known bugs
  */
 
+#include <cmath>
 #include <gtest/gtest.h>
 #include <iostream>
 
@@ -413,6 +414,52 @@ TEST(nntrainer_ccapi, train_batch_size_update_after) {
   EXPECT_NEAR(model->getValidationLoss(), 2.179843, tolerance);
 }
 
+/**
+ * @brief Neural Network Model Training with the partial batch
+ */
+TEST(nntrainer_ccapi, train_partial_batch_p) {
+  std::unique_ptr<ml::train::Model> model;
+  std::shared_ptr<ml::train::Dataset> dataset;
+
+  EXPECT_NO_THROW(model =
+                    ml::train::createModel(ml::train::ModelType::NEURAL_NET));
+
+  EXPECT_NO_THROW(model->addLayer(ml::train::layer::Input(
+    {"input_shape=1:1:62720", "normalization=true"})));
+  EXPECT_NO_THROW(model->addLayer(ml::train::layer::FullyConnected(
+    {"unit= 10", "activation=softmax", "bias_initializer=zeros",
+     "weight_initializer=xavier_uniform", "input_layers=input0"})));
+  EXPECT_NO_THROW(
+    model->setOptimizer(ml::train::optimizer::SGD({"learning_rate=0.0001"})));
+
+  EXPECT_NO_THROW(
+    dataset = ml::train::createDataset(
+      ml::train::DatasetType::FILE, getTestResPath("trainingSet.dat").c_str()));
+  EXPECT_EQ(model->setDataset(ml::train::DatasetModeType::MODE_TRAIN, dataset),
+            ML_ERROR_NONE);
+
+  EXPECT_NO_THROW(
+    dataset = ml::train::createDataset(ml::train::DatasetType::FILE,
+                                       getTestResPath("valSet.dat").c_str()));
+  EXPECT_EQ(model->setDataset(ml::train::DatasetModeType::MODE_VALID, dataset),
+            ML_ERROR_NONE);
+
+  /** the last batch of each epoch has 2 samples */
+  EXPECT_NO_THROW(model->setProperty(
+    {"loss=cross", "batch_size=16", "epochs=2", "drop_last=false"}));
+
+  EXPECT_EQ(model->compile(), ML_ERROR_NONE);
+  EXPECT_EQ(model->initialize(), ML_ERROR_NONE);
+  EXPECT_NO_THROW(model->train());
+
+  EXPECT_TRUE(std::isfinite(model->getTrainingLoss()));
+  EXPECT_TRUE(std::isfinite(model->getValidationLoss()));
+
+  /** the batch size is restored after the partial batch */
+  EXPECT_NO_THROW(model->setProperty({"drop_last=true"}));
+  EXPECT_NO_THROW(model->train());
+}
+
 /**
  * @brief Neural Network Model Training
  */
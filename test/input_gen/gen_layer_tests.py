@@ -173,6 +173,12 @@ if __name__ == "__main__":
     record_single(conv, (1, 3, 11, 11), "conv2d_sb_same_dilation")
     record_single(conv, (3, 3, 11, 11), "conv2d_mb_same_dilation")
 
+    conv = K.layers.Conv2D(2, 3, padding="valid")
+    record_single(conv, (3, 3, 7, 7), "conv2d_mb_valid_3x3")
+
+    conv = K.layers.Conv2D(2, 3, padding="same")
+    record_single(conv, (3, 3, 11, 11), "conv2d_mb_same_3x3")
+
     conv = K.layers.UpSampling2D(size=(2, 2), interpolation="nearest", input_shape=(2, 2, 1))
     record_single(conv, (1, 2, 2, 1), "upsample2d_2x2_nearest")  # input_shape: n h w c
 
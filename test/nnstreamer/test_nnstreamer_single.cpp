@@ -12,11 +12,16 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <thread>
+#include <vector>
+
 #include <nnstreamer-single.h>
 #include <nnstreamer.h>
 
 #include <nntrainer_internal.h>
 #include <nntrainer_test_util.h>
+#include <tensor_filter_nntrainer.hh>
 
 static std::string mnist_model_path =
   getResPath("mnist.ini", {"test", "test_models", "models"});
@@ -49,15 +54,17 @@ protected:
 };
 
 static int singleshot_case(ml_tensors_info_h in_info,
-                           ml_tensors_info_h out_info) {
+                           ml_tensors_info_h out_info,
+                           const char *custom = nullptr) {
   ml_single_h single;
   ml_tensors_data_h in_data, out_data;
   ml_tensors_info_h queried_in_info, queried_out_info;
   int status = 0;
 
   // 1. open singleshot handle
-  status = ml_single_open(&single, mnist_model_path.c_str(), in_info, out_info,
-                          ML_NNFW_TYPE_NNTR_INF, ML_NNFW_HW_ANY);
+  status =
+    ml_single_open_full(&single, mnist_model_path.c_str(), in_info, out_info,
+                        ML_NNFW_TYPE_NNTR_INF, ML_NNFW_HW_ANY, custom);
   EXPECT_EQ(status, 0);
   if (status != 0) {
     return status;
@@ -173,6 +180,136 @@ TEST_F(mlInference, singleshot_p) {
   EXPECT_EQ(status, 0);
 }
 
+TEST_F(mlInference, singleshotBatching_p) {
+  int status = 0;
+
+  status = singleshot_case(nullptr, nullptr, "MaxBatch:4,MaxDelay:1");
+  EXPECT_EQ(status, 0) << "case: batching with a single caller";
+
+  status = singleshot_case(nullptr, nullptr, "MaxBatch:4,MaxDelay:0");
+  EXPECT_EQ(status, 0) << "case: batching without delay";
+}
+
+/**
+ * @brief run a single sample through a singleshot handle
+ *
+ * @param single singleshot handle
+ * @param input input of the sample
+ * @param[out] output output of the sample
+ * @return int ML_ERROR_NONE if success
+ */
+static int singleshot_invoke(ml_single_h single,
+                             const std::vector<float> &input,
+                             std::vector<float> &output) {
+  ml_tensors_info_h in_info;
+  ml_tensors_data_h in_data, out_data;
+  void *out_buf;
+  size_t out_size;
+
+  int status = ml_single_get_input_info(single, &in_info);
+  if (status != 0)
+    return status;
+  status = ml_tensors_data_create(in_info, &in_data);
+  ml_tensors_info_destroy(in_info);
+  if (status != 0)
+    return status;
+
+  status = ml_tensors_data_set_tensor_data(in_data, 0, input.data(),
+                                           input.size() * sizeof(float));
+  if (status == 0)
+    status = ml_single_invoke(single, in_data, &out_data);
+  ml_tensors_data_destroy(in_data);
+  if (status != 0)
+    return status;
+
+  status = ml_tensors_data_get_tensor_data(out_data, 0, &out_buf, &out_size);
+  if (status == 0) {
+    float *out = static_cast<float *>(out_buf);
+    output.assign(out, out + out_size / sizeof(float));
+  }
+  ml_tensors_data_destroy(out_data);
+  return status;
+}
+
+TEST_F(mlInference, singleshotBatchingConcurrent_p) {
+  constexpr unsigned int num_callers = 4;
+  constexpr unsigned int num_invokes = 8;
+  constexpr unsigned int max_batch = 4;
+  constexpr unsigned int in_len = 28 * 28;
+
+  auto make_input = [](unsigned int caller, unsigned int invoke) {
+    std::vector<float> input(in_len);
+    for (unsigned int i = 0; i < in_len; ++i)
+      input[i] = ((caller * 31 + invoke * 7 + i) % 17) / 17.0f;
+    return input;
+  };
+
+  /// 1. expected outputs without batching
+  std::vector<std::vector<std::vector<float>>> expected(
+    num_callers, std::vector<std::vector<float>>(num_invokes));
+  ml_single_h ref;
+  int status = ml_single_open(&ref, mnist_model_path.c_str(), nullptr,
+                              nullptr, ML_NNFW_TYPE_NNTR_INF, ML_NNFW_HW_ANY);
+  ASSERT_EQ(status, 0);
+  for (unsigned int c = 0; c < num_callers; ++c) {
+    for (unsigned int i = 0; i < num_invokes; ++i) {
+      status = singleshot_invoke(ref, make_input(c, i), expected[c][i]);
+      ASSERT_EQ(status, 0);
+    }
+  }
+  EXPECT_EQ(ml_single_close(ref), 0);
+
+  /// 2. the filters of the same model join the scheduler held here, so its
+  /// counters only cover the requests below
+  auto scheduler = NNTrainerBatchScheduler::get(
+    mnist_model_path, max_batch, std::chrono::milliseconds(20));
+
+  std::vector<ml_single_h> singles(num_callers);
+  for (auto &single : singles) {
+    status = ml_single_open_full(&single, mnist_model_path.c_str(), nullptr,
+                                 nullptr, ML_NNFW_TYPE_NNTR_INF,
+                                 ML_NNFW_HW_ANY, "MaxBatch:4,MaxDelay:20");
+    ASSERT_EQ(status, 0);
+  }
+
+  /// 3. each caller checks its own outputs
+  std::vector<int> errors(num_callers, 0);
+  std::vector<std::thread> callers;
+  for (unsigned int c = 0; c < num_callers; ++c) {
+    callers.emplace_back([&, c] {
+      for (unsigned int i = 0; i < num_invokes; ++i) {
+        std::vector<float> output;
+        if (singleshot_invoke(singles[c], make_input(c, i), output) != 0 ||
+            output.size() != expected[c][i].size()) {
+          errors[c]++;
+          continue;
+        }
+        for (unsigned int k = 0; k < output.size(); ++k) {
+          if (std::fabs(output[k] - expected[c][i][k]) > 1e-5f)
+            errors[c]++;
+        }
+      }
+    });
+  }
+  for (auto &caller : callers)
+    caller.join();
+
+  for (unsigned int c = 0; c < num_callers; ++c)
+    EXPECT_EQ(errors[c], 0) << "caller: " << c;
+
+  /// 4. the requests were coalesced and every one of them is counted
+  auto stats = scheduler->getStatistics();
+  EXPECT_EQ(stats.requests, num_callers * num_invokes);
+  EXPECT_EQ(stats.samples, num_callers * num_invokes);
+  EXPECT_LT(stats.batches, stats.requests);
+  EXPECT_GE(stats.batches * max_batch, stats.samples + stats.padded_samples);
+  EXPECT_GE(stats.total_latency_us, stats.total_queue_us);
+  EXPECT_GE(stats.max_latency_us, stats.max_queue_us);
+
+  for (auto &single : singles)
+    EXPECT_EQ(ml_single_close(single), 0);
+}
+
 TEST_F(mlInference, singleshotModelDoesNotExist_n) {
   ml_single_h single;
   ml_tensors_info_h in_info, out_info;
@@ -17,6 +17,7 @@
 #include <bn_realizer.h>
 #include <connection.h>
 #include <flatten_realizer.h>
+#include <fusion_realizer.h>
 #include <input_realizer.h>
 #include <loss_realizer.h>
 #include <multiout_realizer.h>
@@ -923,6 +924,49 @@ TEST(BnRealizer, bn_realizer_resblock_p) {
   EXPECT_NO_THROW(compileAndRealizeAndEqual(r, realizers, before, after));
 }
 
+TEST(FusionRealizer, fusion_p) {
+  std::vector<LayerRepresentation> before = {
+    {"input", {"name=input0"}},
+    {"conv2d", {"name=conv0", "kernel_size=3,3", "input_layers=input0"}},
+    {"batch_normalization",
+     {"name=bn0", "epsilon=0.01", "input_layers=conv0"}},
+    {"activation", {"name=ac0", "activation=relu", "input_layers=bn0"}},
+    {"fully_connected", {"name=fc1", "input_layers=ac0"}},
+    {"batch_normalization", {"name=bn1", "input_layers=fc1"}},
+    {"fully_connected", {"name=fc2", "input_layers=bn1"}},
+    {"activation", {"name=ac2", "activation=swish", "input_layers=fc2"}},
+  };
+  std::vector<LayerRepresentation> after = {
+    {"input", {"name=input0"}},
+    {"conv2d",
+     {"name=conv0", "kernel_size=3,3", "input_layers=input0",
+      "fused_bn_epsilon=0.01", "fused_bn_name=bn0", "fused_activation=relu"}},
+    {"fully_connected",
+     {"name=fc1", "input_layers=conv0", "fused_bn_epsilon=0.001",
+      "fused_bn_name=bn1"}},
+    {"fully_connected",
+     {"name=fc2", "input_layers=fc1", "fused_activation=swish"}},
+  };
+  FusionRealizer r;
+  EXPECT_NO_THROW(realizeAndEqual(r, before, after));
+}
+
+TEST(FusionRealizer, fusion_not_fusable_p) {
+  std::vector<LayerRepresentation> before = {
+    {"input", {"name=input0"}},
+    {"conv2d", {"name=conv0", "kernel_size=3,3", "input_layers=input0"}},
+    {"batch_normalization", {"name=bn0", "input_layers=conv0"}},
+    {"activation", {"name=ac0", "activation=relu", "input_layers=conv0"}},
+    {"addition", {"name=add0", "input_layers=bn0,ac0"}},
+    {"fully_connected", {"name=fc1", "input_layers=add0"}},
+    {"batch_normalization", {"name=bn1", "axis=3", "input_layers=fc1"}},
+    {"fully_connected", {"name=fc2", "input_layers=bn1"}},
+    {"activation", {"name=ac2", "activation=softmax", "input_layers=fc2"}},
+  };
+  FusionRealizer r;
+  EXPECT_NO_THROW(realizeAndEqual(r, before, before));
+}
+
 TEST(LossRealizer, loss_realizer_p) {
   /// realization without identifying custom input
   std::vector<LayerRepresentation> before = {
@@ -14,7 +14,78 @@
 #include <databuffer.h>
 #include <random_data_producers.h>
 
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief multi thread safe producer which fills the samples with its index
+ */
+class IndexDataProducer : public nntrainer::DataProducer {
+public:
+  IndexDataProducer(unsigned int num_samples) : num_samples(num_samples) {}
+
+  const std::string getType() const override { return "index"; }
+
+  bool isMultiThreadSafe() const override { return true; }
+
+  nntrainer::DataProducer::Generator
+  finalize(const std::vector<nntrainer::TensorDim> &input_dims,
+           const std::vector<nntrainer::TensorDim> &label_dims,
+           void *user_data = nullptr) override {
+    return [this](unsigned int idx, std::vector<nntrainer::Tensor> &inputs,
+                  std::vector<nntrainer::Tensor> &labels) {
+      inputs[0].setValue(idx);
+      labels[0].setValue(idx);
+      generated++;
+      return false;
+    };
+  }
+
+  unsigned int
+  size(const std::vector<nntrainer::TensorDim> &input_dims,
+       const std::vector<nntrainer::TensorDim> &label_dims) const override {
+    return num_samples;
+  }
+
+  void prefetch(unsigned int idx) const override {
+    std::lock_guard<std::mutex> lock(hint_mutex);
+    hinted.push_back(idx);
+  }
+
+  mutable std::vector<unsigned int> hinted; /**< prefetched indices */
+  std::atomic<unsigned int> generated = 0;  /**< number of samples filled */
+
+private:
+  unsigned int num_samples;
+  mutable std::mutex hint_mutex;
+};
+
+/**
+ * @brief fetch an epoch and return the index of the samples in order
+ */
+static std::vector<unsigned int> fetchEpoch(nntrainer::DataBuffer &db,
+                                            bool shuffle) {
+  std::vector<unsigned int> order;
+  auto future_iq = db.startFetchWorker({{4, 1, 1, 2}}, {{4, 1, 1, 1}}, shuffle);
+  while (true) {
+    auto iteration_view = db.fetch();
+    if (iteration_view.isEmpty()) {
+      break;
+    }
+    auto &inputs = iteration_view.get().getInputsRef();
+    auto &labels = iteration_view.get().getLabelsRef();
+    for (unsigned int b = 0; b < iteration_view.get().batch(); ++b) {
+      EXPECT_EQ(inputs[0].getValue(b, 0, 0, 1), labels[0].getValue(b, 0, 0, 0));
+      order.push_back(inputs[0].getValue(b, 0, 0, 0));
+    }
+  }
+  future_iq.get();
+  return order;
+}
 
 TEST(DataBuffer, getGenerator_p) {
   std::unique_ptr<nntrainer::DataProducer> prod =
@@ -89,3 +160,92 @@ TEST(DataBuffer, fetchAfterBqIsDeleted_n) {
   future_bq.get();
   EXPECT_THROW(db.fetch(), std::runtime_error);
 }
+
+TEST(DataBuffer, fetchWithMultipleWorkers_p) {
+  nntrainer::DataBuffer db(std::make_unique<IndexDataProducer>(30));
+  db.setProperty({"buffer_size=3", "num_workers=4"});
+
+  auto order = fetchEpoch(db, false);
+  ASSERT_EQ(order.size(), 30u);
+  for (unsigned int i = 0; i < order.size(); ++i) {
+    EXPECT_EQ(order[i], i);
+  }
+}
+
+TEST(DataBuffer, fetchWithMultipleWorkersShuffle_p) {
+  nntrainer::DataBuffer single(std::make_unique<IndexDataProducer>(30));
+  single.setProperty({"buffer_size=3"});
+  nntrainer::DataBuffer multi(std::make_unique<IndexDataProducer>(30));
+  multi.setProperty({"buffer_size=3", "num_workers=4"});
+
+  /// the shuffled order does not depend on the number of workers
+  for (unsigned int epoch = 0; epoch < 2; ++epoch) {
+    EXPECT_EQ(fetchEpoch(single, true), fetchEpoch(multi, true));
+  }
+}
+
+TEST(DataBuffer, fetchWithMultipleWorkersNotThreadSafe_p) {
+  std::unique_ptr<nntrainer::DataProducer> prod =
+    std::make_unique<nntrainer::RandomDataOneHotProducer>();
+
+  nntrainer::DataBuffer db(std::move(prod));
+  db.setProperty(
+    {"buffer_size=2", "num_workers=4", "min=1", "max=2", "num_samples=10"});
+
+  /// falls back to a single worker
+  auto future_iq = db.startFetchWorker({{3, 1, 1, 2}}, {{3, 1, 1, 1}});
+  unsigned int num_samples = 0;
+  while (true) {
+    auto iteration_view = db.fetch();
+    if (iteration_view.isEmpty()) {
+      break;
+    }
+    num_samples += iteration_view.get().batch();
+  }
+  future_iq.get();
+  EXPECT_EQ(num_samples, 10u);
+}
+
+TEST(DataBuffer, prefetchInFetchOrder_p) {
+  auto prod = std::make_unique<IndexDataProducer>(30);
+  auto &hinted = prod->hinted;
+  nntrainer::DataBuffer db(std::move(prod));
+  db.setProperty({"buffer_size=3"});
+
+  /// every sample is hinted once, ahead of the samples being fetched
+  auto order = fetchEpoch(db, true);
+  EXPECT_EQ(hinted, order);
+}
+
+TEST(DataBuffer, stageNextBatch_p) {
+  auto prod = std::make_unique<IndexDataProducer>(8);
+  auto &generated = prod->generated;
+  nntrainer::DataBuffer db(std::move(prod));
+
+  /// with the default buffer size, the next batch is filled in its own slot
+  /// while the current batch is held by the model
+  auto future_iq =
+    db.startFetchWorker({{4, 1, 1, 2}}, {{4, 1, 1, 1}}, false);
+  {
+    auto current = db.fetch();
+    ASSERT_FALSE(current.isEmpty());
+    for (unsigned int i = 0; i < 500 && generated < 8; ++i)
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    ASSERT_EQ(generated, 8u);
+
+    auto next = db.fetch();
+    ASSERT_FALSE(next.isEmpty());
+    auto &current_input = current.get().getInputsRef()[0];
+    auto &next_input = next.get().getInputsRef()[0];
+    EXPECT_NE(current_input.getData(), next_input.getData());
+    EXPECT_EQ(current_input.getValue(0, 0, 0, 0), 0.0f);
+    EXPECT_EQ(next_input.getValue(0, 0, 0, 0), 4.0f);
+  }
+  EXPECT_TRUE(db.fetch().isEmpty());
+  future_iq.get();
+}
+
+TEST(DataBuffer, setNumWorkers_n) {
+  nntrainer::DataBuffer db(std::make_unique<IndexDataProducer>(30));
+  EXPECT_THROW(db.setProperty({"num_workers=0"}), std::invalid_argument);
+}
@@ -12,6 +12,9 @@
 
 #include <gtest/gtest.h>
 
+#include <fstream>
+#include <future>
+
 #include <data_producer_common_tests.h>
 #include <raw_file_data_producer.h>
 #include <tensor.h>
@@ -55,3 +58,47 @@ auto batch_too_big = DataProducerSemanticsParamType(
 
 GTEST_PARAMETER_TEST(RawFile, DataProducerSemantics,
                      ::testing::Values(training_set, valSet, testSet));
+
+TEST(RawFile, readFromMapping_p) {
+  nntrainer::RawFileDataProducer producer(getTestResPath("valSet.dat"));
+  std::vector<nntrainer::TensorDim> input_dims = {{1, 3, 32, 32}};
+  std::vector<nntrainer::TensorDim> label_dims = {{1, 1, 1, 10}};
+
+  EXPECT_TRUE(producer.isMultiThreadSafe());
+  auto generator = producer.finalize(input_dims, label_dims);
+  auto sz = producer.size(input_dims, label_dims);
+  ASSERT_GT(sz, 3u);
+
+  /// hints only load the pages, an index out of the file is ignored
+  producer.prefetch(3);
+  producer.prefetch(sz - 1);
+  producer.prefetch(sz + 100);
+
+  /// read samples from two threads and compare with the stream read
+  auto read = [&](unsigned int idx) {
+    std::vector<nntrainer::Tensor> inputs = {nntrainer::Tensor(input_dims[0])};
+    std::vector<nntrainer::Tensor> labels = {nntrainer::Tensor(label_dims[0])};
+    generator(idx, inputs, labels);
+    return std::make_pair(inputs[0], labels[0]);
+  };
+  auto other = std::async(std::launch::async, read, sz - 1);
+  auto sample = read(3);
+
+  std::ifstream file(getTestResPath("valSet.dat"), std::ios::binary);
+  auto check = [&](unsigned int idx, const nntrainer::Tensor &input,
+                   const nntrainer::Tensor &label) {
+    nntrainer::Tensor expected_input(input_dims[0]);
+    nntrainer::Tensor expected_label(label_dims[0]);
+    file.seekg(static_cast<std::streamoff>(idx) *
+                 (expected_input.bytes() + expected_label.bytes()),
+               std::ios_base::beg);
+    expected_input.read(file);
+    expected_label.read(file);
+    EXPECT_EQ(input, expected_input);
+    EXPECT_EQ(label, expected_label);
+  };
+
+  check(3, sample.first, sample.second);
+  auto last = other.get();
+  check(sz - 1, last.first, last.second);
+}
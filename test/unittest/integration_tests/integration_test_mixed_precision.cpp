@@ -17,6 +17,7 @@
 #include <app_context.h>
 #include <layer.h>
 #include <lite/core/c/common.h>
+#include <loss_scaler.h>
 #include <model.h>
 #include <neuralnet.h>
 #include <nntrainer_test_util.h>
@@ -114,6 +115,58 @@ TEST(mixed_precision, loss_scale_test) {
     {"batch_size=1", "model_tensor_type=FP16-FP16", "loss_scale=65536"}));
 }
 
+TEST(mixed_precision, loss_scaler_skip_overflow_test) {
+  std::unique_ptr<NeuralNetwork> nn(new NeuralNetwork());
+  nn->setProperty({"batch_size=1", "loss=mse", "model_tensor_type=FP16-FP16",
+                   "loss_scale=65536", "loss_scale_on_overflow=skip"});
+  nn->setOptimizer(ml::train::createOptimizer("sgd", {"learning_rate=0.1"}));
+
+  auto graph = makeGraph({
+    {"input", {"name=in", "input_shape=1:1:4"}},
+    {"fully_connected", {"name=fc", "unit=2"}},
+  });
+  for (auto &node : graph) {
+    nn->addLayer(node);
+  }
+
+  EXPECT_EQ(nn->compile(), ML_ERROR_NONE);
+  EXPECT_EQ(nn->initialize(), ML_ERROR_NONE);
+  EXPECT_EQ(nn->allocate(ml::train::ExecutionMode::TRAIN), ML_ERROR_NONE);
+
+  std::shared_ptr<LayerNode> fc;
+  for (auto &node : nn->getFlatGraph()) {
+    if (node->getName() == "fc")
+      fc = node;
+  }
+  ASSERT_NE(fc, nullptr);
+  auto &rc = fc->getRunContext();
+  std::vector<Tensor> before;
+  for (unsigned int i = 0; i < rc.getNumWeights(); ++i)
+    before.push_back(rc.getWeight(i).clone(TensorDim::DataType::FP32));
+
+  /** the scaled gradients do not fit in FP16 */
+  auto x = std::make_shared<Tensor>(
+    TensorDim(1, 1, 1, 4, {Tformat::NCHW, TensorDim::DataType::FP16}));
+  x->setValue(60000.0f);
+  auto y = std::make_shared<Tensor>(
+    TensorDim(1, 1, 1, 2, {Tformat::NCHW, TensorDim::DataType::FP16}));
+  y->setValue(0.0f);
+
+  nn->forwarding({x}, {y});
+  nn->backwarding(1);
+
+  auto model_graph = nn->getNetworkGraph();
+  auto &scaler = model_graph.getLossScaler();
+  EXPECT_EQ(scaler.getNumOverflows(), 1u);
+  EXPECT_FLOAT_EQ(scaler.getScale(), 32768.0f);
+
+  /** the step is skipped, so the weights are left as they were */
+  for (unsigned int i = 0; i < rc.getNumWeights(); ++i) {
+    Tensor after = rc.getWeight(i).clone(TensorDim::DataType::FP32);
+    EXPECT_EQ(after, before[i]) << rc.getWeightName(i);
+  }
+}
+
 TEST(mixed_precision, model_tensor_type_test) {
   std::unique_ptr<ml::train::Model> nn =
     ml::train::createModel(ml::train::ModelType::NEURAL_NET, {"loss=mse"});
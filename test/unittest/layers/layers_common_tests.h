@@ -104,15 +104,15 @@ typedef enum {
   SKIP_CALC_DERIV = 1 << 1, /**< skip calculating derivative and compare */
   USE_INC_FORWARD = 1 << 2, /**< use incremental forwarding and compare */
 
-  FORWARD_MODE_INFERENCE =
-    1 << 2, /**< set if layer should be forwarded with inference mode */
-
   DROPOUT_MATCH_60_PERCENT = 1 << 3, /**< set if only 60 percentage output
                                match is sufficient for dropout */
 
   SKIP_COSINE_SIMILARITY =
     1 << 4, /**< skip for zero error but large cos similarity case for now*/
 
+  FORWARD_MODE_INFERENCE =
+    1 << 5, /**< set if layer should be forwarded with inference mode */
+
   DEFAULT =
     0, /**< default set up, compare forward, backward in training mode */
 } LayerGoldenTestParamOptions;
@@ -210,6 +210,18 @@ auto conv1d_mb_causal_dilation = LayerGoldenTestParamType(
   "conv1d_mb_causal_dilation.nnlayergolden",
   LayerGoldenTestParamOptions::DEFAULT, "nchw", "fp32", "fp32");
 
+auto conv1d_mb_same_dilation_im2col = LayerGoldenTestParamType(
+  nntrainer::createLayer<nntrainer::Conv1DLayer>,
+  {
+    "filters=2",
+    "kernel_size=3",
+    "padding=same",
+    "dilation=2",
+    "conv_algorithm=im2col",
+  },
+  "3:3:1:11", "conv1d_mb_same_dilation.nnlayergolden",
+  LayerGoldenTestParamOptions::DEFAULT, "nchw", "fp32", "fp32");
+
 GTEST_PARAMETER_TEST(
   Convolution1D, LayerGoldenTest,
   ::testing::Values(conv1d_sb_minimum, conv1d_mb_minimum, conv1d_sb_same_remain,
@@ -222,4 +234,5 @@ GTEST_PARAMETER_TEST(
                     conv1d_sb_1x1_kernel, conv1d_mb_1x1_kernel,
                     conv1d_sb_dilation, conv1d_mb_dilation,
                     conv1d_sb_same_dilation, conv1d_mb_same_dilation,
-                    conv1d_sb_causal_dilation, conv1d_mb_causal_dilation));
+                    conv1d_sb_causal_dilation, conv1d_mb_causal_dilation,
+                    conv1d_mb_same_dilation_im2col));
@@ -188,6 +188,84 @@ auto conv2d_mb_same_dilation = LayerGoldenTestParamType(
   "3:3:11:11", "conv2d_mb_same_dilation.nnlayergolden",
   LayerGoldenTestParamOptions::DEFAULT, "nchw", "fp32", "fp32");
 
+auto conv2d_sb_same_remain_winograd = LayerGoldenTestParamType(
+  nntrainer::createLayer<nntrainer::Conv2DLayer>,
+  {"filters=2", "kernel_size=3,3", "padding=same", "conv_algorithm=winograd"},
+  "1:1:4:4", "conv2d_sb_same_remain.nnlayergolden",
+  LayerGoldenTestParamOptions::DEFAULT, "nchw", "fp32", "fp32");
+
+auto conv2d_mb_same_remain_winograd = LayerGoldenTestParamType(
+  nntrainer::createLayer<nntrainer::Conv2DLayer>,
+  {"filters=2", "kernel_size=3,3", "padding=same", "conv_algorithm=winograd"},
+  "3:1:4:4", "conv2d_mb_same_remain.nnlayergolden",
+  LayerGoldenTestParamOptions::DEFAULT, "nchw", "fp32", "fp32");
+
+auto conv2d_mb_same_remain_im2col = LayerGoldenTestParamType(
+  nntrainer::createLayer<nntrainer::Conv2DLayer>,
+  {"filters=2", "kernel_size=3,3", "padding=same", "conv_algorithm=im2col"},
+  "3:1:4:4", "conv2d_mb_same_remain.nnlayergolden",
+  LayerGoldenTestParamOptions::DEFAULT, "nchw", "fp32", "fp32");
+
+auto conv2d_mb_valid_drop_last_im2col = LayerGoldenTestParamType(
+  nntrainer::createLayer<nntrainer::Conv2DLayer>,
+  {
+    "filters=2",
+    "kernel_size=3,3",
+    "stride=2,2",
+    "padding=valid",
+    "conv_algorithm=im2col",
+  },
+  "3:3:7:7", "conv2d_mb_valid_drop_last.nnlayergolden",
+  LayerGoldenTestParamOptions::DEFAULT, "nchw", "fp32", "fp32");
+
+auto conv2d_mb_same_dilation_im2col = LayerGoldenTestParamType(
+  nntrainer::createLayer<nntrainer::Conv2DLayer>,
+  {
+    "filters=2",
+    "kernel_size=3,3",
+    "padding=same",
+    "dilation=2,2",
+    "conv_algorithm=im2col",
+  },
+  "3:3:11:11", "conv2d_mb_same_dilation.nnlayergolden",
+  LayerGoldenTestParamOptions::DEFAULT, "nchw", "fp32", "fp32");
+
+auto conv2d_mb_valid_3x3 = LayerGoldenTestParamType(
+  nntrainer::createLayer<nntrainer::Conv2DLayer>,
+  {"filters=2", "kernel_size=3,3", "padding=valid"}, "3:3:7:7",
+  "conv2d_mb_valid_3x3.nnlayergolden", LayerGoldenTestParamOptions::DEFAULT,
+  "nchw", "fp32", "fp32");
+
+auto conv2d_mb_valid_3x3_winograd = LayerGoldenTestParamType(
+  nntrainer::createLayer<nntrainer::Conv2DLayer>,
+  {"filters=2", "kernel_size=3,3", "padding=valid", "conv_algorithm=winograd"},
+  "3:3:7:7", "conv2d_mb_valid_3x3.nnlayergolden",
+  LayerGoldenTestParamOptions::DEFAULT, "nchw", "fp32", "fp32");
+
+auto conv2d_mb_valid_3x3_im2col = LayerGoldenTestParamType(
+  nntrainer::createLayer<nntrainer::Conv2DLayer>,
+  {"filters=2", "kernel_size=3,3", "padding=valid", "conv_algorithm=im2col"},
+  "3:3:7:7", "conv2d_mb_valid_3x3.nnlayergolden",
+  LayerGoldenTestParamOptions::DEFAULT, "nchw", "fp32", "fp32");
+
+auto conv2d_mb_same_3x3 = LayerGoldenTestParamType(
+  nntrainer::createLayer<nntrainer::Conv2DLayer>,
+  {"filters=2", "kernel_size=3,3", "padding=same"}, "3:3:11:11",
+  "conv2d_mb_same_3x3.nnlayergolden", LayerGoldenTestParamOptions::DEFAULT,
+  "nchw", "fp32", "fp32");
+
+auto conv2d_mb_same_3x3_winograd = LayerGoldenTestParamType(
+  nntrainer::createLayer<nntrainer::Conv2DLayer>,
+  {"filters=2", "kernel_size=3,3", "padding=same", "conv_algorithm=winograd"},
+  "3:3:11:11", "conv2d_mb_same_3x3.nnlayergolden",
+  LayerGoldenTestParamOptions::DEFAULT, "nchw", "fp32", "fp32");
+
+auto conv2d_mb_same_3x3_im2col = LayerGoldenTestParamType(
+  nntrainer::createLayer<nntrainer::Conv2DLayer>,
+  {"filters=2", "kernel_size=3,3", "padding=same", "conv_algorithm=im2col"},
+  "3:3:11:11", "conv2d_mb_same_3x3.nnlayergolden",
+  LayerGoldenTestParamOptions::DEFAULT, "nchw", "fp32", "fp32");
+
 GTEST_PARAMETER_TEST(
   Convolution2D, LayerGoldenTest,
   ::testing::Values(
@@ -197,7 +275,13 @@ GTEST_PARAMETER_TEST(
     conv2d_mb_same_uneven_remain_2, conv2d_sb_valid_drop_last,
     conv2d_mb_valid_drop_last, conv2d_sb_no_overlap, conv2d_mb_no_overlap,
     conv2d_sb_1x1_kernel, conv2d_mb_1x1_kernel, conv2d_sb_dilation,
-    conv2d_mb_dilation, conv2d_sb_same_dilation, conv2d_mb_same_dilation));
+    conv2d_mb_dilation, conv2d_sb_same_dilation, conv2d_mb_same_dilation,
+    conv2d_sb_same_remain_winograd, conv2d_mb_same_remain_winograd,
+    conv2d_mb_same_remain_im2col, conv2d_mb_valid_drop_last_im2col,
+    conv2d_mb_same_dilation_im2col, conv2d_mb_valid_3x3,
+    conv2d_mb_valid_3x3_winograd, conv2d_mb_valid_3x3_im2col,
+    conv2d_mb_same_3x3, conv2d_mb_same_3x3_winograd,
+    conv2d_mb_same_3x3_im2col));
 
 #ifdef ENABLE_FP16
 auto conv2d_sb_minimum_w16a16 = LayerGoldenTestParamType(
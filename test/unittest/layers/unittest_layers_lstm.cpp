@@ -14,7 +14,11 @@
 #include <gtest/gtest.h>
 
 #include <layers_common_tests.h>
+#include <layer_context.h>
 #include <lstm.h>
+#include <nntr_threads.h>
+#include <var_grad.h>
+#include <weight.h>
 
 auto semantic_lstm = LayerSemanticsParamType(
   nntrainer::createLayer<nntrainer::LSTMLayer>, nntrainer::LSTMLayer::type,
@@ -114,3 +118,96 @@ GTEST_PARAMETER_TEST(LSTM16, LayerGoldenTest,
                                        lstm_multi_step_seq_act_orig_w16a16,
                                        lstm_multi_step_seq_act_w16a16));
 #endif
+
+/**
+ * @brief fill the tensor with a fixed pattern in [-0.5, 0.5)
+ */
+static void fillPattern(nntrainer::Tensor &t, unsigned int seed) {
+  float *data = t.getData<float>();
+  for (size_t i = 0; i < t.size(); ++i) {
+    data[i] = static_cast<float>((i * 7 + seed) % 23) / 23.0f - 0.5f;
+  }
+}
+
+/**
+ * @brief run forwarding, calcGradient and calcDerivative of a bidirectional
+ * lstm on @a num_threads threads
+ *
+ * @return std::vector<nntrainer::Tensor> output, outgoing derivative and
+ * weight gradients
+ */
+static std::vector<nntrainer::Tensor> runLSTM(unsigned int num_threads) {
+  nntrainer::ThreadPool &pool = nntrainer::ThreadPool::Global();
+  const unsigned int prev_num_threads = pool.getNumThreads();
+  pool.setNumThreads(num_threads);
+
+  /// every forEachBatchChunk() call costs 1 << 14 per sample, so the batch
+  /// of 8 is split in 4 chunks of 2 samples on 4 threads
+  auto layer = nntrainer::createLayer<nntrainer::LSTMLayer>(
+    {"unit=64", "integrate_bias=true", "return_sequences=true",
+     "bidirectional=true"});
+  nntrainer::InitLayerContext ic({nntrainer::TensorDim(8, 1, 4, 16)}, {true},
+                                 false, "lstm_chunk");
+  layer->finalize(ic);
+
+  std::vector<nntrainer::Weight> weights;
+  std::vector<nntrainer::Var_Grad> ins, outs, tensors;
+  weights.reserve(ic.getWeightsSpec().size());
+  for (auto &spec : ic.getWeightsSpec()) {
+    weights.emplace_back(spec, true);
+    fillPattern(weights.back().getVariableRef(), weights.size());
+    weights.back().getGradientRef().setZero();
+  }
+  for (auto &dim : ic.getInputDimensions()) {
+    ins.emplace_back(dim, nntrainer::Initializer::NONE, true, true, "in");
+    fillPattern(ins.back().getVariableRef(), 0);
+  }
+  for (auto &spec : ic.getOutSpecs()) {
+    outs.emplace_back(spec.variable_spec.dim, nntrainer::Initializer::NONE,
+                      true, true, "out");
+    outs.back().getGradientRef().setValue(2.0f);
+  }
+  tensors.reserve(ic.getTensorsSpec().size());
+  for (auto &spec : ic.getTensorsSpec()) {
+    tensors.emplace_back(spec, true);
+  }
+
+  auto view = [](auto &var_grads) {
+    std::vector<std::add_pointer_t<
+      typename std::decay_t<decltype(var_grads)>::value_type>>
+      ret;
+    for (auto &vg : var_grads) {
+      ret.push_back(&vg);
+    }
+    return ret;
+  };
+  nntrainer::RunLayerContext rc("lstm_chunk", true, 0.0f, false, 1.0, false,
+                                view(weights), view(ins), view(outs),
+                                view(tensors));
+
+  layer->forwarding(rc, true);
+  layer->calcGradient(rc);
+  layer->calcDerivative(rc);
+
+  std::vector<nntrainer::Tensor> result = {
+    rc.getOutput(0).clone(), rc.getOutgoingDerivative(0).clone()};
+  for (unsigned int i = 0; i < rc.getNumWeights(); ++i) {
+    result.push_back(rc.getWeightGrad(i).clone());
+  }
+
+  pool.setNumThreads(prev_num_threads);
+  return result;
+}
+
+/**
+ * @brief the batch split on the threads must give the single chunk result
+ */
+TEST(LSTM, batch_chunks_match_single_chunk_p) {
+  std::vector<nntrainer::Tensor> single_chunk = runLSTM(1);
+  std::vector<nntrainer::Tensor> multi_chunk = runLSTM(4);
+
+  ASSERT_EQ(single_chunk.size(), multi_chunk.size());
+  for (size_t i = 0; i < single_chunk.size(); ++i) {
+    EXPECT_EQ(single_chunk[i], multi_chunk[i]) << "tensor " << i;
+  }
+}
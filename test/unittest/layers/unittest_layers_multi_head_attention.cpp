@@ -71,12 +71,29 @@ auto multi_head_attention_output_shape = LayerGoldenTestParamType(
   "2:1:5:7,2:1:3:7,2:1:3:7", "multi_head_attention_output_shape.nnlayergolden",
   no_cos_sim_option, "nchw", "fp32", "fp32");
 
+auto fused_inference_option =
+  inference_only_option | LayerGoldenTestParamOptions::FORWARD_MODE_INFERENCE;
+
+auto multi_head_attention_fused_inference = LayerGoldenTestParamType(
+  nntrainer::createLayer<nntrainer::MultiHeadAttentionLayer>,
+  {"num_heads=2", "projected_key_dim=3"}, "2:1:5:7,2:1:3:7,2:1:3:7",
+  "multi_head_attention.nnlayergolden", fused_inference_option, "nchw", "fp32",
+  "fp32");
+
+auto multi_head_attention_value_dim_fused_inference = LayerGoldenTestParamType(
+  nntrainer::createLayer<nntrainer::MultiHeadAttentionLayer>,
+  {"num_heads=2", "projected_key_dim=3", "projected_value_dim=5"},
+  "2:1:5:7,2:1:3:7,2:1:3:7", "multi_head_attention_value_dim.nnlayergolden",
+  fused_inference_option, "nchw", "fp32", "fp32");
+
 GTEST_PARAMETER_TEST(
   MultiHeadAttention, LayerGoldenTest,
   ::testing::Values(multi_head_attention_single_batch, multi_head_attention,
                     multi_head_attention_return_attention_scores,
                     multi_head_attention_value_dim,
-                    multi_head_attention_output_shape));
+                    multi_head_attention_output_shape,
+                    multi_head_attention_fused_inference,
+                    multi_head_attention_value_dim_fused_inference));
 #ifdef ENABLE_FP16
 auto multi_head_attention_single_batch_w16a16 = LayerGoldenTestParamType(
   nntrainer::createLayer<nntrainer::MultiHeadAttentionLayer>,
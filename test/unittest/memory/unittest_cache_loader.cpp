@@ -646,6 +646,54 @@ TEST_F(CacheLoaderTest, load_async_03_p) {
   delete p;
 }
 
+/**
+ * @brief load asynchronously ahead, keeping the window in the budget
+ */
+TEST_F(CacheLoaderTest, load_async_window_01_p) {
+  std::shared_ptr<nntrainer::MemoryData> mem1, mem2, mem3;
+  auto idx1 = pool->requestMemory(4, 1, 5, {1, 5});
+  auto idx2 = pool->requestMemory(4, 2, 3, {2});
+  auto idx3 = pool->requestMemory(4, 3, 4, {3});
+  EXPECT_NO_THROW(pool->planLayout(nntrainer::OptimizedV1Planner()));
+  EXPECT_NO_THROW(pool->allocate());
+  EXPECT_NO_THROW(mem1 = pool->getMemory(idx1));
+  EXPECT_NO_THROW(mem2 = pool->getMemory(idx2));
+  EXPECT_NO_THROW(mem3 = pool->getMemory(idx3));
+
+  std::promise<void> p1, p2;
+  auto noop = [](int id, nntrainer::TaskExecutor::CompleteStatus status) {};
+  auto complete1 = [&p1](int id,
+                         nntrainer::TaskExecutor::CompleteStatus status) {
+    EXPECT_EQ(status, nntrainer::TaskExecutor::SUCCESS);
+    p1.set_value();
+  };
+  auto complete2 = [&p2](int id,
+                         nntrainer::TaskExecutor::CompleteStatus status) {
+    EXPECT_EQ(status, nntrainer::TaskExecutor::SUCCESS);
+    p2.set_value();
+  };
+
+  /** orders 2 and 3 are loaded ahead while order 1 runs */
+  pool->loadExec(1);
+  EXPECT_GT(loader->loadAsync(2, 1, 12, noop), 0);
+  EXPECT_GT(loader->loadAsync(3, 1, 12, complete1), 0);
+  p1.get_future().wait();
+
+  EXPECT_NE(mem1->getAddr(), nullptr);
+  EXPECT_NE(mem2->getAddr(), nullptr);
+  EXPECT_NE(mem3->getAddr(), nullptr);
+
+  /** mem2 is not used anymore, mem1 is kept as it fits in the budget */
+  EXPECT_GT(loader->loadAsync(4, 3, 8, complete2), 0);
+  p2.get_future().wait();
+
+  EXPECT_NE(mem1->getAddr(), nullptr);
+  EXPECT_EQ(mem2->getAddr(), nullptr);
+  EXPECT_NE(mem3->getAddr(), nullptr);
+
+  pool->flush();
+}
+
 /**
  * TODO: cancel and timeout logic test
  */
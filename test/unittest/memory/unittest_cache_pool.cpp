@@ -636,3 +636,72 @@ TEST_F(CachePoolTest, load_unload_actives_01_p) {
 
   EXPECT_NO_THROW(pool->deallocate());
 }
+
+/**
+ * @brief evict cache data by the next use
+ */
+TEST_F(CachePoolTest, evictExcept_01_p) {
+  EXPECT_CALL(*pool, validate).Times(testing::AtLeast(4));
+  EXPECT_CALL(*pool, invalidate).Times(testing::AtLeast(0));
+
+  std::shared_ptr<nntrainer::MemoryData> mem1, mem2, mem3, mem4;
+  auto idx1 = pool->requestMemory(4, 1, 6, {1, 6});
+  auto idx2 = pool->requestMemory(4, 2, 9, {2, 9});
+  auto idx3 = pool->requestMemory(4, 3, 4, {3});
+  auto idx4 = pool->requestMemory(4, 4, 5, {4});
+  EXPECT_NO_THROW(pool->planLayout(nntrainer::OptimizedV1Planner()));
+  EXPECT_NO_THROW(pool->allocate());
+  EXPECT_NO_THROW(mem1 = pool->getMemory(idx1));
+  EXPECT_NO_THROW(mem2 = pool->getMemory(idx2));
+  EXPECT_NO_THROW(mem3 = pool->getMemory(idx3));
+  EXPECT_NO_THROW(mem4 = pool->getMemory(idx4));
+
+  pool->loadExec(1);
+  pool->loadExec(2);
+  pool->loadExec(3);
+  EXPECT_EQ(pool->residentSize(), 12u);
+
+  /** mem4 is loaded next, mem2 is used later than mem1 */
+  pool->evictExcept(3, 4, 12);
+  EXPECT_NE(mem1->getAddr<float>(), nullptr);
+  EXPECT_EQ(mem2->getAddr<float>(), nullptr);
+  EXPECT_NE(mem3->getAddr<float>(), nullptr);
+  pool->loadExec(4);
+  EXPECT_EQ(pool->residentSize(), 12u);
+
+  /** the window is kept even over the budget */
+  pool->evictExcept(3, 4, 4);
+  EXPECT_EQ(mem1->getAddr<float>(), nullptr);
+  EXPECT_NE(mem3->getAddr<float>(), nullptr);
+  EXPECT_NE(mem4->getAddr<float>(), nullptr);
+
+  /** no budget evicts all out of the window */
+  pool->loadExec(1);
+  pool->evictExcept(4, 5, 0);
+  EXPECT_EQ(mem1->getAddr<float>(), nullptr);
+  EXPECT_EQ(mem3->getAddr<float>(), nullptr);
+  EXPECT_NE(mem4->getAddr<float>(), nullptr);
+
+  EXPECT_NO_THROW(pool->deallocate());
+}
+
+/**
+ * @brief peak size of the cache data in consecutive execution orders
+ */
+TEST_F(CachePoolTest, getPeakWindowSize_01_p) {
+  pool->requestMemory(4, 1, 5, {1, 2, 3, 4, 5});
+  pool->requestMemory(8, 3, 8, {3, 4, 5, 6, 7, 8});
+  pool->requestMemory(16, 2, 4, {2, 3, 4});
+  pool->requestMemory(32, 8, 9, {8, 9});
+  EXPECT_NO_THROW(pool->planLayout(nntrainer::OptimizedV1Planner()));
+  EXPECT_NO_THROW(pool->allocate());
+  for (unsigned int idx = 1; idx <= 4; ++idx)
+    EXPECT_NO_THROW(pool->getMemory(idx));
+
+  EXPECT_EQ(pool->getPeakWindowSize(1), 40u);
+  EXPECT_EQ(pool->getPeakWindowSize(2), 40u);
+  EXPECT_EQ(pool->getPeakWindowSize(5), 60u);
+  EXPECT_EQ(pool->getPeakWindowSize(9), 60u);
+
+  EXPECT_NO_THROW(pool->deallocate());
+}
@@ -0,0 +1,250 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file unittest_kv_cache_manager.cpp
+ * @date 18 October 2026
+ * @brief Paged KV Cache Manager Test
+ * @see	https://github.com/nnstreamer/nntrainer
+ * @bug No known bugs except for NYI items
+ */
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <blas_interface.h>
+#include <kv_cache_manager.h>
+#include <nntrainer_test_util.h>
+
+using nntrainer::KVCacheManager;
+
+static constexpr unsigned int KEY_WIDTH = 4;
+static constexpr unsigned int VALUE_WIDTH = 2;
+
+/**
+ * @brief fill the key and value of the token of the sequence with val
+ */
+static void writeToken(KVCacheManager &kv, unsigned int seq, unsigned int pos,
+                       float val) {
+  std::fill_n(kv.getKey(0, seq, pos), KEY_WIDTH, val);
+  std::fill_n(kv.getValue(0, seq, pos), VALUE_WIDTH, val);
+}
+
+/**
+ * @brief append tokens of val to the sequence in a step
+ */
+static void appendTokens(KVCacheManager &kv, unsigned int seq,
+                         unsigned int len, float val) {
+  unsigned int from = kv.getLength(seq);
+  kv.beginStep({seq}, len);
+  for (unsigned int i = 0; i < len; ++i)
+    writeToken(kv, seq, from + i, val);
+  kv.endStep();
+}
+
+/**
+ * @brief Create kv cache manager with invalid arguments
+ */
+TEST(KVCacheManager, create_n) {
+  EXPECT_THROW(KVCacheManager(0, 4), std::invalid_argument);
+  EXPECT_THROW(KVCacheManager(4, 0), std::invalid_argument);
+}
+
+/**
+ * @brief Register the same layer twice
+ */
+TEST(KVCacheManager, register_layer_p) {
+  KVCacheManager kv(4, 4);
+  EXPECT_EQ(kv.registerLayer("a", KEY_WIDTH, VALUE_WIDTH,
+                             ml::train::TensorDim::DataType::FP32),
+            0u);
+  EXPECT_EQ(kv.registerLayer("b", KEY_WIDTH, VALUE_WIDTH,
+                             ml::train::TensorDim::DataType::FP32),
+            1u);
+  EXPECT_EQ(kv.registerLayer("a", KEY_WIDTH, VALUE_WIDTH,
+                             ml::train::TensorDim::DataType::FP32),
+            0u);
+  EXPECT_THROW(kv.registerLayer("a", KEY_WIDTH, VALUE_WIDTH + 1,
+                                ml::train::TensorDim::DataType::FP32),
+               std::invalid_argument);
+}
+
+/**
+ * @brief Pages are reserved as the sequence grows
+ */
+TEST(KVCacheManager, append_p) {
+  KVCacheManager kv(4, 4);
+  kv.registerLayer("a", KEY_WIDTH, VALUE_WIDTH,
+                   ml::train::TensorDim::DataType::FP32);
+
+  unsigned int seq = kv.createSequence();
+  appendTokens(kv, seq, 3, 1.0f);
+  EXPECT_EQ(kv.getLength(seq), 3u);
+  EXPECT_EQ(kv.getPageTable(seq).size(), 1u);
+  EXPECT_EQ(kv.getNumFreePages(), 3u);
+
+  appendTokens(kv, seq, 6, 2.0f);
+  EXPECT_EQ(kv.getLength(seq), 9u);
+  EXPECT_EQ(kv.getPageTable(seq).size(), 3u);
+  EXPECT_EQ(kv.getNumFreePages(), 1u);
+  EXPECT_FLOAT_EQ(kv.getKey(0, seq, 2)[0], 1.0f);
+  EXPECT_FLOAT_EQ(kv.getValue(0, seq, 8)[1], 2.0f);
+
+  kv.releaseSequence(seq);
+  EXPECT_EQ(kv.getNumFreePages(), 4u);
+}
+
+/**
+ * @brief A discarded step does not grow the sequence
+ */
+TEST(KVCacheManager, discard_step_p) {
+  KVCacheManager kv(4, 4);
+  kv.registerLayer("a", KEY_WIDTH, VALUE_WIDTH,
+                   ml::train::TensorDim::DataType::FP32);
+
+  unsigned int seq = kv.createSequence();
+  kv.beginStep({seq}, 2);
+  EXPECT_TRUE(kv.inStep());
+  EXPECT_EQ(kv.getStepLength(), 2u);
+  kv.endStep(false);
+
+  EXPECT_FALSE(kv.inStep());
+  EXPECT_EQ(kv.getLength(seq), 0u);
+}
+
+/**
+ * @brief Forked sequence shares the pages until it writes to them
+ */
+TEST(KVCacheManager, fork_copy_on_write_p) {
+  KVCacheManager kv(4, 8);
+  kv.registerLayer("a", KEY_WIDTH, VALUE_WIDTH,
+                   ml::train::TensorDim::DataType::FP32);
+
+  unsigned int parent = kv.createSequence();
+  appendTokens(kv, parent, 6, 1.0f);
+  EXPECT_EQ(kv.getNumFreePages(), 6u);
+
+  unsigned int child = kv.forkSequence(parent);
+  EXPECT_EQ(kv.getLength(child), 6u);
+  EXPECT_EQ(kv.getPageTable(child), kv.getPageTable(parent));
+  EXPECT_EQ(kv.getNumFreePages(), 6u);
+
+  /** the second page is shared, so it is copied before being written */
+  appendTokens(kv, child, 1, 2.0f);
+  EXPECT_EQ(kv.getPageTable(child)[0], kv.getPageTable(parent)[0]);
+  EXPECT_NE(kv.getPageTable(child)[1], kv.getPageTable(parent)[1]);
+  EXPECT_EQ(kv.getNumFreePages(), 5u);
+
+  EXPECT_FLOAT_EQ(kv.getKey(0, child, 5)[0], 1.0f);
+  EXPECT_FLOAT_EQ(kv.getKey(0, child, 6)[0], 2.0f);
+
+  appendTokens(kv, parent, 1, 3.0f);
+  EXPECT_FLOAT_EQ(kv.getKey(0, parent, 6)[0], 3.0f);
+  EXPECT_FLOAT_EQ(kv.getKey(0, child, 6)[0], 2.0f);
+
+  kv.releaseSequence(parent);
+  EXPECT_EQ(kv.getNumFreePages(), 6u);
+  kv.releaseSequence(child);
+  EXPECT_EQ(kv.getNumFreePages(), 8u);
+}
+
+/**
+ * @brief The least recently used sequence is evicted when out of pages
+ */
+TEST(KVCacheManager, evict_p) {
+  KVCacheManager kv(2, 4);
+  kv.registerLayer("a", KEY_WIDTH, VALUE_WIDTH,
+                   ml::train::TensorDim::DataType::FP32);
+
+  unsigned int a = kv.createSequence();
+  unsigned int b = kv.createSequence();
+  appendTokens(kv, a, 4, 1.0f);
+  appendTokens(kv, b, 4, 2.0f);
+  EXPECT_EQ(kv.getNumFreePages(), 0u);
+
+  appendTokens(kv, b, 1, 3.0f);
+  EXPECT_TRUE(kv.isEvicted(a));
+  EXPECT_FALSE(kv.isEvicted(b));
+  EXPECT_EQ(kv.getLength(a), 0u);
+  EXPECT_FLOAT_EQ(kv.getKey(0, b, 3)[0], 2.0f);
+
+  EXPECT_THROW(kv.beginStep({a}, 1), std::invalid_argument);
+  EXPECT_FALSE(kv.inStep());
+  kv.releaseSequence(a);
+}
+
+/**
+ * @brief Sequences of the step are never evicted
+ */
+TEST(KVCacheManager, out_of_pages_n) {
+  KVCacheManager kv(2, 2);
+  kv.registerLayer("a", KEY_WIDTH, VALUE_WIDTH,
+                   ml::train::TensorDim::DataType::FP32);
+
+  unsigned int seq = kv.createSequence();
+  appendTokens(kv, seq, 4, 1.0f);
+
+  EXPECT_THROW(kv.beginStep({seq}, 1), std::runtime_error);
+  EXPECT_FALSE(kv.inStep());
+  EXPECT_EQ(kv.getLength(seq), 4u);
+}
+
+/**
+ * @brief Step with a sequence which does not exist
+ */
+TEST(KVCacheManager, step_invalid_sequence_n) {
+  KVCacheManager kv(2, 2);
+  kv.registerLayer("a", KEY_WIDTH, VALUE_WIDTH,
+                   ml::train::TensorDim::DataType::FP32);
+
+  EXPECT_THROW(kv.beginStep({3}, 1), std::invalid_argument);
+  unsigned int seq = kv.createSequence();
+  EXPECT_THROW(kv.beginStep({seq, seq}, 1), std::invalid_argument);
+  EXPECT_FALSE(kv.inStep());
+}
+
+/**
+ * @brief Attention over the pages is same with the one over contiguous keys
+ */
+TEST(KVCacheManager, flash_attention_paged_p) {
+  const unsigned int q_len = 3, k_len = 11, dk = 5, dv = 3, page_len = 4;
+  const unsigned int num_pages = (k_len + page_len - 1) / page_len;
+
+  std::vector<float> Q(q_len * dk), K(k_len * dk), V(k_len * dv);
+  for (unsigned int i = 0; i < Q.size(); ++i)
+    Q[i] = ((i * 7) % 11) / 11.0f - 0.5f;
+  for (unsigned int i = 0; i < K.size(); ++i)
+    K[i] = ((i * 5) % 13) / 13.0f - 0.5f;
+  for (unsigned int i = 0; i < V.size(); ++i)
+    V[i] = ((i * 3) % 7) / 7.0f;
+
+  /** scatter the keys and values to the pages in reverse order */
+  std::vector<float> K_paged(num_pages * page_len * dk),
+    V_paged(num_pages * page_len * dv);
+  std::vector<const float *> K_pages(num_pages), V_pages(num_pages);
+  for (unsigned int p = 0; p < num_pages; ++p) {
+    K_pages[p] = K_paged.data() + (num_pages - 1 - p) * page_len * dk;
+    V_pages[p] = V_paged.data() + (num_pages - 1 - p) * page_len * dv;
+  }
+  for (unsigned int j = 0; j < k_len; ++j) {
+    std::copy_n(K.data() + j * dk, dk,
+                const_cast<float *>(K_pages[j / page_len]) +
+                  (j % page_len) * dk);
+    std::copy_n(V.data() + j * dv, dv,
+                const_cast<float *>(V_pages[j / page_len]) +
+                  (j % page_len) * dv);
+  }
+
+  const float scale = 0.5f;
+  const int causal_offset = k_len - q_len;
+  std::vector<float> expected(q_len * dv), output(q_len * dv);
+  nntrainer::flash_attention(q_len, k_len, dk, dv, Q.data(), dk, K.data(), dk,
+                             V.data(), dv, nullptr, 0, scale, causal_offset,
+                             expected.data(), dv);
+  nntrainer::flash_attention_paged(q_len, k_len, dk, dv, Q.data(), dk,
+                                   K_pages.data(), dk, V_pages.data(), dv,
+                                   page_len, scale, causal_offset,
+                                   output.data(), dv);
+
+  for (unsigned int i = 0; i < output.size(); ++i)
+    EXPECT_NEAR(output[i], expected[i], 1e-5f);
+}
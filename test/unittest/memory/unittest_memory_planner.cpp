@@ -15,6 +15,7 @@
 #include <memory>
 
 #include <basic_planner.h>
+#include <best_fit_planner.h>
 #include <memory_planner.h>
 #include <memory_pool.h>
 #include <nntrainer_test_util.h>
@@ -390,7 +391,92 @@ TEST_P(MemoryPlannerValidate, validate_memory_partial_overlap) {
   pool.deallocate();
 }
 
+/**
+ * @brief expired memory larger than the request is reused
+ */
+TEST(BestFitPlanner, partial_reuse_p) {
+  nntrainer::BestFitPlanner planner;
+
+  /** a (100) expires below d, then b (60) and c (40) share its memory */
+  std::vector<size_t> memory_size = {100, 60, 40, 10};
+  std::vector<std::pair<unsigned int, unsigned int>> memory_validity = {
+    {0, 2}, {2, 4}, {2, 4}, {1, 5}};
+  std::vector<size_t> memory_offset;
+  std::vector<bool> memory_is_wgrad;
+  size_t pool_size = planner.planLayout(memory_size, memory_validity,
+                                        memory_offset, memory_is_wgrad, 0);
+
+  EXPECT_EQ(pool_size, 110u);
+  EXPECT_TRUE(validateOverflow(memory_size, memory_offset, pool_size));
+  EXPECT_TRUE(
+    validateIntervalOverlap(memory_validity, memory_size, memory_offset));
+
+  nntrainer::OptimizedV1Planner v1;
+  EXPECT_LT(pool_size, v1.planLayout(memory_size, memory_validity,
+                                     memory_offset, memory_is_wgrad, 0));
+}
+
+/**
+ * @brief search does not make the layout worse
+ */
+TEST(BestFitPlanner, search_p) {
+  std::mt19937 rng;
+  std::uniform_int_distribution<size_t> dist(1, MEM_BYTES);
+  std::uniform_int_distribution<unsigned int> dist_interval(1, 20);
+  std::uniform_int_distribution<unsigned int> dist_start(0, MEM_QUANT);
+
+  std::vector<size_t> memory_size(MEM_QUANT);
+  std::vector<std::pair<unsigned int, unsigned int>> memory_validity(MEM_QUANT);
+  for (unsigned int idx = 0; idx < MEM_QUANT; idx++) {
+    memory_size[idx] = dist(rng);
+    unsigned int start = dist_start(rng);
+    memory_validity[idx] = {start, start + dist_interval(rng)};
+  }
+
+  std::vector<size_t> memory_offset;
+  std::vector<bool> memory_is_wgrad;
+  size_t greedy = nntrainer::BestFitPlanner().planLayout(
+    memory_size, memory_validity, memory_offset, memory_is_wgrad, 0);
+  size_t searched = nntrainer::BestFitPlanner(100).planLayout(
+    memory_size, memory_validity, memory_offset, memory_is_wgrad, 0);
+
+  EXPECT_LE(searched, greedy);
+  EXPECT_TRUE(validateOverflow(memory_size, memory_offset, searched));
+  EXPECT_TRUE(
+    validateIntervalOverlap(memory_validity, memory_size, memory_offset));
+}
+
+/**
+ * @brief weight gradients are packed together above the other requests
+ */
+TEST(BestFitPlanner, wgrad_group_p) {
+  nntrainer::BestFitPlanner planner(10);
+
+  /** c and d do not overlap in time, so they share the gradient region */
+  std::vector<size_t> memory_size = {100, 60, 40, 30, 20};
+  std::vector<std::pair<unsigned int, unsigned int>> memory_validity = {
+    {0, 2}, {2, 4}, {0, 1}, {3, 4}, {1, 3}};
+  std::vector<bool> memory_is_wgrad = {false, false, true, true, false};
+  std::vector<size_t> memory_offset;
+  size_t pool_size = planner.planLayout(memory_size, memory_validity,
+                                        memory_offset, memory_is_wgrad, 2);
+
+  EXPECT_EQ(pool_size, 120u + 40u);
+  EXPECT_TRUE(validateOverflow(memory_size, memory_offset, pool_size));
+  EXPECT_TRUE(
+    validateIntervalOverlap(memory_validity, memory_size, memory_offset));
+
+  for (unsigned int idx = 0; idx < memory_size.size(); idx++) {
+    if (memory_is_wgrad[idx])
+      EXPECT_GE(memory_offset[idx], 120u);
+    else
+      EXPECT_LE(memory_offset[idx] + memory_size[idx], 120u);
+  }
+}
+
 GTEST_PARAMETER_TEST(
   MemoryPlanner, MemoryPlannerValidate,
   ::testing::Values(std::make_shared<nntrainer::BasicPlanner>(),
-                    std::make_shared<nntrainer::OptimizedV1Planner>()));
+                    std::make_shared<nntrainer::OptimizedV1Planner>(),
+                    std::make_shared<nntrainer::BestFitPlanner>(),
+                    std::make_shared<nntrainer::BestFitPlanner>(10)));
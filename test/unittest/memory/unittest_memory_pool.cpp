@@ -11,9 +11,12 @@
  * @bug No known bugs except for NYI items
  */
 
+#include <algorithm>
 #include <cstring>
+#include <fstream>
 #include <memory>
 #include <random>
+#include <unistd.h>
 #include <vector>
 
 #include <gtest/gtest.h>
@@ -436,6 +439,283 @@ TEST_P(MemoryPoolTest, get_memory_04_p) {
   EXPECT_NO_THROW(pool.deallocate());
 }
 
+/**
+ * @brief offsets of the memory are aligned
+ */
+TEST(MemoryPool, alignment_01_p) {
+  nntrainer::MemoryPool pool(64);
+  std::vector<unsigned int> idx;
+
+  idx.push_back(pool.requestMemory(1, 4, 5));
+  idx.push_back(pool.requestMemory(3, 4, 5));
+  idx.push_back(pool.requestMemory(100, 4, 5));
+  EXPECT_NO_THROW(pool.planLayout(nntrainer::BasicPlanner()));
+  EXPECT_EQ(pool.size(), 256u);
+  EXPECT_EQ(pool.minMemoryRequirement(), 104u);
+
+  EXPECT_NO_THROW(pool.allocate());
+  for (auto i : idx) {
+    auto mem = pool.getMemory(i);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(mem->getAddr()) % 64, 0u);
+  }
+  EXPECT_NO_THROW(pool.deallocate());
+}
+
+/**
+ * @brief alignment which is not power of 2
+ */
+TEST(MemoryPool, alignment_02_n) {
+  EXPECT_THROW(nntrainer::MemoryPool(0), std::invalid_argument);
+  EXPECT_THROW(nntrainer::MemoryPool(48), std::invalid_argument);
+}
+
+/**
+ * @brief allocators give aligned zero-filled memory
+ */
+TEST(MemoryPool, allocator_01_p) {
+  const size_t size = 3 * 1024 * 1024 + 5;
+
+  for (auto type : {"malloc", "mmap", "thp", "hugetlb"}) {
+    auto allocator = nntrainer::MemoryAllocator::create(type);
+    EXPECT_EQ(allocator->getType(), type);
+
+    char *ptr = static_cast<char *>(allocator->alloc(size));
+    ASSERT_NE(ptr, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) %
+                nntrainer::MemoryAllocator::DEFAULT_ALIGNMENT,
+              0u);
+    for (size_t i = 0; i < size; i += 4093)
+      EXPECT_EQ(ptr[i], 0);
+
+    std::memset(ptr, 1, size);
+    EXPECT_GE(nntrainer::getResidentSize(ptr, size), size);
+    allocator->free(ptr, size);
+  }
+}
+
+/**
+ * @brief unknown allocator
+ */
+TEST(MemoryPool, allocator_02_n) {
+  EXPECT_THROW(nntrainer::MemoryAllocator::create("unknown"),
+               std::invalid_argument);
+}
+
+/**
+ * @brief file mapping gives the contents of the file and keeps the file
+ */
+TEST(MemoryPool, allocator_03_p) {
+  const std::string path = "memory_pool_allocator_03_p.bin";
+  const size_t page = sysconf(_SC_PAGE_SIZE);
+  const size_t size = 3 * page + 5;
+  std::vector<char> data(page + size);
+  for (size_t i = 0; i < data.size(); ++i)
+    data[i] = static_cast<char>(i % 127);
+  std::ofstream(path, std::ios::binary).write(data.data(), data.size());
+
+  auto allocator = nntrainer::MemoryAllocator::createFileMapped(path, page);
+  EXPECT_EQ(allocator->getType(), "file");
+
+  char *ptr = static_cast<char *>(allocator->alloc(size));
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(std::memcmp(ptr, data.data() + page, size), 0);
+
+  std::memset(ptr, 0, size);
+  allocator->free(ptr, size);
+
+  std::vector<char> saved(data.size());
+  std::ifstream(path, std::ios::binary).read(saved.data(), saved.size());
+  EXPECT_EQ(saved, data);
+
+  EXPECT_THROW(allocator->alloc(size + page), std::runtime_error);
+  remove(path.c_str());
+}
+
+/**
+ * @brief file mapping with an offset not aligned to the page size
+ */
+TEST(MemoryPool, allocator_04_n) {
+  EXPECT_THROW(nntrainer::MemoryAllocator::createFileMapped("file", 100),
+               std::invalid_argument);
+}
+
+/**
+ * @brief detached memory is reused if the next layout fits in it
+ */
+TEST(MemoryPool, detach_01_p) {
+  nntrainer::MemoryPool pool(64);
+
+  pool.requestMemory(1024, 1, 3);
+  pool.requestMemory(1024, 2, 4);
+  EXPECT_NO_THROW(pool.planLayout(nntrainer::BasicPlanner()));
+  EXPECT_NO_THROW(pool.allocate());
+  void *ptr = pool.getMemory(1)->getAddr();
+  std::memset(ptr, 1, 2048);
+
+  EXPECT_NO_THROW(pool.detach());
+  EXPECT_FALSE(pool.isAllocated());
+
+  pool.clear();
+  pool.requestMemory(512, 1, 3);
+  EXPECT_NO_THROW(pool.planLayout(nntrainer::BasicPlanner()));
+  EXPECT_NO_THROW(pool.allocate());
+  EXPECT_EQ(pool.getMemory(1)->getAddr(), ptr);
+
+  /** the reused memory is zero-filled as the allocator gives it */
+  const char *reused = pool.getMemory(1)->getAddr<char>();
+  EXPECT_TRUE(std::all_of(reused, reused + 512, [](char c) { return c == 0; }));
+
+  EXPECT_NO_THROW(pool.detach());
+  pool.clear();
+  pool.requestMemory(4096, 1, 3);
+  EXPECT_NO_THROW(pool.planLayout(nntrainer::BasicPlanner()));
+  EXPECT_NO_THROW(pool.allocate());
+  std::memset(pool.getMemory(1)->getAddr(), 1, 4096);
+
+  EXPECT_NO_THROW(pool.deallocate());
+}
+
+/**
+ * @brief pools share the memory until the last of them deallocates
+ */
+TEST(MemoryPool, share_01_p) {
+  nntrainer::MemoryPool pool(64), other(64);
+  for (auto p : {&pool, &other}) {
+    p->requestMemory(1024, 1, 3);
+    EXPECT_NO_THROW(p->planLayout(nntrainer::BasicPlanner()));
+  }
+
+  EXPECT_THROW(pool.share(), std::runtime_error);
+  EXPECT_NO_THROW(pool.allocate());
+  std::memset(pool.getMemory(1)->getAddr(), 7, 1024);
+
+  EXPECT_NO_THROW(other.setAllocator(pool.share()));
+  EXPECT_NO_THROW(other.allocate());
+  EXPECT_EQ(other.getMemory(1)->getAddr(), pool.getMemory(1)->getAddr());
+
+  EXPECT_NO_THROW(pool.deallocate());
+  EXPECT_EQ(other.getMemory(1)->getAddr<char>()[1023], 7);
+  EXPECT_NO_THROW(other.deallocate());
+}
+
+/**
+ * @brief the pool which shared its memory allocates new memory after
+ * deallocation
+ */
+TEST(MemoryPool, share_02_p) {
+  nntrainer::MemoryPool pool(64), other(64);
+  for (auto p : {&pool, &other}) {
+    p->requestMemory(1024, 1, 3);
+    EXPECT_NO_THROW(p->planLayout(nntrainer::BasicPlanner()));
+  }
+
+  EXPECT_NO_THROW(pool.allocate());
+  std::memset(pool.getMemory(1)->getAddr(), 7, 1024);
+  EXPECT_NO_THROW(other.setAllocator(pool.share()));
+  EXPECT_NO_THROW(other.allocate());
+
+  /** reallocated while the other pool holds the shared memory */
+  EXPECT_NO_THROW(pool.deallocate());
+  EXPECT_NO_THROW(pool.allocate());
+  EXPECT_NE(pool.getMemory(1)->getAddr(), other.getMemory(1)->getAddr());
+  std::memset(pool.getMemory(1)->getAddr(), 1, 1024);
+  EXPECT_EQ(other.getMemory(1)->getAddr<char>()[1023], 7);
+
+  /** detach does not keep the shared memory either */
+  EXPECT_NO_THROW(other.deallocate());
+  EXPECT_NO_THROW(other.setAllocator(pool.share()));
+  EXPECT_NO_THROW(other.allocate());
+  EXPECT_NO_THROW(pool.detach());
+  EXPECT_NO_THROW(pool.allocate());
+  EXPECT_NE(pool.getMemory(1)->getAddr(), other.getMemory(1)->getAddr());
+
+  /** reallocated after every pool sharing the memory is deallocated */
+  EXPECT_NO_THROW(other.deallocate());
+  EXPECT_NO_THROW(pool.deallocate());
+  EXPECT_NO_THROW(pool.allocate());
+  EXPECT_NO_THROW(other.allocate());
+  EXPECT_NO_THROW(pool.deallocate());
+  EXPECT_NO_THROW(other.deallocate());
+}
+
+/**
+ * @brief planner counting its calls
+ */
+class CountingPlanner : public nntrainer::BasicPlanner {
+public:
+  /**
+   * @copydoc BasicPlanner::planLayout
+   */
+  size_t planLayout(
+    const std::vector<size_t> &memory_size,
+    const std::vector<std::pair<unsigned int, unsigned int>> &memory_validity,
+    std::vector<size_t> &memory_offset, std::vector<bool> &memory_is_wgrad,
+    size_t n_wgrad = 0) const override {
+    ++count;
+    return BasicPlanner::planLayout(memory_size, memory_validity,
+                                    memory_offset, memory_is_wgrad, n_wgrad);
+  }
+
+  mutable unsigned int count = 0; /**< number of planLayout() calls */
+};
+
+/**
+ * @brief layout planned for the same requests is reused
+ */
+TEST(MemoryPool, plan_layout_cache_01_p) {
+  nntrainer::MemoryPool pool(64);
+  CountingPlanner planner;
+
+  auto request = [&pool](size_t size) {
+    pool.clear();
+    pool.requestMemory(size, 1, 3);
+    pool.requestMemory(100, 2, 4);
+  };
+
+  request(100);
+  pool.planLayout(planner);
+  EXPECT_EQ(planner.count, 1u);
+  EXPECT_EQ(pool.size(), 256u);
+
+  request(1000);
+  pool.planLayout(planner);
+  EXPECT_EQ(planner.count, 2u);
+  EXPECT_EQ(pool.size(), 1152u);
+
+  request(100);
+  pool.planLayout(planner);
+  EXPECT_EQ(planner.count, 2u);
+  EXPECT_EQ(pool.size(), 256u);
+
+  EXPECT_NO_THROW(pool.allocate());
+  EXPECT_EQ(pool.getMemory(2)->getAddr<char>() -
+              pool.getMemory(1)->getAddr<char>(),
+            128);
+  EXPECT_NO_THROW(pool.deallocate());
+}
+
+/**
+ * @brief untouched memory of the pool is not resident
+ */
+TEST(MemoryPool, resident_size_01_p) {
+  nntrainer::MemoryPool pool(64, nntrainer::MemoryAllocator::create("mmap"));
+  const size_t size = 1024 * 1024;
+
+  auto idx1 = pool.requestMemory(size, 4, 5);
+  pool.requestMemory(size, 4, 5);
+  EXPECT_NO_THROW(pool.planLayout(nntrainer::BasicPlanner()));
+  EXPECT_EQ(pool.residentSize(), 0u);
+
+  EXPECT_NO_THROW(pool.allocate());
+  EXPECT_EQ(pool.residentSize(), 0u);
+
+  std::memset(pool.getMemory(idx1)->getAddr(), 1, size);
+  EXPECT_GE(pool.residentSize(), size);
+  EXPECT_LT(pool.residentSize(), 2 * size);
+
+  EXPECT_NO_THROW(pool.deallocate());
+}
+
 GTEST_PARAMETER_TEST(
   MemoryPool, MemoryPoolTest,
   ::testing::Values(std::make_shared<nntrainer::MemoryPool>(),
@@ -0,0 +1,181 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file unittest_swap_device.cpp
+ * @date 18 Oct 2026
+ * @brief Swap Device Test
+ * @see	https://github.com/nnstreamer/nntrainer
+ * @bug No known bugs except for NYI items
+ */
+
+#include <csignal>
+#include <cstring>
+#include <sys/resource.h>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <cache_elem.h>
+#include <memory_data.h>
+#include <nntrainer_test_util.h>
+#include <swap_device.h>
+
+/**
+ * @brief Swap device test class
+ */
+class SwapDeviceTest : public ::testing::Test {
+public:
+  void SetUp(void) {
+    device = std::make_shared<nntrainer::SwapDevice>("unittest_swap_device");
+    device->start(SIZE);
+  }
+
+  void TearDown(void) { EXPECT_NO_THROW(device->finish()); }
+
+  /**
+   * @brief write value to the area of device
+   */
+  void fill(off_t offset, size_t len, char value) {
+    char *buf = static_cast<char *>(device->getBuffer(offset, len, true));
+    std::memset(buf, value, len);
+    device->putBuffer(buf);
+  }
+
+  /**
+   * @brief check the area of device has value
+   */
+  void check(off_t offset, size_t len, char value) {
+    char *buf = static_cast<char *>(device->getBuffer(offset, len));
+    for (size_t i = 0; i < len; ++i)
+      ASSERT_EQ(buf[i], value) << "at " << offset + i;
+    device->putBuffer(buf, true);
+  }
+
+  static constexpr size_t SIZE = 1024 * 1024;
+  std::shared_ptr<nntrainer::SwapDevice> device;
+};
+
+/**
+ * @brief written data is read back
+ */
+TEST_F(SwapDeviceTest, write_read_01_p) {
+  fill(0, 4096, 1);
+  fill(4096, 100, 2);
+  fill(4196, 5000, 3);
+
+  check(0, 4096, 1);
+  check(4096, 100, 2);
+  check(4196, 5000, 3);
+}
+
+/**
+ * @brief prefetched data is taken by getBuffer
+ */
+TEST_F(SwapDeviceTest, prefetch_01_p) {
+  for (unsigned int i = 0; i < 8; ++i)
+    fill(i * 8192, 8192, i + 1);
+
+  for (unsigned int i = 0; i < 8; ++i)
+    device->prefetch(i * 8192, 8192);
+
+  for (unsigned int i = 0; i < 8; ++i)
+    check(i * 8192, 8192, i + 1);
+}
+
+/**
+ * @brief prefetched data is invalidated by overlapped write
+ */
+TEST_F(SwapDeviceTest, prefetch_02_p) {
+  fill(0, 8192, 1);
+  device->prefetch(0, 8192);
+
+  /** overlapped area with different size */
+  fill(4096, 8192, 2);
+
+  check(0, 4096, 1);
+  check(4096, 8192, 2);
+}
+
+/**
+ * @brief dealloc only buffer is not written, the others are written as is
+ */
+TEST_F(SwapDeviceTest, put_01_p) {
+  fill(0, 1000, 1);
+
+  char *buf = static_cast<char *>(device->getBuffer(0, 1000));
+  device->putBuffer(buf);
+  check(0, 1000, 1);
+
+  buf = static_cast<char *>(device->getBuffer(0, 1000));
+  std::memset(buf, 5, 1000);
+  device->putBuffer(buf, true);
+  check(0, 1000, 1);
+
+  buf = static_cast<char *>(device->getBuffer(0, 1000));
+  buf[999] = 7;
+  device->putBuffer(buf);
+  buf = static_cast<char *>(device->getBuffer(0, 1000));
+  EXPECT_EQ(buf[0], 1);
+  EXPECT_EQ(buf[999], 7);
+  device->putBuffer(buf);
+}
+
+/**
+ * @brief cache element writes back only when its policy allows writing
+ */
+TEST_F(SwapDeviceTest, cache_elem_dirty_01_p) {
+  auto data = std::make_shared<nntrainer::MemoryData>(nullptr);
+  nntrainer::CacheElem sync_once(device, 1, 0, 1000, data,
+                                 nntrainer::CachePolicy::SYNC_ONCE);
+
+  sync_once.swapIn();
+  EXPECT_TRUE(sync_once.isDirty());
+  std::memset(data->getAddr(), 1, 1000);
+  sync_once.swapOut();
+  check(0, 1000, 1);
+
+  /** read only after the first write */
+  sync_once.swapIn();
+  EXPECT_FALSE(sync_once.isDirty());
+  std::memset(data->getAddr(), 2, 1000);
+  sync_once.swapOut();
+  check(0, 1000, 1);
+
+  nntrainer::CacheElem synced(device, 2, 4096, 1000, data,
+                              nntrainer::CachePolicy::ALWAYS_SYNCED);
+  synced.swapIn();
+  EXPECT_TRUE(synced.isDirty());
+  std::memset(data->getAddr(), 3, 1000);
+  synced.swapOut();
+  EXPECT_FALSE(synced.isDirty());
+  check(4096, 1000, 3);
+}
+
+/**
+ * @brief failed write is reported
+ */
+TEST_F(SwapDeviceTest, write_error_01_n) {
+  /** writing beyond the file size limit fails with EFBIG */
+  struct rlimit limit;
+  ASSERT_EQ(getrlimit(RLIMIT_FSIZE, &limit), 0);
+  struct rlimit small = {SIZE / 2, limit.rlim_max};
+  auto prev_handler = std::signal(SIGXFSZ, SIG_IGN);
+  ASSERT_EQ(setrlimit(RLIMIT_FSIZE, &small), 0);
+
+  EXPECT_THROW(
+    {
+      fill(SIZE - 4096, 4096, 1);
+      device->finish();
+    },
+    std::runtime_error);
+
+  setrlimit(RLIMIT_FSIZE, &limit);
+  std::signal(SIGXFSZ, prev_handler);
+}
+
+/**
+ * @brief put unknown buffer
+ */
+TEST_F(SwapDeviceTest, put_02_n) {
+  char data[10];
+  EXPECT_ANY_THROW(device->putBuffer(data));
+}
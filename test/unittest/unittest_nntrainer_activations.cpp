@@ -622,6 +622,164 @@ TEST(nntrainer_activation, mishPrime_01_p) {
   }
 }
 
+TEST(nntrainer_activation, vectorized_kernels_p) {
+  using Kernel = void (*)(const unsigned int, const float *, float *);
+  const std::vector<std::pair<Kernel, std::function<float(float)>>> kernels = {
+    {nntrainer::ele_sigmoid,
+     [](float x) { return 1.0f / (1.0f + std::exp(-x)); }},
+    {nntrainer::ele_tanh, [](float x) { return std::tanh(x); }},
+    {nntrainer::ele_swish, [](float x) { return x / (1.0f + std::exp(-x)); }},
+    {nntrainer::ele_gelu,
+     [](float x) { return 0.5f * x * (1.0f + std::erf(x / std::sqrt(2.0f))); }},
+    {nntrainer::ele_tanh_gelu,
+     [](float x) {
+       return 0.5f * x *
+              (1.0f + std::tanh(std::sqrt(2.0f / (float)M_PI) *
+                                (x + 0.044715f * x * x * x)));
+     }},
+    {nntrainer::ele_sigmoid_gelu,
+     [](float x) { return x / (1.0f + std::exp(-1.702f * x)); }},
+  };
+
+  /** lengths cover the vector body and the padded tail */
+  for (unsigned int N : {1u, 7u, 8u, 37u}) {
+    std::vector<float> X(N), Y(N);
+    for (unsigned int i = 0; i < N; ++i)
+      X[i] = -8.0f + 16.0f * i / N;
+
+    for (auto &[kernel, reference] : kernels) {
+      kernel(N, X.data(), Y.data());
+      for (unsigned int i = 0; i < N; ++i)
+        EXPECT_NEAR(Y[i], reference(X[i]), tolerance);
+
+      /** in-place */
+      std::vector<float> Z = X;
+      kernel(N, Z.data(), Z.data());
+      for (unsigned int i = 0; i < N; ++i)
+        EXPECT_FLOAT_EQ(Z[i], Y[i]);
+    }
+  }
+}
+
+TEST(nntrainer_activation, apply_op_p) {
+  /** large enough to be split over the threads */
+  int batch = 4;
+  int channel = 3;
+  int height = 128;
+  int width = 100;
+
+  nntrainer::Tensor input(batch, channel, height, width);
+  GEN_TEST_INPUT(input, (l - 50) * 0.01 * (k % 7 + 1));
+
+  nntrainer::Tensor expected =
+    input.apply<float>(nntrainer::ActiFunc::sigmoid<float>);
+
+  nntrainer::Tensor element;
+  input.apply_op<float>(
+    [](float x) { return nntrainer::ActiFunc::sigmoid<float>(x); }, element);
+  EXPECT_EQ(element, expected);
+
+  nntrainer::Tensor span(input.getDim());
+  input.apply_op<float>(nntrainer::ele_sigmoid, span);
+  for (unsigned int i = 0; i < span.size(); ++i)
+    EXPECT_NEAR(span.getData()[i], expected.getData()[i], tolerance);
+
+  nntrainer::Tensor wrong(1, 1, 1, 10);
+  EXPECT_THROW(input.apply_op<float>(nntrainer::ele_sigmoid, wrong),
+               std::invalid_argument);
+}
+
+TEST(nntrainer_activation, apply_op_strided_p) {
+  int batch = 2;
+  int channel = 3;
+  int height = 4;
+  int width = 5;
+
+  nntrainer::Tensor input(batch, channel, height, width);
+  GEN_TEST_INPUT(input, (l - 2) * 0.1 * (i + j + k + 1));
+
+  /** a column of width 1 out of the width of 5 is strided */
+  nntrainer::TensorDim column_dim(batch, channel, height, 1);
+  nntrainer::Tensor column = input.getSharedDataTensor(column_dim, 2, false);
+  nntrainer::Tensor output(column_dim);
+  column.apply_op<float>(nntrainer::ele_tanh, output);
+
+  for (int b = 0; b < batch; ++b)
+    for (int c = 0; c < channel; ++c)
+      for (int h = 0; h < height; ++h)
+        EXPECT_NEAR(output.getValue(b, c, h, 0),
+                    std::tanh(input.getValue(b, c, h, 2)), tolerance);
+}
+
+TEST(nntrainer_activation, run_fn_vectorized_p) {
+  const std::vector<std::pair<nntrainer::ActivationType, float (*)(float)>>
+    activations = {
+      {nntrainer::ActivationType::ACT_SIGMOID,
+       nntrainer::ActiFunc::sigmoid<float>},
+      {nntrainer::ActivationType::ACT_TANH,
+       nntrainer::ActiFunc::tanhFloat<float>},
+      {nntrainer::ActivationType::ACT_RELU, nntrainer::ActiFunc::relu<float>},
+    };
+
+  int batch = 3;
+  int channel = 1;
+  int height = 1;
+  int width = 37;
+
+  nntrainer::Tensor input(batch, channel, height, width);
+  GEN_TEST_INPUT(input, (l - 18) * 0.2 * (i + 1));
+
+  for (auto &[type, reference] : activations) {
+    nntrainer::ActiFunc acti_func(type, false);
+    nntrainer::Tensor output(input.getDim());
+    acti_func.run_fn(input, output);
+
+    nntrainer::Tensor expected = input.apply<float>(reference);
+    for (unsigned int i = 0; i < output.size(); ++i)
+      EXPECT_NEAR(output.getData()[i], expected.getData()[i], tolerance);
+  }
+}
+
+TEST(nntrainer_activation, tanhGelu_01_p) {
+  int batch = 3;
+  int channel = 1;
+  int height = 1;
+  int width = 10;
+
+  nntrainer::Tensor input(batch, channel, height, width);
+  GEN_TEST_INPUT(input, (l - 4) * 0.1 * (i + 1));
+
+  nntrainer::Tensor results(input.getDim());
+  nntrainer::ActiFunc::tanhGelu(input, results);
+
+  for (unsigned int i = 0; i < input.size(); ++i) {
+    float x = input.getData()[i];
+    float answer = 0.5f * x *
+                   (1.0f + std::tanh(std::sqrt(2.0f / (float)M_PI) *
+                                     (x + 0.044715f * x * x * x)));
+    EXPECT_NEAR(results.getData()[i], answer, tolerance);
+  }
+}
+
+TEST(nntrainer_activation, sigmoidGelu_01_p) {
+  int batch = 3;
+  int channel = 1;
+  int height = 1;
+  int width = 10;
+
+  nntrainer::Tensor input(batch, channel, height, width);
+  GEN_TEST_INPUT(input, (l - 4) * 0.1 * (i + 1));
+
+  nntrainer::Tensor results(input.getDim());
+  nntrainer::ActiFunc::sigmoidGelu(input, results);
+
+  for (unsigned int i = 0; i < input.size(); ++i) {
+    float x = input.getData()[i];
+    EXPECT_NEAR(results.getData()[i], x / (1.0f + std::exp(-1.702f * x)),
+                tolerance);
+  }
+}
+
 /**
  * @brief Main gtest
  */
@@ -11,7 +11,13 @@
  */
 
 #include <gtest/gtest.h>
+
+#include <thread>
+
+#include <app_context.h>
+#include <blas_interface.h>
 #include <ini_wrapper.h>
+#include <loss_scaler.h>
 #include <neuralnet.h>
 
 #include "nntrainer_test_util.h"
@@ -366,6 +372,926 @@ TEST(nntrainerGraphUnitTest, call_functions) {
   }
 }
 
+/**
+ * @brief make a self attention model whose keys and values are in the paged
+ * kv cache of 2 tokens a page
+ */
+static std::unique_ptr<nntrainer::NeuralNetwork> makePagedSelfAttention() {
+  std::unique_ptr<nntrainer::NeuralNetwork> nn(new nntrainer::NeuralNetwork());
+  nn->setProperty(
+    {"batch_size=1", "kv_cache_page_size=2", "kv_cache_pages=8"});
+
+  auto g = makeGraph({
+    {"input", {"name=in", "input_shape=1:4:6"}},
+    {"multi_head_attention",
+     {"name=mha", "input_layers=in, in, in", "num_heads=2"}},
+  });
+  for (auto &node : g)
+    nn->addLayer(node);
+
+  EXPECT_EQ(nn->compile(ml::train::ExecutionMode::INFERENCE), ML_ERROR_NONE);
+  EXPECT_EQ(nn->initialize(ml::train::ExecutionMode::INFERENCE),
+            ML_ERROR_NONE);
+  return nn;
+}
+
+TEST(nntrainerGraphUnitTest, paged_kv_cache_incremental_inference_p) {
+  auto nn = makePagedSelfAttention();
+  nntrainer::KVCacheManager *kv_cache = nn->getKVCacheManager();
+  ASSERT_NE(kv_cache, nullptr);
+
+  auto x = std::make_shared<nntrainer::Tensor>(
+    nntrainer::TensorDim(1, 1, 4, 6), true, nntrainer::Initializer::NONE);
+  for (unsigned int i = 0; i < x->size(); ++i)
+    x->getData()[i] = ((i * 7) % 11) / 11.0f - 0.5f;
+
+  /** the last token of the full inference attends to all the tokens */
+  nntrainer::Tensor expected = nn->inference({x})[0]->clone();
+
+  /** prompt of 3 tokens, then the last token alone */
+  unsigned int seq = kv_cache->createSequence();
+  nn->incremental_inference({x}, {seq}, 3);
+  EXPECT_EQ(kv_cache->getLength(seq), 3u);
+
+  unsigned int fork = kv_cache->forkSequence(seq);
+
+  auto last = std::make_shared<nntrainer::Tensor>(
+    nntrainer::TensorDim(1, 1, 4, 6), true, nntrainer::Initializer::ZEROS);
+  std::copy_n(x->getAddress(0, 0, 3, 0), 6, last->getData());
+
+  for (auto s : {seq, fork}) {
+    nntrainer::Tensor out =
+      nn->incremental_inference({last}, {s}, 1)[0]->clone();
+    EXPECT_EQ(kv_cache->getLength(s), 4u);
+    for (unsigned int i = 0; i < 6; ++i)
+      EXPECT_NEAR(out.getValue(0, 0, 0, i), expected.getValue(0, 0, 3, i),
+                  1e-5f);
+  }
+}
+
+TEST(nntrainerGraphUnitTest, paged_kv_cache_step_mismatch_n) {
+  auto nn = makePagedSelfAttention();
+  nntrainer::KVCacheManager *kv_cache = nn->getKVCacheManager();
+
+  auto x = std::make_shared<nntrainer::Tensor>(
+    nntrainer::TensorDim(1, 1, 4, 6), true, nntrainer::Initializer::ONES);
+
+  unsigned int a = kv_cache->createSequence();
+  unsigned int b = kv_cache->createSequence();
+  EXPECT_THROW(nn->incremental_inference({x}, {a, b}, 1),
+               std::invalid_argument);
+  EXPECT_FALSE(kv_cache->inStep());
+  EXPECT_EQ(kv_cache->getLength(a), 0u);
+}
+
+/**
+ * @brief check the fully connected layer of the weight-only quantized model
+ * against the full precision one with the dequantized weight
+ */
+static void testQuantizedFullyConnected(const std::string &tensor_type) {
+  const unsigned int K = 16, N = 11, group_size = 8;
+  std::unique_ptr<nntrainer::NeuralNetwork> nn(new nntrainer::NeuralNetwork());
+  nn->setProperty({"batch_size=2", "model_tensor_type=" + tensor_type});
+
+  auto g = makeGraph({
+    {"input", {"name=in", "input_shape=1:3:16"}},
+    {"fully_connected", {"name=fc", "unit=11", "quant_group_size=8"}},
+  });
+  for (auto &node : g)
+    nn->addLayer(node);
+
+  EXPECT_EQ(nn->compile(ml::train::ExecutionMode::INFERENCE), ML_ERROR_NONE);
+  EXPECT_EQ(nn->initialize(ml::train::ExecutionMode::INFERENCE),
+            ML_ERROR_NONE);
+  nn->allocate(ml::train::ExecutionMode::INFERENCE);
+
+  auto graph = nn->getFlatGraph();
+  auto fc = std::find_if(graph.begin(), graph.end(),
+                         [](auto &node) { return node->getName() == "fc"; });
+  ASSERT_NE(fc, graph.end());
+  nntrainer::RunLayerContext &rc = (*fc)->getRunContext();
+  nntrainer::Tensor &weight = rc.getWeight(0);
+  nntrainer::Tensor &scale = rc.getWeight(1);
+  nntrainer::Tensor &bias = rc.getWeight(2);
+  ASSERT_EQ(scale.height(), K / group_size);
+
+  std::vector<float> W(K * N);
+  for (unsigned int i = 0; i < W.size(); ++i)
+    W[i] = ((i * 5) % 23) / 23.0f - 0.5f;
+  for (unsigned int i = 0; i < N; ++i)
+    bias.getData()[i] = i / 10.0f;
+
+  nntrainer::Tensor dequantized(nntrainer::TensorDim(1, 1, K, N));
+  if (tensor_type == "QINT4-FP32") {
+    uint8_t *B = weight.getData<uint8_t>();
+    nntrainer::quantize_q4(K, N, W.data(), N, B, weight.width(),
+                           scale.getData(), N, group_size);
+    for (unsigned int k = 0; k < K; ++k)
+      for (unsigned int n = 0; n < N; ++n) {
+        uint8_t nibble = (B[k * weight.width() + n / 2] >> (4 * (n % 2))) & 15;
+        dequantized.setValue(0, 0, k, n,
+                             (nibble < 8 ? nibble : nibble - 16) *
+                               scale.getValue(0, 0, k / group_size, n));
+      }
+  } else {
+    int8_t *B = weight.getData<int8_t>();
+    nntrainer::quantize_q8(K, N, W.data(), N, B, weight.width(),
+                           scale.getData(), N, group_size);
+    for (unsigned int k = 0; k < K; ++k)
+      for (unsigned int n = 0; n < N; ++n)
+        dequantized.setValue(0, 0, k, n,
+                             B[k * N + n] *
+                               scale.getValue(0, 0, k / group_size, n));
+  }
+
+  auto x = std::make_shared<nntrainer::Tensor>(
+    nntrainer::TensorDim(2, 1, 3, K), true, nntrainer::Initializer::NONE);
+  for (unsigned int i = 0; i < x->size(); ++i)
+    x->getData()[i] = ((i * 7) % 11) / 11.0f - 0.5f;
+
+  nntrainer::Tensor expected = x->dot(dequantized);
+  expected.add_i(bias);
+
+  nntrainer::Tensor out = nn->inference({x})[0]->clone();
+  nntrainer::Tensor out_incremental =
+    nn->incremental_inference({x}, 3, 0, 3)[0]->clone();
+  for (unsigned int i = 0; i < expected.size(); ++i) {
+    EXPECT_NEAR(out.getData()[i], expected.getData()[i], 1e-5f);
+    EXPECT_NEAR(out_incremental.getData()[i], expected.getData()[i], 1e-5f);
+  }
+}
+
+TEST(nntrainerGraphUnitTest, quantized_fully_connected_int8_p) {
+  testQuantizedFullyConnected("QINT8-FP32");
+}
+
+TEST(nntrainerGraphUnitTest, quantized_fully_connected_int4_p) {
+  testQuantizedFullyConnected("QINT4-FP32");
+}
+
+TEST(nntrainerGraphUnitTest, quantized_fully_connected_group_size_n) {
+  std::unique_ptr<nntrainer::NeuralNetwork> nn(new nntrainer::NeuralNetwork());
+  nn->setProperty({"batch_size=1", "model_tensor_type=QINT4-FP32"});
+
+  auto g = makeGraph({
+    {"input", {"name=in", "input_shape=1:1:10"}},
+    {"fully_connected", {"name=fc", "unit=4", "quant_group_size=4"}},
+  });
+  for (auto &node : g)
+    nn->addLayer(node);
+
+  EXPECT_EQ(nn->compile(ml::train::ExecutionMode::INFERENCE), ML_ERROR_NONE);
+  EXPECT_THROW(nn->initialize(ml::train::ExecutionMode::INFERENCE),
+               std::invalid_argument);
+}
+
+/**
+ * @brief run the concat-split model of a single sample
+ */
+static nntrainer::Tensor inferConcatSplit(nntrainer::NeuralNetwork &nn,
+                                          const nntrainer::Tensor &x) {
+  auto in = std::make_shared<nntrainer::Tensor>(x.clone());
+  return nn.inference({in}, false)[0]->clone();
+}
+
+TEST(nntrainerGraphUnitTest, concat_split_zero_copy_p) {
+  std::unique_ptr<nntrainer::NeuralNetwork> nn(new nntrainer::NeuralNetwork());
+  nn->setProperty({"batch_size=1"});
+
+  auto g = makeGraph({
+    {"input", {"name=in", "input_shape=1:1:6"}},
+    {"fully_connected", {"name=a", "input_layers=in", "unit=4"}},
+    {"fully_connected", {"name=b", "input_layers=in", "unit=4"}},
+    {"concat", {"name=concat", "input_layers=a, b", "axis=3"}},
+    {"split", {"name=split", "axis=3", "split_number=2"}},
+    {"addition", {"name=add", "input_layers=split(0), split(1)"}},
+  });
+  for (auto &node : g)
+    nn->addLayer(node);
+
+  EXPECT_EQ(nn->compile(ml::train::ExecutionMode::INFERENCE), ML_ERROR_NONE);
+  EXPECT_EQ(nn->initialize(ml::train::ExecutionMode::INFERENCE),
+            ML_ERROR_NONE);
+  nn->allocate(ml::train::ExecutionMode::INFERENCE);
+
+  auto graph = nn->getFlatGraph();
+  auto find = [&graph](const std::string &name)
+    -> nntrainer::RunLayerContext & {
+    auto node = std::find_if(graph.begin(), graph.end(), [&name](auto &node) {
+      return node->getName() == name;
+    });
+    EXPECT_NE(node, graph.end());
+    return (*node)->getRunContext();
+  };
+
+  /** the inputs of concat and the outputs of split are placed in place */
+  nntrainer::RunLayerContext &concat = find("concat");
+  float *concat_out = concat.getOutput(0).getData();
+  EXPECT_EQ(concat.getInput(0).getData(), concat_out);
+  EXPECT_EQ(concat.getInput(1).getData(), concat_out + 4);
+
+  nntrainer::RunLayerContext &split = find("split");
+  float *split_in = split.getInput(0).getData();
+  EXPECT_EQ(split.getOutput(0).getData(), split_in);
+  EXPECT_EQ(split.getOutput(1).getData(), split_in + 4);
+
+  nntrainer::Tensor x(nntrainer::TensorDim(2, 1, 1, 6));
+  for (unsigned int i = 0; i < x.size(); ++i)
+    x.getData()[i] = ((i * 7) % 11) / 11.0f - 0.5f;
+
+  nntrainer::Tensor expected0 = inferConcatSplit(*nn, x.getBatchSlice(0, 1));
+  nntrainer::Tensor expected1 = inferConcatSplit(*nn, x.getBatchSlice(1, 1));
+
+  /** the batch of 2 is not placed, and copied instead */
+  nntrainer::Tensor out = inferConcatSplit(*nn, x);
+  for (unsigned int i = 0; i < 4; ++i) {
+    EXPECT_FLOAT_EQ(out.getValue(0, 0, 0, i), expected0.getValue(0, 0, 0, i));
+    EXPECT_FLOAT_EQ(out.getValue(1, 0, 0, i), expected1.getValue(0, 0, 0, i));
+  }
+}
+
+/**
+ * @brief make a small model of fully connected layers
+ *
+ * @param props model properties
+ * @param mode execution mode to compile the model
+ * @return allocated model
+ */
+static std::unique_ptr<nntrainer::NeuralNetwork>
+makeFcModel(const std::vector<std::string> &props,
+            ml::train::ExecutionMode mode = ml::train::ExecutionMode::TRAIN) {
+  std::unique_ptr<nntrainer::NeuralNetwork> nn(new nntrainer::NeuralNetwork());
+  nn->setProperty(props);
+  nn->setProperty({"batch_size=2", "loss=mse"});
+  nn->setOptimizer(ml::train::createOptimizer("sgd", {"learning_rate=0.1"}));
+
+  auto g = makeGraph({
+    {"input", {"name=in", "input_shape=1:1:8"}},
+    {"fully_connected",
+     {"name=fc0", "unit=16", "weight_initializer=ones", "activation=tanh"}},
+    {"fully_connected",
+     {"name=fc1", "unit=16", "weight_initializer=ones", "activation=tanh"}},
+    {"fully_connected", {"name=fc2", "unit=4", "weight_initializer=ones"}},
+  });
+  for (auto &node : g)
+    nn->addLayer(node);
+
+  EXPECT_EQ(nn->compile(mode), ML_ERROR_NONE);
+  EXPECT_EQ(nn->initialize(mode), ML_ERROR_NONE);
+  EXPECT_EQ(nn->allocate(mode), ML_ERROR_NONE);
+  return nn;
+}
+
+/**
+ * @brief input of the model given by makeFcModel()
+ */
+static std::shared_ptr<nntrainer::Tensor> makeFcInput() {
+  auto x = std::make_shared<nntrainer::Tensor>(
+    nntrainer::TensorDim(2, 1, 1, 8), true, nntrainer::Initializer::NONE);
+  for (unsigned int i = 0; i < x->size(); ++i)
+    x->getData()[i] = ((i * 7) % 11) / 110.0f - 0.05f;
+  return x;
+}
+
+/**
+ * @brief train a few iterations of the model given by makeFcModel()
+ *
+ * @param props model properties
+ * @return trained model
+ */
+static std::unique_ptr<nntrainer::NeuralNetwork>
+trainFcModel(const std::vector<std::string> &props) {
+  auto nn = makeFcModel(props);
+
+  auto x = makeFcInput();
+  auto y = std::make_shared<nntrainer::Tensor>(
+    nntrainer::TensorDim(2, 1, 1, 4), true, nntrainer::Initializer::NONE);
+  for (unsigned int i = 0; i < y->size(); ++i)
+    y->getData()[i] = ((i * 3) % 5) / 5.0f;
+
+  for (int iter = 1; iter <= 4; ++iter) {
+    nn->forwarding({x}, {y});
+    nn->backwarding(iter);
+  }
+
+  return nn;
+}
+
+/**
+ * @brief train a few iterations of a small model and infer with it
+ *
+ * @param props model properties
+ * @param save_path path to save the trained model as MODEL_FORMAT_MMAP_BIN,
+ * not saved if empty
+ * @return Tensor inference result after the training
+ */
+static nntrainer::Tensor trainAndInfer(const std::vector<std::string> &props,
+                                       const std::string &save_path = "") {
+  auto nn = trainFcModel(props);
+
+  if (!save_path.empty())
+    nn->save(save_path, ml::train::ModelFormat::MODEL_FORMAT_MMAP_BIN);
+
+  return nn->inference({makeFcInput()}, false)[0]->clone();
+}
+
+TEST(nntrainerGraphUnitTest, memory_swap_lookahead_p) {
+  nntrainer::Tensor expected = trainAndInfer({"memory_swap=false"});
+
+  for (auto lookahead : {"1", "3"}) {
+    nntrainer::Tensor out =
+      trainAndInfer({"memory_swap=true", "memory_swap_path=/tmp",
+                     std::string("memory_swap_lookahead=") + lookahead});
+    ASSERT_EQ(out.size(), expected.size());
+    for (unsigned int i = 0; i < out.size(); ++i)
+      EXPECT_FLOAT_EQ(out.getData()[i], expected.getData()[i]);
+  }
+}
+
+TEST(nntrainerGraphUnitTest, mmap_bin_save_load_p) {
+  const std::string path = "mmap_bin_save_load_p.bin";
+  nntrainer::Tensor expected = trainAndInfer({}, path);
+
+  for (auto mode :
+       {ml::train::ExecutionMode::TRAIN, ml::train::ExecutionMode::INFERENCE}) {
+    auto nn = makeFcModel({}, mode);
+    EXPECT_NO_THROW(
+      nn->load(path, ml::train::ModelFormat::MODEL_FORMAT_MMAP_BIN));
+
+    nntrainer::Tensor out = *nn->inference({makeFcInput()}, false)[0];
+    ASSERT_EQ(out.size(), expected.size());
+    for (unsigned int i = 0; i < out.size(); ++i)
+      EXPECT_FLOAT_EQ(out.getData()[i], expected.getData()[i]);
+  }
+
+  remove(path.c_str());
+}
+
+TEST(nntrainerGraphUnitTest, mmap_bin_load_n) {
+  const std::string path = "mmap_bin_load_n.bin";
+  auto nn = makeFcModel({});
+  nn->save(path, ml::train::ModelFormat::MODEL_FORMAT_BIN);
+
+  EXPECT_THROW(nn->load(path, ml::train::ModelFormat::MODEL_FORMAT_MMAP_BIN),
+               std::invalid_argument);
+
+  remove(path.c_str());
+}
+
+TEST(nntrainerGraphUnitTest, inference_reuse_p) {
+  auto nn = makeFcModel({}, ml::train::ExecutionMode::INFERENCE);
+  auto x = makeFcInput();
+  nntrainer::Tensor expected = nn->inference({x}, false)[0]->clone();
+
+  auto x4 = std::make_shared<nntrainer::Tensor>(
+    nntrainer::TensorDim(4, 1, 1, 8), true, nntrainer::Initializer::NONE);
+  for (unsigned int i = 0; i < x4->size(); ++i)
+    x4->getData()[i] = x->getData()[i % x->size()];
+
+  for (int repeat = 0; repeat < 2; ++repeat) {
+    nntrainer::Tensor out = *nn->inference({x}, false)[0];
+    ASSERT_EQ(out.size(), expected.size());
+    for (unsigned int i = 0; i < out.size(); ++i)
+      EXPECT_FLOAT_EQ(out.getData()[i], expected.getData()[i]);
+
+    nntrainer::Tensor out4 = *nn->inference({x4}, false)[0];
+    ASSERT_EQ(out4.size(), 2 * expected.size());
+    for (unsigned int i = 0; i < out4.size(); ++i)
+      EXPECT_FLOAT_EQ(out4.getData()[i],
+                      expected.getData()[i % expected.size()]);
+  }
+}
+
+TEST(nntrainerGraphUnitTest, inference_session_p) {
+  auto nn = trainFcModel({});
+  auto x = makeFcInput();
+  nntrainer::Tensor expected = nn->inference({x}, false)[0]->clone();
+
+  std::vector<std::unique_ptr<nntrainer::NeuralNetwork>> sessions;
+  for (int i = 0; i < 3; ++i)
+    sessions.push_back(nn->createSession());
+
+  auto weight = [](nntrainer::NeuralNetwork &model) {
+    return model.getNetworkGraph().getWeightLocations()[0].var->getData();
+  };
+  for (auto &session : sessions)
+    EXPECT_EQ(weight(*session), weight(*nn));
+
+  /** the weights stay while the sessions hold them */
+  nn.reset();
+
+  std::vector<nntrainer::Tensor> outs(sessions.size());
+  std::vector<std::thread> threads;
+  for (unsigned int i = 0; i < sessions.size(); ++i) {
+    threads.emplace_back([&, i] {
+      auto input = makeFcInput();
+      for (int repeat = 0; repeat < 10; ++repeat)
+        outs[i] = sessions[i]->inference({input}, false)[0]->clone();
+    });
+  }
+  for (auto &t : threads)
+    t.join();
+
+  for (auto &out : outs) {
+    ASSERT_EQ(out.size(), expected.size());
+    for (unsigned int i = 0; i < out.size(); ++i)
+      EXPECT_FLOAT_EQ(out.getData()[i], expected.getData()[i]);
+  }
+}
+
+TEST(nntrainerGraphUnitTest, inference_session_n) {
+  EXPECT_THROW(nntrainer::NeuralNetwork().createSession(), std::runtime_error);
+
+  auto swapped = makeFcModel({"memory_swap=true", "memory_swap_path=/tmp"});
+  EXPECT_THROW(swapped->createSession(), std::invalid_argument);
+}
+
+/**
+ * @brief layer projecting its input by a table named as the embedding table,
+ * so that the table tied with an embedding is also written densely
+ */
+class TableProjectionLayer final : public nntrainer::Layer {
+public:
+  const std::string getType() const override { return "table_projection"; }
+
+  void finalize(nntrainer::InitLayerContext &context) override {
+    nntrainer::TensorDim in_dim = context.getInputDimensions()[0];
+    nntrainer::TensorDim out_dim = in_dim;
+    out_dim.width(4);
+    context.setOutputDimensions({out_dim});
+    table_idx = context.requestWeight(
+      nntrainer::TensorDim(1, 1, in_dim.width(), 4),
+      nntrainer::Initializer::XAVIER_UNIFORM,
+      nntrainer::WeightRegularizer::NONE, 1.0f, 0.0f, "Embedding", true);
+  }
+
+  void forwarding(nntrainer::RunLayerContext &context, bool) override {
+    context.getInput(0).dot(context.getWeight(table_idx),
+                            context.getOutput(0));
+  }
+
+  void calcDerivative(nntrainer::RunLayerContext &context) override {
+    context.getIncomingDerivative(0).dot(context.getWeight(table_idx),
+                                         context.getOutgoingDerivative(0),
+                                         false, true);
+  }
+
+  void calcGradient(nntrainer::RunLayerContext &context) override {
+    context.getInput(0).dot_deriv_wrt_2(
+      context.getWeightGrad(table_idx), context.getIncomingDerivative(0),
+      false, false, !context.isGradientFirstAccess(table_idx));
+  }
+
+  void setProperty(const std::vector<std::string> &values) override {
+    NNTR_THROW_IF(!values.empty(), std::invalid_argument)
+      << "table_projection has no property";
+  }
+
+  bool supportBackwarding() const override { return true; }
+
+private:
+  unsigned int table_idx = 0; /**< index of the table */
+};
+
+/**
+ * @brief make the model adding the projection of x and the embedding of ids
+ *
+ * @param tied the embedding shares the table of the projection if true
+ */
+static std::unique_ptr<nntrainer::NeuralNetwork> makeTiedTableModel(bool tied) {
+  std::unique_ptr<nntrainer::NeuralNetwork> nn(new nntrainer::NeuralNetwork());
+  nn->setProperty({"batch_size=2", "loss=mse"});
+  nn->setOptimizer(ml::train::createOptimizer("sgd", {"learning_rate=0.5"}));
+
+  /** the layer is created again by its type when the graph is compiled */
+  static const int table_projection_key =
+    nntrainer::AppContext::Global().registerFactory(
+      nntrainer::createLayer<TableProjectionLayer>, "table_projection");
+  (void)table_projection_key;
+
+  std::vector<std::string> emb_props = {"name=emb", "input_layers=ids",
+                                        "in_dim=6", "out_dim=4"};
+  if (tied)
+    emb_props.push_back("shared_from=proj");
+
+  /**
+   * the sorted graph runs the embedding after the projection, so the
+   * embedding writes the gradient of the table first in the backwarding
+   */
+  auto g = makeGraph({
+    {"input", {"name=ids", "input_shape=1:1:1"}},
+    {"embedding", emb_props},
+    {"input", {"name=x", "input_shape=1:1:6"}},
+    {"table_projection", {"name=proj", "input_layers=x"}},
+    {"addition", {"name=add", "input_layers=proj, emb"}},
+  });
+  for (auto &node : g)
+    nn->addLayer(node);
+
+  nn->setProperty({"input_layers=x, ids"});
+  EXPECT_EQ(nn->compile(), ML_ERROR_NONE);
+  EXPECT_EQ(nn->initialize(), ML_ERROR_NONE);
+  EXPECT_EQ(nn->allocate(), ML_ERROR_NONE);
+  return nn;
+}
+
+TEST(nntrainerGraphUnitTest, tied_embedding_dense_gradient_p) {
+  auto tied = makeTiedTableModel(true);
+  auto untied = makeTiedTableModel(false);
+
+  auto table = [](nntrainer::NeuralNetwork &model,
+                  const std::string &name) -> nntrainer::Tensor & {
+    for (auto &node : model.getFlatGraph()) {
+      if (node->getName() == name)
+        return node->getRunContext().getWeight(0);
+    }
+    throw std::invalid_argument("no layer named " + name);
+  };
+  nntrainer::Tensor initial = table(*tied, "emb").clone();
+  EXPECT_EQ(table(*tied, "proj").getData(), table(*tied, "emb").getData());
+  table(*untied, "proj").copyData(initial);
+  table(*untied, "emb").copyData(initial);
+
+  auto x = std::make_shared<nntrainer::Tensor>(
+    nntrainer::TensorDim(2, 1, 1, 6), true, nntrainer::Initializer::NONE);
+  for (unsigned int i = 0; i < x->size(); ++i)
+    x->getData()[i] = ((i * 7) % 11) / 11.0f - 0.5f;
+  auto ids = std::make_shared<nntrainer::Tensor>(
+    nntrainer::TensorDim(2, 1, 1, 1), true, nntrainer::Initializer::NONE);
+  ids->getData()[0] = 1.0f;
+  ids->getData()[1] = 4.0f;
+  auto y = std::make_shared<nntrainer::Tensor>(
+    nntrainer::TensorDim(2, 1, 1, 4), true, nntrainer::Initializer::NONE);
+  y->setValue(1.0f);
+
+  tied->forwarding({x, ids}, {y});
+  tied->backwarding(1);
+  untied->forwarding({x, ids}, {y});
+  untied->backwarding(1);
+
+  /** the embedding writes the rows of ids and the projection every row */
+  nntrainer::Tensor &updated = table(*tied, "emb");
+  nntrainer::Tensor &proj = table(*untied, "proj");
+  nntrainer::Tensor &emb = table(*untied, "emb");
+  for (unsigned int i = 0; i < updated.size(); ++i) {
+    EXPECT_NEAR(updated.getData()[i],
+                proj.getData()[i] + emb.getData()[i] - initial.getData()[i],
+                1e-6f);
+  }
+}
+
+/**
+ * @brief make the model adding two fully connected layers of the same input,
+ * either directly or through a concat and a split
+ *
+ * @param concat_split add the halves of the split of the concat if true
+ */
+static std::unique_ptr<nntrainer::NeuralNetwork>
+makeConcatSplitTrainModel(bool concat_split) {
+  std::unique_ptr<nntrainer::NeuralNetwork> nn(new nntrainer::NeuralNetwork());
+  nn->setProperty({"batch_size=2", "loss=mse"});
+  nn->setOptimizer(ml::train::createOptimizer("sgd", {"learning_rate=0.1"}));
+
+  std::vector<LayerRepresentation> layers = {
+    {"input", {"name=in", "input_shape=1:1:6"}},
+    {"fully_connected", {"name=a", "input_layers=in", "unit=4"}},
+    {"fully_connected", {"name=b", "input_layers=in", "unit=4"}},
+  };
+  if (concat_split) {
+    layers.push_back(
+      {"concat", {"name=concat", "input_layers=a, b", "axis=3"}});
+    layers.push_back({"split", {"name=split", "axis=3", "split_number=2"}});
+    layers.push_back(
+      {"addition", {"name=add", "input_layers=split(0), split(1)"}});
+  } else {
+    layers.push_back({"addition", {"name=add", "input_layers=a, b"}});
+  }
+  for (auto &node : makeGraph(layers))
+    nn->addLayer(node);
+
+  EXPECT_EQ(nn->compile(), ML_ERROR_NONE);
+  EXPECT_EQ(nn->initialize(), ML_ERROR_NONE);
+  EXPECT_EQ(nn->allocate(), ML_ERROR_NONE);
+  return nn;
+}
+
+TEST(nntrainerGraphUnitTest, concat_split_batch_copy_p) {
+  auto nn = makeConcatSplitTrainModel(true);
+  auto ref = makeConcatSplitTrainModel(false);
+
+  auto find = [](nntrainer::NeuralNetwork &model, const std::string &name)
+    -> nntrainer::RunLayerContext & {
+    auto graph = model.getFlatGraph();
+    auto node = std::find_if(graph.begin(), graph.end(), [&name](auto &node) {
+      return node->getName() == name;
+    });
+    EXPECT_NE(node, graph.end());
+    return (*node)->getRunContext();
+  };
+
+  /** slices of a batch of 2 are not contiguous, so they are not placed */
+  nntrainer::RunLayerContext &concat = find(*nn, "concat");
+  EXPECT_NE(concat.getInput(1).getData(), concat.getOutput(0).getData() + 4);
+  nntrainer::RunLayerContext &split = find(*nn, "split");
+  EXPECT_NE(split.getOutput(1).getData(), split.getInput(0).getData() + 4);
+
+  for (auto name : {"a", "b"}) {
+    nntrainer::RunLayerContext &from = find(*ref, name);
+    nntrainer::RunLayerContext &to = find(*nn, name);
+    for (unsigned int i = 0; i < from.getNumWeights(); ++i)
+      to.getWeight(i).copyData(from.getWeight(i));
+  }
+
+  auto x = std::make_shared<nntrainer::Tensor>(
+    nntrainer::TensorDim(2, 1, 1, 6), true, nntrainer::Initializer::NONE);
+  for (unsigned int i = 0; i < x->size(); ++i)
+    x->getData()[i] = ((i * 7) % 11) / 11.0f - 0.5f;
+  auto y = std::make_shared<nntrainer::Tensor>(
+    nntrainer::TensorDim(2, 1, 1, 4), true, nntrainer::Initializer::NONE);
+  for (unsigned int i = 0; i < y->size(); ++i)
+    y->getData()[i] = ((i * 3) % 5) / 5.0f;
+
+  /** the copies give the same outputs and the same updates */
+  for (int iter = 1; iter <= 2; ++iter) {
+    nntrainer::Tensor out = nn->forwarding({x}, {y})[0]->clone();
+    nntrainer::Tensor expected = ref->forwarding({x}, {y})[0]->clone();
+    nn->backwarding(iter);
+    ref->backwarding(iter);
+
+    ASSERT_EQ(out.size(), expected.size());
+    for (unsigned int i = 0; i < out.size(); ++i)
+      EXPECT_FLOAT_EQ(out.getData()[i], expected.getData()[i]);
+  }
+
+  for (auto name : {"a", "b"}) {
+    nntrainer::RunLayerContext &from = find(*ref, name);
+    nntrainer::RunLayerContext &to = find(*nn, name);
+    for (unsigned int i = 0; i < from.getNumWeights(); ++i) {
+      nntrainer::Tensor &w = to.getWeight(i);
+      nntrainer::Tensor &expected = from.getWeight(i);
+      for (unsigned int j = 0; j < w.size(); ++j)
+        EXPECT_FLOAT_EQ(w.getData()[j], expected.getData()[j]);
+    }
+  }
+}
+
+/**
+ * @brief make a small model of convolution and fully connected layers, each
+ * followed by a batch normalization and an activation
+ *
+ * @param props model properties
+ * @param mode execution mode to compile the model
+ * @return allocated model
+ */
+static std::unique_ptr<nntrainer::NeuralNetwork>
+makeConvBnModel(const std::vector<std::string> &props,
+                ml::train::ExecutionMode mode) {
+  std::unique_ptr<nntrainer::NeuralNetwork> nn(new nntrainer::NeuralNetwork());
+  nn->setProperty(props);
+  nn->setProperty({"batch_size=2", "loss=mse"});
+  nn->setOptimizer(ml::train::createOptimizer("sgd", {"learning_rate=0.1"}));
+
+  auto g = makeGraph({
+    {"input", {"name=in", "input_shape=2:4:4"}},
+    {"conv2d",
+     {"name=conv", "filters=3", "kernel_size=3,3", "padding=same"}},
+    {"batch_normalization", {"name=bn0", "momentum=0.5", "epsilon=0.01"}},
+    {"activation", {"name=act0", "activation=relu"}},
+    {"flatten", {"name=flat"}},
+    {"fully_connected", {"name=fc", "unit=5"}},
+    {"batch_normalization", {"name=bn1", "momentum=0.5"}},
+    {"activation", {"name=act1", "activation=sigmoid"}},
+  });
+  for (auto &node : g)
+    nn->addLayer(node);
+
+  EXPECT_EQ(nn->compile(mode), ML_ERROR_NONE);
+  EXPECT_EQ(nn->initialize(mode), ML_ERROR_NONE);
+  EXPECT_EQ(nn->allocate(mode), ML_ERROR_NONE);
+  return nn;
+}
+
+/**
+ * @brief train the model without fusion, save it in the format and check the
+ * fused model loading it infers the same
+ *
+ * @param path path to save the model
+ * @param format format to save and load the model
+ */
+static void checkInferenceFusion(const std::string &path,
+                                 ml::train::ModelFormat format) {
+  auto nn = makeConvBnModel({}, ml::train::ExecutionMode::TRAIN);
+
+  auto x = std::make_shared<nntrainer::Tensor>(
+    nntrainer::TensorDim(2, 2, 4, 4), true, nntrainer::Initializer::NONE);
+  for (unsigned int i = 0; i < x->size(); ++i)
+    x->getData()[i] = ((i * 7) % 11) / 11.0f - 0.5f;
+  auto y = std::make_shared<nntrainer::Tensor>(
+    nntrainer::TensorDim(2, 1, 1, 5), true, nntrainer::Initializer::NONE);
+  for (unsigned int i = 0; i < y->size(); ++i)
+    y->getData()[i] = ((i * 3) % 5) / 5.0f;
+
+  /** moves the statistics of the batch normalization away from the init */
+  for (int iter = 1; iter <= 4; ++iter) {
+    nn->forwarding({x}, {y});
+    nn->backwarding(iter);
+  }
+  nn->save(path, format);
+  nntrainer::Tensor expected = nn->inference({x}, false)[0]->clone();
+
+  auto fused = makeConvBnModel({"inference_fusion=true"},
+                               ml::train::ExecutionMode::INFERENCE);
+  for (auto &node : fused->getFlatGraph()) {
+    EXPECT_NE(node->getType(), "batch_normalization");
+    EXPECT_NE(node->getType(), "activation");
+  }
+  /** the scale and the shift cached before loading must not be used after */
+  fused->inference({x}, false);
+  EXPECT_NO_THROW(fused->load(path, format));
+
+  nntrainer::Tensor out = *fused->inference({x}, false)[0];
+  ASSERT_EQ(out.size(), expected.size());
+  for (unsigned int i = 0; i < out.size(); ++i)
+    EXPECT_NEAR(out.getData()[i], expected.getData()[i], 1e-5f);
+
+  remove(path.c_str());
+}
+
+TEST(nntrainerGraphUnitTest, inference_fusion_p) {
+  checkInferenceFusion("inference_fusion_p.bin",
+                       ml::train::ModelFormat::MODEL_FORMAT_BIN);
+}
+
+TEST(nntrainerGraphUnitTest, inference_fusion_weight_image_p) {
+  /** the weights are found by the names of the unfused layers */
+  checkInferenceFusion("inference_fusion_weight_image_p.bin",
+                       ml::train::ModelFormat::MODEL_FORMAT_MMAP_BIN);
+}
+
+TEST(nntrainerGraphUnitTest, inference_fusion_train_n) {
+  std::unique_ptr<nntrainer::NeuralNetwork> nn(new nntrainer::NeuralNetwork());
+  nn->setProperty({"batch_size=1"});
+
+  auto g = makeGraph({
+    {"input", {"name=in", "input_shape=1:1:4"}},
+    {"fully_connected", {"name=fc", "unit=2", "fused_activation=relu"}},
+  });
+  for (auto &node : g)
+    nn->addLayer(node);
+
+  EXPECT_EQ(nn->compile(), ML_ERROR_NONE);
+  EXPECT_THROW(nn->initialize(), std::invalid_argument);
+}
+
+
+/**
+ * @brief make the model of a fully connected layer over 2 channels followed by
+ * @a next
+ *
+ * @param props model properties
+ * @param next layer after the fully connected layer
+ */
+static std::unique_ptr<nntrainer::NeuralNetwork>
+makeChannelFcModel(const std::vector<std::string> &props,
+                   const LayerRepresentation &next) {
+  std::unique_ptr<nntrainer::NeuralNetwork> nn(new nntrainer::NeuralNetwork());
+  nn->setProperty(props);
+  nn->setProperty({"batch_size=2"});
+
+  auto g = makeGraph({
+    {"input", {"name=in", "input_shape=2:1:4"}},
+    {"fully_connected", {"name=fc", "unit=3"}},
+    next,
+  });
+  for (auto &node : g)
+    nn->addLayer(node);
+
+  EXPECT_EQ(nn->compile(ml::train::ExecutionMode::INFERENCE), ML_ERROR_NONE);
+  return nn;
+}
+
+TEST(nntrainerGraphUnitTest, inference_fusion_fc_channels_p) {
+  const std::string path = "inference_fusion_fc_channels_p.bin";
+  const LayerRepresentation act = {"activation",
+                                   {"name=act", "activation=sigmoid"}};
+
+  auto nn = makeChannelFcModel({}, act);
+  EXPECT_EQ(nn->initialize(ml::train::ExecutionMode::INFERENCE),
+            ML_ERROR_NONE);
+  nn->save(path, ml::train::ModelFormat::MODEL_FORMAT_BIN);
+
+  auto x = std::make_shared<nntrainer::Tensor>(
+    nntrainer::TensorDim(2, 2, 1, 4), true, nntrainer::Initializer::NONE);
+  for (unsigned int i = 0; i < x->size(); ++i)
+    x->getData()[i] = ((i * 7) % 11) / 11.0f - 0.5f;
+  nntrainer::Tensor expected = nn->inference({x}, false)[0]->clone();
+
+  /** the bias runs along the width of the output, not its channels */
+  auto fused = makeChannelFcModel({"inference_fusion=true"}, act);
+  EXPECT_EQ(fused->initialize(ml::train::ExecutionMode::INFERENCE),
+            ML_ERROR_NONE);
+  for (auto &node : fused->getFlatGraph())
+    EXPECT_NE(node->getType(), "activation");
+  EXPECT_NO_THROW(fused->load(path, ml::train::ModelFormat::MODEL_FORMAT_BIN));
+
+  nntrainer::Tensor out = *fused->inference({x}, false)[0];
+  ASSERT_EQ(out.size(), expected.size());
+  for (unsigned int i = 0; i < out.size(); ++i)
+    EXPECT_NEAR(out.getData()[i], expected.getData()[i], 1e-6f);
+
+  remove(path.c_str());
+}
+
+TEST(nntrainerGraphUnitTest, inference_fusion_fc_channels_n) {
+  const LayerRepresentation bn = {"batch_normalization", {"name=bn"}};
+
+  /** the statistics run along the channels, and the bias along the width */
+  auto nn = makeChannelFcModel({}, bn);
+  EXPECT_EQ(nn->initialize(ml::train::ExecutionMode::INFERENCE),
+            ML_ERROR_NONE);
+
+  auto fused = makeChannelFcModel({"inference_fusion=true"}, bn);
+  EXPECT_THROW(fused->initialize(ml::train::ExecutionMode::INFERENCE),
+               std::invalid_argument);
+}
+
+TEST(nntrainerGraphUnitTest, inference_fusion_nhwc_n) {
+  auto make = [](const std::string &fusion) {
+    std::unique_ptr<nntrainer::NeuralNetwork> nn(
+      new nntrainer::NeuralNetwork());
+    nn->setProperty(
+      {"batch_size=1", "tensor_format=NHWC", "inference_fusion=" + fusion});
+
+    auto g = makeGraph({
+      {"input", {"name=in", "input_shape=2:4:4"}},
+      {"conv2d",
+       {"name=conv", "filters=3", "kernel_size=3,3", "padding=same"}},
+      {"batch_normalization", {"name=bn"}},
+    });
+    for (auto &node : g)
+      nn->addLayer(node);
+
+    EXPECT_EQ(nn->compile(ml::train::ExecutionMode::INFERENCE), ML_ERROR_NONE);
+    return nn;
+  };
+
+  /** the fused epilogue walks the output as NCHW */
+  EXPECT_EQ(make("false")->initialize(ml::train::ExecutionMode::INFERENCE),
+            ML_ERROR_NONE);
+  EXPECT_THROW(make("true")->initialize(ml::train::ExecutionMode::INFERENCE),
+               std::invalid_argument);
+}
+
+TEST(nntrainerGraphUnitTest, loss_scaler_p) {
+  nntrainer::DynamicLossScaler scaler(1024.0f, 3, 2.0f, 0.25f, true);
+  EXPECT_TRUE(scaler.isSkipOnOverflow());
+
+  /** grows after 3 consecutive steps without overflow */
+  EXPECT_FALSE(scaler.update(false));
+  EXPECT_FALSE(scaler.update(false));
+  EXPECT_TRUE(scaler.update(false));
+  EXPECT_FLOAT_EQ(scaler.getScale(), 2048.0f);
+
+  /** overflow backs off and restarts the growth interval */
+  EXPECT_FALSE(scaler.update(false));
+  EXPECT_TRUE(scaler.update(true));
+  EXPECT_FLOAT_EQ(scaler.getScale(), 512.0f);
+  EXPECT_FALSE(scaler.update(false));
+  EXPECT_FALSE(scaler.update(false));
+  EXPECT_TRUE(scaler.update(false));
+  EXPECT_FLOAT_EQ(scaler.getScale(), 1024.0f);
+
+  /** the scale does not go below 1 */
+  for (unsigned int i = 0; i < 10; ++i) {
+    scaler.update(true);
+  }
+  EXPECT_FLOAT_EQ(scaler.getScale(), 1.0f);
+  EXPECT_FALSE(scaler.update(true));
+  EXPECT_EQ(scaler.getNumOverflows(), 12u);
+}
+
+TEST(nntrainerGraphUnitTest, loss_scaler_property_p) {
+  std::unique_ptr<ml::train::Model> nn =
+    ml::train::createModel(ml::train::ModelType::NEURAL_NET, {"loss=mse"});
+
+  EXPECT_NO_THROW(nn->setProperty(
+    {"loss_scale=65536", "loss_scale_growth_interval=100",
+     "loss_scale_growth_factor=4", "loss_scale_backoff_factor=0.25",
+     "loss_scale_on_overflow=skip"}));
+  EXPECT_NO_THROW(nn->setProperty({"loss_scale_on_overflow=retry"}));
+
+  EXPECT_THROW(nn->setProperty({"loss_scale_growth_interval=0"}),
+               std::invalid_argument);
+  EXPECT_THROW(nn->setProperty({"loss_scale_growth_factor=0.5"}),
+               std::invalid_argument);
+  EXPECT_THROW(nn->setProperty({"loss_scale_backoff_factor=0"}),
+               std::invalid_argument);
+  EXPECT_THROW(nn->setProperty({"loss_scale_backoff_factor=2"}),
+               std::invalid_argument);
+  EXPECT_THROW(nn->setProperty({"loss_scale_on_overflow=abort"}),
+               std::invalid_argument);
+}
+
 int main(int argc, char **argv) {
   int result = -1;
 
@@ -22,12 +22,17 @@
  */
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <fstream>
 
 #include <neuralnet.h>
 #include <nntrainer_error.h>
+#include <node_exporter.h>
 #include <optimizer.h>
+#include <optimizer_context.h>
+#include <optimizer_wrapped.h>
 #include <util_func.h>
+#include <weight.h>
 
 #include <nntrainer_test_util.h>
 
@@ -99,6 +104,35 @@ TEST(nntrainer_Optimizer, create_07_n) {
     op = ac.createObject<nntrainer::Optimizer>("sgd", {"learning_rate:0.1"}));
 }
 
+/**
+ * @brief Optimizer create
+ */
+TEST(nntrainer_Optimizer, create_08_p) {
+  std::unique_ptr<nntrainer::Optimizer> op;
+  auto &ac = nntrainer::AppContext::Global();
+  EXPECT_NO_THROW(
+    op = ac.createObject<nntrainer::Optimizer>("adamw", {"weight_decay=0.1"}));
+}
+
+/**
+ * @brief AdamW does not decay the weights unless weight_decay is given
+ */
+TEST(nntrainer_Optimizer, adamw_default_weight_decay_p) {
+  std::unique_ptr<nntrainer::Optimizer> op;
+  auto &ac = nntrainer::AppContext::Global();
+  EXPECT_NO_THROW(op = ac.createObject<nntrainer::Optimizer>("adamw", {}));
+
+  nntrainer::Exporter e;
+  op->exportTo(e, ml::train::ExportMethods::METHOD_STRINGVECTOR);
+  auto props = e.getResult<ml::train::ExportMethods::METHOD_STRINGVECTOR>();
+
+  auto iter = std::find_if(props->begin(), props->end(), [](const auto &p) {
+    return p.first == "weight_decay";
+  });
+  ASSERT_NE(iter, props->end());
+  EXPECT_EQ(iter->second, "0");
+}
+
 /**
  * @brief Optimizer create
  */
@@ -119,6 +153,115 @@ TEST(nntrainer_Optimizer, create_09_n) {
     op = ac.createObject<nntrainer::Optimizer>("non-existing type", {}));
 }
 
+/**
+ * @brief create a weight of 4 x 3 with row-sparse gradient, whose rows 0 and 2
+ * are valid and the others hold stale values
+ */
+static nntrainer::Weight createRowSparseWeight() {
+  nntrainer::Weight w(nntrainer::TensorDim(1, 1, 4, 3),
+                      nntrainer::Initializer::ONES,
+                      nntrainer::WeightRegularizer::NONE, 1.0f, 0.0f, 0.0f,
+                      true, true);
+  w.getGradientRef().setValue(100.0f);
+  for (unsigned int i = 0; i < 3; ++i) {
+    w.getGradientRef().setValue(0, 0, 0, i, 1.0f);
+    w.getGradientRef().setValue(0, 0, 2, i, 2.0f);
+  }
+  w.setGradientRows({0, 2});
+  return w;
+}
+
+/**
+ * @brief Row-sparse gradient is made dense
+ */
+TEST(nntrainer_Optimizer, row_sparse_gradient_densify_p) {
+  nntrainer::Weight w = createRowSparseWeight();
+  EXPECT_TRUE(w.isGradientRowSparse());
+  EXPECT_FLOAT_EQ(w.getGradientNorm(), std::sqrt(15.0f));
+
+  w.densifyGradient();
+  EXPECT_FALSE(w.isGradientRowSparse());
+  EXPECT_FLOAT_EQ(w.getGradientRef().getValue(0, 0, 1, 1), 0.0f);
+  EXPECT_FLOAT_EQ(w.getGradientRef().getValue(0, 0, 2, 1), 2.0f);
+  EXPECT_FLOAT_EQ(w.getGradientRef().getValue(0, 0, 3, 2), 0.0f);
+  EXPECT_FLOAT_EQ(w.getGradientNorm(), std::sqrt(15.0f));
+}
+
+/**
+ * @brief SGD updates only the valid rows of the row-sparse gradient
+ */
+TEST(nntrainer_Optimizer, row_sparse_gradient_sgd_p) {
+  nntrainer::Weight w = createRowSparseWeight();
+  auto opt = nntrainer::createOptimizerWrapped("sgd");
+  nntrainer::RunOptimizerContext context(&w, 0, 0.1);
+  opt->applyGradient(context);
+
+  EXPECT_FLOAT_EQ(w.getVariableRef().getValue(0, 0, 0, 0), 0.9f);
+  EXPECT_FLOAT_EQ(w.getVariableRef().getValue(0, 0, 1, 0), 1.0f);
+  EXPECT_FLOAT_EQ(w.getVariableRef().getValue(0, 0, 2, 1), 0.8f);
+  EXPECT_FLOAT_EQ(w.getVariableRef().getValue(0, 0, 3, 2), 1.0f);
+}
+
+/**
+ * @brief Adam without lazy update decays the moments of all the rows
+ */
+TEST(nntrainer_Optimizer, row_sparse_gradient_adam_p) {
+  nntrainer::Weight w = createRowSparseWeight();
+  nntrainer::Tensor wm(w.getDim()), wv(w.getDim());
+  wm.setValue(0.5f);
+  wv.setValue(0.5f);
+  w.setOptimizerVariables({&wm, &wv});
+
+  auto opt = nntrainer::createOptimizerWrapped("adam");
+  nntrainer::RunOptimizerContext context(&w, 0, 0.1);
+  opt->applyGradient(context);
+
+  EXPECT_FALSE(w.isGradientRowSparse());
+  EXPECT_FLOAT_EQ(wm.getValue(0, 0, 1, 0), 0.45f);
+  EXPECT_NE(w.getVariableRef().getValue(0, 0, 1, 0), 1.0f);
+}
+
+/**
+ * @brief Lazy Adam updates only the valid rows of the row-sparse gradient
+ */
+TEST(nntrainer_Optimizer, row_sparse_gradient_lazy_adam_p) {
+  nntrainer::Weight w = createRowSparseWeight();
+  nntrainer::Tensor wm(w.getDim()), wv(w.getDim());
+  wm.setValue(0.5f);
+  wv.setValue(0.5f);
+  w.setOptimizerVariables({&wm, &wv});
+
+  nntrainer::Weight dense = createRowSparseWeight();
+  dense.densifyGradient();
+  nntrainer::Tensor dense_wm(w.getDim()), dense_wv(w.getDim());
+  dense_wm.setValue(0.5f);
+  dense_wv.setValue(0.5f);
+  dense.setOptimizerVariables({&dense_wm, &dense_wv});
+
+  auto opt = nntrainer::createOptimizerWrapped("adam", {"lazy_update=true"});
+  nntrainer::RunOptimizerContext context(&w, 0, 0.1);
+  opt->applyGradient(context);
+  nntrainer::RunOptimizerContext dense_context(&dense, 0, 0.1);
+  opt->applyGradient(dense_context);
+
+  EXPECT_TRUE(w.isGradientRowSparse());
+  for (unsigned int i = 0; i < 3; ++i) {
+    for (unsigned int row : {0u, 2u}) {
+      EXPECT_FLOAT_EQ(w.getVariableRef().getValue(0, 0, row, i),
+                      dense.getVariableRef().getValue(0, 0, row, i));
+      EXPECT_FLOAT_EQ(wm.getValue(0, 0, row, i),
+                      dense_wm.getValue(0, 0, row, i));
+      EXPECT_FLOAT_EQ(wv.getValue(0, 0, row, i),
+                      dense_wv.getValue(0, 0, row, i));
+    }
+    for (unsigned int row : {1u, 3u}) {
+      EXPECT_FLOAT_EQ(w.getVariableRef().getValue(0, 0, row, i), 1.0f);
+      EXPECT_FLOAT_EQ(wm.getValue(0, 0, row, i), 0.5f);
+      EXPECT_FLOAT_EQ(wv.getValue(0, 0, row, i), 0.5f);
+    }
+  }
+}
+
 TEST(nntrainer_throw_if, throw_invalid_arg_p) {
   try {
     NNTR_THROW_IF(1 == 1, std::invalid_argument) << "error msg";
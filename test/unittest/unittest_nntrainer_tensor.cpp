@@ -13,12 +13,17 @@
 
 #include "nntrainer_test_util.h"
 #include "util_func.h"
+#include <blas_interface.h>
 #include <float_tensor.h>
 #include <fstream>
 #include <nntrainer_error.h>
 #include <tensor.h>
 #include <tensor_dim.h>
 
+#ifdef USE_AVX
+#include <blas_avx.h>
+#endif
+
 TEST(nntrainer_TensorDim, ctor_initializer_p) {
   unsigned int b = 3;
   unsigned int c = 2;
@@ -5487,6 +5492,427 @@ TEST(nntrainer_Tensor, is_valid_01) {
   EXPECT_EQ(input.isValid(), false);
 }
 
+#ifdef USE_AVX
+/**
+ * @brief naive reference of C = alpha * op(A) * op(B) + beta * C, the
+ * matrices are row major unless ColMajor is set
+ */
+static void sgemm_reference(bool TransA, bool TransB, unsigned int M,
+                            unsigned int N, unsigned int K, float alpha,
+                            const float *A, unsigned int lda, const float *B,
+                            unsigned int ldb, float beta, float *C,
+                            unsigned int ldc, bool ColMajor = false) {
+  /// element (r, c) of a matrix with the leading dimension ld
+  auto at = [ColMajor](unsigned int r, unsigned int c, unsigned int ld) {
+    return ColMajor ? c * ld + r : r * ld + c;
+  };
+
+  for (unsigned int m = 0; m < M; ++m) {
+    for (unsigned int n = 0; n < N; ++n) {
+      double c = 0.0;
+      for (unsigned int k = 0; k < K; ++k) {
+        float a = TransA ? A[at(k, m, lda)] : A[at(m, k, lda)];
+        float b = TransB ? B[at(n, k, ldb)] : B[at(k, n, ldb)];
+        c += a * b;
+      }
+      C[at(m, n, ldc)] = alpha * c + beta * C[at(m, n, ldc)];
+    }
+  }
+}
+
+TEST(nntrainer_Tensor, avx_sgemm_p) {
+  /// sizes are chosen to cross micro-kernel and cache blocking boundaries
+  const unsigned int M = 151, N = 37, K = 263;
+  const float alpha = 0.5f, beta = 2.0f;
+
+  for (bool TransA : {false, true}) {
+    for (bool TransB : {false, true}) {
+      const unsigned int lda = TransA ? M : K;
+      const unsigned int ldb = TransB ? K : N;
+      std::vector<float> A(M * K), B(K * N), C(M * N), C_ref(M * N);
+      for (unsigned int i = 0; i < A.size(); ++i)
+        A[i] = ((i * 7) % 13) / 13.0f - 0.5f;
+      for (unsigned int i = 0; i < B.size(); ++i)
+        B[i] = ((i * 5) % 11) / 11.0f - 0.5f;
+      for (unsigned int i = 0; i < C.size(); ++i)
+        C[i] = C_ref[i] = (i % 3) / 3.0f;
+
+      nntrainer::avx::sgemm(0, TransA, TransB, M, N, K, alpha, A.data(), lda,
+                            B.data(), ldb, beta, C.data(), N);
+      sgemm_reference(TransA, TransB, M, N, K, alpha, A.data(), lda, B.data(),
+                      ldb, beta, C_ref.data(), N);
+
+      for (unsigned int i = 0; i < C.size(); ++i)
+        EXPECT_NEAR(C[i], C_ref[i], 1e-4);
+    }
+  }
+}
+
+TEST(nntrainer_Tensor, avx_sgemm_col_major_p) {
+  const unsigned int M = 151, N = 37, K = 263;
+  const float alpha = 0.5f, beta = 2.0f;
+
+  for (bool TransA : {false, true}) {
+    for (bool TransB : {false, true}) {
+      /// leading dimensions are the number of rows of the stored matrices
+      const unsigned int lda = TransA ? K : M;
+      const unsigned int ldb = TransB ? N : K;
+      std::vector<float> A(M * K), B(K * N), C(M * N), C_ref(M * N);
+      for (unsigned int i = 0; i < A.size(); ++i)
+        A[i] = ((i * 7) % 13) / 13.0f - 0.5f;
+      for (unsigned int i = 0; i < B.size(); ++i)
+        B[i] = ((i * 5) % 11) / 11.0f - 0.5f;
+      for (unsigned int i = 0; i < C.size(); ++i)
+        C[i] = C_ref[i] = (i % 3) / 3.0f;
+
+      nntrainer::avx::sgemm(1, TransA, TransB, M, N, K, alpha, A.data(), lda,
+                            B.data(), ldb, beta, C.data(), M);
+      sgemm_reference(TransA, TransB, M, N, K, alpha, A.data(), lda, B.data(),
+                      ldb, beta, C_ref.data(), M, true);
+
+      for (unsigned int i = 0; i < C.size(); ++i)
+        EXPECT_NEAR(C[i], C_ref[i], 1e-4);
+    }
+  }
+}
+
+TEST(nntrainer_Tensor, avx_sgemv_p) {
+  const unsigned int M = 67, N = 45;
+  const float alpha = 1.5f, beta = 0.5f;
+
+  std::vector<float> A(M * N), X(std::max(M, N)), Y(std::max(M, N));
+  for (unsigned int i = 0; i < A.size(); ++i)
+    A[i] = ((i * 7) % 13) / 13.0f - 0.5f;
+  for (unsigned int i = 0; i < X.size(); ++i)
+    X[i] = (i % 5) / 5.0f;
+
+  for (bool TransA : {false, true}) {
+    const unsigned int len = TransA ? N : M;
+    std::vector<float> Y_ref(len);
+    for (unsigned int i = 0; i < len; ++i)
+      Y[i] = Y_ref[i] = (i % 3) / 3.0f;
+
+    nntrainer::avx::sgemv(0, TransA, M, N, alpha, A.data(), N, X.data(), 1,
+                          beta, Y.data(), 1);
+    /// Y = op(A) * X is C = op(A) * B with a single column B
+    sgemm_reference(TransA, false, len, 1, TransA ? M : N, alpha, A.data(), N,
+                    X.data(), 1, beta, Y_ref.data(), 1);
+
+    for (unsigned int i = 0; i < len; ++i)
+      EXPECT_NEAR(Y[i], Y_ref[i], 1e-4);
+  }
+}
+
+TEST(nntrainer_Tensor, avx_sgemv_col_major_p) {
+  const unsigned int M = 67, N = 45;
+  const float alpha = 1.5f, beta = 0.5f;
+
+  std::vector<float> A(M * N), X(std::max(M, N)), Y(std::max(M, N));
+  for (unsigned int i = 0; i < A.size(); ++i)
+    A[i] = ((i * 7) % 13) / 13.0f - 0.5f;
+  for (unsigned int i = 0; i < X.size(); ++i)
+    X[i] = (i % 5) / 5.0f;
+
+  for (bool TransA : {false, true}) {
+    const unsigned int len = TransA ? N : M;
+    std::vector<float> Y_ref(len);
+    for (unsigned int i = 0; i < len; ++i)
+      Y[i] = Y_ref[i] = (i % 3) / 3.0f;
+
+    nntrainer::avx::sgemv(1, TransA, M, N, alpha, A.data(), M, X.data(), 1,
+                          beta, Y.data(), 1);
+    sgemm_reference(TransA, false, len, 1, TransA ? M : N, alpha, A.data(), M,
+                    X.data(), TransA ? M : N, beta, Y_ref.data(), len, true);
+
+    for (unsigned int i = 0; i < len; ++i)
+      EXPECT_NEAR(Y[i], Y_ref[i], 1e-4);
+  }
+}
+#endif
+
+TEST(nntrainer_Tensor, adam_update_p) {
+  /// odd length to exercise the vector remainder
+  const unsigned int N = 37;
+  const float grad_scale = 0.25f, beta1 = 0.9f, beta2 = 0.999f, eps = 1e-7f;
+  const float v_scale = 2.0f, step = 0.01f, decay = 0.001f;
+
+  std::vector<float> G(N), W(N), M(N), V(N);
+  for (unsigned int i = 0; i < N; ++i) {
+    G[i] = ((i * 7) % 13) / 13.0f - 0.5f;
+    W[i] = ((i * 5) % 11) / 11.0f - 0.5f;
+    M[i] = (i % 3) / 30.0f;
+    V[i] = (i % 4) / 40.0f;
+  }
+  std::vector<float> W_ref(W), M_ref(M), V_ref(V);
+
+  nntrainer::adam_update(N, G.data(), W.data(), M.data(), V.data(), grad_scale,
+                         beta1, beta2, eps, v_scale, step, decay);
+
+  for (unsigned int i = 0; i < N; ++i) {
+    float g = G[i] * grad_scale;
+    M_ref[i] = beta1 * M_ref[i] + (1 - beta1) * g;
+    V_ref[i] = beta2 * V_ref[i] + (1 - beta2) * g * g;
+    W_ref[i] = W_ref[i] * (1 - decay) -
+               step * M_ref[i] / (std::sqrt(V_ref[i]) * v_scale + eps);
+
+    EXPECT_NEAR(M[i], M_ref[i], 1e-6);
+    EXPECT_NEAR(V[i], V_ref[i], 1e-6);
+    EXPECT_NEAR(W[i], W_ref[i], 1e-5);
+  }
+}
+
+/**
+ * @brief naive softmax(scale * Q * K**T + mask) * V of flash_attention
+ */
+static void attention_reference(unsigned int q_len, unsigned int k_len,
+                                unsigned int dk, unsigned int dv,
+                                const float *Q, unsigned int ldq,
+                                const float *K, unsigned int ldk,
+                                const float *V, unsigned int ldv,
+                                const float *mask, float scale,
+                                int causal_offset, float *O,
+                                unsigned int ldo) {
+  std::vector<double> score(k_len);
+  for (unsigned int i = 0; i < q_len; ++i) {
+    unsigned int valid = k_len;
+    if (causal_offset >= 0)
+      valid = std::min<unsigned int>(k_len, i + causal_offset + 1);
+
+    double max = -std::numeric_limits<double>::infinity(), sum = 0;
+    for (unsigned int j = 0; j < valid; ++j) {
+      score[j] = 0;
+      for (unsigned int d = 0; d < dk; ++d)
+        score[j] += Q[i * ldq + d] * K[j * ldk + d];
+      score[j] = score[j] * scale + (mask ? mask[i * k_len + j] : 0);
+      max = std::max(max, score[j]);
+    }
+    for (unsigned int j = 0; j < valid; ++j)
+      sum += score[j] = std::exp(score[j] - max);
+
+    for (unsigned int d = 0; d < dv; ++d) {
+      double o = 0;
+      for (unsigned int j = 0; j < valid; ++j)
+        o += score[j] * V[j * ldv + d];
+      O[i * ldo + d] = o / sum;
+    }
+  }
+}
+
+TEST(nntrainer_Tensor, flash_attention_p) {
+  /// keys span several tiles with a remainder, and two heads are interleaved
+  const unsigned int q_len = 37, k_len = 300, dk = 12, dv = 5, heads = 2;
+  const unsigned int ldq = dk * heads, ldk = dk * heads, ldv = dv * heads;
+  const unsigned int ldo = dv * heads;
+  const float scale = 1 / std::sqrt((float)dk);
+
+  std::vector<float> Q(q_len * ldq), K(k_len * ldk), V(k_len * ldv);
+  std::vector<float> mask(q_len * k_len);
+  for (unsigned int i = 0; i < Q.size(); ++i)
+    Q[i] = ((i * 7) % 19) / 19.0f - 0.5f;
+  for (unsigned int i = 0; i < K.size(); ++i)
+    K[i] = ((i * 5) % 23) / 23.0f - 0.5f;
+  for (unsigned int i = 0; i < V.size(); ++i)
+    V[i] = ((i * 3) % 17) / 17.0f - 0.5f;
+  for (unsigned int i = 0; i < mask.size(); ++i)
+    mask[i] = (i % 7 == 0) ? -1e10f : ((i * 11) % 13) / 13.0f;
+
+  for (int causal_offset : {-1, 0, 100}) {
+    std::vector<float> O(q_len * ldo), O_ref(q_len * ldo);
+    for (unsigned int h = 0; h < heads; ++h) {
+      const float *m = causal_offset < 0 ? mask.data() : nullptr;
+      nntrainer::flash_attention(q_len, k_len, dk, dv, Q.data() + h * dk, ldq,
+                                 K.data() + h * dk, ldk, V.data() + h * dv,
+                                 ldv, m, k_len, scale, causal_offset,
+                                 O.data() + h * dv, ldo);
+      attention_reference(q_len, k_len, dk, dv, Q.data() + h * dk, ldq,
+                          K.data() + h * dk, ldk, V.data() + h * dv, ldv, m,
+                          scale, causal_offset, O_ref.data() + h * dv, ldo);
+    }
+
+    for (unsigned int i = 0; i < O.size(); ++i)
+      EXPECT_NEAR(O[i], O_ref[i], 1e-5);
+  }
+}
+
+TEST(nntrainer_Tensor, qgemm_q8_p) {
+  /// columns and rows with a remainder of the simd tile, and 4 groups
+  const unsigned int M = 6, N = 21, K = 32, group_size = 8;
+  const unsigned int groups = K / group_size;
+
+  std::vector<float> A(M * K), W(K * N), scales(groups * N);
+  std::vector<int8_t> B(K * N);
+  for (unsigned int i = 0; i < A.size(); ++i)
+    A[i] = ((i * 7) % 19) / 19.0f - 0.5f;
+  for (unsigned int i = 0; i < W.size(); ++i)
+    W[i] = ((i * 5) % 23) / 23.0f - 0.5f;
+
+  nntrainer::quantize_q8(K, N, W.data(), N, B.data(), N, scales.data(), N,
+                         group_size);
+
+  for (unsigned int k = 0; k < K; ++k) {
+    for (unsigned int n = 0; n < N; ++n) {
+      float s = scales[(k / group_size) * N + n];
+      EXPECT_NEAR(B[k * N + n] * s, W[k * N + n], s / 2 + 1e-6);
+    }
+  }
+
+  for (unsigned int rows : {1u, M}) {
+    std::vector<float> C(rows * N);
+    nntrainer::qgemm_q8(rows, N, K, A.data(), K, B.data(), N, scales.data(), N,
+                        group_size, C.data(), N);
+
+    for (unsigned int m = 0; m < rows; ++m) {
+      for (unsigned int n = 0; n < N; ++n) {
+        float expected = 0.0f;
+        for (unsigned int k = 0; k < K; ++k)
+          expected += A[m * K + k] * B[k * N + n] *
+                      scales[(k / group_size) * N + n];
+        EXPECT_NEAR(C[m * N + n], expected, 1e-5);
+      }
+    }
+  }
+}
+
+TEST(nntrainer_Tensor, qgemm_q4_p) {
+  /// odd number of columns leaves the last nibble of each row unused
+  const unsigned int M = 5, N = 19, K = 24, ldb = (N + 1) / 2;
+
+  std::vector<float> A(M * K), W(K * N), scales(N);
+  std::vector<uint8_t> B(K * ldb);
+  for (unsigned int i = 0; i < A.size(); ++i)
+    A[i] = ((i * 7) % 19) / 19.0f - 0.5f;
+  for (unsigned int i = 0; i < W.size(); ++i)
+    W[i] = ((i * 5) % 23) / 23.0f - 0.5f;
+
+  /// per channel scale
+  nntrainer::quantize_q4(K, N, W.data(), N, B.data(), ldb, scales.data(), N,
+                         K);
+
+  std::vector<float> dequantized(K * N);
+  for (unsigned int k = 0; k < K; ++k) {
+    for (unsigned int n = 0; n < N; ++n) {
+      uint8_t nibble = (B[k * ldb + n / 2] >> (4 * (n % 2))) & 0x0F;
+      int q = nibble < 8 ? nibble : nibble - 16;
+      dequantized[k * N + n] = q * scales[n];
+      EXPECT_NEAR(dequantized[k * N + n], W[k * N + n], scales[n] / 2 + 1e-6);
+    }
+  }
+
+  std::vector<float> C(M * N);
+  nntrainer::qgemm_q4(M, N, K, A.data(), K, B.data(), ldb, scales.data(), N, K,
+                      C.data(), N);
+
+  for (unsigned int m = 0; m < M; ++m) {
+    for (unsigned int n = 0; n < N; ++n) {
+      float expected = 0.0f;
+      for (unsigned int k = 0; k < K; ++k)
+        expected += A[m * K + k] * dequantized[k * N + n];
+      EXPECT_NEAR(C[m * N + n], expected, 1e-5);
+    }
+  }
+}
+
+TEST(nntrainer_Tensor, qgemm_group_size_n) {
+  std::vector<float> A(10), scales(1), C(1);
+  std::vector<int8_t> B(10);
+  EXPECT_THROW(nntrainer::qgemm_q8(1, 1, 10, A.data(), 10, B.data(), 1,
+                                   scales.data(), 1, 4, C.data(), 1),
+               std::invalid_argument);
+}
+
+TEST(nntrainer_Tensor, layer_norm_p) {
+  /// a large offset checks the single pass statistics are stable
+  const unsigned int N = 37;
+  const float epsilon = 1e-5f, offset = 100.0f;
+
+  std::vector<float> X(N), gamma(N), beta(N), Y(N), dev(N);
+  for (unsigned int i = 0; i < N; ++i) {
+    X[i] = offset + ((i * 7) % 19) / 19.0f - 0.5f;
+    gamma[i] = ((i * 5) % 23) / 23.0f + 0.5f;
+    beta[i] = ((i * 3) % 17) / 17.0f - 0.5f;
+  }
+
+  double mean = 0.0, var = 0.0;
+  for (unsigned int i = 0; i < N; ++i)
+    mean += X[i];
+  mean /= N;
+  for (unsigned int i = 0; i < N; ++i)
+    var += (X[i] - mean) * (X[i] - mean);
+  var /= N;
+  const double inv_std = 1.0 / std::sqrt(var + epsilon);
+
+  float ret = nntrainer::layer_norm(N, X.data(), gamma.data(), beta.data(),
+                                    epsilon, Y.data(), dev.data());
+  EXPECT_NEAR(ret, inv_std, inv_std * 1e-4);
+  for (unsigned int i = 0; i < N; ++i) {
+    EXPECT_NEAR(dev[i], X[i] - mean, 1e-4);
+    EXPECT_NEAR(Y[i], (X[i] - mean) * inv_std * gamma[i] + beta[i], 1e-3);
+  }
+
+  /// in-place without the affine transform
+  nntrainer::layer_norm(N, X.data(), nullptr, nullptr, epsilon, X.data());
+  for (unsigned int i = 0; i < N; ++i)
+    EXPECT_NEAR(X[i], dev[i] * inv_std, 1e-3);
+}
+
+TEST(nntrainer_Tensor, rms_norm_p) {
+  const unsigned int N = 21;
+  const float epsilon = 1e-6f;
+
+  std::vector<float> X(N), gamma(N), Y(N);
+  for (unsigned int i = 0; i < N; ++i) {
+    X[i] = ((i * 7) % 19) / 19.0f - 0.5f;
+    gamma[i] = ((i * 5) % 23) / 23.0f + 0.5f;
+  }
+
+  float sum = 0.0f;
+  for (unsigned int i = 0; i < N; ++i)
+    sum += X[i] * X[i];
+  const float inv_rms = 1.0f / std::sqrt(sum / N + epsilon);
+
+  EXPECT_NEAR(
+    nntrainer::rms_norm(N, X.data(), gamma.data(), epsilon, Y.data()),
+    inv_rms, 1e-5);
+  for (unsigned int i = 0; i < N; ++i)
+    EXPECT_NEAR(Y[i], X[i] * inv_rms * gamma[i], 1e-5);
+}
+
+TEST(nntrainer_Tensor, layer_norm_backward_p) {
+  /// compare to the central difference of sum(layer_norm(X) * dY)
+  const unsigned int N = 13;
+  const float epsilon = 1e-3f, h = 1e-2f;
+
+  std::vector<float> X(N), gamma(N), dY(N), dX(N), dev(N), Y(N);
+  for (unsigned int i = 0; i < N; ++i) {
+    X[i] = ((i * 7) % 19) / 19.0f - 0.5f;
+    gamma[i] = ((i * 5) % 23) / 23.0f + 0.5f;
+    dY[i] = ((i * 3) % 17) / 17.0f - 0.5f;
+  }
+
+  float inv_std = nntrainer::layer_norm(N, X.data(), gamma.data(), nullptr,
+                                        epsilon, Y.data(), dev.data());
+  nntrainer::layer_norm_backward(N, dY.data(), dev.data(), gamma.data(),
+                                 inv_std, dX.data());
+
+  auto loss = [&](const std::vector<float> &in) {
+    nntrainer::layer_norm(N, in.data(), gamma.data(), nullptr, epsilon,
+                          Y.data());
+    double l = 0.0;
+    for (unsigned int i = 0; i < N; ++i)
+      l += Y[i] * dY[i];
+    return l;
+  };
+
+  for (unsigned int i = 0; i < N; ++i) {
+    std::vector<float> in = X;
+    in[i] = X[i] + h;
+    double l_plus = loss(in);
+    in[i] = X[i] - h;
+    double l_minus = loss(in);
+    EXPECT_NEAR(dX[i], (l_plus - l_minus) / (2 * h), 1e-2);
+  }
+}
+
 int main(int argc, char **argv) {
   int result = -1;
 
@@ -436,7 +436,8 @@ TEST(TensorPool, validate_memory) {
 }
 
 /**
- * @brief qint8 tensors reuse fp32 tensor memory space
+ * @brief qint8 tensors reuse fp32 tensor memory space, each at an aligned
+ * offset
  */
 TEST(TensorPool, validate_memory_reuse_01_p) {
   // |--------- t1 ---------|
@@ -446,39 +447,39 @@ TEST(TensorPool, validate_memory_reuse_01_p) {
                     *t5 = nullptr;
 
   EXPECT_NO_THROW(
-    t1 = pool.request("t1", nntrainer::TensorDim({4}), {0},
+    t1 = pool.request("t1", nntrainer::TensorDim({64}), {0},
                       nntrainer::TensorLifespan::FORWARD_FUNC_LIFESPAN));
   EXPECT_NE(t1, nullptr);
   EXPECT_FALSE(t1->isAllocated());
 
   EXPECT_NO_THROW(
     t2 = pool.request("t2",
-                      nntrainer::TensorDim({4}, {nntrainer::Tformat::NCHW,
-                                                 nntrainer::Tdatatype::QINT8}),
+                      nntrainer::TensorDim({64}, {nntrainer::Tformat::NCHW,
+                                                  nntrainer::Tdatatype::QINT8}),
                       {1}, nntrainer::TensorLifespan::BACKWARD_FUNC_LIFESPAN));
   EXPECT_NE(t2, nullptr);
   EXPECT_FALSE(t2->isAllocated());
 
   EXPECT_NO_THROW(
     t3 = pool.request("t3",
-                      nntrainer::TensorDim({4}, {nntrainer::Tformat::NCHW,
-                                                 nntrainer::Tdatatype::QINT8}),
+                      nntrainer::TensorDim({64}, {nntrainer::Tformat::NCHW,
+                                                  nntrainer::Tdatatype::QINT8}),
                       {1}, nntrainer::TensorLifespan::BACKWARD_FUNC_LIFESPAN));
   EXPECT_NE(t3, nullptr);
   EXPECT_FALSE(t3->isAllocated());
 
   EXPECT_NO_THROW(
     t4 = pool.request("t4",
-                      nntrainer::TensorDim({4}, {nntrainer::Tformat::NCHW,
-                                                 nntrainer::Tdatatype::QINT8}),
+                      nntrainer::TensorDim({64}, {nntrainer::Tformat::NCHW,
+                                                  nntrainer::Tdatatype::QINT8}),
                       {1}, nntrainer::TensorLifespan::BACKWARD_FUNC_LIFESPAN));
   EXPECT_NE(t4, nullptr);
   EXPECT_FALSE(t4->isAllocated());
 
   EXPECT_NO_THROW(
     t5 = pool.request("t5",
-                      nntrainer::TensorDim({4}, {nntrainer::Tformat::NCHW,
-                                                 nntrainer::Tdatatype::QINT8}),
+                      nntrainer::TensorDim({64}, {nntrainer::Tformat::NCHW,
+                                                  nntrainer::Tdatatype::QINT8}),
                       {1}, nntrainer::TensorLifespan::BACKWARD_FUNC_LIFESPAN));
   EXPECT_NE(t5, nullptr);
   EXPECT_FALSE(t5->isAllocated());
@@ -489,9 +490,9 @@ TEST(TensorPool, validate_memory_reuse_01_p) {
   EXPECT_NO_THROW(pool.allocate());
 
   EXPECT_EQ(t1->getAddress<float>(0), (float *)t2->getAddress<int8_t>(0));
-  EXPECT_EQ(t1->getAddress<float>(1), (float *)t3->getAddress<int8_t>(0));
-  EXPECT_EQ(t1->getAddress<float>(2), (float *)t4->getAddress<int8_t>(0));
-  EXPECT_EQ(t1->getAddress<float>(3), (float *)t5->getAddress<int8_t>(0));
+  EXPECT_EQ(t1->getAddress<float>(16), (float *)t3->getAddress<int8_t>(0));
+  EXPECT_EQ(t1->getAddress<float>(32), (float *)t4->getAddress<int8_t>(0));
+  EXPECT_EQ(t1->getAddress<float>(48), (float *)t5->getAddress<int8_t>(0));
 
   EXPECT_NO_THROW(pool.deallocate());
 }
@@ -878,6 +879,103 @@ TEST(TensorPool, createOrExtend_unmanaged_n) {
     pool.requestOrExtend("t", {10}, {0}, nntrainer::TensorLifespan::UNMANAGED));
 }
 
+TEST(TensorPool, place_p) {
+  nntrainer::TensorPool pool;
+  // |-------- t1 -------|
+  //         |-t2-|
+  auto t1 = pool.request("t1", {10}, {1}, max_ls);
+  auto t2 = pool.request("t2", {3}, {0}, max_ls);
+  auto t3 = pool.view("t3", "t2", {3}, {1}, max_ls);
+  EXPECT_TRUE(pool.place("t3", "t1", 4));
+  pool.finalize(nntrainer::BasicPlanner(), 0, 2);
+  pool.allocate();
+
+  testSubset(t1, t2);
+  EXPECT_EQ(t2->getData<float>(), t1->getData<float>() + 4);
+  EXPECT_EQ(t3->getData<float>(), t2->getData<float>());
+  pool.deallocate();
+}
+
+TEST(TensorPool, place_in_placed_p) {
+  nntrainer::TensorPool pool;
+  // |-------- t1 -------|
+  //   |---- t2 ----|
+  //         |-t3-|
+  auto t1 = pool.request("t1", {10}, {2}, max_ls);
+  auto t2 = pool.request("t2", {6}, {1}, max_ls);
+  auto t3 = pool.request("t3", {2}, {0}, max_ls);
+  EXPECT_TRUE(pool.place("t3", "t2", 3));
+  EXPECT_TRUE(pool.place("t2", "t1", 2));
+  pool.finalize(nntrainer::BasicPlanner(), 0, 2);
+  pool.allocate();
+
+  EXPECT_EQ(t2->getData<float>(), t1->getData<float>() + 2);
+  EXPECT_EQ(t3->getData<float>(), t1->getData<float>() + 5);
+  pool.deallocate();
+}
+
+TEST(TensorPool, place_batch_p) {
+  nntrainer::TensorPool pool;
+  /// the placement holds only for the batch size of 1
+  auto t1 = pool.request("t1", {2, 1, 1, 6}, {1}, max_ls);
+  auto t2 = pool.request("t2", {2, 1, 1, 3}, {0}, max_ls);
+  EXPECT_TRUE(pool.place("t2", "t1", 3));
+  pool.finalize(nntrainer::BasicPlanner(), 0, 2);
+  pool.allocate();
+  testNoOverlap(t1, t2);
+  pool.deallocate();
+
+  pool.setBatchSize("t1", 1);
+  pool.setBatchSize("t2", 1);
+  pool.finalize(nntrainer::BasicPlanner(), 0, 2);
+  pool.allocate();
+  EXPECT_EQ(t2->getData<float>(), t1->getData<float>() + 3);
+  pool.deallocate();
+}
+
+TEST(TensorPool, place_batch_reset_p) {
+  nntrainer::TensorPool pool;
+  /// the host takes the orders of the placed tensor only while it is placed
+  auto t1 = pool.request("t1", {1, 1, 1, 6}, {1}, max_ls);
+  auto t2 = pool.request("t2", {1, 1, 1, 3}, {0}, max_ls);
+  EXPECT_TRUE(pool.place("t2", "t1", 3));
+  pool.finalize(nntrainer::BasicPlanner(), 0, 2);
+  pool.allocate();
+  EXPECT_EQ(t2->getData<float>(), t1->getData<float>() + 3);
+  pool.deallocate();
+
+  pool.setBatchSize("t1", 2);
+  pool.setBatchSize("t2", 2);
+  pool.finalize(nntrainer::BasicPlanner(), 0, 2);
+  pool.allocate();
+  testNoOverlap(t1, t2);
+  EXPECT_EQ(pool.getExecutionOrder("t1"), std::vector<unsigned int>({1}));
+  pool.deallocate();
+}
+
+TEST(TensorPool, place_n) {
+  nntrainer::TensorPool pool;
+  pool.request("t1", {10}, {0}, max_ls);
+  pool.request("t2", {3}, {0}, max_ls);
+  pool.request("t3", {3}, {0}, max_ls);
+  pool.view("t4", "t3", {2}, {0}, max_ls, 1);
+  pool.placeholder("t5", {3});
+
+  /// out of range
+  EXPECT_FALSE(pool.place("t2", "t1", 8));
+  /// a part of the source
+  EXPECT_FALSE(pool.place("t4", "t1", 0));
+  /// unmanaged
+  EXPECT_FALSE(pool.place("t5", "t1", 0));
+
+  EXPECT_TRUE(pool.place("t2", "t1", 0));
+  /// placed already
+  EXPECT_FALSE(pool.place("t2", "t1", 3));
+  /// circular
+  EXPECT_FALSE(pool.place("t1", "t2", 0));
+  EXPECT_ANY_THROW(pool.place("unknown", "t1", 0));
+}
+
 /**
  * @brief Main gtest
  */
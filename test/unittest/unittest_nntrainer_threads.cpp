@@ -0,0 +1,152 @@
+// SPDX-License-Identifier: Apache-2.0
+/**
+ * @file        unittest_nntrainer_threads.cpp
+ * @date        18 October 2026
+ * @brief       Unit test for thread pool and ParallelBatch
+ * @see         https://github.com/nnstreamer/nntrainer
+ * @bug         No known bugs
+ */
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <nntr_threads.h>
+
+TEST(nntrainer_ThreadPool, parallel_for_covers_range_p) {
+  nntrainer::ThreadPool pool(4);
+  std::vector<std::atomic<int>> visited(1000);
+  for (auto &v : visited)
+    v = 0;
+
+  pool.parallel_for(0, visited.size(), 7,
+                    [&](unsigned int s, unsigned int e, unsigned int) {
+                      for (unsigned int i = s; i < e; ++i)
+                        visited[i]++;
+                    });
+
+  for (auto &v : visited)
+    EXPECT_EQ(v, 1);
+}
+
+TEST(nntrainer_ThreadPool, parallel_for_even_split_p) {
+  nntrainer::ThreadPool pool(3);
+  std::atomic<unsigned int> num_chunks(0);
+  std::atomic<unsigned int> max_chunk_id(0);
+
+  pool.parallel_for(0, 10, 0,
+                    [&](unsigned int s, unsigned int e, unsigned int id) {
+                      num_chunks++;
+                      unsigned int prev = max_chunk_id;
+                      while (prev < id &&
+                             !max_chunk_id.compare_exchange_weak(prev, id))
+                        ;
+                    });
+
+  EXPECT_EQ(num_chunks, 3u);
+  EXPECT_EQ(max_chunk_id, 2u);
+}
+
+TEST(nntrainer_ThreadPool, parallel_for_nested_p) {
+  nntrainer::ThreadPool pool(4);
+  std::atomic<unsigned int> sum(0);
+
+  pool.parallel_for(0, 8, 1, [&](unsigned int s, unsigned int e, unsigned int) {
+    pool.parallel_for(0, 16, 2,
+                      [&](unsigned int s_, unsigned int e_, unsigned int) {
+                        sum += e_ - s_;
+                      });
+  });
+
+  EXPECT_EQ(sum, 8u * 16u);
+}
+
+TEST(nntrainer_ThreadPool, parallel_for_exception_n) {
+  nntrainer::ThreadPool pool(4);
+
+  auto fail_at_42 = [](unsigned int s, unsigned int, unsigned int) {
+    if (s == 42)
+      throw std::runtime_error("failed");
+  };
+
+  EXPECT_THROW(pool.parallel_for(0, 100, 1, fail_at_42), std::runtime_error);
+}
+
+TEST(nntrainer_ThreadPool, parallel_for_many_short_batches_p) {
+  nntrainer::ThreadPool pool(4);
+
+  /// each batch returns while the last worker may still be signalling it
+  for (unsigned int iter = 0; iter < 2000; ++iter) {
+    std::atomic<unsigned int> count(0);
+    pool.parallel_for(0, 4, 1,
+                      [&](unsigned int s, unsigned int e, unsigned int) {
+                        count += e - s;
+                      });
+    ASSERT_EQ(count, 4u);
+  }
+}
+
+TEST(nntrainer_ThreadPool, set_num_threads_p) {
+  nntrainer::ThreadPool pool(2);
+  pool.setNumThreads(5);
+  EXPECT_EQ(pool.getNumThreads(), 5u);
+  pool.setAffinity(true);
+
+  std::atomic<unsigned int> count(0);
+  pool.parallel_for(0, 50, 1,
+                    [&](unsigned int s, unsigned int e, unsigned int) {
+                      count += e - s;
+                    });
+  EXPECT_EQ(count, 50u);
+
+  pool.setNumThreads(0);
+  EXPECT_EQ(pool.getNumThreads(), 1u);
+}
+
+TEST(nntrainer_ParallelBatch, run_p) {
+  nntrainer::ThreadPool::Global().setNumThreads(4);
+
+  std::vector<int> visited(10, 0);
+  auto job = [&](unsigned int s, unsigned int e, unsigned int pid,
+                 void *user_data) {
+    EXPECT_EQ(user_data, &visited);
+    for (unsigned int b = s; b < e; ++b)
+      visited[b] += pid + 1;
+  };
+
+  auto workers = nntrainer::ParallelBatch(job, visited.size(), &visited);
+  EXPECT_EQ(workers.getNumWorkers(), 4u);
+  workers.run();
+
+  /// 10 batches over 4 workers are split into chunks of 3
+  std::vector<int> expected = {1, 1, 1, 2, 2, 2, 3, 3, 3, 4};
+  EXPECT_EQ(visited, expected);
+
+  nntrainer::ThreadPool::Global().setNumThreads(1);
+}
+
+TEST(nntrainer_ParallelBatch, run_without_callback_n) {
+  auto workers = nntrainer::ParallelBatch(4);
+  EXPECT_THROW(workers.run(), std::invalid_argument);
+}
+
+int main(int argc, char **argv) {
+  int result = -1;
+
+  try {
+    testing::InitGoogleTest(&argc, argv);
+  } catch (...) {
+    std::cerr << "Error during InitGoogleTest" << std::endl;
+    return 0;
+  }
+
+  try {
+    result = RUN_ALL_TESTS();
+  } catch (...) {
+    std::cerr << "Error during RUN_ALL_TESTS()" << std::endl;
+  }
+
+  return result;
+}